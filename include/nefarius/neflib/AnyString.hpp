@@ -1,5 +1,8 @@
 #pragma once
 
+#include <concepts>
+#include <string>
+
 namespace nefarius::utilities
 {
 	template <class T>
@@ -9,4 +12,12 @@ namespace nefarius::utilities
 
 	template <typename StringType>
 	void StripNullCharacters(StringType& s);
+
+	namespace detail
+	{
+		// For static_assert in a discarded if constexpr branch; a plain false only compiles on
+		// compilers implementing P2593 (MSVC, GCC 13+)
+		template <typename>
+		inline constexpr bool AlwaysFalse = false;
+	}
 }
@@ -0,0 +1,183 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cwchar>
+#include <string>
+#include <string_view>
+
+//
+// Locale-invariant, case-insensitive string comparison based on Unicode simple case folding.
+// Unlike towlower/_wcsicmp the result doesn't depend on the C runtime locale, and unlike
+// CompareStringOrdinal it's portable and exposes a matching hash, so folded keys can live in
+// hash containers. Wide strings are treated as UTF-16 or UTF-32, depending on the width of
+// wchar_t, and fold per code point; narrow strings fold ASCII only and compare every other byte
+// ordinally, which is correct for any ANSI code page and UTF-8.
+//
+namespace nefarius::utilities::casefold
+{
+	/**
+	 * Maps a code point to its simple case folding (CaseFolding.txt status C and S).
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	CodePoint	The code point to fold.
+	 *
+	 * @returns	The folded code point, or CodePoint itself if it has no folding.
+	 */
+	char32_t FoldCodePoint(char32_t CodePoint);
+
+	///< Case-insensitive equality
+	bool EqualsIgnoreCase(std::u16string_view Lhs, std::u16string_view Rhs);
+
+	///< Case-insensitive equality
+	bool EqualsIgnoreCase(std::u32string_view Lhs, std::u32string_view Rhs);
+
+	///< Case-insensitive equality, ASCII folding only
+	bool EqualsIgnoreCase(std::string_view Lhs, std::string_view Rhs);
+
+	///< Hash that is equal for every pair EqualsIgnoreCase considers equal
+	size_t HashIgnoreCase(std::u16string_view Value);
+
+	///< Hash that is equal for every pair EqualsIgnoreCase considers equal; the same as the
+	///< UTF-16 hash of the same text
+	size_t HashIgnoreCase(std::u32string_view Value);
+
+	///< Hash that is equal for every pair EqualsIgnoreCase considers equal
+	size_t HashIgnoreCase(std::string_view Value);
+
+	///< Position of the first case-insensitive occurrence of Needle in Haystack, or npos
+	size_t FindIgnoreCase(std::u16string_view Haystack, std::u16string_view Needle);
+
+	///< Position of the first case-insensitive occurrence of Needle in Haystack, or npos
+	size_t FindIgnoreCase(std::u32string_view Haystack, std::u32string_view Needle);
+
+	///< Position of the first case-insensitive occurrence of Needle in Haystack, or npos
+	size_t FindIgnoreCase(std::string_view Haystack, std::string_view Needle);
+
+	///< Case-insensitive ordering by folded code point, consistent with EqualsIgnoreCase
+	std::strong_ordering CompareIgnoreCase(std::u16string_view Lhs, std::u16string_view Rhs);
+
+	///< Case-insensitive ordering by folded code point, consistent with EqualsIgnoreCase
+	std::strong_ordering CompareIgnoreCase(std::u32string_view Lhs, std::u32string_view Rhs);
+
+	/**
+	 * Writes the simple case folding of every code point of Value to Folded. Surrogate pairs
+	 * are folded as the code point they encode; no folding changes the length in code units,
+	 * so Folded receives exactly Value.size() of them.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 *
+	 * @param 	Value 	The string to fold.
+	 * @param 	Folded	Receives the folded string; must have room for Value.size() units.
+	 */
+	void FoldCase(std::u16string_view Value, char16_t* Folded);
+
+	///< Writes the case folding of every code point of Value to Folded (Value.size() units)
+	void FoldCase(std::u32string_view Value, char32_t* Folded);
+
+#if WCHAR_MAX <= 0xFFFF
+	//
+	// wchar_t is UTF-16 on Windows; these forward to the char16_t implementation.
+	//
+
+	inline std::u16string_view AsUtf16(std::wstring_view Value)
+	{
+		return {reinterpret_cast<const char16_t*>(Value.data()), Value.size()};
+	}
+
+	inline bool EqualsIgnoreCase(std::wstring_view Lhs, std::wstring_view Rhs)
+	{
+		return nefarius::utilities::casefold::EqualsIgnoreCase(AsUtf16(Lhs), AsUtf16(Rhs));
+	}
+
+	inline size_t HashIgnoreCase(std::wstring_view Value)
+	{
+		return nefarius::utilities::casefold::HashIgnoreCase(AsUtf16(Value));
+	}
+
+	inline size_t FindIgnoreCase(std::wstring_view Haystack, std::wstring_view Needle)
+	{
+		return nefarius::utilities::casefold::FindIgnoreCase(AsUtf16(Haystack), AsUtf16(Needle));
+	}
+
+	inline std::strong_ordering CompareIgnoreCase(std::wstring_view Lhs, std::wstring_view Rhs)
+	{
+		return nefarius::utilities::casefold::CompareIgnoreCase(AsUtf16(Lhs), AsUtf16(Rhs));
+	}
+
+	inline void FoldCase(std::wstring_view Value, wchar_t* Folded)
+	{
+		nefarius::utilities::casefold::FoldCase(AsUtf16(Value), reinterpret_cast<char16_t*>(Folded));
+	}
+#else
+	//
+	// wchar_t is UTF-32 elsewhere (GCC/Clang on Linux); these forward to the char32_t implementation.
+	//
+
+	inline std::u32string_view AsUtf32(std::wstring_view Value)
+	{
+		return {reinterpret_cast<const char32_t*>(Value.data()), Value.size()};
+	}
+
+	inline bool EqualsIgnoreCase(std::wstring_view Lhs, std::wstring_view Rhs)
+	{
+		return nefarius::utilities::casefold::EqualsIgnoreCase(AsUtf32(Lhs), AsUtf32(Rhs));
+	}
+
+	inline size_t HashIgnoreCase(std::wstring_view Value)
+	{
+		return nefarius::utilities::casefold::HashIgnoreCase(AsUtf32(Value));
+	}
+
+	inline size_t FindIgnoreCase(std::wstring_view Haystack, std::wstring_view Needle)
+	{
+		return nefarius::utilities::casefold::FindIgnoreCase(AsUtf32(Haystack), AsUtf32(Needle));
+	}
+
+	inline std::strong_ordering CompareIgnoreCase(std::wstring_view Lhs, std::wstring_view Rhs)
+	{
+		return nefarius::utilities::casefold::CompareIgnoreCase(AsUtf32(Lhs), AsUtf32(Rhs));
+	}
+
+	inline void FoldCase(std::wstring_view Value, wchar_t* Folded)
+	{
+		nefarius::utilities::casefold::FoldCase(AsUtf32(Value), reinterpret_cast<char32_t*>(Folded));
+	}
+#endif
+
+	///< Appends the case folding of Value to Folded
+	inline void AppendFolded(std::u16string& Folded, std::u16string_view Value)
+	{
+		const size_t offset = Folded.size();
+		Folded.resize(offset + Value.size());
+		nefarius::utilities::casefold::FoldCase(Value, Folded.data() + offset);
+	}
+
+	///< Appends the case folding of Value to Folded
+	inline void AppendFolded(std::wstring& Folded, std::wstring_view Value)
+	{
+		const size_t offset = Folded.size();
+		Folded.resize(offset + Value.size());
+		nefarius::utilities::casefold::FoldCase(Value, Folded.data() + offset);
+	}
+
+	///< Value with every code point replaced by its case folding
+	inline std::u16string FoldCase(std::u16string_view Value)
+	{
+		std::u16string folded(Value.size(), u'\0');
+		nefarius::utilities::casefold::FoldCase(Value, folded.data());
+		return folded;
+	}
+
+	///< Value with every code point replaced by its case folding
+	inline std::wstring FoldCase(std::wstring_view Value)
+	{
+		std::wstring folded(Value.size(), L'\0');
+		nefarius::utilities::casefold::FoldCase(Value, folded.data());
+		return folded;
+	}
+}
@@ -1,33 +1,18 @@
 // ReSharper disable CppRedundantQualifier
 #pragma once
 
+#include <span>
+
 #include <nefarius/neflib/AnyString.hpp>
 #include <nefarius/neflib/Win32Error.hpp>
 #include <nefarius/neflib/MultiStringArray.hpp>
+#include <nefarius/neflib/DriverStore.hpp>
+#include <nefarius/neflib/DriverMatchIndex.hpp>
+#include <nefarius/neflib/DeviceTree.hpp>
+#include <nefarius/neflib/DeviceIndex.hpp>
 
 namespace nefarius::devcon
 {
-	template <nefarius::utilities::string_type StringType>
-	struct FindByHwIdResult
-	{
-		std::vector<StringType> HardwareIds;
-
-		StringType Name;
-
-		union
-		{
-			struct
-			{
-				uint16_t Major;
-				uint16_t Minor;
-				uint16_t Build;
-				uint16_t Private;
-			};
-
-			uint64_t Value;
-		} Version;
-	};
-
 	template <nefarius::utilities::string_type StringType>
 	struct INFClassResult
 	{
@@ -63,6 +48,33 @@ namespace nefarius::devcon
 		const std::string& ClassName, const GUID* ClassGuid,
 		const nefarius::utilities::WideMultiStringArray& HardwareId);
 
+	/**
+	 * Creates a new root-enumerated device node for a driver to load on to.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	ClassName 	Name of the device class (System, HIDClass, USB, etc.).
+	 * @param 	ClassGuid 	Unique identifier for the device class.
+	 * @param 	HardwareId	The Hardware ID(s) to set, from any multi-string buffer (small-buffer or
+	 * 						arena-backed MultiStringArray, registry data...) without copying it.
+	 *
+	 * @returns	A std::expected&lt;void,nefarius::util::Win32Error&gt;
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<void, nefarius::utilities::Win32Error> Create(const StringType& ClassName, const GUID* ClassGuid,
+	                                                            nefarius::utilities::WideMultiStringView HardwareId);
+
+	template
+	std::expected<void, nefarius::utilities::Win32Error> nefarius::devcon::Create(
+		const std::wstring& ClassName, const GUID* ClassGuid,
+		nefarius::utilities::WideMultiStringView HardwareId);
+
+	template
+	std::expected<void, nefarius::utilities::Win32Error> nefarius::devcon::Create(
+		const std::string& ClassName, const GUID* ClassGuid,
+		nefarius::utilities::WideMultiStringView HardwareId);
+
 	/**
 	 * Triggers a driver update on all devices matching a given hardware ID with using the provided INF.
 	 *
@@ -239,6 +251,65 @@ namespace nefarius::devcon
 	nefarius::devcon::FindByHwId(
 		const std::string& Matchstring);
 
+	/**
+	 * Like FindByHwId above, but takes the driver version from the best match of a
+	 * DriverMatchIndex instead of letting SetupDiBuildDriverInfoList search the INF directory for
+	 * every found device. Build the index over %WINDIR%\INF (see
+	 * inf::DriverMatchIndex::BuildFromDirectory) for the same candidates, with the target's OS
+	 * version set so the right models sections are picked.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Matchstring	The partial string to search for.
+	 * @param 	Drivers	   	The drivers that can bind, matched by hardware and compatible IDs.
+	 *
+	 * @returns	The found devices; Version is zero for devices no indexed driver matches.
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, nefarius::utilities::Win32Error>
+	FindByHwId(
+		const StringType& Matchstring, const inf::DriverMatchIndex& Drivers);
+
+	template
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, nefarius::utilities::Win32Error>
+	nefarius::devcon::FindByHwId(
+		const std::wstring& Matchstring, const inf::DriverMatchIndex& Drivers);
+
+	template
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::string>>, nefarius::utilities::Win32Error>
+	nefarius::devcon::FindByHwId(
+		const std::string& Matchstring, const inf::DriverMatchIndex& Drivers);
+
+	/**
+	 * Like FindByHwId above, but searches a DeviceIndex of the system's devices (see
+	 * BuildDeviceIndex) instead of enumerating every device again, for tools running many
+	 * searches against the same set of devices. Only the driver versions of the found devices
+	 * are still queried from the system.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 *
+	 * @param 	Index	   	Index of the system's devices.
+	 * @param 	Matchstring	The partial string to search for.
+	 *
+	 * @returns	The found devices.
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, nefarius::utilities::Win32Error>
+	FindByHwId(
+		const DeviceIndex& Index, const StringType& Matchstring);
+
+	template
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, nefarius::utilities::Win32Error>
+	nefarius::devcon::FindByHwId(
+		const DeviceIndex& Index, const std::wstring& Matchstring);
+
+	template
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::string>>, nefarius::utilities::Win32Error>
+	nefarius::devcon::FindByHwId(
+		const DeviceIndex& Index, const std::string& Matchstring);
+
 	template <nefarius::utilities::string_type StringType>
 	std::expected<nefarius::devcon::INFClassResult<StringType>, nefarius::utilities::Win32Error>
 	GetINFClass(const StringType& InfPath);
@@ -259,29 +330,28 @@ namespace nefarius::devcon
 	}
 
 	/**
-	 * A single driver package published into the Windows driver store.
+	 * Enumerates the driver packages published in the local driver store, without copying
+	 * anything. Uses the undocumented drvstore.dll offline enumeration API; fails with
+	 * ERROR_INVALID_FUNCTION if drvstore.dll or the export it needs isn't available. Exceptions
+	 * thrown by the callback end the enumeration and are rethrown to the caller.
 	 *
 	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	16.08.2026
+	 * @date	16.10.2026
+	 *
+	 * @param 	Callback	Invoked for every package that passes the filter.
+	 * @param 	Filter  	(Optional) Criteria packages have to meet.
+	 *
+	 * @returns	A std::expected&lt;void,nefarius::utilities::Win32Error&gt;
 	 */
-	struct DriverStorePackage
-	{
-		/// Absolute path of this package's INF copy inside the driver store
-		std::wstring DriverPackageInfPath;
-		/// Published name in %WINDIR%\INF, e.g. "oem12.inf"
-		std::wstring PublishedInfName;
-		/// True for driver packages that ship inbox with Windows itself
-		bool IsInbox = false;
-		/// Processor architecture the package was published for
-		unsigned short ProcessorArchitecture = 0;
-		/// Locale the package was published for
-		std::wstring LocaleName;
-	};
+	std::expected<void, nefarius::utilities::Win32Error> EnumerateDriverStorePackages(
+		const DriverStorePackageCallback& Callback, const DriverStorePackageFilter& Filter = {});
 
 	/**
 	 * Enumerates every non-inbox driver package currently published in the local driver store.
 	 * Uses the undocumented drvstore.dll offline enumeration API; fails with
 	 * ERROR_INVALID_FUNCTION if drvstore.dll or the export it needs isn't available.
+	 * InfMetadataCache::lookup on DriverPackageInfPath inspects the packages without reparsing
+	 * the ones seen before.
 	 *
 	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
 	 * @date	16.08.2026
@@ -290,6 +360,29 @@ namespace nefarius::devcon
 	 */
 	std::expected<std::vector<DriverStorePackage>, nefarius::utilities::Win32Error> EnumerateDriverStorePackages();
 
+	/**
+	 * Looks up a driver store package by its published name, ending the enumeration at the first
+	 * match.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	PublishedInfName	Published name in %WINDIR%\INF, e.g. "oem12.inf".
+	 *
+	 * @returns	The package, ERROR_NOT_FOUND if there is none, or the enumeration error.
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<DriverStorePackage, nefarius::utilities::Win32Error> FindDriverStorePackage(
+		const StringType& PublishedInfName);
+
+	template
+	std::expected<DriverStorePackage, nefarius::utilities::Win32Error> nefarius::devcon::FindDriverStorePackage(
+		const std::wstring& PublishedInfName);
+
+	template
+	std::expected<DriverStorePackage, nefarius::utilities::Win32Error> nefarius::devcon::FindDriverStorePackage(
+		const std::string& PublishedInfName);
+
 	/**
 	 * Surgically removes the driver store package matching a given original INF file, without
 	 * touching any device node (unlike UninstallDriver/DiUninstallDriverW, which also uninstalls
@@ -318,4 +411,55 @@ namespace nefarius::devcon
 	template
 	std::expected<void, nefarius::utilities::Win32Error> nefarius::devcon::RemoveDriverStorePackage(
 		const std::string& FullInfPath, bool* RebootRequired);
+
+	/**
+	 * Like RemoveDriverStorePackage above, but reads the [Version] identities of the original INF
+	 * and of every driver store candidate through an InfMetadataCache, so only packages added or
+	 * changed since the cache was last saved get parsed. Call InfMetadataCache::save afterwards to
+	 * persist newly parsed entries.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 		  	FullInfPath   	Full pathname of the original INF file.
+	 * @param [in,out]	Cache         	The metadata cache to consult and update.
+	 * @param [in,out]	RebootRequired	If non-null, true if reboot required (only set by the
+	 * 									DiUninstallDriverW fallback).
+	 *
+	 * @returns	A std::expected&lt;void,nefarius::utilities::Win32Error&gt;
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<void, nefarius::utilities::Win32Error> RemoveDriverStorePackage(
+		const StringType& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired = nullptr);
+
+	template
+	std::expected<void, nefarius::utilities::Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+		const std::wstring& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired);
+
+	template
+	std::expected<void, nefarius::utilities::Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+		const std::string& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired);
+
+	/**
+	 * Removes the driver store packages of many original INF files, enumerating the store only
+	 * once (see DriverStoreIndex). Each INF is handled like by RemoveDriverStorePackage, except
+	 * that packages are matched by their full identity and every matching package is deleted.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 		  	FullInfPaths  	Full pathnames of the original INF files.
+	 * @param 		  	Options		  	(Optional) Index options.
+	 * @param [in,out]	RebootRequired	If non-null, true if any DiUninstallDriverW fallback requires
+	 * 									a reboot.
+	 *
+	 * @returns	One result per INF, in the order of FullInfPaths.
+	 */
+	std::vector<std::expected<void, nefarius::utilities::Win32Error>> RemoveDriverStorePackages(
+		std::span<const std::wstring> FullInfPaths, const DriverStoreIndexOptions& Options = {},
+		bool* RebootRequired = nullptr);
+
+	std::vector<std::expected<void, nefarius::utilities::Win32Error>> RemoveDriverStorePackages(
+		std::span<const std::string> FullInfPaths, const DriverStoreIndexOptions& Options = {},
+		bool* RebootRequired = nullptr);
 }
@@ -0,0 +1,264 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/DeviceTree.hpp>
+
+//
+// A copy of the state of every present device that follows the device tree by applying the
+// arrivals, removals and changes an event source reports, instead of enumerating the tree
+// again. Readers get an immutable view that is swapped out atomically whenever a batch of events
+// has been applied, so they never wait for a batch to be applied (and vice versa); a lookup in a
+// view is a hash probe. Views are sharded so a batch only copies the shards it touches. Events
+// come from a DeviceEventSource: SystemDeviceEvents subscribes to CfgMgr32 notifications on
+// Windows, SyntheticDeviceEvents lets a test (e.g. next to a DeviceTreeSimulator) post them on
+// any platform.
+//
+namespace nefarius::devcon
+{
+	/**
+	 * What happened to a device.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	enum class DeviceEventType
+	{
+		Arrival, ///< The device was enumerated (CM_NOTIFY_ACTION_DEVICEINSTANCEENUMERATED)
+		Started, ///< The device was started (CM_NOTIFY_ACTION_DEVICEINSTANCESTARTED)
+		Removal, ///< The device is gone (CM_NOTIFY_ACTION_DEVICEINSTANCEREMOVED)
+		Changed ///< Its state or properties may have changed, e.g. an interface of it came or went
+	};
+
+	/**
+	 * A single event of a DeviceEventSource.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	struct DeviceEvent
+	{
+		DeviceEventType Type = DeviceEventType::Changed;
+		std::wstring InstanceId; ///< The device the event is about
+	};
+
+	/**
+	 * Reports device events to a sink until stopped. The sink may be called from any thread and
+	 * must return quickly.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class DeviceEventSource
+	{
+	public:
+		using Sink = std::function<void(DeviceEvent Event)>;
+
+		virtual ~DeviceEventSource() = default;
+
+		///< Starts reporting events to Target; fails if already started
+		virtual std::expected<void, std::error_code> start(Sink Target) = 0;
+
+		///< Stops reporting; once it returns, the sink is no longer called
+		virtual void stop() = 0;
+	};
+
+#if defined(_WIN32)
+	/**
+	 * Device instance and device interface notifications of the running system
+	 * (CM_Register_Notification). Interface arrivals and removals are reported as
+	 * DeviceEventType::Changed of the device exposing the interface.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class SystemDeviceEvents final : public DeviceEventSource
+	{
+	public:
+		SystemDeviceEvents() = default;
+		~SystemDeviceEvents() override;
+
+		SystemDeviceEvents(const SystemDeviceEvents&) = delete;
+		SystemDeviceEvents& operator=(const SystemDeviceEvents&) = delete;
+
+		std::expected<void, std::error_code> start(Sink Target) override;
+		void stop() override;
+
+	private:
+		struct Registration;
+
+		std::unique_ptr<Registration> registration_;
+	};
+#endif
+
+	/**
+	 * Events posted by the caller, delivered to the sink on the posting thread; posts while
+	 * stopped are dropped.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class SyntheticDeviceEvents final : public DeviceEventSource
+	{
+	public:
+		std::expected<void, std::error_code> start(Sink Target) override;
+		void stop() override;
+
+		void post(DeviceEvent Event);
+
+		///< Shorthand for post with an event of Type about InstanceId
+		void post(DeviceEventType Type, std::wstring InstanceId)
+		{
+			post(DeviceEvent{Type, std::move(InstanceId)});
+		}
+
+	private:
+		std::mutex lock_;
+		Sink sink_;
+	};
+
+	/**
+	 * The cached state of a present device.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	struct CachedDevice
+	{
+		std::wstring InstanceId;
+		DeviceNodeStatus Status; ///< Default (not started, no problem) if it couldn't be queried
+		std::wstring Name; ///< DEVPKEY_Device_DeviceDesc, else DEVPKEY_Device_FriendlyName; may be empty
+		std::wstring Service; ///< DEVPKEY_Device_Service; empty if not set
+		std::vector<std::wstring> HardwareIds; ///< DEVPKEY_Device_HardwareIds
+		std::optional<nefarius::utilities::Guid> ClassGuid; ///< DEVPKEY_Device_ClassGuid
+	};
+
+	/**
+	 * An immutable state of a DeviceCache.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class DeviceCacheView
+	{
+	public:
+		///< Number of batches of events applied before this view was published
+		[[nodiscard]] uint64_t generation() const
+		{
+			return generation_;
+		}
+
+		///< Number of present devices
+		[[nodiscard]] size_t size() const
+		{
+			return size_;
+		}
+
+		///< A device by instance ID (case-insensitive); nullptr if it isn't present. Valid as
+		///< long as the view.
+		[[nodiscard]] const CachedDevice* find(std::wstring_view InstanceId) const;
+
+		///< Calls Visit for every present device, in no particular order
+		void for_each(const std::function<void(const CachedDevice& Device)>& Visit) const;
+
+	private:
+		friend class DeviceCache;
+
+		///< Case-folded instance ID to device
+		using Shard = std::unordered_map<std::wstring, std::shared_ptr<const CachedDevice>>;
+
+		static constexpr size_t ShardCount = 64;
+
+		///< Index of the shard a case-folded instance ID belongs to
+		[[nodiscard]] static size_t shard_of(std::wstring_view Key);
+
+		uint64_t generation_ = 0;
+		size_t size_ = 0;
+		///< Never modified once published; a batch copies the shards it touches and shares the
+		///< others, and every device it doesn't touch, with the previous view
+		std::array<std::shared_ptr<const Shard>, ShardCount> shards_;
+	};
+
+	/**
+	 * A live cache of the present devices of a device tree. Events are queued by the source's
+	 * sink and applied in batches on a worker thread, each batch re-reading only the devices it
+	 * names from the tree and publishing one new view. Readers never wait for a batch; view() only
+	 * briefly locks to copy the pointer (std::atomic<std::shared_ptr> isn't lock-free with the
+	 * common standard libraries), lookups in a view take no lock at all.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class DeviceCache
+	{
+	public:
+		/**
+		 * Subscribes to Events, then reads every present device of Tree once. Events reported
+		 * while that sweep runs are applied right after it, so nothing in between is missed. Tree
+		 * and Events must outlive the cache.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	17.10.2026
+		 *
+		 * @param 	Tree  	The device tree the events are about.
+		 * @param 	Events	The event source; it's stopped again when the cache is destroyed, unless
+		 * 					starting it failed (e.g. because it has another owner).
+		 *
+		 * @returns	The cache, or the error of starting the source or enumerating the tree.
+		 */
+		static std::expected<std::unique_ptr<DeviceCache>, std::error_code> Create(DeviceTreeBackend& Tree,
+		                                                                           DeviceEventSource& Events);
+
+		~DeviceCache();
+
+		DeviceCache(const DeviceCache&) = delete;
+		DeviceCache& operator=(const DeviceCache&) = delete;
+
+		///< The current state; keep the pointer for a consistent picture across several lookups
+		[[nodiscard]] std::shared_ptr<const DeviceCacheView> view() const
+		{
+			return view_.load(std::memory_order_acquire);
+		}
+
+		///< Waits until every event reported so far has been applied to view()
+		void flush();
+
+	private:
+		DeviceCache(DeviceTreeBackend& Tree, DeviceEventSource& Events);
+
+		void enqueue(DeviceEvent Event);
+		void run(const std::stop_token& Stop);
+		[[nodiscard]] std::shared_ptr<const CachedDevice> read_device(std::wstring_view InstanceId) const;
+
+		DeviceTreeBackend& tree_;
+		DeviceEventSource& events_;
+		bool started_ = false; ///< events_ was started by this cache, so it's stopped by it, too
+
+		std::atomic<std::shared_ptr<const DeviceCacheView>> view_;
+
+		std::mutex queue_lock_;
+		std::condition_variable_any queue_signal_;
+		std::condition_variable applied_signal_;
+		std::deque<DeviceEvent> queue_;
+		uint64_t queued_ = 0; ///< Events ever queued
+		uint64_t applied_ = 0; ///< Events ever applied to view_
+
+		std::jthread worker_;
+	};
+}
@@ -0,0 +1,152 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+
+//
+// Lookup tables over a DeviceSnapshot, so a tool asking many questions about the devices of a
+// system pays for one sweep over the device tree instead of one per question: exact lookups by
+// instance ID, hardware ID, compatible ID, service and setup class are a hash probe, substring
+// searches over hardware IDs (like FindByHwId does) go through a trigram index and only verify
+// the candidates it yields. IDs and service names are matched case-insensitively, like Windows
+// does. Portable like DeviceTree.
+//
+namespace nefarius::devcon
+{
+	/**
+	 * Index of the devices of a device tree. Rows are the rows of the underlying DeviceSnapshot;
+	 * row lists are ascending. Immutable once built, so concurrent lookups are safe.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class DeviceIndex
+	{
+	public:
+		///< Row of the snapshot
+		using Row = uint32_t;
+
+		///< The properties captured for every device
+		static constexpr std::array Properties{
+			DeviceProperty::InstanceId,
+			DeviceProperty::HardwareIds,
+			DeviceProperty::CompatibleIds,
+			DeviceProperty::Service,
+			DeviceProperty::ClassGuid,
+			DeviceProperty::DeviceDesc,
+			DeviceProperty::FriendlyName
+		};
+
+		/**
+		 * Captures a snapshot of the device tree and indexes it.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	17.10.2026
+		 *
+		 * @param 	Tree	   	The device tree.
+		 * @param 	PresentOnly	(Optional) True to only index devices currently present.
+		 *
+		 * @returns	The index, or the error of enumerating the tree.
+		 */
+		static std::expected<DeviceIndex, std::error_code> Build(DeviceTreeBackend& Tree, bool PresentOnly = true);
+
+		///< Indexes a snapshot; properties of Properties it didn't capture simply find nothing
+		static DeviceIndex Build(DeviceSnapshot Snapshot);
+
+		///< Number of indexed devices
+		[[nodiscard]] size_t size() const
+		{
+			return snapshot_.size();
+		}
+
+		///< The indexed properties; rows returned by the lookups are rows of this
+		[[nodiscard]] const DeviceSnapshot& snapshot() const
+		{
+			return snapshot_;
+		}
+
+		///< The device with an instance ID; std::nullopt if it isn't indexed
+		[[nodiscard]] std::optional<Row> by_instance_id(std::wstring_view InstanceId) const;
+
+		///< The devices with a hardware ID
+		[[nodiscard]] std::span<const Row> by_hardware_id(std::wstring_view HardwareId) const;
+
+		///< The devices with a compatible ID
+		[[nodiscard]] std::span<const Row> by_compatible_id(std::wstring_view CompatibleId) const;
+
+		///< The devices with a function driver service (DEVPKEY_Device_Service)
+		[[nodiscard]] std::span<const Row> by_service(std::wstring_view ServiceName) const;
+
+		///< The devices of a device setup class
+		[[nodiscard]] std::span<const Row> by_class(const nefarius::utilities::Guid& ClassGuid) const;
+
+		/**
+		 * Finds the devices with a hardware ID containing a string.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	17.10.2026
+		 *
+		 * @param 	Substring 	The partial string to search for.
+		 * @param 	IgnoreCase	(Optional) True to match case-insensitively; FindByHwId doesn't.
+		 *
+		 * @returns	The rows, ascending.
+		 */
+		[[nodiscard]] std::vector<Row> find_hardware_id(std::wstring_view Substring, bool IgnoreCase = false) const;
+
+	private:
+		struct GuidHash
+		{
+			size_t operator()(const nefarius::utilities::Guid& Value) const;
+		};
+
+		using Rows = std::vector<Row>;
+
+		DeviceSnapshot snapshot_;
+		std::unordered_map<std::wstring, Row> instance_ids_;
+		std::unordered_map<std::wstring, Rows> hardware_ids_;
+		std::unordered_map<std::wstring, Rows> compatible_ids_;
+		std::unordered_map<std::wstring, Rows> services_;
+		std::unordered_map<nefarius::utilities::Guid, Rows, GuidHash> classes_;
+		///< Case-folded hardware ID trigram to the rows having it
+		std::unordered_map<uint64_t, Rows> trigrams_;
+	};
+
+	///< Like ListDeviceInstancesByService, answered from an index
+	std::vector<std::wstring> ListDeviceInstancesByService(const DeviceIndex& Index, std::wstring_view ServiceName);
+
+	///< Like ListDeviceInstancesByClass, answered from an index
+	std::vector<std::wstring> ListDeviceInstancesByClass(const DeviceIndex& Index,
+	                                                     const nefarius::utilities::Guid& ClassGuid);
+
+	/**
+	 * Like FindByHwId, answered from an index: the search and the names don't touch the device
+	 * tree, only the driver versions of the found devices are read from it.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 *
+	 * @param 	Tree	   	The device tree the index was built from.
+	 * @param 	Index	   	The index.
+	 * @param 	Matchstring	The partial string to search for (case-sensitive).
+	 *
+	 * @returns	The found devices.
+	 */
+	std::vector<FindByHwIdResult<std::wstring>> FindByHwId(DeviceTreeBackend& Tree, const DeviceIndex& Index,
+	                                                       std::wstring_view Matchstring);
+
+	///< Like FindByHwId above, taking the driver version from the best match of Drivers instead
+	std::vector<FindByHwIdResult<std::wstring>> FindByHwId(const DeviceIndex& Index, std::wstring_view Matchstring,
+	                                                       const inf::DriverMatchIndex& Drivers);
+}
@@ -2,107 +2,18 @@
 #pragma once
 
 #include <chrono>
+#include <span>
 
 #include <nefarius/neflib/AnyString.hpp>
 #include <nefarius/neflib/Win32Error.hpp>
 #include <nefarius/neflib/ClassFilter.hpp>
+#include <nefarius/neflib/InfAnalysis.hpp>
+#include <nefarius/neflib/DeviceTree.hpp>
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+#include <nefarius/neflib/DeviceIndex.hpp>
 
 namespace nefarius::devcon
 {
-	/**
-	 * The mechanism that was used (or attempted) to bring a device back online without a reboot.
-	 *
-	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	13.08.2026
-	 */
-	enum class RestartStrategy
-	{
-		///< No strategy succeeded (or none was attempted)
-		None,
-		///< The USB hub port the device is attached to was power-cycled
-		UsbPortCycle,
-		///< A DIF_PROPERTYCHANGE/DICS_PROPCHANGE was sent to the device
-		PropertyChange,
-		///< The device sub-tree was removed and the parent was re-enumerated
-		RemoveAndReenumerate
-	};
-
-	/**
-	 * Tuning knobs for RestartDeviceInstance.
-	 *
-	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	13.08.2026
-	 */
-	struct DeviceRestartOptions
-	{
-		///< Upper bound each individual strategy attempt may take before it is abandoned
-		std::chrono::milliseconds PerDeviceTimeout{std::chrono::seconds(10)};
-		///< Upper bound to wait for the devnode to actually report started/no-problem after a
-		///< strategy reports success, before trying the next strategy (or giving up)
-		std::chrono::milliseconds PostRestartVerifyTimeout{std::chrono::seconds(3)};
-		///< Allow attempting a USB hub port cycle
-		bool AllowUsbPortCycle = true;
-		///< Allow attempting a DIF_PROPERTYCHANGE restart
-		bool AllowPropertyChange = true;
-		///< Allow attempting a query-remove + re-enumerate of the parent devnode
-		bool AllowRemoveAndReenumerate = true;
-	};
-
-	/**
-	 * Outcome of a single RestartDeviceInstance call.
-	 *
-	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	13.08.2026
-	 */
-	struct DeviceRestartResult
-	{
-		///< Instance ID of the device this result refers to
-		std::wstring InstanceId;
-		///< Friendly name/description, if it could be resolved, for logging purposes
-		std::wstring FriendlyName;
-		///< The strategy that succeeded; RestartStrategy::None if every attempt failed
-		RestartStrategy Strategy = RestartStrategy::None;
-		///< True if the device could be brought back online without a reboot. This reflects a
-		///< verified outcome (the devnode was polled and confirmed started with no problem code
-		///< after the winning strategy ran), not just that the restart mechanism itself didn't
-		///< error out.
-		bool Succeeded = false;
-		///< True if the last attempted strategy hit PerDeviceTimeout
-		bool TimedOut = false;
-		///< True if Windows reported DI_NEEDRESTART/DI_NEEDREBOOT for this device regardless of Succeeded
-		bool RebootRequired = false;
-		///< Win32 error code of the last failed attempt, ERROR_SUCCESS if Succeeded
-		DWORD LastError = ERROR_SUCCESS;
-		///< Populated with the blocking driver/application name if a query-remove was vetoed
-		std::wstring VetoName;
-		///< Populated alongside VetoName with the veto reason reported by the PnP manager
-		PNP_VETO_TYPE VetoType = static_cast<PNP_VETO_TYPE>(0);
-		///< The last strategy actually attempted, regardless of outcome; unlike Strategy (which
-		///< stays None on total failure), this is populated even when every attempt failed, for
-		///< diagnostic purposes
-		RestartStrategy LastAttempted = RestartStrategy::None;
-		///< True if the devnode could still be located (CM_LOCATE_DEVNODE_NORMAL) by the final,
-		///< authoritative re-check that RestartDeviceInstance always performs before returning -
-		///< even after a strategy already verified success. False means the device is no longer
-		///< present (e.g. a phantom/removed node) - there is nothing left to restart, which is a
-		///< materially different situation than a device that is present but stuck
-		bool DevicePresent = false;
-		///< True if CM_Get_DevNode_Status was actually queried successfully on that same final
-		///< re-check; FinalStarted/FinalHasProblem/FinalProblemCode are only meaningful when this
-		///< is true (and DevicePresent is true). A device can be DevicePresent but still have this
-		///< false if the status query itself failed
-		bool FinalStatusValid = false;
-		///< CM_Get_DevNode_Status's CONFIGRET from that final re-check when FinalStatusValid is
-		///< false and DevicePresent is true; CR_SUCCESS otherwise
-		CONFIGRET FinalStatusError = CR_SUCCESS;
-		///< DN_STARTED bit observed on the final re-check; only meaningful if FinalStatusValid
-		bool FinalStarted = false;
-		///< DN_HAS_PROBLEM bit observed on the final re-check; only meaningful if FinalStatusValid
-		bool FinalHasProblem = false;
-		///< CM_PROB_* problem code observed on the final re-check if FinalHasProblem, else 0
-		ULONG FinalProblemCode = 0;
-	};
-
 	/**
 	 * A single class filter registration a given INF's [DefaultInstall]/[DefaultUninstall]
 	 * section would add or remove.
@@ -144,6 +55,49 @@ namespace nefarius::devcon
 	std::expected<std::vector<InfClassFilterTarget>, nefarius::utilities::Win32Error>
 	nefarius::devcon::GetInfClassFilterTargets(const std::string& FullInfPath);
 
+	/**
+	 * The class filter registrations of an INF on one of the platforms passed to
+	 * GetInfClassFilterTargets.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfPlatformFilterTargets
+	{
+		///< The platform the INF was evaluated for
+		inf::InfPlatformTarget Target;
+		///< What GetInfClassFilterTargets would return when run on that platform
+		std::vector<InfClassFilterTarget> FilterTargets;
+	};
+
+	/**
+	 * Like GetInfClassFilterTargets above, for any number of platforms from a single parse of the
+	 * INF, so a rollout can be planned without running the analysis on every architecture or OS
+	 * build. Uses the SetupAPI-free INF parser; the decorated DefaultInstall/DefaultUninstall
+	 * sections are resolved per target like SetupDiGetActualSectionToInstall would on it.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	FullInfPath	Full pathname to the INF file.
+	 * @param 	Targets	   	The platforms to evaluate the INF for.
+	 *
+	 * @returns	One entry per target, in the order of Targets.
+	 */
+	template <nefarius::utilities::string_type StringType>
+	std::expected<std::vector<InfPlatformFilterTargets>, nefarius::utilities::Win32Error> GetInfClassFilterTargets(
+		const StringType& FullInfPath, std::span<const inf::InfPlatformTarget> Targets);
+
+	template
+	std::expected<std::vector<InfPlatformFilterTargets>, nefarius::utilities::Win32Error>
+	nefarius::devcon::GetInfClassFilterTargets(const std::wstring& FullInfPath,
+	                                           std::span<const inf::InfPlatformTarget> Targets);
+
+	template
+	std::expected<std::vector<InfPlatformFilterTargets>, nefarius::utilities::Win32Error>
+	nefarius::devcon::GetInfClassFilterTargets(const std::string& FullInfPath,
+	                                           std::span<const inf::InfPlatformTarget> Targets);
+
 	/**
 	 * Enumerates the instance IDs of every device currently belonging to a device setup class.
 	 *
@@ -159,63 +113,51 @@ namespace nefarius::devcon
 		const GUID* ClassGuid, bool PresentOnly = true);
 
 	/**
-	 * Power-cycles the USB hub port a device is attached to, forcing it to restart, even if the
-	 * device itself refuses to be closed/reopened by any driver in its stack. Fails with
-	 * ERROR_NOT_SUPPORTED if no USB hub ancestor could be found for the device.
+	 * Reads a set of properties of every device (of a device setup class) in a single sweep into a
+	 * DeviceSnapshot, e.g. for an inventory. Costs a bounded number of CfgMgr32 calls per device
+	 * and a handful of allocations overall; properties a device doesn't have are left empty in its
+	 * row.
 	 *
 	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	13.08.2026
+	 * @date	17.10.2026
 	 *
-	 * @param 	InstanceId	Instance ID of the device to restart.
+	 * @param 	ClassGuid  	Device class GUID to enumerate, nullptr for every class.
+	 * @param 	Properties 	The properties to read.
+	 * @param 	PresentOnly	(Optional) True to only include devices currently present in the system.
 	 *
-	 * @returns	A std::expected&lt;void,nefarius::utilities::Win32Error&gt;
+	 * @returns	A std::expected&lt;DeviceSnapshot,nefarius::utilities::Win32Error&gt;
 	 */
-	std::expected<void, nefarius::utilities::Win32Error> CycleUsbPortOfDevice(const std::wstring& InstanceId);
+	std::expected<DeviceSnapshot, nefarius::utilities::Win32Error> SnapshotDevices(
+		const GUID* ClassGuid, std::span<const DeviceProperty> Properties, bool PresentOnly = true);
 
 	/**
-	 * Outcome of a single DetachDeviceInstance call.
+	 * Indexes every device of the system in a single sweep, so that repeated lookups by ID,
+	 * service or class (see the DeviceIndex overloads of ListDeviceInstancesByClass,
+	 * ListDeviceInstancesByService and FindByHwId) don't enumerate the devices over and over.
+	 * The index doesn't follow later changes to the system; build a new one when needed.
 	 *
 	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
-	 * @date	13.08.2026
+	 * @date	17.10.2026
+	 *
+	 * @param 	PresentOnly	(Optional) True to only index devices currently present in the system.
+	 *
+	 * @returns	A std::expected&lt;DeviceIndex,nefarius::utilities::Win32Error&gt;
 	 */
-	struct DetachResult
-	{
-		///< Instance ID of the device this result refers to
-		std::wstring InstanceId;
-		///< Friendly name/description, if it could be resolved, for logging purposes
-		std::wstring FriendlyName;
-		///< Instance ID of the device's parent devnode; only populated if Succeeded, pass this to
-		///< ReenumerateParentDevNode later to make Windows re-discover the detached device
-		std::wstring ParentInstanceId;
-		///< True if the device sub-tree could be removed (its driver is no longer loaded/locking files)
-		bool Succeeded = false;
-		///< True if the attempt hit the given timeout
-		bool TimedOut = false;
-		///< Win32 error code of the failed attempt, ERROR_SUCCESS if Succeeded
-		DWORD LastError = ERROR_SUCCESS;
-		///< Populated with the blocking driver/application name if the removal was vetoed
-		std::wstring VetoName;
-		///< Populated alongside VetoName with the veto reason reported by the PnP manager
-		PNP_VETO_TYPE VetoType = static_cast<PNP_VETO_TYPE>(0);
-	};
+	std::expected<DeviceIndex, nefarius::utilities::Win32Error> BuildDeviceIndex(bool PresentOnly = true);
 
 	/**
-	 * Outcome of a single ReenumerateParentDevNode call.
+	 * Power-cycles the USB hub port a device is attached to, forcing it to restart, even if the
+	 * device itself refuses to be closed/reopened by any driver in its stack. Fails with
+	 * ERROR_NOT_SUPPORTED if no USB hub ancestor could be found for the device.
 	 *
 	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
 	 * @date	13.08.2026
+	 *
+	 * @param 	InstanceId	Instance ID of the device to restart.
+	 *
+	 * @returns	A std::expected&lt;void,nefarius::utilities::Win32Error&gt;
 	 */
-	struct ReenumerateResult
-	{
-		///< Instance ID of the (parent) devnode this result refers to
-		std::wstring InstanceId;
-		///< True if the devnode could be located and re-enumerated
-		bool Succeeded = false;
-		///< True if the attempt hit the given timeout
-		bool TimedOut = false;
-		///< Win32 error code of the failed attempt, ERROR_SUCCESS if Succeeded
-		DWORD LastError = ERROR_SUCCESS;
-	};
+	std::expected<void, nefarius::utilities::Win32Error> CycleUsbPortOfDevice(const std::wstring& InstanceId);
 
 	/**
 	 * Enumerates the instance IDs of every device currently bound to a given driver service,
@@ -0,0 +1,130 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <nefarius/neflib/DeviceTree.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
+
+//
+// A table of devnode properties read in a single sweep over the device tree: one row per
+// devnode, one column per requested DeviceProperty. String and string list values are appended
+// to a single buffer the rows refer to by offset, so capturing the whole tree takes a bounded
+// number of backend calls per devnode and a handful of allocations in total instead of one (or
+// more) per value. Portable like DeviceTree.
+//
+namespace nefarius::devcon
+{
+	/**
+	 * Which devnodes DeviceSnapshot::Capture includes.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	struct DeviceSnapshotOptions
+	{
+		///< Only devnodes of this device setup class; every class if not set
+		std::optional<nefarius::utilities::Guid> ClassGuid;
+		///< Only devnodes of present devices
+		bool PresentOnly = true;
+	};
+
+	/**
+	 * Columnar snapshot of devnode properties. Immutable once captured, so concurrent reads are
+	 * safe; the returned views stay valid as long as the snapshot isn't destroyed or moved.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	class DeviceSnapshot
+	{
+	public:
+		/**
+		 * Enumerates the devnodes of a device tree and reads the given properties of each. A
+		 * property a devnode doesn't have (or that vanished mid-sweep) is simply missing from its
+		 * row; only failing to enumerate the tree fails the capture.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	17.10.2026
+		 *
+		 * @param 	Tree	  	The device tree.
+		 * @param 	Properties	The properties to read; duplicates are read once.
+		 * @param 	Options   	(Optional) Which devnodes to include.
+		 *
+		 * @returns	The snapshot, or the error of enumerating the tree.
+		 */
+		static std::expected<DeviceSnapshot, std::error_code> Capture(DeviceTreeBackend& Tree,
+		                                                              std::span<const DeviceProperty> Properties,
+		                                                              const DeviceSnapshotOptions& Options = {});
+
+		///< Number of rows (devnodes)
+		[[nodiscard]] size_t size() const
+		{
+			return nodes_.size();
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return nodes_.empty();
+		}
+
+		///< The devnode of a row, as handed out by the backend at capture time
+		[[nodiscard]] DeviceNode node(size_t Row) const
+		{
+			return nodes_[Row];
+		}
+
+		///< Whether a property was captured
+		[[nodiscard]] bool contains(DeviceProperty Property) const;
+
+		///< DeviceProperty::InstanceId of a row; empty if it wasn't captured or couldn't be read
+		[[nodiscard]] std::wstring_view instance_id(size_t Row) const;
+
+		///< A string property of a row; std::nullopt if the devnode doesn't have it or it wasn't captured
+		[[nodiscard]] std::optional<std::wstring_view> string(size_t Row, DeviceProperty Property) const;
+
+		///< A string list property of a row; std::nullopt if the devnode doesn't have it or it
+		///< wasn't captured
+		[[nodiscard]] std::optional<nefarius::utilities::WideMultiStringView> strings(
+			size_t Row, DeviceProperty Property) const;
+
+		///< A uint32 property of a row; std::nullopt if the devnode doesn't have it or it wasn't captured
+		[[nodiscard]] std::optional<uint32_t> uint32(size_t Row, DeviceProperty Property) const;
+
+		///< A GUID property of a row; std::nullopt if the devnode doesn't have it or it wasn't captured
+		[[nodiscard]] std::optional<nefarius::utilities::Guid> guid(size_t Row, DeviceProperty Property) const;
+
+	private:
+		//
+		// One value: a range of arena_ for strings and string lists, the value itself for a
+		// uint32, an index into guids_ for a GUID
+		//
+		struct Cell
+		{
+			uint32_t Value = 0;
+			uint32_t Length = 0;
+			bool Present = false;
+		};
+
+		struct Column
+		{
+			DeviceProperty Property;
+			std::vector<Cell> Cells;
+		};
+
+		[[nodiscard]] const Cell* cell(size_t Row, DeviceProperty Property, DevicePropertyType Type) const;
+
+		std::vector<DeviceNode> nodes_;
+		std::vector<Column> columns_;
+		std::wstring arena_;
+		std::vector<nefarius::utilities::Guid> guids_;
+	};
+}
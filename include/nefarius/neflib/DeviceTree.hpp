@@ -0,0 +1,575 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/AnyString.hpp>
+#include <nefarius/neflib/DriverMatchIndex.hpp>
+#include <nefarius/neflib/Guid.hpp>
+
+//
+// The PnP device tree behind an interface: SystemDeviceTree goes through CfgMgr32/SetupAPI
+// (Windows only), DeviceTreeSimulator keeps devnodes in memory with configurable latency, vetoes
+// and failures, so the restart, detach and search logic below runs unchanged against either and
+// can be exercised at scale on any platform. Errors of both backends are Win32 error codes in
+// the system category, the same values the Win32Error based APIs report; the only exception is
+// the CONFIGRET a failed SystemDeviceTree::status reports (see DeviceTreeBackend::status).
+//
+namespace nefarius::devcon
+{
+	/**
+	 * The mechanism that was used (or attempted) to bring a device back online without a reboot.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	13.08.2026
+	 */
+	enum class RestartStrategy
+	{
+		///< No strategy succeeded (or none was attempted)
+		None,
+		///< The USB hub port the device is attached to was power-cycled
+		UsbPortCycle,
+		///< A DIF_PROPERTYCHANGE/DICS_PROPCHANGE was sent to the device
+		PropertyChange,
+		///< The device sub-tree was removed and the parent was re-enumerated
+		RemoveAndReenumerate
+	};
+
+	/**
+	 * Tuning knobs for RestartDeviceInstance.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	13.08.2026
+	 */
+	struct DeviceRestartOptions
+	{
+		///< Upper bound each individual strategy attempt may take before it is abandoned
+		std::chrono::milliseconds PerDeviceTimeout{std::chrono::seconds(10)};
+		///< Upper bound to wait for the devnode to actually report started/no-problem after a
+		///< strategy reports success, before trying the next strategy (or giving up)
+		std::chrono::milliseconds PostRestartVerifyTimeout{std::chrono::seconds(3)};
+		///< Allow attempting a USB hub port cycle
+		bool AllowUsbPortCycle = true;
+		///< Allow attempting a DIF_PROPERTYCHANGE restart
+		bool AllowPropertyChange = true;
+		///< Allow attempting a query-remove + re-enumerate of the parent devnode
+		bool AllowRemoveAndReenumerate = true;
+	};
+
+	/**
+	 * Outcome of a single RestartDeviceInstance call.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	13.08.2026
+	 */
+	struct DeviceRestartResult
+	{
+		///< Instance ID of the device this result refers to
+		std::wstring InstanceId;
+		///< Friendly name/description, if it could be resolved, for logging purposes
+		std::wstring FriendlyName;
+		///< The strategy that succeeded; RestartStrategy::None if every attempt failed
+		RestartStrategy Strategy = RestartStrategy::None;
+		///< True if the device could be brought back online without a reboot. This reflects a
+		///< verified outcome (the devnode was polled and confirmed started with no problem code
+		///< after the winning strategy ran), not just that the restart mechanism itself didn't
+		///< error out.
+		bool Succeeded = false;
+		///< True if the last attempted strategy hit PerDeviceTimeout
+		bool TimedOut = false;
+		///< True if Windows reported DI_NEEDRESTART/DI_NEEDREBOOT for this device regardless of Succeeded
+		bool RebootRequired = false;
+		///< Win32 error code of the last failed attempt, ERROR_SUCCESS if Succeeded
+		uint32_t LastError = 0;
+		///< Populated with the blocking driver/application name if a query-remove was vetoed
+		std::wstring VetoName;
+		///< Populated alongside VetoName with the PNP_VETO_TYPE reported by the PnP manager
+		uint32_t VetoType = 0;
+		///< The last strategy actually attempted, regardless of outcome; unlike Strategy (which
+		///< stays None on total failure), this is populated even when every attempt failed, for
+		///< diagnostic purposes
+		RestartStrategy LastAttempted = RestartStrategy::None;
+		///< True if the devnode could still be located (CM_LOCATE_DEVNODE_NORMAL) by the final,
+		///< authoritative re-check that RestartDeviceInstance always performs before returning -
+		///< even after a strategy already verified success. False means the device is no longer
+		///< present (e.g. a phantom/removed node) - there is nothing left to restart, which is a
+		///< materially different situation than a device that is present but stuck
+		bool DevicePresent = false;
+		///< True if the devnode status was actually queried successfully on that same final
+		///< re-check; FinalStarted/FinalHasProblem/FinalProblemCode are only meaningful when this
+		///< is true (and DevicePresent is true). A device can be DevicePresent but still have this
+		///< false if the status query itself failed
+		bool FinalStatusValid = false;
+		///< Backend-native code of the failed status query of that final re-check when
+		///< FinalStatusValid is false and DevicePresent is true, 0 otherwise: CM_Get_DevNode_Status's
+		///< CONFIGRET for SystemDeviceTree (and so for the Windows entry points), the Win32 error for
+		///< backends reporting plain Win32 codes. Prefer FinalStatusWin32Error in portable code
+		uint32_t FinalStatusError = 0;
+		///< FinalStatusError as a Win32 error code; ERROR_SUCCESS if there is none
+		uint32_t FinalStatusWin32Error = 0;
+		///< DN_STARTED bit observed on the final re-check; only meaningful if FinalStatusValid
+		bool FinalStarted = false;
+		///< DN_HAS_PROBLEM bit observed on the final re-check; only meaningful if FinalStatusValid
+		bool FinalHasProblem = false;
+		///< CM_PROB_* problem code observed on the final re-check if FinalHasProblem, else 0
+		uint32_t FinalProblemCode = 0;
+	};
+
+	/**
+	 * Outcome of a single DetachDeviceInstance call.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	13.08.2026
+	 */
+	struct DetachResult
+	{
+		///< Instance ID of the device this result refers to
+		std::wstring InstanceId;
+		///< Friendly name/description, if it could be resolved, for logging purposes
+		std::wstring FriendlyName;
+		///< Instance ID of the device's parent devnode; only populated if Succeeded, pass this to
+		///< ReenumerateParentDevNode later to make Windows re-discover the detached device
+		std::wstring ParentInstanceId;
+		///< True if the device sub-tree could be removed (its driver is no longer loaded/locking files)
+		bool Succeeded = false;
+		///< True if the attempt hit the given timeout
+		bool TimedOut = false;
+		///< Win32 error code of the failed attempt, ERROR_SUCCESS if Succeeded
+		uint32_t LastError = 0;
+		///< Populated with the blocking driver/application name if the removal was vetoed
+		std::wstring VetoName;
+		///< Populated alongside VetoName with the PNP_VETO_TYPE reported by the PnP manager
+		uint32_t VetoType = 0;
+	};
+
+	/**
+	 * Outcome of a single ReenumerateParentDevNode call.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	13.08.2026
+	 */
+	struct ReenumerateResult
+	{
+		///< Instance ID of the (parent) devnode this result refers to
+		std::wstring InstanceId;
+		///< True if the devnode could be located and re-enumerated
+		bool Succeeded = false;
+		///< True if the attempt hit the given timeout
+		bool TimedOut = false;
+		///< Win32 error code of the failed attempt, ERROR_SUCCESS if Succeeded
+		uint32_t LastError = 0;
+	};
+
+	template <nefarius::utilities::string_type StringType>
+	struct FindByHwIdResult
+	{
+		std::vector<StringType> HardwareIds;
+
+		StringType Name;
+
+		union
+		{
+			struct
+			{
+				uint16_t Major;
+				uint16_t Minor;
+				uint16_t Build;
+				uint16_t Private;
+			};
+
+			uint64_t Value;
+		} Version;
+	};
+
+	///< Handle of a devnode, only meaningful to the backend that handed it out (a DEVINST for
+	///< SystemDeviceTree)
+	using DeviceNode = uint32_t;
+
+	/**
+	 * Devnode properties a DeviceTreeBackend can read.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class DeviceProperty
+	{
+		DeviceDesc, ///< DEVPKEY_Device_DeviceDesc, string
+		FriendlyName, ///< DEVPKEY_Device_FriendlyName, string
+		Service, ///< DEVPKEY_Device_Service, string
+		HardwareIds, ///< DEVPKEY_Device_HardwareIds, string list
+		CompatibleIds, ///< DEVPKEY_Device_CompatibleIds, string list
+		Address, ///< DEVPKEY_Device_Address, uint32; the port number for devices on a USB hub
+		InstanceId, ///< DEVPKEY_Device_InstanceId, string
+		ClassGuid ///< DEVPKEY_Device_ClassGuid, GUID
+	};
+
+	/**
+	 * Value types of the DeviceProperty entries.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 */
+	enum class DevicePropertyType
+	{
+		String,
+		StringList,
+		Uint32,
+		Guid
+	};
+
+	///< The type a DeviceProperty is stored as
+	constexpr DevicePropertyType GetDevicePropertyType(DeviceProperty Property)
+	{
+		switch (Property)
+		{
+		case DeviceProperty::HardwareIds:
+		case DeviceProperty::CompatibleIds:
+			return DevicePropertyType::StringList;
+		case DeviceProperty::Address:
+			return DevicePropertyType::Uint32;
+		case DeviceProperty::ClassGuid:
+			return DevicePropertyType::Guid;
+		default:
+			return DevicePropertyType::String;
+		}
+	}
+
+	/**
+	 * A single devnode status observation.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DeviceNodeStatus
+	{
+		bool Started = false; ///< DN_STARTED
+		bool HasProblem = false; ///< DN_HAS_PROBLEM
+		uint32_t ProblemCode = 0; ///< CM_PROB_* code if HasProblem, else 0
+	};
+
+	/**
+	 * Why a sub-tree removal was refused.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DeviceRemovalVeto
+	{
+		uint32_t Type = 0; ///< PNP_VETO_TYPE
+		std::wstring Name; ///< The vetoing driver, device or application
+	};
+
+	/**
+	 * A device tree the restart, detach and search functions can operate on. Implementations
+	 * must be safe to call from multiple threads, since every operation may run on a worker thread
+	 * that is abandoned (and keeps using the backend) after a timeout.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DeviceTreeBackend
+	{
+	public:
+		virtual ~DeviceTreeBackend() = default;
+
+		///< Looks up a devnode by instance ID (case-insensitive); Phantom also finds devnodes of
+		///< devices that aren't present, like CM_LOCATE_DEVNODE_PHANTOM
+		virtual std::expected<DeviceNode, std::error_code> locate(std::wstring_view InstanceId,
+		                                                          bool Phantom = false) = 0;
+
+		///< Every devnode, or only those of present devices; only those of one device setup class
+		///< if ClassGuid is set
+		virtual std::expected<std::vector<DeviceNode>, std::error_code> enumerate(
+			bool PresentOnly = true, const nefarius::utilities::Guid* ClassGuid = nullptr) = 0;
+
+		virtual std::expected<std::wstring, std::error_code> instance_id(DeviceNode Node) = 0;
+
+		virtual std::expected<DeviceNode, std::error_code> parent(DeviceNode Node) = 0;
+
+		///< Status of a present devnode. May fail with a backend-specific error category whose
+		///< default_error_condition is the equivalent Win32 error; SystemDeviceTree reports the
+		///< CONFIGRET this way, which becomes DeviceRestartResult::FinalStatusError
+		virtual std::expected<DeviceNodeStatus, std::error_code> status(DeviceNode Node) = 0;
+
+		///< Reads a string property; fails with ERROR_NOT_FOUND if it isn't set
+		virtual std::expected<std::wstring, std::error_code> property_string(DeviceNode Node,
+		                                                                    DeviceProperty Property) = 0;
+
+		///< Reads a string list property; fails with ERROR_NOT_FOUND if it isn't set
+		virtual std::expected<std::vector<std::wstring>, std::error_code> property_strings(
+			DeviceNode Node, DeviceProperty Property) = 0;
+
+		///< Reads a uint32 property; fails with ERROR_NOT_FOUND if it isn't set
+		virtual std::expected<uint32_t, std::error_code> property_uint32(DeviceNode Node,
+		                                                                 DeviceProperty Property) = 0;
+
+		///< Reads a GUID property; fails with ERROR_NOT_FOUND if it isn't set
+		virtual std::expected<nefarius::utilities::Guid, std::error_code> property_guid(
+			DeviceNode Node, DeviceProperty Property) = 0;
+
+		///< Appends a string property (without terminator) or a string list property (every entry
+		///< NUL-terminated) to Buffer, which is left unchanged on failure. The default goes through
+		///< property_string/property_strings; backends override it to read into Buffer directly.
+		virtual std::expected<void, std::error_code> append_property(DeviceNode Node, DeviceProperty Property,
+		                                                             std::wstring& Buffer);
+
+		///< Sends DIF_PROPERTYCHANGE/DICS_PROPCHANGE; yields whether a reboot is required
+		virtual std::expected<bool, std::error_code> restart(DeviceNode Node) = 0;
+
+		///< Query-removes the devnode sub-tree without forcing it; fails with ERROR_CANCELLED and
+		///< fills Veto if the removal was vetoed
+		virtual std::expected<void, std::error_code> remove_subtree(DeviceNode Node, DeviceRemovalVeto& Veto) = 0;
+
+		///< Synchronously re-enumerates the devnode, bringing back removed children
+		virtual std::expected<void, std::error_code> reenumerate(DeviceNode Node) = 0;
+
+		///< Power-cycles a port of a USB hub devnode
+		virtual std::expected<void, std::error_code> cycle_port(DeviceNode Hub, uint32_t Port) = 0;
+
+		///< DriverVersion of the best compatible driver, if any, like SetupDiBuildDriverInfoList
+		///< with SPDIT_COMPATDRIVER picks
+		virtual std::optional<uint64_t> compatible_driver_version(DeviceNode Node) = 0;
+	};
+
+#if defined(_WIN32)
+	/**
+	 * The device tree of the running system. Stateless; DeviceNode values are DEVINSTs.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class SystemDeviceTree final : public DeviceTreeBackend
+	{
+	public:
+		std::expected<DeviceNode, std::error_code> locate(std::wstring_view InstanceId, bool Phantom = false) override;
+		std::expected<std::vector<DeviceNode>, std::error_code> enumerate(
+			bool PresentOnly = true, const nefarius::utilities::Guid* ClassGuid = nullptr) override;
+		std::expected<std::wstring, std::error_code> instance_id(DeviceNode Node) override;
+		std::expected<DeviceNode, std::error_code> parent(DeviceNode Node) override;
+		std::expected<DeviceNodeStatus, std::error_code> status(DeviceNode Node) override;
+		std::expected<std::wstring, std::error_code> property_string(DeviceNode Node,
+		                                                            DeviceProperty Property) override;
+		std::expected<std::vector<std::wstring>, std::error_code> property_strings(
+			DeviceNode Node, DeviceProperty Property) override;
+		std::expected<uint32_t, std::error_code> property_uint32(DeviceNode Node, DeviceProperty Property) override;
+		std::expected<nefarius::utilities::Guid, std::error_code> property_guid(DeviceNode Node,
+		                                                                        DeviceProperty Property) override;
+		std::expected<void, std::error_code> append_property(DeviceNode Node, DeviceProperty Property,
+		                                                     std::wstring& Buffer) override;
+		std::expected<bool, std::error_code> restart(DeviceNode Node) override;
+		std::expected<void, std::error_code> remove_subtree(DeviceNode Node, DeviceRemovalVeto& Veto) override;
+		std::expected<void, std::error_code> reenumerate(DeviceNode Node) override;
+		std::expected<void, std::error_code> cycle_port(DeviceNode Hub, uint32_t Port) override;
+		std::optional<uint64_t> compatible_driver_version(DeviceNode Node) override;
+	};
+#endif
+
+	/**
+	 * A devnode of a DeviceTreeSimulator: its properties, its current state and how it reacts to
+	 * the operations of DeviceTreeBackend.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct SimulatedDevice
+	{
+		std::wstring InstanceId; ///< Instance ID, unique case-insensitively
+		std::wstring ParentInstanceId; ///< The parent, added before; empty for a child of the root devnode
+
+		std::wstring DeviceDesc; ///< DEVPKEY_Device_DeviceDesc; empty if not set
+		std::wstring FriendlyName; ///< DEVPKEY_Device_FriendlyName; empty if not set
+		std::wstring Service; ///< DEVPKEY_Device_Service, e.g. "USBHUB3" for a hub; empty if not set
+		std::vector<std::wstring> HardwareIds; ///< DEVPKEY_Device_HardwareIds
+		std::vector<std::wstring> CompatibleIds; ///< DEVPKEY_Device_CompatibleIds
+		std::optional<uint32_t> Address; ///< DEVPKEY_Device_Address; the port on the parent hub
+		std::optional<uint64_t> DriverVersion; ///< See DeviceTreeBackend::compatible_driver_version
+		std::optional<nefarius::utilities::Guid> ClassGuid; ///< DEVPKEY_Device_ClassGuid
+
+		bool Present = true; ///< False for a phantom devnode
+		bool Started = true; ///< DN_STARTED
+		uint32_t ProblemCode = 0; ///< CM_PROB_* code, 0 if the devnode has no problem
+
+		///< Time every operation on the devnode takes
+		std::chrono::milliseconds OperationLatency{0};
+		///< Time after a restart, port cycle or re-enumeration until the devnode reports started
+		std::chrono::milliseconds StartLatency{0};
+		///< If set, removing the devnode or a sub-tree containing it is vetoed with this
+		std::optional<DeviceRemovalVeto> RemovalVeto;
+		///< The driver ignores DIF_PROPERTYCHANGE (e.g. keeps a handle open); restart succeeds
+		///< without effect
+		bool IgnoresPropertyChange = false;
+		///< restart reports a required reboot instead of restarting the devnode
+		bool RequiresReboot = false;
+		///< ProblemCode stays set across restarts (e.g. a driver that fails to start)
+		bool ProblemSurvivesRestart = false;
+
+		uint32_t RestartError = 0; ///< If non-zero, restart fails with this Win32 error
+		uint32_t RemoveError = 0; ///< If non-zero, remove_subtree fails with this Win32 error
+		uint32_t ReenumerateError = 0; ///< If non-zero, reenumerate fails with this Win32 error
+		uint32_t CyclePortError = 0; ///< If non-zero, cycle_port on this hub fails with this Win32 error
+	};
+
+	/**
+	 * Number of operations a DeviceTreeSimulator has carried out.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DeviceTreeSimulatorStats
+	{
+		uint64_t PropertyReads = 0;
+		uint64_t StatusQueries = 0;
+		uint64_t Restarts = 0;
+		uint64_t Removals = 0;
+		uint64_t Vetoes = 0;
+		uint64_t Reenumerations = 0;
+		uint64_t PortCycles = 0;
+	};
+
+	/**
+	 * An in-memory device tree. Devnodes hang below a root devnode "HTREE\ROOT\0"; removing a
+	 * sub-tree detaches it until its parent is re-enumerated, cycling a hub port restarts the
+	 * sub-tree of the child whose Address is that port. Thread-safe; operations sleep their
+	 * OperationLatency without holding the lock.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DeviceTreeSimulator final : public DeviceTreeBackend
+	{
+	public:
+		DeviceTreeSimulator();
+
+		DeviceTreeSimulator(const DeviceTreeSimulator&) = delete;
+		DeviceTreeSimulator& operator=(const DeviceTreeSimulator&) = delete;
+
+		///< Adds a devnode; fails with ERROR_ALREADY_EXISTS for a duplicate instance ID and with
+		///< ERROR_NOT_FOUND if the parent doesn't exist
+		std::expected<DeviceNode, std::error_code> add(SimulatedDevice Device);
+
+		///< Changes a devnode, e.g. to inject a failure while operations are running; properties
+		///< that define the topology (InstanceId, ParentInstanceId) must be left alone
+		std::expected<void, std::error_code> update(std::wstring_view InstanceId,
+		                                            const std::function<void(SimulatedDevice& Device)>& Change);
+
+		///< Copy of a devnode's current state
+		[[nodiscard]] std::optional<SimulatedDevice> find(std::wstring_view InstanceId) const;
+
+		///< Number of devnodes, including the root
+		[[nodiscard]] size_t size() const;
+
+		[[nodiscard]] DeviceTreeSimulatorStats stats() const;
+
+		std::expected<DeviceNode, std::error_code> locate(std::wstring_view InstanceId, bool Phantom = false) override;
+		std::expected<std::vector<DeviceNode>, std::error_code> enumerate(
+			bool PresentOnly = true, const nefarius::utilities::Guid* ClassGuid = nullptr) override;
+		std::expected<std::wstring, std::error_code> instance_id(DeviceNode Node) override;
+		std::expected<DeviceNode, std::error_code> parent(DeviceNode Node) override;
+		std::expected<DeviceNodeStatus, std::error_code> status(DeviceNode Node) override;
+		std::expected<std::wstring, std::error_code> property_string(DeviceNode Node,
+		                                                            DeviceProperty Property) override;
+		std::expected<std::vector<std::wstring>, std::error_code> property_strings(
+			DeviceNode Node, DeviceProperty Property) override;
+		std::expected<uint32_t, std::error_code> property_uint32(DeviceNode Node, DeviceProperty Property) override;
+		std::expected<nefarius::utilities::Guid, std::error_code> property_guid(DeviceNode Node,
+		                                                                        DeviceProperty Property) override;
+		std::expected<void, std::error_code> append_property(DeviceNode Node, DeviceProperty Property,
+		                                                     std::wstring& Buffer) override;
+		std::expected<bool, std::error_code> restart(DeviceNode Node) override;
+		std::expected<void, std::error_code> remove_subtree(DeviceNode Node, DeviceRemovalVeto& Veto) override;
+		std::expected<void, std::error_code> reenumerate(DeviceNode Node) override;
+		std::expected<void, std::error_code> cycle_port(DeviceNode Hub, uint32_t Port) override;
+		std::optional<uint64_t> compatible_driver_version(DeviceNode Node) override;
+
+	private:
+		struct NodeState
+		{
+			SimulatedDevice Device;
+			DeviceNode Parent;
+			std::vector<DeviceNode> Children;
+			bool Removed = false; ///< Detached by remove_subtree until the parent is re-enumerated
+			std::chrono::steady_clock::time_point OnlineAt; ///< Reports started from then on
+		};
+
+		struct Counters
+		{
+			std::atomic<uint64_t> PropertyReads{0};
+			std::atomic<uint64_t> StatusQueries{0};
+			std::atomic<uint64_t> Restarts{0};
+			std::atomic<uint64_t> Removals{0};
+			std::atomic<uint64_t> Vetoes{0};
+			std::atomic<uint64_t> Reenumerations{0};
+			std::atomic<uint64_t> PortCycles{0};
+		};
+
+		[[nodiscard]] std::chrono::milliseconds latency(DeviceNode Node) const;
+		void start_subtree(DeviceNode Node, std::chrono::steady_clock::time_point Now);
+
+		mutable std::shared_mutex lock_;
+		std::vector<NodeState> nodes_;
+		std::unordered_map<std::wstring, DeviceNode> ids_;
+		Counters counters_;
+	};
+
+	/**
+	 * Like ListDeviceInstancesByService, on any device tree.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Tree	   	The device tree.
+	 * @param 	ServiceName	Name of the driver service, compared case-insensitively.
+	 * @param 	PresentOnly	(Optional) True to only return devices currently present.
+	 *
+	 * @returns	The instance IDs, or the error of enumerating the tree.
+	 */
+	std::expected<std::vector<std::wstring>, std::error_code> ListDeviceInstancesByService(
+		DeviceTreeBackend& Tree, std::wstring_view ServiceName, bool PresentOnly = true);
+
+	///< Like CycleUsbPortOfDevice, on any device tree
+	std::expected<void, std::error_code> CycleUsbPortOfDevice(DeviceTreeBackend& Tree, const std::wstring& InstanceId);
+
+	///< Like DetachDeviceInstance, on any device tree; Tree must outlive an attempt that timed out
+	DetachResult DetachDeviceInstance(DeviceTreeBackend& Tree, const std::wstring& InstanceId,
+	                                  std::chrono::milliseconds Timeout = std::chrono::seconds(10));
+
+	///< Like ReenumerateParentDevNode, on any device tree; Tree must outlive an attempt that
+	///< timed out
+	ReenumerateResult ReenumerateParentDevNode(DeviceTreeBackend& Tree, const std::wstring& ParentInstanceId,
+	                                           std::chrono::milliseconds Timeout = std::chrono::seconds(10));
+
+	///< Like RestartDeviceInstance, on any device tree; Tree must outlive an attempt that timed out
+	DeviceRestartResult RestartDeviceInstance(DeviceTreeBackend& Tree, const std::wstring& InstanceId,
+	                                          const DeviceRestartOptions& Options = {});
+
+	/**
+	 * Like FindByHwId, on any device tree: finds the present devices with a hardware ID
+	 * containing Matchstring (case-sensitive).
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Tree	   	The device tree.
+	 * @param 	Matchstring	The partial string to search for.
+	 *
+	 * @returns	The found devices, or the error of enumerating the tree.
+	 */
+	std::expected<std::vector<FindByHwIdResult<std::wstring>>, std::error_code> FindByHwId(
+		DeviceTreeBackend& Tree, std::wstring_view Matchstring);
+
+	///< Like FindByHwId above, taking the driver version from the best match of Drivers
+	std::expected<std::vector<FindByHwIdResult<std::wstring>>, std::error_code> FindByHwId(
+		DeviceTreeBackend& Tree, std::wstring_view Matchstring, const inf::DriverMatchIndex& Drivers);
+}
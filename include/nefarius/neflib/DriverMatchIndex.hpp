@@ -0,0 +1,139 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/InfMetadataCache.hpp>
+
+//
+// Answers "which driver would bind to this device" without SetupDiBuildDriverInfoList: the
+// models of a set of INFs (see InfAnalysis::Models, resolved for the platform and OS version of
+// InfPlatformTarget) are indexed by hardware and compatible ID, and candidates are ranked the
+// way Windows ranks them by ID match, then DriverVer date and version. Driver signatures aren't
+// taken into account. Portable like InfFile.
+//
+namespace nefarius::devcon::inf
+{
+	/**
+	 * A device model of an indexed INF that matches a device.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverMatch
+	{
+		const std::filesystem::path* InfPath = nullptr; ///< The INF the model is listed in
+		const InfAnalysis* Inf = nullptr; ///< Analysis of that INF
+		const InfModel* Model = nullptr; ///< The matching model
+		///< ID match rank, lower is better: 0x0000 device hardware ID = model hardware ID,
+		///< 0x1000 device hardware ID = model compatible ID, 0x2000 device compatible ID = model
+		///< hardware ID, 0x3000 device compatible ID = model compatible ID, plus the position of the
+		///< device ID (bits 8-11) and of the model ID (bits 0-7) in their lists
+		uint32_t Rank = 0;
+		uint32_t DriverDate = 0; ///< DriverVer date as yyyymmdd; 0 if missing or malformed
+		uint64_t DriverVersion = 0; ///< DriverVer version packed like SP_DRVINFO_DATA::DriverVersion
+	};
+
+	/**
+	 * Index of device models by hardware and compatible ID. Movable; DriverMatch pointers stay
+	 * valid until the index is destroyed. Concurrent matches are safe, add() is not.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DriverMatchIndex
+	{
+	public:
+		/**
+		 * Analyzes INF files in parallel and indexes their models; files that can't be read are
+		 * skipped.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	InfPaths	The INF files.
+		 * @param 	Options 	(Optional) Batch options; Target selects the models sections.
+		 *
+		 * @returns	The index.
+		 */
+		static DriverMatchIndex Build(std::span<const std::filesystem::path> InfPaths,
+		                              const InfBatchOptions& Options = {});
+
+		///< Like Build above, reading the INFs through a metadata cache (on one thread)
+		static DriverMatchIndex Build(std::span<const std::filesystem::path> InfPaths, InfMetadataCache& Cache);
+
+		/**
+		 * Indexes every INF in a directory, e.g. %WINDIR%\INF to see the same candidates
+		 * SetupDiBuildDriverInfoList(SPDIT_COMPATDRIVER) considers.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Directory	The directory.
+		 * @param 	Options  	(Optional) Batch options; Target selects the models sections.
+		 *
+		 * @returns	The index, or the error of opening the directory.
+		 */
+		static std::expected<DriverMatchIndex, std::error_code> BuildFromDirectory(
+			const std::filesystem::path& Directory, const InfBatchOptions& Options = {});
+
+		///< Indexes the models of an analyzed INF
+		void add(std::filesystem::path InfPath, InfAnalysis Analysis);
+
+		/**
+		 * Finds every model matching any of the IDs of a device.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	HardwareIds  	Hardware IDs of the device, most specific first.
+		 * @param 	CompatibleIds	(Optional) Compatible IDs of the device, most specific first.
+		 *
+		 * @returns	One match per matching model, best first: by rank, then newest DriverVer date,
+		 * 			then highest DriverVer version.
+		 */
+		[[nodiscard]] std::vector<DriverMatch> match(std::span<const std::u16string_view> HardwareIds,
+		                                             std::span<const std::u16string_view> CompatibleIds = {}) const;
+
+		///< The driver that would bind, i.e. the first result of match; std::nullopt if none matches
+		[[nodiscard]] std::optional<DriverMatch> best(std::span<const std::u16string_view> HardwareIds,
+		                                              std::span<const std::u16string_view> CompatibleIds = {}) const;
+
+		///< Number of indexed INFs
+		[[nodiscard]] size_t size() const
+		{
+			return infs_.size();
+		}
+
+	private:
+		struct IndexedInf
+		{
+			std::filesystem::path Path;
+			InfAnalysis Analysis;
+			uint32_t DriverDate;
+			uint64_t DriverVersion;
+		};
+
+		struct Posting
+		{
+			uint32_t Inf;
+			uint32_t Model;
+			uint32_t IdIndex;
+		};
+
+		// deque, so DriverMatch pointers survive further add() calls
+		std::deque<IndexedInf> infs_;
+		std::unordered_map<std::u16string, std::vector<Posting>> postings_;
+	};
+}
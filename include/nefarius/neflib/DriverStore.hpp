@@ -0,0 +1,326 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/InfMetadataCache.hpp>
+
+//
+// The driver store behind an interface: SystemDriverStore binds the undocumented drvstore.dll
+// offline API (Windows only), DriverStoreEmulator keeps packages in a FileRepository-style
+// directory tree, so enumeration, matching and deletion can be exercised and measured on any
+// platform without touching a real system. DriverStoreIndex works on either.
+//
+namespace nefarius::devcon
+{
+	/**
+	 * A single driver package published into a driver store.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.08.2026
+	 */
+	struct DriverStorePackage
+	{
+		/// Absolute path of this package's INF copy inside the driver store
+		std::wstring DriverPackageInfPath;
+		/// Published name in %WINDIR%\INF, e.g. "oem12.inf"
+		std::wstring PublishedInfName;
+		/// True for driver packages that ship inbox with Windows itself
+		bool IsInbox = false;
+		/// Processor architecture the package was published for
+		unsigned short ProcessorArchitecture = 0;
+		/// Locale the package was published for
+		std::wstring LocaleName;
+	};
+
+	/**
+	 * A driver store package as reported during enumeration. The views point into buffers of the
+	 * backend and are only valid for the duration of the callback.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStorePackageView
+	{
+		std::wstring_view DriverPackageInfPath; ///< Absolute path of the package's INF copy
+		std::wstring_view PublishedInfName; ///< Published name in %WINDIR%\INF, e.g. "oem12.inf"
+		bool IsInbox = false; ///< True for packages that ship inbox with Windows
+		unsigned short ProcessorArchitecture = 0; ///< Processor architecture the package was published for
+		std::wstring_view LocaleName; ///< Locale the package was published for
+
+		///< Copies the package out of the enumeration buffers
+		[[nodiscard]] DriverStorePackage materialize() const
+		{
+			return DriverStorePackage{
+				std::wstring(DriverPackageInfPath),
+				std::wstring(PublishedInfName),
+				IsInbox,
+				ProcessorArchitecture,
+				std::wstring(LocaleName)
+			};
+		}
+	};
+
+	/**
+	 * Criteria a package has to meet to be passed to a DriverStorePackageCallback; unset members
+	 * match every package. Evaluated before the callback, on the enumeration buffers.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStorePackageFilter
+	{
+		std::optional<std::wstring_view> PublishedInfName; ///< Published name, compared case-insensitively
+		std::optional<unsigned short> ProcessorArchitecture; ///< A PROCESSOR_ARCHITECTURE_* value
+		std::optional<std::wstring_view> LocaleName; ///< Locale name, compared case-insensitively
+		std::optional<bool> IsInbox; ///< Only inbox or only non-inbox packages
+
+		///< True if the package meets every set criterion
+		[[nodiscard]] bool matches(const DriverStorePackageView& Package) const;
+	};
+
+	///< Receives each matching package; return false to end the enumeration
+	using DriverStorePackageCallback = std::function<bool(const DriverStorePackageView& Package)>;
+
+	/**
+	 * A driver store the enumeration, matching and removal functions can operate on.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DriverStoreBackend
+	{
+	public:
+		virtual ~DriverStoreBackend() = default;
+
+		/**
+		 * Reports the published packages without copying anything. Exceptions thrown by the
+		 * callback end the enumeration and are rethrown to the caller.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Callback	Invoked for every package that passes the filter.
+		 * @param 	Filter  	(Optional) Criteria packages have to meet.
+		 *
+		 * @returns	Nothing, or the error of the enumeration.
+		 */
+		virtual std::expected<void, std::error_code> enumerate(const DriverStorePackageCallback& Callback,
+		                                                       const DriverStorePackageFilter& Filter = {}) = 0;
+
+		/**
+		 * Deletes a package from the store, leaving device nodes that use it alone.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Package	The package, as reported by enumerate.
+		 *
+		 * @returns	Nothing, or the error of deleting the package.
+		 */
+		virtual std::expected<void, std::error_code> remove(const DriverStorePackage& Package) = 0;
+	};
+
+#if defined(_WIN32)
+	/**
+	 * The driver store of the running system, via the undocumented drvstore.dll offline API.
+	 * Fails with ERROR_INVALID_FUNCTION (system category) if drvstore.dll or the export needed
+	 * isn't available; remove falls back to SetupUninstallOEMInfW.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class SystemDriverStore final : public DriverStoreBackend
+	{
+	public:
+		std::expected<void, std::error_code> enumerate(const DriverStorePackageCallback& Callback,
+		                                               const DriverStorePackageFilter& Filter = {}) override;
+
+		std::expected<void, std::error_code> remove(const DriverStorePackage& Package) override;
+	};
+#endif
+
+	/**
+	 * Options of DriverStoreEmulator::publish.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStorePublishOptions
+	{
+		///< A PROCESSOR_ARCHITECTURE_* value; defaults to PROCESSOR_ARCHITECTURE_AMD64
+		unsigned short ProcessorArchitecture = 9;
+		///< Locale the package is published for
+		std::wstring LocaleName;
+		///< Publish under the INF's own name instead of the next free oemNN.inf
+		bool IsInbox = false;
+	};
+
+	/**
+	 * A driver store kept in a directory tree laid out like %WINDIR%: package INFs live in
+	 * FileRepository\<name>.inf_<arch>_<hash>, published copies in INF\oemNN.inf (the lowest free
+	 * number, like the real store picks) and the package list in drvstore.idx. Only the INF of a
+	 * package is copied, not the files it references. Not synchronized, and callbacks of enumerate
+	 * must not publish or remove packages.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DriverStoreEmulator final : public DriverStoreBackend
+	{
+	public:
+		/**
+		 * Opens an emulated store, creating an empty one if the directory doesn't hold any yet.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Root	Root directory of the store.
+		 *
+		 * @returns	The store, or the error of creating the directories or reading the package list.
+		 */
+		static std::expected<DriverStoreEmulator, std::error_code> Open(const std::filesystem::path& Root);
+
+		/**
+		 * Publishes a driver package. An INF with the same name, content and architecture as a
+		 * package already in the store yields that package, like re-adding it to a real store does.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	InfPath	Path of the INF to publish.
+		 * @param 	Options	(Optional) Publish options.
+		 *
+		 * @returns	The published package, or the error of reading or copying the INF.
+		 */
+		std::expected<DriverStorePackage, std::error_code> publish(const std::filesystem::path& InfPath,
+		                                                           const DriverStorePublishOptions& Options = {});
+
+		std::expected<void, std::error_code> enumerate(const DriverStorePackageCallback& Callback,
+		                                               const DriverStorePackageFilter& Filter = {}) override;
+
+		///< Deletes the package's FileRepository directory and published INF; fails with
+		///< no_such_file_or_directory if the package isn't in the store
+		std::expected<void, std::error_code> remove(const DriverStorePackage& Package) override;
+
+		///< Writes the package list if it changed since the store was opened or last saved
+		std::expected<void, std::error_code> save();
+
+		///< Number of published packages
+		[[nodiscard]] size_t size() const
+		{
+			return packages_.size();
+		}
+
+		[[nodiscard]] const std::filesystem::path& root() const
+		{
+			return root_;
+		}
+
+	private:
+		explicit DriverStoreEmulator(std::filesystem::path Root) : root_(std::move(Root))
+		{
+		}
+
+		void add(DriverStorePackage Package);
+
+		std::filesystem::path root_;
+		std::vector<DriverStorePackage> packages_;
+		std::unordered_map<std::wstring, size_t> positions_;
+		std::set<unsigned> free_oem_numbers_;
+		unsigned next_oem_number_ = 0;
+		bool dirty_ = false;
+	};
+
+	/**
+	 * Options of DriverStoreIndex::Build and RemoveDriverStorePackages.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStoreIndexOptions
+	{
+		///< Threads reading the package INFs; 0 picks the number of hardware threads
+		unsigned Threads = 0;
+		///< If set, package and original INFs are read through this cache instead (on one thread)
+		inf::InfMetadataCache* Cache = nullptr;
+	};
+
+	/**
+	 * Snapshot of the non-inbox driver store packages, indexed by identity: the case-folded
+	 * Provider, DriverVer date and version, INF file name and device class. Built with a single
+	 * enumeration, so matching any number of original INFs against the store costs one parse
+	 * of each package INF in total rather than one per match.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DriverStoreIndex
+	{
+	public:
+		/**
+		 * Enumerates a driver store and reads the identity of every package.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Store  	The store to index.
+		 * @param 	Options	(Optional) Index options.
+		 *
+		 * @returns	The index, or the error of the enumeration.
+		 */
+		static std::expected<DriverStoreIndex, std::error_code> Build(DriverStoreBackend& Store,
+		                                                              const DriverStoreIndexOptions& Options = {});
+
+#if defined(_WIN32)
+		///< Indexes the SystemDriverStore
+		static std::expected<DriverStoreIndex, std::error_code> Build(const DriverStoreIndexOptions& Options = {});
+#endif
+
+		///< Packages with the identity of the given analysis of an INF named InfName
+		[[nodiscard]] std::vector<const DriverStorePackage*> find(const inf::InfAnalysis& Identity,
+		                                                          std::u16string_view InfName) const;
+
+		/**
+		 * Finds the store packages published from an original INF file.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	OriginalInfPath	Full pathname of the original INF file.
+		 * @param 	Cache		   	(Optional) Cache to read the original INF through.
+		 *
+		 * @returns	The matching packages (possibly none), or the error of reading the INF.
+		 */
+		[[nodiscard]] std::expected<std::vector<const DriverStorePackage*>, std::error_code>
+		match(const std::filesystem::path& OriginalInfPath, inf::InfMetadataCache* Cache = nullptr) const;
+
+		///< Excludes a package from further matches, e.g. after it was deleted
+		void remove(const DriverStorePackage& Package);
+
+		///< Every package of the snapshot, including removed ones
+		[[nodiscard]] const std::vector<DriverStorePackage>& packages() const
+		{
+			return packages_;
+		}
+
+	private:
+		DriverStoreIndex() = default;
+
+		void insert(const inf::InfAnalysis& Identity, size_t Package);
+
+		std::vector<DriverStorePackage> packages_;
+		std::vector<bool> removed_;
+		std::unordered_multimap<std::u16string, size_t> identities_;
+	};
+}
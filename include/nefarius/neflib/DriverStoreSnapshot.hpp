@@ -0,0 +1,146 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <nefarius/neflib/DriverStore.hpp>
+
+//
+// Compact, persistable snapshots of driver store state, so a poller can detect published,
+// removed and re-published packages by merging two sorted snapshots instead of comparing full
+// package vectors. Strings are interned into one buffer and packages are kept sorted by their
+// case-folded published name. Portable like DriverStore.
+//
+namespace nefarius::devcon
+{
+	namespace detail
+	{
+		struct DriverStoreSnapshotData;
+	}
+
+	/**
+	 * Immutable snapshot of the packages of a driver store, sorted by published name (compared
+	 * case-insensitively). Movable; views obtained from it stay valid until it is destroyed.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class DriverStoreSnapshot
+	{
+	public:
+		///< An empty snapshot, e.g. the baseline of a first run
+		DriverStoreSnapshot();
+		DriverStoreSnapshot(DriverStoreSnapshot&& Other) noexcept;
+		DriverStoreSnapshot& operator=(DriverStoreSnapshot&& Other) noexcept;
+		~DriverStoreSnapshot();
+
+		DriverStoreSnapshot(const DriverStoreSnapshot&) = delete;
+		DriverStoreSnapshot& operator=(const DriverStoreSnapshot&) = delete;
+
+		/**
+		 * Enumerates a driver store into a snapshot. Of packages sharing a published name, only
+		 * the first one reported is kept.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Store 	The store to capture.
+		 * @param 	Filter	(Optional) Criteria packages have to meet to be captured.
+		 *
+		 * @returns	The snapshot, or the error of the enumeration.
+		 */
+		static std::expected<DriverStoreSnapshot, std::error_code> Capture(
+			DriverStoreBackend& Store, const DriverStorePackageFilter& Filter = {});
+
+		///< Snapshot of packages enumerated earlier, e.g. by EnumerateDriverStorePackages
+		static DriverStoreSnapshot FromPackages(std::span<const DriverStorePackage> Packages);
+
+		/**
+		 * Reads a snapshot written by save(). Snapshots can only be exchanged between platforms
+		 * with the same wchar_t width.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	File	Path of the snapshot file.
+		 *
+		 * @returns	The snapshot, the error of reading the file, or std::errc::bad_message if it's
+		 * 			corrupt or was written by an incompatible platform or version.
+		 */
+		static std::expected<DriverStoreSnapshot, std::error_code> Load(const std::filesystem::path& File);
+
+		///< Writes the snapshot, replacing File atomically
+		std::expected<void, std::error_code> save(const std::filesystem::path& File) const;
+
+		[[nodiscard]] size_t size() const;
+
+		[[nodiscard]] bool empty() const
+		{
+			return size() == 0;
+		}
+
+		///< The package at the given position of the sorted order
+		[[nodiscard]] DriverStorePackageView operator[](size_t Index) const;
+
+		///< Looks up a package by its published name (case-insensitive) by binary search
+		[[nodiscard]] std::optional<DriverStorePackageView> find(std::wstring_view PublishedInfName) const;
+
+	private:
+		explicit DriverStoreSnapshot(std::unique_ptr<detail::DriverStoreSnapshotData> Data);
+
+		std::unique_ptr<detail::DriverStoreSnapshotData> data_;
+	};
+
+	/**
+	 * A package published under the same name in both snapshots, with different properties
+	 * (typically re-published from an updated INF, so its FileRepository path changed).
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStorePackageChange
+	{
+		DriverStorePackage Old; ///< The package in the older snapshot
+		DriverStorePackage New; ///< The package in the newer snapshot
+	};
+
+	/**
+	 * Difference between two driver store snapshots; every list is sorted by published name.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct DriverStoreDiff
+	{
+		std::vector<DriverStorePackage> Added; ///< Published names only the newer snapshot has
+		std::vector<DriverStorePackage> Removed; ///< Published names only the older snapshot has
+		std::vector<DriverStorePackageChange> Changed; ///< Published names whose package differs
+
+		[[nodiscard]] bool empty() const
+		{
+			return Added.empty() && Removed.empty() && Changed.empty();
+		}
+	};
+
+	/**
+	 * Compares two snapshots in a single merge pass over both, i.e. in linear time. Only the
+	 * differing packages are copied out.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Old	The older snapshot.
+	 * @param 	New	The newer snapshot.
+	 *
+	 * @returns	The packages added, removed and changed from Old to New.
+	 */
+	DriverStoreDiff DiffDriverStore(const DriverStoreSnapshot& Old, const DriverStoreSnapshot& New);
+}
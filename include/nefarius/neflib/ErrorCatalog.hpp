@@ -0,0 +1,40 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+//
+// Built-in catalog of the Win32 error codes this library commonly surfaces: generic I/O
+// errors, SetupAPI (0xE000xxxx) codes, the codes CM_MapCrToWin32Err maps CONFIGRET values to,
+// and service control manager errors. FormatMessage knows no text for the SetupAPI range at all,
+// and the catalog is free of Windows dependencies so messages are also available on other
+// platforms (e.g. when replaying recorded failures).
+//
+namespace nefarius::utilities::errors
+{
+	/**
+	 * Looks up the catalog message of an error code.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Code	The Win32 error code.
+	 *
+	 * @returns	The English message text (without trailing line break), or an empty view if the
+	 * 			code isn't in the catalog.
+	 */
+	std::string_view FallbackMessage(uint32_t Code);
+
+	/**
+	 * Looks up the symbolic name of an error code, e.g. "ERROR_NO_SUCH_DEVINST".
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Code	The Win32 error code.
+	 *
+	 * @returns	The symbol, or an empty view if the code isn't in the catalog.
+	 */
+	std::string_view FallbackSymbol(uint32_t Code);
+}
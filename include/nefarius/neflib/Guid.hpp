@@ -0,0 +1,384 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <guiddef.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NEFLIB_GUID_SSE2
+#endif
+
+//
+// Allocation-free GUID parsing and formatting that works in constant expressions and doesn't
+// depend on any Windows API (so it is usable and testable on every platform). Accepted forms are
+// "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" and the same enclosed in curly braces; hex digits may
+// be of either case, anything else (whitespace, missing or extra characters, mismatched braces)
+// is rejected. At runtime the hex decoding is done with SSE2 where available.
+//
+namespace nefarius::utilities
+{
+	/**
+	 * Portable GUID with the same layout as the Windows GUID struct, convertible to and from it.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct Guid
+	{
+		uint32_t Data1 = 0;
+		uint16_t Data2 = 0;
+		uint16_t Data3 = 0;
+		std::array<uint8_t, 8> Data4{};
+
+		constexpr bool operator==(const Guid&) const = default;
+
+#if defined(_WIN32)
+		constexpr Guid() = default;
+
+		constexpr Guid(uint32_t D1, uint16_t D2, uint16_t D3, const std::array<uint8_t, 8>& D4)
+			: Data1(D1), Data2(D2), Data3(D3), Data4(D4)
+		{
+		}
+
+		constexpr Guid(const GUID& Native)
+			: Data1(Native.Data1), Data2(Native.Data2), Data3(Native.Data3),
+			  Data4{
+				  Native.Data4[0], Native.Data4[1], Native.Data4[2], Native.Data4[3],
+				  Native.Data4[4], Native.Data4[5], Native.Data4[6], Native.Data4[7]
+			  }
+		{
+		}
+
+		constexpr operator GUID() const
+		{
+			return GUID{
+				Data1, Data2, Data3,
+				{Data4[0], Data4[1], Data4[2], Data4[3], Data4[4], Data4[5], Data4[6], Data4[7]}
+			};
+		}
+#endif
+	};
+
+	///< Length of the unbraced string form, e.g. "4d36e96a-e325-11ce-bfc1-08002be10318"
+	inline constexpr size_t GuidStringLength = 36;
+
+	///< Length of the braced string form, e.g. "{4d36e96a-e325-11ce-bfc1-08002be10318}"
+	inline constexpr size_t BracedGuidStringLength = 38;
+
+	namespace detail
+	{
+		// Offsets of the 32 hex digits within the unbraced form, in textual (big endian) order
+		inline constexpr std::array<uint8_t, 32> GuidDigitOffsets{
+			0, 1, 2, 3, 4, 5, 6, 7,
+			9, 10, 11, 12,
+			14, 15, 16, 17,
+			19, 20, 21, 22,
+			24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35
+		};
+
+		inline constexpr std::array<uint8_t, 4> GuidHyphenOffsets{8, 13, 18, 23};
+
+		// Returns the nibble value, or 0xFF for anything that isn't a hex digit
+		template <typename CharT>
+		constexpr uint8_t HexNibble(CharT Char)
+		{
+			const auto c = static_cast<uint32_t>(Char);
+
+			if (c >= '0' && c <= '9')
+			{
+				return static_cast<uint8_t>(c - '0');
+			}
+
+			if (c >= 'a' && c <= 'f')
+			{
+				return static_cast<uint8_t>(c - 'a' + 10);
+			}
+
+			if (c >= 'A' && c <= 'F')
+			{
+				return static_cast<uint8_t>(c - 'A' + 10);
+			}
+
+			return 0xFF;
+		}
+
+		// Strips the braces and checks the overall shape; returns the 36 characters of the core form
+		template <typename CharT>
+		constexpr std::optional<std::basic_string_view<CharT>> GuidCore(std::basic_string_view<CharT> Text)
+		{
+			if (Text.size() == BracedGuidStringLength)
+			{
+				if (Text.front() != CharT('{') || Text.back() != CharT('}'))
+				{
+					return std::nullopt;
+				}
+
+				Text = Text.substr(1, GuidStringLength);
+			}
+			else if (Text.size() != GuidStringLength)
+			{
+				return std::nullopt;
+			}
+
+			for (const auto offset : GuidHyphenOffsets)
+			{
+				if (Text[offset] != CharT('-'))
+				{
+					return std::nullopt;
+				}
+			}
+
+			return Text;
+		}
+
+		constexpr Guid GuidFromBytes(const std::array<uint8_t, 16>& Bytes)
+		{
+			Guid guid;
+			guid.Data1 = static_cast<uint32_t>(Bytes[0]) << 24 | static_cast<uint32_t>(Bytes[1]) << 16
+				| static_cast<uint32_t>(Bytes[2]) << 8 | Bytes[3];
+			guid.Data2 = static_cast<uint16_t>(Bytes[4] << 8 | Bytes[5]);
+			guid.Data3 = static_cast<uint16_t>(Bytes[6] << 8 | Bytes[7]);
+
+			for (size_t i = 0; i < guid.Data4.size(); ++i)
+			{
+				guid.Data4[i] = Bytes[8 + i];
+			}
+
+			return guid;
+		}
+
+		template <typename CharT>
+		constexpr std::optional<Guid> ParseGuidScalar(std::basic_string_view<CharT> Core)
+		{
+			std::array<uint8_t, 16> bytes{};
+
+			for (size_t i = 0; i < bytes.size(); ++i)
+			{
+				const uint8_t high = HexNibble(Core[GuidDigitOffsets[i * 2]]);
+				const uint8_t low = HexNibble(Core[GuidDigitOffsets[i * 2 + 1]]);
+
+				if ((high | low) & 0xF0)
+				{
+					return std::nullopt;
+				}
+
+				bytes[i] = static_cast<uint8_t>(high << 4 | low);
+			}
+
+			return GuidFromBytes(bytes);
+		}
+
+#if defined(NEFLIB_GUID_SSE2)
+		// Decodes 16 ASCII hex digits into 16 nibbles; false if any of them isn't a hex digit
+		inline bool HexNibblesSse2(__m128i Chars, __m128i& Nibbles)
+		{
+			// bytes >= 0x80 are negative as signed and fall outside both ranges
+			const __m128i lower = _mm_or_si128(Chars, _mm_set1_epi8(0x20));
+			const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(Chars, _mm_set1_epi8('0' - 1)),
+			                                      _mm_cmplt_epi8(Chars, _mm_set1_epi8('9' + 1)));
+			const __m128i isAlpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+			                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+
+			if (_mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha)) != 0xFFFF)
+			{
+				return false;
+			}
+
+			Nibbles = _mm_or_si128(
+				_mm_and_si128(isDigit, _mm_sub_epi8(Chars, _mm_set1_epi8('0'))),
+				_mm_and_si128(isAlpha, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+
+			return true;
+		}
+
+		// Combines nibble pairs (high nibble first) of two nibble vectors into 16 bytes
+		inline __m128i PackNibblesSse2(__m128i First, __m128i Second)
+		{
+			const __m128i mask = _mm_set1_epi16(0x00FF);
+			const __m128i first = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(First, mask), 4), _mm_srli_epi16(First, 8));
+			const __m128i second = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(Second, mask), 4), _mm_srli_epi16(Second, 8));
+
+			return _mm_packus_epi16(first, second);
+		}
+
+		template <typename CharT>
+		std::optional<Guid> ParseGuidSse2(std::basic_string_view<CharT> Core)
+		{
+			// gather the digits without the hyphens; wide characters outside of ASCII are mapped
+			// to a byte that can't pass as a hex digit
+			alignas(16) uint8_t digits[32];
+
+			for (size_t i = 0; i < 32; ++i)
+			{
+				const auto c = static_cast<uint32_t>(Core[GuidDigitOffsets[i]]);
+				digits[i] = static_cast<uint8_t>(c < 0x80 ? c : 0xFF);
+			}
+
+			__m128i first, second;
+
+			if (!HexNibblesSse2(_mm_load_si128(reinterpret_cast<const __m128i*>(digits)), first)
+				|| !HexNibblesSse2(_mm_load_si128(reinterpret_cast<const __m128i*>(digits + 16)), second))
+			{
+				return std::nullopt;
+			}
+
+			std::array<uint8_t, 16> bytes;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(bytes.data()), PackNibblesSse2(first, second));
+
+			return GuidFromBytes(bytes);
+		}
+#endif
+	}
+
+	/**
+	 * Parses a GUID in braced or unbraced form.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @tparam	CharT	Character type; char, wchar_t, char8_t, char16_t and char32_t are supported.
+	 * @param 	Text	The text to parse; must contain nothing but the GUID.
+	 *
+	 * @returns	The GUID, or std::nullopt if Text isn't a well-formed GUID string.
+	 */
+	template <typename CharT>
+	constexpr std::optional<Guid> ParseGuid(std::basic_string_view<CharT> Text)
+	{
+		const auto core = detail::GuidCore(Text);
+
+		if (!core)
+		{
+			return std::nullopt;
+		}
+
+#if defined(NEFLIB_GUID_SSE2)
+		if !consteval
+		{
+			return detail::ParseGuidSse2(*core);
+		}
+#endif
+
+		return detail::ParseGuidScalar(*core);
+	}
+
+	constexpr std::optional<Guid> ParseGuid(std::string_view Text)
+	{
+		return ParseGuid<char>(Text);
+	}
+
+	constexpr std::optional<Guid> ParseGuid(std::wstring_view Text)
+	{
+		return ParseGuid<wchar_t>(Text);
+	}
+
+	/**
+	 * Formats a GUID in lower case hex digits into a caller-provided buffer, without terminator.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @tparam	CharT	Character type of the output.
+	 * @param 	Value 	The GUID to format.
+	 * @param 	Out   	Output buffer; must fit BracedGuidStringLength or GuidStringLength characters.
+	 * @param 	Braced	True to enclose the GUID in curly braces.
+	 *
+	 * @returns	Pointer past the last character written.
+	 */
+	template <typename CharT>
+	constexpr CharT* FormatGuid(const Guid& Value, CharT* Out, bool Braced = true)
+	{
+		constexpr char hex[] = "0123456789abcdef";
+
+		std::array<uint8_t, 16> bytes{
+			static_cast<uint8_t>(Value.Data1 >> 24), static_cast<uint8_t>(Value.Data1 >> 16),
+			static_cast<uint8_t>(Value.Data1 >> 8), static_cast<uint8_t>(Value.Data1),
+			static_cast<uint8_t>(Value.Data2 >> 8), static_cast<uint8_t>(Value.Data2),
+			static_cast<uint8_t>(Value.Data3 >> 8), static_cast<uint8_t>(Value.Data3)
+		};
+
+		for (size_t i = 0; i < Value.Data4.size(); ++i)
+		{
+			bytes[8 + i] = Value.Data4[i];
+		}
+
+		CharT* core = Braced ? Out + 1 : Out;
+
+		for (const auto offset : detail::GuidHyphenOffsets)
+		{
+			core[offset] = CharT('-');
+		}
+
+		for (size_t i = 0; i < bytes.size(); ++i)
+		{
+			core[detail::GuidDigitOffsets[i * 2]] = CharT(hex[bytes[i] >> 4]);
+			core[detail::GuidDigitOffsets[i * 2 + 1]] = CharT(hex[bytes[i] & 0x0F]);
+		}
+
+		if (!Braced)
+		{
+			return Out + GuidStringLength;
+		}
+
+		Out[0] = CharT('{');
+		Out[BracedGuidStringLength - 1] = CharT('}');
+
+		return Out + BracedGuidStringLength;
+	}
+
+	///< Formats a GUID in lower case, braced by default
+	inline std::string GuidToString(const Guid& Value, bool Braced = true)
+	{
+		std::string result(Braced ? BracedGuidStringLength : GuidStringLength, '\0');
+		FormatGuid(Value, result.data(), Braced);
+		return result;
+	}
+
+	///< Formats a GUID in lower case, braced by default
+	inline std::wstring GuidToWString(const Guid& Value, bool Braced = true)
+	{
+		std::wstring result(Braced ? BracedGuidStringLength : GuidStringLength, L'\0');
+		FormatGuid(Value, result.data(), Braced);
+		return result;
+	}
+
+	namespace literals
+	{
+		//
+		// A malformed literal isn't a constant expression, so it fails to compile
+		//
+		consteval Guid operator""_guid(const char* Text, size_t Length)
+		{
+			const auto guid = ParseGuid(std::string_view(Text, Length));
+
+			if (!guid)
+			{
+				throw "malformed GUID literal";
+			}
+
+			return *guid;
+		}
+
+		consteval Guid operator""_guid(const wchar_t* Text, size_t Length)
+		{
+			const auto guid = ParseGuid(std::wstring_view(Text, Length));
+
+			if (!guid)
+			{
+				throw "malformed GUID literal";
+			}
+
+			return *guid;
+		}
+	}
+}
+
+#undef NEFLIB_GUID_SSE2
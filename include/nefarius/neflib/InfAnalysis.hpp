@@ -0,0 +1,211 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <nefarius/neflib/Guid.hpp>
+#include <nefarius/neflib/InfFile.hpp>
+
+//
+// What GetINFClass, GetInfClassFilterTargets and the [Version] identity lookups extract from an
+// INF, computed from an InfFile instead of SetupAPI, plus batch variants that analyze whole
+// directories (e.g. DriverStore\FileRepository) on a thread pool. Portable like InfFile.
+//
+namespace nefarius::devcon::inf
+{
+	/**
+	 * Filter stack position named by an UpperFilters/LowerFilters registry directive.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class InfFilterPosition
+	{
+		Upper,
+		Lower
+	};
+
+	/**
+	 * A device class an INF registers (AddReg) or removes (DelReg) a class filter for.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfFilterTarget
+	{
+		nefarius::utilities::Guid ClassGuid; ///< The affected device class
+		InfFilterPosition Position = InfFilterPosition::Upper; ///< Upper or lower filter
+		std::u16string ServiceName; ///< The filter service; empty if a DelReg removes the whole value
+	};
+
+	/**
+	 * A device model listed in a [Manufacturer] models section.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfModel
+	{
+		std::u16string Description; ///< Device description, strings expanded
+		std::u16string InstallSection; ///< Undecorated DDInstall section name
+		///< The hardware ID (empty if the model is only matched by compatible IDs), followed by any
+		///< compatible IDs
+		std::vector<std::u16string> HardwareIds;
+	};
+
+	/**
+	 * Identity, class filter and device model information of an INF.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfAnalysis
+	{
+		///< [Version] ClassGuid or, if missing or malformed, the GUID of the class named by [Version]
+		///< Class (like SetupDiGetINFClass); std::nullopt if neither resolves
+		std::optional<nefarius::utilities::Guid> ClassGuid;
+		std::u16string ClassName; ///< [Version] Class
+		std::u16string Provider; ///< [Version] Provider, strings expanded
+		std::u16string DriverDate; ///< First field of [Version] DriverVer
+		std::u16string DriverVersion; ///< Second field of [Version] DriverVer
+		///< Class filters referenced from the DefaultInstall/DefaultUninstall sections, de-duplicated
+		std::vector<InfFilterTarget> FilterTargets;
+		///< Models of every models section applicable to the target platform, de-duplicated
+		std::vector<InfModel> Models;
+	};
+
+	/**
+	 * Looks up one of the system-defined device setup classes by name, case-insensitively.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	17.10.2026
+	 *
+	 * @param 	ClassName	The class name, e.g. "HIDClass".
+	 *
+	 * @returns	The class GUID, or std::nullopt for a custom (or unknown) class.
+	 */
+	std::optional<nefarius::utilities::Guid> SystemSetupClassGuid(std::u16string_view ClassName);
+
+	/**
+	 * Analyzes a parsed INF.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	File		 	The INF.
+	 * @param 	Target		 	(Optional) Platform the install sections are resolved for.
+	 * @param 	NamedClassGuid	(Optional) GUID of the custom class named by [Version] Class, e.g.
+	 * 							looked up with SetupDiClassGuidsFromName; used only if the INF has
+	 * 							no valid ClassGuid and doesn't name a system-defined class.
+	 *
+	 * @returns	The analysis.
+	 */
+	InfAnalysis AnalyzeInf(const InfFile& File, const InfPlatformTarget& Target = InfPlatformTarget::Host(),
+	                       const std::optional<nefarius::utilities::Guid>& NamedClassGuid = std::nullopt);
+
+	/**
+	 * Analyzes a parsed INF for several platforms at once, e.g. every architecture and OS build of
+	 * a rollout. The [Version] identity is read once, and targets resolving to the same install
+	 * sections share their class filter evaluation.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	File		 	The INF.
+	 * @param 	Targets		 	The platforms to resolve the install and models sections for.
+	 * @param 	NamedClassGuid	(Optional) GUID of the custom class named by [Version] Class, see
+	 * 							the single target overload.
+	 *
+	 * @returns	One analysis per target, in the order of Targets.
+	 */
+	std::vector<InfAnalysis> AnalyzeInf(const InfFile& File, std::span<const InfPlatformTarget> Targets,
+	                                    const std::optional<nefarius::utilities::Guid>& NamedClassGuid =
+		                                    std::nullopt);
+
+	/**
+	 * Options of the batch analysis functions.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfBatchOptions
+	{
+		///< Worker threads; 0 picks the number of hardware threads
+		unsigned Threads = 0;
+		///< Upper bound of files queued, being parsed or waiting for the callback; 0 picks 4 per thread
+		size_t MaxInFlight = 0;
+		///< Descend into subdirectories (AnalyzeInfDirectory only)
+		bool Recursive = true;
+		///< Platform the install sections are resolved for
+		InfPlatformTarget Target = InfPlatformTarget::Host();
+		///< Options every file is opened with
+		InfOpenOptions Open;
+	};
+
+	/**
+	 * Receives the result of one file; return false to stop the batch. Always invoked on the thread
+	 * that started the batch, one file at a time, in order of completion (not submission).
+	 */
+	using InfBatchCallback = std::function<bool(const std::filesystem::path& Path,
+	                                            std::expected<InfAnalysis, std::error_code>&& Result)>;
+
+	/**
+	 * Summary of a batch run.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfBatchStats
+	{
+		size_t Analyzed = 0; ///< Files delivered with an analysis
+		size_t Failed = 0; ///< Files delivered with an error
+		size_t Inaccessible = 0; ///< Directories that couldn't be enumerated (AnalyzeInfDirectory only)
+		bool Stopped = false; ///< True if the callback ended the batch early
+	};
+
+	/**
+	 * Analyzes the given INF files in parallel, streaming each result to Callback as soon as it is
+	 * available. At most InfBatchOptions::MaxInFlight files are pending at any time, so memory
+	 * use doesn't grow with the number of files.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Paths   	The INF files.
+	 * @param 	Callback	Receives every result.
+	 * @param 	Options 	(Optional) Batch options.
+	 *
+	 * @returns	The batch summary.
+	 */
+	InfBatchStats AnalyzeInfFiles(std::span<const std::filesystem::path> Paths, const InfBatchCallback& Callback,
+	                              const InfBatchOptions& Options = {});
+
+	/**
+	 * Like AnalyzeInfFiles, for every *.inf file in a directory, enumerated while the first files
+	 * are already being analyzed. A subdirectory that can't be opened or read to the end is
+	 * skipped (or, if the error hit midway, the rest of it is) and the enumeration carries on; it
+	 * is delivered to Callback with its path and the error, and counted in
+	 * InfBatchStats::Inaccessible rather than InfBatchStats::Failed.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Directory	The directory, e.g. C:\Windows\System32\DriverStore\FileRepository.
+	 * @param 	Callback 	Receives every result.
+	 * @param 	Options  	(Optional) Batch options.
+	 *
+	 * @returns	The batch summary, or the error of opening the directory.
+	 */
+	std::expected<InfBatchStats, std::error_code> AnalyzeInfDirectory(const std::filesystem::path& Directory,
+	                                                                  const InfBatchCallback& Callback,
+	                                                                  const InfBatchOptions& Options = {});
+}
@@ -0,0 +1,335 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cwchar>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+//
+// SetupAPI-free INF parser. The file is memory-mapped (UTF-16LE files are used in place,
+// UTF-8 and ANSI ones are converted once), split into an index of sections, lines and fields
+// held as views into the text, and %strkey% substitutions are only expanded when a field
+// containing one is first read. Unlike SetupGetStringField there's no LINE_LEN limit on fields.
+// Portable, so INF corpora can be analyzed on any platform.
+//
+namespace nefarius::devcon::inf
+{
+	namespace detail
+	{
+		struct InfData;
+	}
+
+	/**
+	 * Text encoding an INF file was detected to use.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class InfEncoding
+	{
+		///< No BOM and either pure ASCII or not valid UTF-8; decoded as Windows-1252
+		Ansi,
+		///< UTF-8 with BOM, or without BOM if it contains valid non-ASCII sequences
+		Utf8,
+		///< UTF-16 little endian with or without BOM
+		Utf16LE,
+		///< UTF-16 big endian with BOM
+		Utf16BE
+	};
+
+	/**
+	 * Processor architecture used to pick decorated install sections.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class InfArchitecture
+	{
+		X86,
+		Amd64,
+		Ia64,
+		Arm,
+		Arm64
+	};
+
+	/**
+	 * Platform an install section is resolved for (see InfFile::resolve_install_section) and
+	 * [Manufacturer] models sections are selected for (see AnalyzeInf).
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfPlatformTarget
+	{
+		InfArchitecture Architecture = InfArchitecture::Amd64; ///< Architecture of the target system
+		///< Major version of the target OS, e.g. 10; 0 leaves the OS version constraints of
+		///< TargetOSVersion decorations unevaluated, so every models section of the architecture applies
+		uint16_t OsMajorVersion = 0;
+		uint16_t OsMinorVersion = 0; ///< Minor version of the target OS
+		uint32_t OsBuildNumber = 0; ///< Build number of the target OS, e.g. 22631
+		///< VER_NT_* product type of the target OS; 0 matches any ProductType decoration
+		uint8_t ProductType = 0;
+
+		///< The architecture this code was compiled for
+		static constexpr InfPlatformTarget Host()
+		{
+#if defined(_M_ARM64) || defined(__aarch64__)
+			return {InfArchitecture::Arm64};
+#elif defined(_M_ARM) || defined(__arm__)
+			return {InfArchitecture::Arm};
+#elif defined(_M_IX86) || defined(__i386__)
+			return {InfArchitecture::X86};
+#else
+			return {InfArchitecture::Amd64};
+#endif
+		}
+	};
+
+	/**
+	 * Options for opening an INF file.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfOpenOptions
+	{
+		///< If non-zero, entries of [Strings.xxxx] for this LANGID take precedence over [Strings]
+		uint16_t LanguageId = 0;
+	};
+
+	/**
+	 * A line of a section; a cheap handle that stays valid as long as its InfFile does.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class InfLine
+	{
+	public:
+		InfLine() = default;
+
+		///< True if the line has a "key =" part
+		[[nodiscard]] bool has_key() const;
+
+		///< The expanded key, empty if the line has none
+		[[nodiscard]] std::u16string_view key() const;
+
+		///< Number of value fields (the key not counted), like SetupGetFieldCount
+		[[nodiscard]] size_t field_count() const;
+
+		///< The expanded field; 0 is the key, values start at 1 like in SetupGetStringField. Empty
+		///< if out of range.
+		[[nodiscard]] std::u16string_view field(size_t Index) const;
+
+		///< The field as written (quotes and %strkey% tokens kept, surrounding whitespace trimmed)
+		[[nodiscard]] std::u16string_view raw_field(size_t Index) const;
+
+		///< 1-based number of the physical line this line starts on
+		[[nodiscard]] uint32_t line_number() const;
+
+	private:
+		friend class InfSection;
+		friend class InfFile;
+
+		InfLine(const detail::InfData* Data, uint32_t Index) : data_(Data), index_(Index)
+		{
+		}
+
+		const detail::InfData* data_{nullptr};
+		uint32_t index_{0};
+	};
+
+	/**
+	 * A section, with the lines of all same-named sections of the file merged in file order.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class InfSection
+	{
+	public:
+		class iterator
+		{
+		public:
+			using value_type = InfLine;
+			using reference = InfLine;
+			using difference_type = std::ptrdiff_t;
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+
+			iterator() = default;
+
+			reference operator*() const
+			{
+				return InfLine(data_, index_);
+			}
+
+			iterator& operator++()
+			{
+				++index_;
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator previous = *this;
+				++index_;
+				return previous;
+			}
+
+			bool operator==(const iterator& other) const
+			{
+				return index_ == other.index_;
+			}
+
+		private:
+			friend class InfSection;
+
+			iterator(const detail::InfData* Data, uint32_t Index) : data_(Data), index_(Index)
+			{
+			}
+
+			const detail::InfData* data_{nullptr};
+			uint32_t index_{0};
+		};
+
+		InfSection() = default;
+
+		///< The section name as written in its (first) header
+		[[nodiscard]] std::u16string_view name() const;
+
+		[[nodiscard]] iterator begin() const
+		{
+			return iterator(data_, first_);
+		}
+
+		[[nodiscard]] iterator end() const
+		{
+			return iterator(data_, first_ + count_);
+		}
+
+		[[nodiscard]] size_t size() const
+		{
+			return count_;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return count_ == 0;
+		}
+
+		///< First line whose (expanded) key matches case-insensitively
+		[[nodiscard]] std::optional<InfLine> find(std::u16string_view Key) const;
+
+	private:
+		friend class InfFile;
+
+		InfSection(const detail::InfData* Data, uint32_t Section, uint32_t First, uint32_t Count)
+			: data_(Data), section_(Section), first_(First), count_(Count)
+		{
+		}
+
+		const detail::InfData* data_{nullptr};
+		uint32_t section_{0};
+		uint32_t first_{0};
+		uint32_t count_{0};
+	};
+
+	/**
+	 * A parsed INF file. Movable; sections, lines and views obtained from it point into its
+	 * heap-allocated state and remain valid across moves, until the owning object is destroyed.
+	 * Concurrent reads from multiple threads are safe.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class InfFile
+	{
+	public:
+		InfFile(InfFile&& Other) noexcept;
+		InfFile& operator=(InfFile&& Other) noexcept;
+		~InfFile();
+
+		InfFile(const InfFile&) = delete;
+		InfFile& operator=(const InfFile&) = delete;
+
+		/**
+		 * Memory-maps and parses an INF file.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Path   	Path of the INF file.
+		 * @param 	Options	(Optional) Parsing options.
+		 *
+		 * @returns	The parsed file, or the OS error of opening/mapping the file.
+		 */
+		static std::expected<InfFile, std::error_code> Open(const std::filesystem::path& Path,
+		                                                    const InfOpenOptions& Options = {});
+
+		///< Parses INF content held in memory; the content is copied
+		static std::expected<InfFile, std::error_code> FromBuffer(std::span<const std::byte> Content,
+		                                                          const InfOpenOptions& Options = {});
+
+		[[nodiscard]] InfEncoding encoding() const;
+
+		///< Looks up a section by name (case-insensitive)
+		[[nodiscard]] std::optional<InfSection> section(std::u16string_view Name) const;
+
+		///< All distinct sections, in order of first appearance
+		[[nodiscard]] std::vector<InfSection> sections() const;
+
+		///< First field of the first line with the given key in the given section, e.g.
+		///< value(u"Version", u"Provider")
+		[[nodiscard]] std::optional<std::u16string_view> value(std::u16string_view Section,
+		                                                       std::u16string_view Key) const;
+
+		///< Looks up a [Strings] entry, unquoted
+		[[nodiscard]] std::optional<std::u16string_view> string(std::u16string_view Key) const;
+
+		/**
+		 * Finds the platform-decorated variant of an install section the way
+		 * SetupDiGetActualSectionToInstall does: Base.NT[arch], then Base.NT, then Base.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	Base  	Undecorated section name, e.g. "DefaultInstall".
+		 * @param 	Target	(Optional) The platform to resolve for.
+		 *
+		 * @returns	The best matching section (see InfSection::name for the actual name), or
+		 * 			std::nullopt if none of the variants exists.
+		 */
+		[[nodiscard]] std::optional<InfSection> resolve_install_section(
+			std::u16string_view Base, const InfPlatformTarget& Target = InfPlatformTarget::Host()) const;
+
+	private:
+		explicit InfFile(std::unique_ptr<detail::InfData> Data);
+
+		std::unique_ptr<detail::InfData> data_;
+	};
+
+#if WCHAR_MAX <= 0xFFFF
+	//
+	// wchar_t is UTF-16 on Windows; views can be handed to Win32 APIs as-is.
+	//
+
+	inline std::wstring_view AsWide(std::u16string_view Value)
+	{
+		return {reinterpret_cast<const wchar_t*>(Value.data()), Value.size()};
+	}
+
+	inline std::u16string_view AsUtf16(std::wstring_view Value)
+	{
+		return {reinterpret_cast<const char16_t*>(Value.data()), Value.size()};
+	}
+#endif
+}
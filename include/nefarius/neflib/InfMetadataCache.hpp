@@ -0,0 +1,134 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <system_error>
+
+#include <nefarius/neflib/InfAnalysis.hpp>
+
+//
+// Persistent cache of InfAnalysis results, so repeated scans of the driver store only parse the
+// INFs that changed since the last run. The cache file is memory-mapped and entries are decoded
+// on lookup; new and refreshed entries are held in memory until saved. Portable like InfFile.
+//
+namespace nefarius::devcon::inf
+{
+	namespace detail
+	{
+		struct InfMetadataCacheData;
+	}
+
+	/**
+	 * How a cached entry is checked against the INF file it was created from.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class InfCacheValidation
+	{
+		///< An entry is valid while file size and last write time are unchanged
+		SizeAndTime,
+		///< Like SizeAndTime, but if only the write time differs, a matching content hash keeps
+		///< the entry (e.g. after a package was re-copied with identical content)
+		ContentHash
+	};
+
+	/**
+	 * Options of an InfMetadataCache. Target and Open become part of the cache file; a file
+	 * written with different values is discarded.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfMetadataCacheOptions
+	{
+		///< How entries are validated
+		InfCacheValidation Validation = InfCacheValidation::SizeAndTime;
+		///< Platform the analyses are made for
+		InfPlatformTarget Target = InfPlatformTarget::Host();
+		///< Options INF files are opened with
+		InfOpenOptions Open;
+	};
+
+	/**
+	 * Counters of an InfMetadataCache since it was opened.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InfMetadataCacheStats
+	{
+		size_t Hits = 0; ///< Lookups answered from the cache
+		size_t Misses = 0; ///< Lookups that had to parse the INF
+	};
+
+	/**
+	 * A persistent, memory-mapped cache of INF metadata keyed by absolute path. Movable; all
+	 * member functions are safe to call concurrently.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class InfMetadataCache
+	{
+	public:
+		InfMetadataCache(InfMetadataCache&& Other) noexcept;
+		InfMetadataCache& operator=(InfMetadataCache&& Other) noexcept;
+		~InfMetadataCache();
+
+		InfMetadataCache(const InfMetadataCache&) = delete;
+		InfMetadataCache& operator=(const InfMetadataCache&) = delete;
+
+		/**
+		 * Opens a cache file. A missing, corrupt or incompatible file yields an empty cache that
+		 * replaces it on save().
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	CacheFile	Path of the cache file; needn't exist.
+		 * @param 	Options  	(Optional) Cache options.
+		 *
+		 * @returns	The cache, or the error of mapping an existing cache file.
+		 */
+		static std::expected<InfMetadataCache, std::error_code> Open(const std::filesystem::path& CacheFile,
+		                                                             const InfMetadataCacheOptions& Options = {});
+
+		/**
+		 * Gets the analysis of an INF file, from the cache if the file is unchanged, otherwise by
+		 * parsing it and recording the result.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	InfPath	Path of the INF file.
+		 *
+		 * @returns	The analysis, or the error of accessing or opening the INF file.
+		 */
+		std::expected<InfAnalysis, std::error_code> lookup(const std::filesystem::path& InfPath);
+
+		///< Drops the entry of an INF file, so the next lookup parses it again
+		void invalidate(const std::filesystem::path& InfPath);
+
+		/**
+		 * Writes the cache file if anything changed since it was opened or last saved. The file is
+		 * replaced atomically; entries of INF files that no longer exist are dropped.
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @returns	Nothing, or the error of writing the cache file.
+		 */
+		std::expected<void, std::error_code> save();
+
+		[[nodiscard]] InfMetadataCacheStats stats() const;
+
+	private:
+		explicit InfMetadataCache(std::unique_ptr<detail::InfMetadataCacheData> Data);
+
+		std::unique_ptr<detail::InfMetadataCacheData> data_;
+	};
+}
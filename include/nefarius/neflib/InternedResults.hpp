@@ -0,0 +1,263 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <vector>
+
+#include <nefarius/neflib/StringPool.hpp>
+#include <nefarius/neflib/UniUtil.hpp>
+#include <nefarius/neflib/Devcon.hpp>
+#include <nefarius/neflib/DeviceRestart.hpp>
+
+//
+// Opt-in variants of the result structs that carry pool handles instead of owning strings.
+// Instance/hardware IDs, service and class names repeat heavily across a sweep, so snapshots
+// kept resident by long-running agents share one copy of each and compare IDs in O(1).
+// Intern converts a regular result, Materialize converts back.
+//
+namespace nefarius::devcon
+{
+	/**
+	 * DeviceRestartResult with interned strings.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InternedDeviceRestartResult
+	{
+		nefarius::utilities::InternedString InstanceId; ///< See DeviceRestartResult::InstanceId
+		nefarius::utilities::InternedString FriendlyName; ///< See DeviceRestartResult::FriendlyName
+		RestartStrategy Strategy = RestartStrategy::None; ///< See DeviceRestartResult::Strategy
+		bool Succeeded = false; ///< See DeviceRestartResult::Succeeded
+		bool TimedOut = false; ///< See DeviceRestartResult::TimedOut
+		bool RebootRequired = false; ///< See DeviceRestartResult::RebootRequired
+		uint32_t LastError = 0; ///< See DeviceRestartResult::LastError
+		nefarius::utilities::InternedString VetoName; ///< See DeviceRestartResult::VetoName
+		uint32_t VetoType = 0; ///< See DeviceRestartResult::VetoType
+		RestartStrategy LastAttempted = RestartStrategy::None; ///< See DeviceRestartResult::LastAttempted
+		bool DevicePresent = false; ///< See DeviceRestartResult::DevicePresent
+		bool FinalStatusValid = false; ///< See DeviceRestartResult::FinalStatusValid
+		uint32_t FinalStatusError = 0; ///< See DeviceRestartResult::FinalStatusError
+		uint32_t FinalStatusWin32Error = 0; ///< See DeviceRestartResult::FinalStatusWin32Error
+		bool FinalStarted = false; ///< See DeviceRestartResult::FinalStarted
+		bool FinalHasProblem = false; ///< See DeviceRestartResult::FinalHasProblem
+		uint32_t FinalProblemCode = 0; ///< See DeviceRestartResult::FinalProblemCode
+	};
+
+	/**
+	 * DetachResult with interned strings.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InternedDetachResult
+	{
+		nefarius::utilities::InternedString InstanceId; ///< See DetachResult::InstanceId
+		nefarius::utilities::InternedString FriendlyName; ///< See DetachResult::FriendlyName
+		nefarius::utilities::InternedString ParentInstanceId; ///< See DetachResult::ParentInstanceId
+		bool Succeeded = false; ///< See DetachResult::Succeeded
+		bool TimedOut = false; ///< See DetachResult::TimedOut
+		uint32_t LastError = 0; ///< See DetachResult::LastError
+		nefarius::utilities::InternedString VetoName; ///< See DetachResult::VetoName
+		uint32_t VetoType = 0; ///< See DetachResult::VetoType
+	};
+
+	/**
+	 * InfClassFilterTarget with an interned service name.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InternedInfClassFilterTarget
+	{
+		GUID ClassGuid = {}; ///< See InfClassFilterTarget::ClassGuid
+		DeviceClassFilterPosition Position = DeviceClassFilterPosition::Upper; ///< See InfClassFilterTarget::Position
+		nefarius::utilities::InternedString ServiceName; ///< See InfClassFilterTarget::ServiceName
+	};
+
+	/**
+	 * DriverStorePackage with interned strings.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InternedDriverStorePackage
+	{
+		nefarius::utilities::InternedString DriverPackageInfPath; ///< See DriverStorePackage::DriverPackageInfPath
+		nefarius::utilities::InternedString PublishedInfName; ///< See DriverStorePackage::PublishedInfName
+		bool IsInbox = false; ///< See DriverStorePackage::IsInbox
+		unsigned short ProcessorArchitecture = 0; ///< See DriverStorePackage::ProcessorArchitecture
+		nefarius::utilities::InternedString LocaleName; ///< See DriverStorePackage::LocaleName
+	};
+
+	/**
+	 * FindByHwIdResult with interned strings; narrow results are widened on interning.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	struct InternedFindByHwIdResult
+	{
+		std::vector<nefarius::utilities::InternedString> HardwareIds; ///< See FindByHwIdResult::HardwareIds
+		nefarius::utilities::InternedString Name; ///< See FindByHwIdResult::Name
+		decltype(FindByHwIdResult<std::wstring>::Version) Version; ///< See FindByHwIdResult::Version
+	};
+
+	inline InternedDeviceRestartResult Intern(const DeviceRestartResult& Result)
+	{
+		return InternedDeviceRestartResult{
+			nefarius::utilities::InternedString(Result.InstanceId),
+			nefarius::utilities::InternedString(Result.FriendlyName),
+			Result.Strategy,
+			Result.Succeeded,
+			Result.TimedOut,
+			Result.RebootRequired,
+			Result.LastError,
+			nefarius::utilities::InternedString(Result.VetoName),
+			Result.VetoType,
+			Result.LastAttempted,
+			Result.DevicePresent,
+			Result.FinalStatusValid,
+			Result.FinalStatusError,
+			Result.FinalStatusWin32Error,
+			Result.FinalStarted,
+			Result.FinalHasProblem,
+			Result.FinalProblemCode
+		};
+	}
+
+	inline DeviceRestartResult Materialize(const InternedDeviceRestartResult& Result)
+	{
+		return DeviceRestartResult{
+			Result.InstanceId.str(),
+			Result.FriendlyName.str(),
+			Result.Strategy,
+			Result.Succeeded,
+			Result.TimedOut,
+			Result.RebootRequired,
+			Result.LastError,
+			Result.VetoName.str(),
+			Result.VetoType,
+			Result.LastAttempted,
+			Result.DevicePresent,
+			Result.FinalStatusValid,
+			Result.FinalStatusError,
+			Result.FinalStatusWin32Error,
+			Result.FinalStarted,
+			Result.FinalHasProblem,
+			Result.FinalProblemCode
+		};
+	}
+
+	inline InternedDetachResult Intern(const DetachResult& Result)
+	{
+		return InternedDetachResult{
+			nefarius::utilities::InternedString(Result.InstanceId),
+			nefarius::utilities::InternedString(Result.FriendlyName),
+			nefarius::utilities::InternedString(Result.ParentInstanceId),
+			Result.Succeeded,
+			Result.TimedOut,
+			Result.LastError,
+			nefarius::utilities::InternedString(Result.VetoName),
+			Result.VetoType
+		};
+	}
+
+	inline DetachResult Materialize(const InternedDetachResult& Result)
+	{
+		return DetachResult{
+			Result.InstanceId.str(),
+			Result.FriendlyName.str(),
+			Result.ParentInstanceId.str(),
+			Result.Succeeded,
+			Result.TimedOut,
+			Result.LastError,
+			Result.VetoName.str(),
+			Result.VetoType
+		};
+	}
+
+	inline InternedInfClassFilterTarget Intern(const InfClassFilterTarget& Target)
+	{
+		return InternedInfClassFilterTarget{
+			Target.ClassGuid,
+			Target.Position,
+			nefarius::utilities::InternedString(Target.ServiceName)
+		};
+	}
+
+	inline InfClassFilterTarget Materialize(const InternedInfClassFilterTarget& Target)
+	{
+		return InfClassFilterTarget{Target.ClassGuid, Target.Position, Target.ServiceName.str()};
+	}
+
+	inline InternedDriverStorePackage Intern(const DriverStorePackage& Package)
+	{
+		return InternedDriverStorePackage{
+			nefarius::utilities::InternedString(Package.DriverPackageInfPath),
+			nefarius::utilities::InternedString(Package.PublishedInfName),
+			Package.IsInbox,
+			Package.ProcessorArchitecture,
+			nefarius::utilities::InternedString(Package.LocaleName)
+		};
+	}
+
+	inline DriverStorePackage Materialize(const InternedDriverStorePackage& Package)
+	{
+		return DriverStorePackage{
+			Package.DriverPackageInfPath.str(),
+			Package.PublishedInfName.str(),
+			Package.IsInbox,
+			Package.ProcessorArchitecture,
+			Package.LocaleName.str()
+		};
+	}
+
+	template <nefarius::utilities::string_type StringType>
+	InternedFindByHwIdResult Intern(const FindByHwIdResult<StringType>& Result)
+	{
+		InternedFindByHwIdResult interned;
+		interned.HardwareIds.reserve(Result.HardwareIds.size());
+
+		for (const auto& hardwareId : Result.HardwareIds)
+		{
+			interned.HardwareIds.emplace_back(nefarius::utilities::ConvertToWide(hardwareId));
+		}
+
+		interned.Name = nefarius::utilities::InternedString(nefarius::utilities::ConvertToWide(Result.Name));
+		interned.Version.Value = Result.Version.Value;
+
+		return interned;
+	}
+
+	template <nefarius::utilities::string_type StringType>
+	FindByHwIdResult<StringType> Materialize(const InternedFindByHwIdResult& Result)
+	{
+		FindByHwIdResult<StringType> result;
+		result.HardwareIds.reserve(Result.HardwareIds.size());
+
+		for (const auto& hardwareId : Result.HardwareIds)
+		{
+			if constexpr (std::is_same_v<StringType, std::wstring>)
+			{
+				result.HardwareIds.push_back(hardwareId.str());
+			}
+			else
+			{
+				result.HardwareIds.push_back(nefarius::utilities::ConvertToNarrow(hardwareId.view()));
+			}
+		}
+
+		if constexpr (std::is_same_v<StringType, std::wstring>)
+		{
+			result.Name = Result.Name.str();
+		}
+		else
+		{
+			result.Name = nefarius::utilities::ConvertToNarrow(Result.Name.view());
+		}
+
+		result.Version.Value = Result.Version.Value;
+
+		return result;
+	}
+}
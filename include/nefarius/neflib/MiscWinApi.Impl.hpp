@@ -30,7 +30,7 @@ namespace nefarius::winapi
 		}
 		else
 		{
-			static_assert(false, "Not a string type");
+			static_assert(nefarius::utilities::detail::AlwaysFalse<StringType>, "Not a string type");
 		}
 
 		return std::unexpected(nefarius::utilities::Win32Error(ERROR_INTERNAL_ERROR));
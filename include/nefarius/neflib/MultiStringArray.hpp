@@ -1,83 +1,366 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
 
 namespace nefarius::utilities
 {
-	// Template class for double-NULL-terminated multi-string array
-	template <typename CharT>
+	namespace detail
+	{
+		// Character buffer holding up to InlineCapacity characters in place and spilling over
+		// to memory obtained from Allocator beyond that
+		template <typename CharT, size_t InlineCapacity, typename Allocator>
+		class SmallCharBuffer
+		{
+			using Traits = std::allocator_traits<Allocator>;
+
+		public:
+			SmallCharBuffer() = default;
+
+			explicit SmallCharBuffer(const Allocator& alloc) : alloc_(alloc)
+			{
+			}
+
+			SmallCharBuffer(const SmallCharBuffer& other)
+				: alloc_(Traits::select_on_container_copy_construction(other.alloc_))
+			{
+				assign(other.data(), other.data() + other.size());
+			}
+
+			SmallCharBuffer(SmallCharBuffer&& other) noexcept : alloc_(std::move(other.alloc_))
+			{
+				take(other);
+			}
+
+			SmallCharBuffer& operator=(const SmallCharBuffer& other)
+			{
+				if (this != &other)
+				{
+					if constexpr (Traits::propagate_on_container_copy_assignment::value)
+					{
+						if (alloc_ != other.alloc_)
+						{
+							release();
+						}
+
+						alloc_ = other.alloc_;
+					}
+
+					assign(other.data(), other.data() + other.size());
+				}
+
+				return *this;
+			}
+
+			SmallCharBuffer& operator=(SmallCharBuffer&& other) noexcept(
+				Traits::propagate_on_container_move_assignment::value || Traits::is_always_equal::value)
+			{
+				if (this == &other)
+				{
+					return *this;
+				}
+
+				if constexpr (Traits::propagate_on_container_move_assignment::value)
+				{
+					release();
+					alloc_ = std::move(other.alloc_);
+					take(other);
+				}
+				else
+				{
+					if (alloc_ == other.alloc_)
+					{
+						release();
+						take(other);
+					}
+					else
+					{
+						// memory from a foreign resource can't be adopted, copy instead
+						assign(other.data(), other.data() + other.size());
+						other.size_ = 0;
+					}
+				}
+
+				return *this;
+			}
+
+			~SmallCharBuffer()
+			{
+				release();
+			}
+
+			CharT* data()
+			{
+				return heap_ ? heap_ : inline_.data();
+			}
+
+			const CharT* data() const
+			{
+				return heap_ ? heap_ : inline_.data();
+			}
+
+			[[nodiscard]] size_t size() const
+			{
+				return size_;
+			}
+
+			[[nodiscard]] size_t capacity() const
+			{
+				return heap_ ? heapCapacity_ : InlineCapacity;
+			}
+
+			CharT& operator[](size_t index)
+			{
+				return data()[index];
+			}
+
+			const CharT& operator[](size_t index) const
+			{
+				return data()[index];
+			}
+
+			Allocator get_allocator() const
+			{
+				return alloc_;
+			}
+
+			// Resizes to count characters, new ones are zero-initialized
+			void resize(size_t count)
+			{
+				reserve(count);
+
+				if (count > size_)
+				{
+					std::fill(data() + size_, data() + count, CharT('\0'));
+				}
+
+				size_ = count;
+			}
+
+			void assign(const CharT* first, const CharT* last)
+			{
+				const size_t count = static_cast<size_t>(last - first);
+
+				size_ = 0;
+				reserve(count);
+				std::copy(first, last, data());
+				size_ = count;
+			}
+
+			void reserve(size_t count)
+			{
+				if (count <= capacity())
+				{
+					return;
+				}
+
+				const size_t newCapacity = std::max(count, capacity() * 2);
+				CharT* buffer = Traits::allocate(alloc_, newCapacity);
+
+				std::copy(data(), data() + size_, buffer);
+				release();
+
+				heap_ = buffer;
+				heapCapacity_ = newCapacity;
+			}
+
+		private:
+			void release()
+			{
+				if (heap_)
+				{
+					Traits::deallocate(alloc_, heap_, heapCapacity_);
+					heap_ = nullptr;
+					heapCapacity_ = 0;
+				}
+			}
+
+			// Adopts the heap block of other, or copies its inline content
+			void take(SmallCharBuffer& other)
+			{
+				if (other.heap_)
+				{
+					heap_ = other.heap_;
+					heapCapacity_ = other.heapCapacity_;
+					other.heap_ = nullptr;
+					other.heapCapacity_ = 0;
+				}
+				else
+				{
+					std::copy(other.inline_.data(), other.inline_.data() + other.size_, inline_.data());
+				}
+
+				size_ = other.size_;
+				other.size_ = 0;
+			}
+
+			CharT* heap_{nullptr};
+			size_t heapCapacity_{0};
+			size_t size_{0};
+			std::array<CharT, InlineCapacity> inline_;
+			Allocator alloc_{};
+		};
+	}
+
+	// Template class for double-NULL-terminated multi-string array; up to InlineCapacity
+	// characters are stored in the object itself, anything larger is obtained from Allocator
+	template <typename CharT, size_t InlineCapacity = 0, typename Allocator = std::allocator<CharT>>
 	class MultiStringArray
 	{
 	public:
 		using StringType = std::basic_string<CharT>;
 		using CharType = CharT;
+		using AllocatorType = Allocator;
 
 		MultiStringArray() = default;
 
+		MultiStringArray(const MultiStringArray&) = default;
+		MultiStringArray& operator=(const MultiStringArray&) = default;
+
+		MultiStringArray(MultiStringArray&& other) noexcept
+			: data_(std::move(other.data_)), payload_(std::exchange(other.payload_, unknownPayload))
+		{
+		}
+
+		MultiStringArray& operator=(MultiStringArray&& other) noexcept(noexcept(data_ = std::move(other.data_)))
+		{
+			if (this != &other)
+			{
+				data_ = std::move(other.data_);
+				payload_ = std::exchange(other.payload_, unknownPayload);
+			}
+
+			return *this;
+		}
+
+		// Construct empty, drawing any memory from the given allocator
+		explicit MultiStringArray(const Allocator& alloc) : data_(alloc)
+		{
+		}
+
 		// Construct from a vector of strings
-		explicit MultiStringArray(const std::vector<StringType>& strings)
+		explicit MultiStringArray(const std::vector<StringType>& strings, const Allocator& alloc = Allocator())
+			: data_(alloc)
 		{
 			from_vector(strings);
 		}
 
 		// Construct from a single string
-		explicit MultiStringArray(const StringType& str)
+		explicit MultiStringArray(const StringType& str, const Allocator& alloc = Allocator()) : data_(alloc)
 		{
 			from_string(str);
 		}
 
+		// Construct from the entries of any multi-string buffer
+		explicit MultiStringArray(MultiStringView<CharType> view, const Allocator& alloc = Allocator())
+			: data_(alloc)
+		{
+			from_view(view);
+		}
+
 		// Preallocate by amount of bytes
-		explicit MultiStringArray(size_t size)
+		explicit MultiStringArray(size_t size, const Allocator& alloc = Allocator()) : data_(alloc)
 		{
 			data_.resize(size);
 		}
 
-		// Construct from C buffer
-		explicit MultiStringArray(LPTSTR buffer, size_t bufferLength)
+		// Construct from C buffer of bufferLength characters; nothing beyond it is ever read, use
+		// is_well_formed() to check untrusted data for proper termination
+		explicit MultiStringArray(const CharType* buffer, size_t bufferLength, const Allocator& alloc = Allocator())
+			: data_(alloc)
 		{
 			data_.assign(buffer, buffer + bufferLength);
 		}
 
+		// Get a non-owning view over the entries
+		[[nodiscard]] MultiStringView<CharType> view() const
+		{
+			return MultiStringView<CharType>(data_.data(), data_.size());
+		}
+
 		// Convert to a vector of strings
 		std::vector<StringType> to_vector() const
 		{
 			std::vector<StringType> result;
-			const CharType* p = data_.data();
-			while (*p)
+			for (const auto entry : view())
 			{
-				result.emplace_back(p);
-				p += std::char_traits<CharType>::length(p) + 1;
+				result.emplace_back(entry);
 			}
 			return result;
 		}
 
-		// Initialize from a vector of strings
+		// Initialize from a vector of strings; empty strings are skipped as they would terminate
+		// the list early, embedded NULL characters cut a string short
 		void from_vector(const std::vector<StringType>& strings)
 		{
 			size_t total_length = 0;
 			for (const auto& str : strings)
 			{
-				total_length += str.size() + 1;
+				const auto entry = entry_of(str);
+				total_length += entry.empty() ? 0 : entry.size() + 1;
 			}
 			total_length++; // For the final double-NULL termination
 
-			data_.resize(total_length);
+			data_.resize(std::max<size_t>(total_length, 2));
 			CharType* p = data_.data();
 			for (const auto& str : strings)
 			{
-				std::memcpy(p, str.data(), str.size() * sizeof(CharType));
-				p += str.size();
+				const auto entry = entry_of(str);
+				if (entry.empty())
+				{
+					continue;
+				}
+				std::memcpy(p, entry.data(), entry.size() * sizeof(CharType));
+				p += entry.size();
 				*p++ = CharType('\0');
 			}
-			*p = CharType('\0');
+			std::fill(p, data_.data() + data_.size(), CharType('\0'));
+			payload_ = static_cast<size_t>(p - data_.data());
 		}
 
-		// Initialize from a single string
+		// Initialize from a single string; embedded NULL characters cut it short
 		void from_string(const StringType& str)
 		{
-			data_.resize(str.size() + 2); // Original string size + double-NULL termination
-			std::memcpy(data_.data(), str.data(), str.size() * sizeof(CharType));
-			data_[str.size()] = CharType('\0');
-			data_[str.size() + 1] = CharType('\0');
+			const auto entry = entry_of(str);
+			data_.resize(entry.size() + 2); // Original string size + double-NULL termination
+			std::memcpy(data_.data(), entry.data(), entry.size() * sizeof(CharType));
+			data_[entry.size()] = CharType('\0');
+			data_[entry.size() + 1] = CharType('\0');
+			payload_ = entry.empty() ? 0 : entry.size() + 1;
+		}
+
+		// Initialize from the entries of any multi-string buffer, dropping anything past the list end
+		void from_view(MultiStringView<CharType> view)
+		{
+			size_t total_length = 0;
+			for (const auto entry : view)
+			{
+				total_length += entry.size() + 1;
+			}
+			total_length++; // For the final double-NULL termination
+
+			data_.resize(std::max<size_t>(total_length, 2));
+			CharType* p = data_.data();
+			for (const auto entry : view)
+			{
+				std::memcpy(p, entry.data(), entry.size() * sizeof(CharType));
+				p += entry.size();
+				*p++ = CharType('\0');
+			}
+			std::fill(p, data_.data() + data_.size(), CharType('\0'));
+			payload_ = static_cast<size_t>(p - data_.data());
 		}
 
 		// Get the raw data
@@ -86,9 +369,10 @@ namespace nefarius::utilities
 			return data_.data();
 		}
 
-		// Get the raw data
+		// Get the raw data; writing through it is fine, the next edit re-reads the entries
 		unsigned char* data() const
 		{
+			payload_ = unknownPayload;
 			return (unsigned char*)data_.data();
 		}
 
@@ -104,18 +388,279 @@ namespace nefarius::utilities
 			return data_.size();
 		}
 
+		// Get the allocator used for storage beyond the inline capacity
+		[[nodiscard]] Allocator get_allocator() const
+		{
+			return data_.get_allocator();
+		}
+
 		// Looks for occurrence of specified string in the array
-		[[nodiscard]] bool contains(const StringType& match)
+		[[nodiscard]] bool contains(std::basic_string_view<CharType> match) const
+		{
+			return view().contains(match);
+		}
+
+		// True if the raw data is properly double-NULL-terminated
+		[[nodiscard]] bool is_well_formed() const
+		{
+			return view().is_well_formed();
+		}
+
+		// Get the number of entries
+		[[nodiscard]] size_t count() const
+		{
+			return static_cast<size_t>(std::ranges::distance(view()));
+		}
+
+		//
+		// The editing functions below work on the contiguous storage directly: every edit moves
+		// the affected tail once and leaves a properly double-NULL-terminated buffer (two NULLs
+		// for an empty list) behind. Empty strings can't be represented and are ignored, embedded
+		// NULL characters cut a string short. The length of the entries is kept across edits, so
+		// only the first edit of a buffer filled from outside (raw constructor or data()) has to
+		// walk the entries to find their end.
+		// 
+
+		// Appends a string; amortized O(length)
+		void push_back(std::basic_string_view<CharType> value)
+		{
+			const size_t payload = normalized_payload();
+			splice(payload, payload, 0, value);
+		}
+
+		// Inserts a string before the entry at index, or appends it if index is past the end;
+		// O(index) to find the entry plus one move of the tail
+		void insert_at(size_t index, std::basic_string_view<CharType> value)
+		{
+			const size_t payload = normalized_payload();
+			splice(payload, offset_of(index, payload), 0, value);
+		}
+
+		// Replaces the first occurrence of a string; returns false if it wasn't found
+		bool replace(std::basic_string_view<CharType> match, std::basic_string_view<CharType> value)
+		{
+			const size_t payload = normalized_payload();
+
+			for (const auto entry : view())
+			{
+				if (entry == match)
+				{
+					const auto offset = static_cast<size_t>(entry.data() - data_.data());
+					splice(payload, offset, entry.size() + 1, value);
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Removes every entry the predicate returns true for, in a single compacting pass;
+		// returns the number of entries removed
+		template <typename Predicate>
+		size_t erase_if(Predicate predicate)
 		{
-			const auto vector = to_vector();
-			return std::ranges::find(vector, match) != vector.end();
+			const size_t payload = normalized_payload();
+			CharType* base = data_.data();
+			size_t read = 0;
+			size_t write = 0;
+			size_t removed = 0;
+
+			while (read < payload)
+			{
+				const size_t length = std::char_traits<CharType>::length(base + read);
+
+				if (predicate(std::basic_string_view<CharType>(base + read, length)))
+				{
+					removed++;
+				}
+				else
+				{
+					if (write != read)
+					{
+						std::memmove(base + write, base + read, (length + 1) * sizeof(CharType));
+					}
+
+					write += length + 1;
+				}
+
+				read += length + 1;
+			}
+
+			terminate(write);
+			return removed;
+		}
+
+		// Removes every occurrence of a string; returns the number of entries removed
+		size_t erase(std::basic_string_view<CharType> match)
+		{
+			return erase_if([match](std::basic_string_view<CharType> entry) { return entry == match; });
+		}
+
+		// Removes entries that equal an earlier one ignoring case (see CaseFolding.hpp), keeping
+		// the first spelling; returns the number of entries removed. The kept entries are indexed
+		// by their case-insensitive hash in an open-addressing table like MultiStringSet's, so
+		// this is O(n) in the number of entries.
+		size_t dedupe_case_insensitive()
+		{
+			struct Kept
+			{
+				size_t Hash;
+				size_t Offset;
+				size_t Length;
+			};
+
+			// Marks an unused slot in the table
+			constexpr uint32_t emptySlot = UINT32_MAX;
+
+			std::vector<Kept> kept;
+			std::vector<uint32_t> slots(std::bit_ceil(std::max<size_t>(16, count() * 2)), emptySlot);
+			const size_t mask = slots.size() - 1;
+			size_t keptChars = 0;
+
+			// kept entries are compacted right after the predicate returns, so each one ends up
+			// at the running total of the kept entries before it
+			return erase_if([this, &kept, &slots, mask, &keptChars](std::basic_string_view<CharType> entry)
+			{
+				const size_t hash = nefarius::utilities::casefold::HashIgnoreCase(entry);
+				size_t slot = hash & mask;
+
+				for (; slots[slot] != emptySlot; slot = (slot + 1) & mask)
+				{
+					const Kept& previous = kept[slots[slot]];
+
+					if (previous.Hash == hash && previous.Length == entry.size() &&
+						nefarius::utilities::casefold::EqualsIgnoreCase(
+							std::basic_string_view<CharType>(data_.data() + previous.Offset, previous.Length), entry))
+					{
+						return true;
+					}
+				}
+
+				slots[slot] = static_cast<uint32_t>(kept.size());
+				kept.push_back(Kept{hash, keptChars, entry.size()});
+				keptChars += entry.size() + 1;
+				return false;
+			});
 		}
 
 	private:
-		std::vector<CharType> data_;
+		// Marks payload_ as not known, i.e. the buffer may have been filled from outside
+		static constexpr size_t unknownPayload = SIZE_MAX;
+
+		// The number of characters occupied by the entries and their terminators, found (and
+		// the buffer normalized) once after it was filled from outside
+		size_t normalized_payload()
+		{
+			if (payload_ == unknownPayload)
+			{
+				payload_ = normalize();
+			}
+
+			return payload_;
+		}
+
+		// Makes sure every entry and the list itself are NULL-terminated inside the storage;
+		// returns the number of characters occupied by the entries and their terminators
+		size_t normalize()
+		{
+			size_t payload = 0;
+
+			for (const auto entry : view())
+			{
+				payload = static_cast<size_t>(entry.data() - data_.data()) + entry.size() + 1;
+			}
+
+			if (data_.size() < payload + 1)
+			{
+				// the last entry ran into the end of the buffer, resize zero-fills the terminators
+				data_.resize(payload + 1);
+			}
+			else
+			{
+				data_[payload] = CharType('\0');
+			}
+
+			return payload;
+		}
+
+		// The part of value that fits into a single entry
+		static std::basic_string_view<CharType> entry_of(std::basic_string_view<CharType> value)
+		{
+			return value.substr(0, value.find(CharType('\0')));
+		}
+
+		// Character offset of the entry at index, or payload if there are fewer entries
+		size_t offset_of(size_t index, size_t payload) const
+		{
+			for (const auto entry : view())
+			{
+				if (index-- == 0)
+				{
+					return static_cast<size_t>(entry.data() - data_.data());
+				}
+			}
+
+			return payload;
+		}
+
+		// Replaces the removed characters at offset with value and its terminator in one move
+		void splice(size_t payload, size_t offset, size_t removed, std::basic_string_view<CharType> value)
+		{
+			value = entry_of(value);
+			const size_t inserted = value.empty() ? 0 : value.size() + 1;
+			const size_t newPayload = payload - removed + inserted;
+
+			if (data_.size() < newPayload + 1)
+			{
+				data_.resize(newPayload + 1);
+			}
+
+			CharType* base = data_.data();
+
+			std::memmove(base + offset + inserted,
+			             base + offset + removed,
+			             (payload - offset - removed) * sizeof(CharType));
+
+			if (inserted)
+			{
+				std::memcpy(base + offset, value.data(), value.size() * sizeof(CharType));
+				base[offset + value.size()] = CharType('\0');
+			}
+
+			terminate(newPayload);
+		}
+
+		// Cuts the storage down to the entries plus the final NULL (two NULLs if empty)
+		void terminate(size_t payload)
+		{
+			data_.resize(std::max<size_t>(payload + 1, 2));
+			std::fill(data_.data() + payload, data_.data() + data_.size(), CharType('\0'));
+			payload_ = payload;
+		}
+
+		detail::SmallCharBuffer<CharType, InlineCapacity, Allocator> data_;
+		// Characters occupied by the entries and their terminators, unknownPayload if data_ may
+		// have been filled from outside since the last edit
+		mutable size_t payload_ = unknownPayload;
 	};
 
 	// Type aliases for narrow and wide versions
 	using NarrowMultiStringArray = MultiStringArray<char>;
 	using WideMultiStringArray = MultiStringArray<wchar_t>;
+
+	// Variants keeping typical hardware ID lists (up to 256 characters) off the heap
+	using SmallNarrowMultiStringArray = MultiStringArray<char, 256>;
+	using SmallWideMultiStringArray = MultiStringArray<wchar_t, 256>;
+
+	namespace pmr
+	{
+		// Variants drawing from a std::pmr::memory_resource, e.g. a monotonic arena shared by
+		// thousands of arrays built during a bulk inventory
+		template <typename CharT, size_t InlineCapacity = 0>
+		using MultiStringArray = nefarius::utilities::MultiStringArray<
+			CharT, InlineCapacity, std::pmr::polymorphic_allocator<CharT>>;
+
+		using NarrowMultiStringArray = MultiStringArray<char>;
+		using WideMultiStringArray = MultiStringArray<wchar_t>;
+	}
 }
@@ -0,0 +1,266 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
+#include <nefarius/neflib/MultiStringArray.hpp>
+
+
+namespace nefarius::utilities
+{
+	// Case-insensitive set of strings kept in insertion order inside a contiguous
+	// double-NULL-terminated buffer, ready to be written back as REG_MULTI_SZ as-is
+	template <typename CharT>
+	class MultiStringSet
+	{
+	public:
+		using StringViewType = std::basic_string_view<CharT>;
+		using CharType = CharT;
+
+		// Creates an empty set, represented as two NULL characters
+		MultiStringSet()
+		{
+			data_.assign(2, CharType('\0'));
+		}
+
+		// Construct from any multi-string buffer; case-insensitive duplicates collapse onto their
+		// first occurrence
+		explicit MultiStringSet(MultiStringView<CharType> view) : MultiStringSet()
+		{
+			for (const auto entry : view)
+			{
+				insert(entry);
+			}
+		}
+
+		// Construct from the entries of a multi-string array
+		template <size_t InlineCapacity, typename Allocator>
+		explicit MultiStringSet(const MultiStringArray<CharType, InlineCapacity, Allocator>& array)
+			: MultiStringSet(array.view())
+		{
+		}
+
+		// Looks for occurrence of specified string in the set
+		[[nodiscard]] bool contains(StringViewType match) const
+		{
+			return find_entry(match, nefarius::utilities::casefold::HashIgnoreCase(match)).has_value();
+		}
+
+		// Gets the stored spelling of the specified string, if present
+		[[nodiscard]] std::optional<StringViewType> find(StringViewType match) const
+		{
+			const auto index = find_entry(match, nefarius::utilities::casefold::HashIgnoreCase(match));
+
+			if (!index)
+			{
+				return std::nullopt;
+			}
+
+			return entry_view(entries_[*index]);
+		}
+
+		// Appends a string unless it's empty or already present; amortized O(1)
+		bool insert(StringViewType value)
+		{
+			if (value.empty())
+			{
+				return false;
+			}
+
+			const size_t hash = nefarius::utilities::casefold::HashIgnoreCase(value);
+
+			if (find_entry(value, hash))
+			{
+				return false;
+			}
+
+			const size_t offset = payload_;
+
+			// overwrites the current final NULL, then terminates entry and list
+			data_.resize(offset + value.size() + 2);
+			std::memcpy(data_.data() + offset, value.data(), value.size() * sizeof(CharType));
+			data_[offset + value.size()] = CharType('\0');
+			data_[offset + value.size() + 1] = CharType('\0');
+			payload_ += value.size() + 1;
+
+			entries_.push_back(Entry{offset, value.size(), hash});
+
+			if ((entries_.size() * 2) > slots_.size())
+			{
+				rehash(std::max<size_t>(16, slots_.size() * 2));
+			}
+			else
+			{
+				place(entries_.size() - 1);
+			}
+
+			return true;
+		}
+
+		// Removes a string if present; O(n) as the remaining buffer is moved up
+		bool erase(StringViewType value)
+		{
+			const auto index = find_entry(value, nefarius::utilities::casefold::HashIgnoreCase(value));
+
+			if (!index)
+			{
+				return false;
+			}
+
+			const Entry removed = entries_[*index];
+			const size_t removedChars = removed.Length + 1;
+
+			// move everything behind the entry (including the final NULL) up
+			std::memmove(data_.data() + removed.Offset,
+			             data_.data() + removed.Offset + removedChars,
+			             (data_.size() - removed.Offset - removedChars) * sizeof(CharType));
+			data_.resize(data_.size() - removedChars);
+			payload_ -= removedChars;
+
+			entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(*index));
+
+			for (size_t i = *index; i < entries_.size(); i++)
+			{
+				entries_[i].Offset -= removedChars;
+			}
+
+			if (entries_.empty())
+			{
+				data_.assign(2, CharType('\0'));
+			}
+
+			rehash(slots_.size());
+
+			return true;
+		}
+
+		// Get the number of entries
+		[[nodiscard]] size_t count() const
+		{
+			return entries_.size();
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return entries_.empty();
+		}
+
+		// Get a non-owning view over the entries, in insertion order
+		[[nodiscard]] MultiStringView<CharType> view() const
+		{
+			return MultiStringView<CharType>(data_.data(), data_.size());
+		}
+
+		[[nodiscard]] auto begin() const
+		{
+			return view().begin();
+		}
+
+		[[nodiscard]] auto end() const
+		{
+			return view().end();
+		}
+
+		// Get the raw data
+		const CharType* c_str() const
+		{
+			return data_.data();
+		}
+
+		// Get the raw data
+		unsigned char* data() const
+		{
+			return (unsigned char*)data_.data();
+		}
+
+		// Get the size of the raw data in bytes
+		[[nodiscard]] size_t size() const
+		{
+			return data_.size() * sizeof(CharType);
+		}
+
+		// Get the size of the raw data in characters
+		[[nodiscard]] size_t chars() const
+		{
+			return data_.size();
+		}
+
+	private:
+		struct Entry
+		{
+			size_t Offset; ///< Position of the first character in data_
+			size_t Length; ///< Length in characters, excluding the NULL terminator
+			size_t Hash; ///< Case-insensitive hash of the entry
+		};
+
+		// Marks an unused slot in the open-addressing table
+		static constexpr uint32_t EmptySlot = UINT32_MAX;
+
+		StringViewType entry_view(const Entry& entry) const
+		{
+			return StringViewType(data_.data() + entry.Offset, entry.Length);
+		}
+
+		std::optional<size_t> find_entry(StringViewType value, size_t hash) const
+		{
+			if (slots_.empty())
+			{
+				return std::nullopt;
+			}
+
+			const size_t mask = slots_.size() - 1;
+
+			for (size_t slot = hash & mask; slots_[slot] != EmptySlot; slot = (slot + 1) & mask)
+			{
+				const Entry& entry = entries_[slots_[slot]];
+
+				if (entry.Hash == hash && entry.Length == value.size() &&
+					nefarius::utilities::casefold::EqualsIgnoreCase(entry_view(entry), value))
+				{
+					return slots_[slot];
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		void place(size_t index)
+		{
+			const size_t mask = slots_.size() - 1;
+			size_t slot = entries_[index].Hash & mask;
+
+			while (slots_[slot] != EmptySlot)
+			{
+				slot = (slot + 1) & mask;
+			}
+
+			slots_[slot] = static_cast<uint32_t>(index);
+		}
+
+		// Rebuilds the table from the stored hashes; no entry is hashed again
+		void rehash(size_t slotCount)
+		{
+			slots_.assign(slotCount, EmptySlot);
+
+			for (size_t i = 0; i < entries_.size(); i++)
+			{
+				place(i);
+			}
+		}
+
+		std::vector<CharType> data_;
+		std::vector<Entry> entries_;
+		std::vector<uint32_t> slots_;
+		size_t payload_{0};
+	};
+
+	// Type aliases for narrow and wide versions
+	using NarrowMultiStringSet = MultiStringSet<char>;
+	using WideMultiStringSet = MultiStringSet<wchar_t>;
+}
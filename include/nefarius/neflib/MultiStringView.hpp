@@ -0,0 +1,175 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+
+namespace nefarius::utilities
+{
+	// Non-owning view over a double-NULL-terminated multi-string buffer (REG_MULTI_SZ value,
+	// SPDRP_HARDWAREID data, CM property blob...), iterated as a forward range of string views
+	template <typename CharT>
+	class MultiStringView
+	{
+	public:
+		using StringViewType = std::basic_string_view<CharT>;
+		using CharType = CharT;
+
+		// Yields each entry up to (excluding) its NULL terminator; never reads past the end of the
+		// buffer, even if the data lacks its terminators
+		class iterator
+		{
+		public:
+			using value_type = StringViewType;
+			using reference = StringViewType;
+			using difference_type = std::ptrdiff_t;
+			using iterator_concept = std::forward_iterator_tag;
+			using iterator_category = std::input_iterator_tag;
+
+			iterator() = default;
+
+			reference operator*() const
+			{
+				return StringViewType(pos_, length_);
+			}
+
+			iterator& operator++()
+			{
+				const CharType* next = pos_ + length_;
+
+				// skip the entry's terminator, unless the buffer ended without one
+				if (next < end_)
+				{
+					++next;
+				}
+
+				seek(next);
+				return *this;
+			}
+
+			iterator operator++(int)
+			{
+				iterator previous = *this;
+				++*this;
+				return previous;
+			}
+
+			bool operator==(const iterator& other) const
+			{
+				return pos_ == other.pos_;
+			}
+
+		private:
+			friend class MultiStringView;
+
+			iterator(const CharType* pos, const CharType* end) : end_(end)
+			{
+				seek(pos);
+			}
+
+			// An empty entry (the second NULL of the pair) or the end of the buffer terminates
+			// the list; both collapse onto the end iterator
+			void seek(const CharType* pos)
+			{
+				const CharType* terminator = pos;
+
+				while (terminator < end_ && *terminator != CharType('\0'))
+				{
+					++terminator;
+				}
+
+				length_ = static_cast<size_t>(terminator - pos);
+				pos_ = length_ ? pos : end_;
+			}
+
+			const CharType* pos_{nullptr};
+			const CharType* end_{nullptr};
+			size_t length_{0};
+		};
+
+		MultiStringView() = default;
+
+		// Wrap a buffer of the given length in characters
+		MultiStringView(const CharType* buffer, size_t length)
+			: begin_(buffer), end_(buffer ? buffer + length : buffer)
+		{
+		}
+
+		// Wrap a buffer of the given size in bytes, as returned by the registry/SetupAPI/CM
+		static MultiStringView from_bytes(const void* buffer, size_t bytes)
+		{
+			return MultiStringView(static_cast<const CharType*>(buffer), bytes / sizeof(CharType));
+		}
+
+		[[nodiscard]] iterator begin() const
+		{
+			return iterator(begin_, end_);
+		}
+
+		[[nodiscard]] iterator end() const
+		{
+			return iterator(end_, end_);
+		}
+
+		// True if the buffer holds no entries
+		[[nodiscard]] bool empty() const
+		{
+			return begin() == end();
+		}
+
+		// Get the raw data
+		[[nodiscard]] const CharType* data() const
+		{
+			return begin_;
+		}
+
+		// Get the size of the underlying buffer in characters
+		[[nodiscard]] size_t chars() const
+		{
+			return static_cast<size_t>(end_ - begin_);
+		}
+
+		// Looks for occurrence of specified string in the array
+		[[nodiscard]] bool contains(StringViewType match) const
+		{
+			return std::ranges::find(*this, match) != end();
+		}
+
+		// True if every entry and the list itself are NULL-terminated within the buffer; iteration
+		// is safe either way, but a malformed buffer must not be passed on to APIs expecting
+		// REG_MULTI_SZ data
+		[[nodiscard]] bool is_well_formed() const
+		{
+			const CharType* terminator = begin_;
+
+			for (const auto entry : *this)
+			{
+				// entry ran into the end of the buffer without its NULL
+				if (entry.data() + entry.size() == end_)
+				{
+					return false;
+				}
+
+				terminator = entry.data() + entry.size() + 1;
+			}
+
+			// an empty entry (or the end of the buffer) stopped the iteration
+			return terminator < end_;
+		}
+
+	private:
+		const CharType* begin_{nullptr};
+		const CharType* end_{nullptr};
+	};
+
+	// Type aliases for narrow and wide versions
+	using NarrowMultiStringView = MultiStringView<char>;
+	using WideMultiStringView = MultiStringView<wchar_t>;
+}
+
+// The view never owns the buffer, so iterators outlive the view object itself
+template <typename CharT>
+inline constexpr bool std::ranges::enable_borrowed_range<nefarius::utilities::MultiStringView<CharT>> = true;
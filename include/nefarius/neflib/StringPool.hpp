@@ -0,0 +1,93 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+
+namespace nefarius::utilities
+{
+	/**
+	 * A wide string interned in the process-wide string pool, referred to by a compact 32-bit
+	 * handle. Interning the same content twice yields the same handle, so equality is a single
+	 * integer comparison. Each object holds a reference on its pool entry, which is freed once
+	 * the last reference goes away. Reading the content never takes a lock.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	class InternedString
+	{
+	public:
+		///< Handle value of the empty string, which never occupies a pool entry
+		static constexpr uint32_t NullHandle = 0;
+
+		InternedString() = default;
+
+		///< Interns the given content (case-sensitive) or references the existing entry
+		explicit InternedString(std::wstring_view Value);
+
+		InternedString(const InternedString& Other);
+
+		InternedString(InternedString&& Other) noexcept;
+
+		InternedString& operator=(const InternedString& Other);
+
+		InternedString& operator=(InternedString&& Other) noexcept;
+
+		~InternedString();
+
+		///< The interned content; NUL-terminated, valid as long as this object is alive
+		[[nodiscard]] std::wstring_view view() const;
+
+		///< The interned content as a C string; never null
+		[[nodiscard]] const wchar_t* c_str() const;
+
+		///< Copy of the interned content
+		[[nodiscard]] std::wstring str() const
+		{
+			return std::wstring(view());
+		}
+
+		///< The pool handle, unique per distinct content among live entries
+		[[nodiscard]] uint32_t handle() const
+		{
+			return handle_;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return handle_ == NullHandle;
+		}
+
+		///< O(1) content equality
+		friend bool operator==(const InternedString& Lhs, const InternedString& Rhs)
+		{
+			return Lhs.handle_ == Rhs.handle_;
+		}
+
+		///< Orders by handle (not lexicographically), for use in ordered containers
+		friend std::strong_ordering operator<=>(const InternedString& Lhs, const InternedString& Rhs)
+		{
+			return Lhs.handle_ <=> Rhs.handle_;
+		}
+
+		///< Number of live entries in the pool, for diagnostics
+		static size_t PoolSize();
+
+	private:
+		uint32_t handle_{NullHandle};
+	};
+}
+
+template <>
+struct std::hash<nefarius::utilities::InternedString>
+{
+	size_t operator()(const nefarius::utilities::InternedString& Value) const noexcept
+	{
+		return std::hash<uint32_t>{}(Value.handle());
+	}
+};
@@ -0,0 +1,129 @@
+// ReSharper disable CppRedundantQualifier
+#pragma once
+
+#include <cstddef>
+
+//
+// Portable UTF-16 <-> UTF-8 transcoding engine backing the ANSI/wide conversion helpers in
+// UniUtil.hpp. Deliberately free of any Windows dependency (char16_t instead of wchar_t) so
+// its output can be verified against the OS converters on any platform.
+//
+namespace nefarius::utilities::transcode
+{
+	/**
+	 * Instruction set a transcoding kernel is implemented with.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 */
+	enum class Kernel
+	{
+		///< Pick the widest kernel the running CPU supports
+		Auto,
+		///< Plain C++, available everywhere
+		Scalar,
+		///< 128-bit x86/x64 kernel
+		SSE2,
+		///< 256-bit x86/x64 kernel
+		AVX2,
+		///< 128-bit ARM64 kernel
+		NEON
+	};
+
+	/**
+	 * Checks whether a given kernel can run on this build and CPU.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Kernel	The kernel to check.
+	 *
+	 * @returns	True if SelectKernel would accept it, false otherwise.
+	 */
+	bool IsKernelSupported(Kernel Kernel);
+
+	/**
+	 * Switches the process-wide kernel used by every conversion. Safe to call concurrently with
+	 * running conversions; each conversion call sticks with whatever kernel it started with.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Kernel	The kernel to use, Kernel::Auto to pick the best available.
+	 *
+	 * @returns	False (leaving the current selection untouched) if the kernel isn't supported.
+	 */
+	bool SelectKernel(Kernel Kernel);
+
+	/**
+	 * Gets the kernel currently in use, never Kernel::Auto.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @returns	The active kernel.
+	 */
+	Kernel GetActiveKernel();
+
+	///< Number of leading code units below 0x80
+	size_t CountAsciiPrefix(const char16_t* Source, size_t Length);
+
+	///< Number of leading bytes below 0x80
+	size_t CountAsciiPrefix(const char* Source, size_t Length);
+
+	///< Narrows the longest pure-ASCII prefix of Source into Destination, returns its length.
+	///< Never writes past the returned length.
+	size_t NarrowAsciiPrefix(const char16_t* Source, size_t Length, char* Destination);
+
+	///< Widens the longest pure-ASCII prefix of Source into Destination, returns its length.
+	///< Never writes past the returned length.
+	size_t WidenAsciiPrefix(const char* Source, size_t Length, char16_t* Destination);
+
+	///< Exact number of UTF-8 bytes Utf16ToUtf8 produces for Source
+	size_t Utf8LengthFromUtf16(const char16_t* Source, size_t Length);
+
+	///< Exact number of UTF-16 code units Utf8ToUtf16 produces for Source
+	size_t Utf16LengthFromUtf8(const char* Source, size_t Length);
+
+	///< Converts UTF-16 to UTF-8, replacing unpaired surrogates with U+FFFD like
+	///< WideCharToMultiByte(CP_UTF8, 0, ...) does. Destination must hold at least
+	///< Utf8LengthFromUtf16(Source, Length) bytes. Returns the number of bytes written.
+	size_t Utf16ToUtf8(const char16_t* Source, size_t Length, char* Destination);
+
+	///< Converts UTF-8 to UTF-16, replacing each maximal invalid subsequence with U+FFFD like
+	///< MultiByteToWideChar(CP_UTF8, 0, ...) does. Destination must hold at least
+	///< Utf16LengthFromUtf8(Source, Length) code units. Returns the number of units written.
+	size_t Utf8ToUtf16(const char* Source, size_t Length, char16_t* Destination);
+
+	//
+	// UTF-32 counterparts for platforms where wchar_t is 32 bits wide (glibc, most Unixes), so
+	// UniUtil.hpp works there too. Only the ASCII scan of UTF-8 input is vectorized. Surrogates
+	// and values above U+10FFFF are replaced with U+FFFD.
+	//
+
+	///< Number of leading code units below 0x80
+	size_t CountAsciiPrefix(const char32_t* Source, size_t Length);
+
+	///< Narrows the longest pure-ASCII prefix of Source into Destination, returns its length.
+	///< Never writes past the returned length.
+	size_t NarrowAsciiPrefix(const char32_t* Source, size_t Length, char* Destination);
+
+	///< Widens the longest pure-ASCII prefix of Source into Destination, returns its length.
+	///< Never writes past the returned length.
+	size_t WidenAsciiPrefix(const char* Source, size_t Length, char32_t* Destination);
+
+	///< Exact number of UTF-8 bytes Utf32ToUtf8 produces for Source
+	size_t Utf8LengthFromUtf32(const char32_t* Source, size_t Length);
+
+	///< Exact number of UTF-32 code units Utf8ToUtf32 produces for Source
+	size_t Utf32LengthFromUtf8(const char* Source, size_t Length);
+
+	///< Converts UTF-32 to UTF-8. Destination must hold at least Utf8LengthFromUtf32(Source,
+	///< Length) bytes. Returns the number of bytes written.
+	size_t Utf32ToUtf8(const char32_t* Source, size_t Length, char* Destination);
+
+	///< Converts UTF-8 to UTF-32, replacing each maximal invalid subsequence with U+FFFD like
+	///< Utf8ToUtf16 does. Destination must hold at least Utf32LengthFromUtf8(Source, Length)
+	///< code units. Returns the number of units written.
+	size_t Utf8ToUtf32(const char* Source, size_t Length, char32_t* Destination);
+}
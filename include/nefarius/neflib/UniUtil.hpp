@@ -1,6 +1,13 @@
 // ReSharper disable CppRedundantQualifier
 #pragma once
 
+#include <algorithm>
+#include <iterator>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
 #include <nefarius/neflib/AnyString.hpp>
 
 namespace nefarius::utilities
@@ -9,6 +16,135 @@ namespace nefarius::utilities
 
 	std::wstring ConvertAnsiToWide(const std::string& narrow);
 
+	/**
+	 * Converts a wide string into a caller-provided buffer without allocating. The output is not
+	 * NUL-terminated.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Input 	The wide string to convert.
+	 * @param 	Output	The buffer to convert into.
+	 *
+	 * @returns	The number of chars the full conversion requires. If this is larger than
+	 * 			Output.size() the content of Output is unspecified; grow it and call again.
+	 */
+	size_t ConvertToNarrow(std::wstring_view Input, std::span<char> Output);
+
+	/**
+	 * Converts a narrow string into a caller-provided buffer without allocating. The output is not
+	 * NUL-terminated.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Input 	The narrow string to convert.
+	 * @param 	Output	The buffer to convert into.
+	 *
+	 * @returns	The number of wchar_ts the full conversion requires. If this is larger than
+	 * 			Output.size() the content of Output is unspecified; grow it and call again.
+	 */
+	size_t ConvertToWide(std::string_view Input, std::span<wchar_t> Output);
+
+	/**
+	 * Appends the narrow conversion of Input to Output, reusing its capacity. Clearing and
+	 * re-appending to the same string lets a loop convert without allocating once the string
+	 * has grown to the longest input seen.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param [in,out]	Output	The string to append to.
+	 * @param 		  	Input 	The wide string to convert.
+	 *
+	 * @returns	Output.
+	 */
+	std::string& AppendNarrow(std::string& Output, std::wstring_view Input);
+
+	/**
+	 * Appends the wide conversion of Input to Output, reusing its capacity.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param [in,out]	Output	The string to append to.
+	 * @param 		  	Input 	The narrow string to convert.
+	 *
+	 * @returns	Output.
+	 */
+	std::wstring& AppendWide(std::wstring& Output, std::string_view Input);
+
+	namespace detail
+	{
+		//
+		// Converts into a per-thread scratch buffer; the returned view stays valid until the
+		// next call on the same thread.
+		//
+		std::string_view ConvertToNarrowScratch(std::wstring_view Input);
+
+		std::wstring_view ConvertToWideScratch(std::string_view Input);
+	}
+
+	/**
+	 * Converts a wide string and writes the result through an output iterator, e.g. a
+	 * std::back_inserter or a raw pointer, using a per-thread scratch buffer.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Input 	The wide string to convert.
+	 * @param 	Output	The output iterator.
+	 *
+	 * @returns	The output iterator past the last written char.
+	 */
+	template <std::output_iterator<char> OutputIt>
+	OutputIt ConvertToNarrow(std::wstring_view Input, OutputIt Output)
+	{
+		const auto converted = nefarius::utilities::detail::ConvertToNarrowScratch(Input);
+		return std::copy(converted.begin(), converted.end(), Output);
+	}
+
+	/**
+	 * Converts a narrow string and writes the result through an output iterator, using a
+	 * per-thread scratch buffer.
+	 *
+	 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+	 * @date	16.10.2026
+	 *
+	 * @param 	Input 	The narrow string to convert.
+	 * @param 	Output	The output iterator.
+	 *
+	 * @returns	The output iterator past the last written wchar_t.
+	 */
+	template <std::output_iterator<wchar_t> OutputIt>
+	OutputIt ConvertToWide(std::string_view Input, OutputIt Output)
+	{
+		const auto converted = nefarius::utilities::detail::ConvertToWideScratch(Input);
+		return std::copy(converted.begin(), converted.end(), Output);
+	}
+
+	inline std::string ConvertToNarrow(std::wstring_view Input)
+	{
+		std::string result;
+		return std::move(nefarius::utilities::AppendNarrow(result, Input));
+	}
+
+	inline std::string ConvertToNarrow(std::string_view Input)
+	{
+		return std::string(Input);
+	}
+
+	inline std::wstring ConvertToWide(std::string_view Input)
+	{
+		std::wstring result;
+		return std::move(nefarius::utilities::AppendWide(result, Input));
+	}
+
+	inline std::wstring ConvertToWide(std::wstring_view Input)
+	{
+		return std::wstring(Input);
+	}
+
 	template <nefarius::utilities::string_type StringType>
 	std::string ConvertToNarrow(const StringType& str)
 	{
@@ -22,7 +158,7 @@ namespace nefarius::utilities
 		}
 		else
 		{
-			static_assert(false, "Not a string type");
+			static_assert(nefarius::utilities::detail::AlwaysFalse<StringType>, "Not a string type");
 		}
 
 		return {};
@@ -41,7 +177,7 @@ namespace nefarius::utilities
 		}
 		else
 		{
-			static_assert(false, "Not a string type");
+			static_assert(nefarius::utilities::detail::AlwaysFalse<StringType>, "Not a string type");
 		}
 
 		return {};
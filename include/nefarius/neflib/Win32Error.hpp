@@ -25,24 +25,17 @@ namespace nefarius::utilities
 			return errorCode;
 		}
 
-		[[nodiscard]] std::string getErrorMessageA() const
+		[[nodiscard]] const std::string& getAdditionalMessage() const
 		{
-			char* messageBuffer = nullptr;
-			size_t messageSize = FormatMessageA(
-				FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-				NULL,
-				errorCode,
-				MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-				(LPSTR)&messageBuffer,
-				0,
-				NULL
-			);
+			return additionalMessage;
+		}
 
-			std::string message(messageBuffer, messageSize);
-			LocalFree(messageBuffer);
+		[[nodiscard]] std::string getErrorMessageA() const
+		{
+			const std::string_view message = SystemMessageA(errorCode);
 
 			if (additionalMessage.empty())
-				return message;
+				return std::string(message);
 
 			return std::format(
 				"{} failed with error: {} ({})",
@@ -54,33 +47,92 @@ namespace nefarius::utilities
 
 		[[nodiscard]] std::wstring getErrorMessageW() const
 		{
-			wchar_t* messageBuffer = nullptr;
-			size_t messageSize = FormatMessageW(
-				FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-				NULL,
-				errorCode,
-				MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT),
-				(LPWSTR)&messageBuffer,
-				0,
-				NULL
-			);
-
-			std::wstring message(messageBuffer, messageSize);
-			LocalFree(messageBuffer);
+			const std::wstring_view message = SystemMessageW(errorCode);
 
 			if (additionalMessage.empty())
-				return message;
+				return std::wstring(message);
 
-			return ConvertAnsiToWide(std::format(
-				"{} failed with error: {} ({})",
-				additionalMessage,
-				ConvertWideToANSI(message),
-				errorCode
-			));
+			std::wstring result;
+			ConvertToWide(std::string_view(additionalMessage), std::back_inserter(result));
+			std::format_to(std::back_inserter(result), L" failed with error: {} ({})", message, errorCode);
+
+			return result;
 		}
 
+		/**
+		 * Gets the system message text of an error code. Messages are formatted once per code and
+		 * language and served from a process-wide cache afterwards; codes the system has no text
+		 * for (e.g. SetupAPI errors) fall back to the built-in catalog (see ErrorCatalog.hpp).
+		 *
+		 * @author	Benjamin "Nefarius" Hoeglinger-Stelzer
+		 * @date	16.10.2026
+		 *
+		 * @param 	ErrorCode	The Win32 error code.
+		 * @param 	Language 	The message language.
+		 *
+		 * @returns	The message, valid for the lifetime of the process; empty if unknown.
+		 */
+		static std::string_view SystemMessageA(DWORD ErrorCode,
+		                                       LANGID Language = MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT));
+
+		///< Wide version of SystemMessageA, formatted natively without an ANSI round-trip
+		static std::wstring_view SystemMessageW(DWORD ErrorCode,
+		                                        LANGID Language = MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT));
+
 	private:
 		DWORD errorCode;
 		std::string additionalMessage;
 	};
 }
+
+//
+// Formats like getErrorMessageA/W, but writes straight into the output without building the
+// message string first, e.g. std::format("{}", error) or std::format(L"{}", error)
+//
+template <typename CharT>
+struct std::formatter<nefarius::utilities::Win32Error, CharT>
+{
+	constexpr auto parse(std::basic_format_parse_context<CharT>& Context)
+	{
+		const auto it = Context.begin();
+
+		if (it != Context.end() && *it != CharT('}'))
+		{
+			throw std::format_error("Win32Error does not support format specifiers");
+		}
+
+		return it;
+	}
+
+	template <typename FormatContext>
+	auto format(const nefarius::utilities::Win32Error& Error, FormatContext& Context) const
+	{
+		auto out = Context.out();
+		const auto& additionalMessage = Error.getAdditionalMessage();
+
+		if constexpr (std::is_same_v<CharT, wchar_t>)
+		{
+			const auto message = nefarius::utilities::Win32Error::SystemMessageW(Error.getErrorCode());
+
+			if (additionalMessage.empty())
+			{
+				return std::ranges::copy(message, out).out;
+			}
+
+			out = nefarius::utilities::ConvertToWide(std::string_view(additionalMessage), out);
+			return std::format_to(out, L" failed with error: {} ({})", message, Error.getErrorCode());
+		}
+		else
+		{
+			const auto message = nefarius::utilities::Win32Error::SystemMessageA(Error.getErrorCode());
+
+			if (additionalMessage.empty())
+			{
+				return std::ranges::copy(message, out).out;
+			}
+
+			return std::format_to(out, "{} failed with error: {} ({})", additionalMessage, message,
+			                      Error.getErrorCode());
+		}
+	}
+};
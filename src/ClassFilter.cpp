@@ -11,55 +11,14 @@ namespace
 	// LowerFilters entries must be compared the same way, or a filter registered as e.g.
 	// "keyboardcaster" can never be found/removed by a caller passing "KeyboardCaster".
 	//
-	// CompareStringOrdinal (with bIgnoreCase) is used instead of _wcsicmp because the latter's
-	// case mapping depends on the current C locale, which can behave inconsistently across
-	// processes/locales for non-ASCII characters. CompareStringOrdinal performs a fast,
-	// locale-invariant ordinal comparison, which is the recommended approach for non-linguistic
-	// identifiers like these.
+	// Simple case folding is used instead of _wcsicmp because the latter's case mapping depends
+	// on the current C locale, which can behave inconsistently across processes/locales for
+	// non-ASCII characters. It's the same locale-invariant comparison MultiStringSet and
+	// MultiStringArray::dedupe_case_insensitive use, so lookups and edits always agree.
 	// 
-	bool EqualsIgnoreCase(const std::wstring& lhs, const wchar_t* rhs)
+	bool EqualsIgnoreCase(std::wstring_view lhs, std::wstring_view rhs)
 	{
-		return CompareStringOrdinal(lhs.c_str(), -1, rhs, -1, TRUE) == CSTR_EQUAL;
-	}
-
-	// Helper function to build a multi-string from a vector<wstring>
-	std::vector<wchar_t> BuildMultiString(const std::vector<std::wstring>& data)
-	{
-		// Special case of the empty multi-string
-		if (data.empty())
-		{
-			// Build a vector containing just two NULs
-			return std::vector(2, L'\0');
-		}
-
-		// Get the total length in wchar_ts of the multi-string
-		size_t totalLen = 0;
-		for (const auto& s : data)
-		{
-			// Add one to current string's length for the terminating NUL
-			totalLen += (s.length() + 1);
-		}
-
-		// Add one for the last NUL terminator (making the whole structure double-NUL terminated)
-		totalLen++;
-
-		// Allocate a buffer to store the multi-string
-		std::vector<wchar_t> multiString;
-		multiString.reserve(totalLen);
-
-		// Copy the single strings into the multi-string
-		for (const auto& s : data)
-		{
-			multiString.insert(multiString.end(), s.begin(), s.end());
-
-			// Don't forget to NUL-terminate the current string
-			multiString.push_back(L'\0');
-		}
-
-		// Add the last NUL-terminator
-		multiString.push_back(L'\0');
-
-		return multiString;
+		return casefold::EqualsIgnoreCase(lhs, rhs);
 	}
 }
 
@@ -79,7 +38,6 @@ std::expected<void, Win32Error> nefarius::devcon::AddDeviceClassFilter(const GUI
 
 	LPCWSTR filterValue = (Position == DeviceClassFilterPosition::Lower) ? L"LowerFilters" : L"UpperFilters";
 	DWORD type, size;
-	std::vector<std::wstring> filters;
 
 	auto status = RegQueryValueExW(
 		key.get(),
@@ -95,14 +53,14 @@ std::expected<void, Win32Error> nefarius::devcon::AddDeviceClassFilter(const GUI
 	// 
 	if (status == ERROR_SUCCESS)
 	{
-		std::vector<wchar_t> temp(size / sizeof(wchar_t));
+		WideMultiStringArray filters(size / sizeof(wchar_t));
 
 		status = RegQueryValueExW(
 			key.get(),
 			filterValue,
 			nullptr,
 			&type,
-			reinterpret_cast<LPBYTE>(temp.data()),
+			filters.data(),
 			&size
 		);
 
@@ -111,39 +69,28 @@ std::expected<void, Win32Error> nefarius::devcon::AddDeviceClassFilter(const GUI
 			return std::unexpected(Win32Error(status, "RegQueryValueExW"));
 		}
 
-		size_t index = 0;
-		size_t len = wcslen(temp.data());
-		while (len > 0)
-		{
-			filters.emplace_back(&temp[index]);
-			index += len + 1;
-			len = wcslen(&temp[index]);
-		}
-
-		//
-		// Filter not there yet, add
-		// 
-		const bool alreadyPresent = std::ranges::any_of(filters, [&filterName](const std::wstring& existing)
+		const bool alreadyPresent = std::ranges::any_of(filters.view(), [&filterName](std::wstring_view entry)
 		{
-			return ::EqualsIgnoreCase(filterName, existing.c_str());
+			return ::EqualsIgnoreCase(filterName, entry);
 		});
 
-		if (!alreadyPresent)
+		if (alreadyPresent)
 		{
-			filters.emplace_back(filterName);
+			return {};
 		}
 
-		const std::vector<wchar_t> multiString = ::BuildMultiString(filters);
-
-		const DWORD dataSize = static_cast<DWORD>(multiString.size() * sizeof(wchar_t));
+		//
+		// Filter not there yet, add
+		// 
+		filters.push_back(filterName);
 
 		status = RegSetValueExW(
 			key.get(),
 			filterValue,
 			0, // reserved
 			REG_MULTI_SZ,
-			reinterpret_cast<const BYTE*>(multiString.data()),
-			dataSize
+			filters.data(),
+			static_cast<DWORD>(filters.size())
 		);
 
 		if (status != ERROR_SUCCESS)
@@ -158,19 +105,15 @@ std::expected<void, Win32Error> nefarius::devcon::AddDeviceClassFilter(const GUI
 	// 
 	if (status == ERROR_FILE_NOT_FOUND)
 	{
-		filters.emplace_back(filterName);
-
-		const std::vector<wchar_t> multiString = ::BuildMultiString(filters);
-
-		const DWORD dataSize = static_cast<DWORD>(multiString.size() * sizeof(wchar_t));
+		const WideMultiStringArray filters(filterName);
 
 		status = RegSetValueExW(
 			key.get(),
 			filterValue,
 			0, // reserved
 			REG_MULTI_SZ,
-			reinterpret_cast<const BYTE*>(multiString.data()),
-			dataSize
+			filters.data(),
+			static_cast<DWORD>(filters.size())
 		);
 
 		if (status != ERROR_SUCCESS)
@@ -215,15 +158,14 @@ std::expected<void, Win32Error> nefarius::devcon::RemoveDeviceClassFilter(
 	// 
 	if (status == ERROR_SUCCESS)
 	{
-		std::vector<std::wstring> filters;
-		std::vector<wchar_t> temp(size / sizeof(wchar_t));
+		WideMultiStringArray filters(size / sizeof(wchar_t));
 
 		status = RegQueryValueExW(
 			key.get(),
 			filterValue,
 			nullptr,
 			&type,
-			reinterpret_cast<LPBYTE>(temp.data()),
+			filters.data(),
 			&size
 		);
 
@@ -235,29 +177,23 @@ std::expected<void, Win32Error> nefarius::devcon::RemoveDeviceClassFilter(
 		//
 		// Remove value, if found
 		//
-		size_t index = 0;
-		size_t len = wcslen(temp.data());
-		while (len > 0)
+		const size_t removed = filters.erase_if([&filterName](std::wstring_view entry)
 		{
-			if (!::EqualsIgnoreCase(filterName, &temp[index]))
-			{
-				filters.emplace_back(&temp[index]);
-			}
-			index += len + 1;
-			len = wcslen(&temp[index]);
-		}
-
-		const std::vector<wchar_t> multiString = ::BuildMultiString(filters);
+			return ::EqualsIgnoreCase(filterName, entry);
+		});
 
-		const DWORD dataSize = static_cast<DWORD>(multiString.size() * sizeof(wchar_t));
+		if (removed == 0)
+		{
+			return {};
+		}
 
 		status = RegSetValueExW(
 			key.get(),
 			filterValue,
 			0, // reserved
 			REG_MULTI_SZ,
-			reinterpret_cast<const BYTE*>(multiString.data()),
-			dataSize
+			filters.data(),
+			static_cast<DWORD>(filters.size())
 		);
 
 		if (status != ERROR_SUCCESS)
@@ -329,19 +265,11 @@ std::expected<bool, Win32Error> nefarius::devcon::HasDeviceClassFilter(const GUI
 		//
 		// Enumerate values
 		//
-		size_t index = 0;
-		size_t len = wcslen(temp.data());
-		while (len > 0)
-		{
-			if (::EqualsIgnoreCase(filterName, &temp[index]))
-			{
-				return true;
-			}
-			index += len + 1;
-			len = wcslen(&temp[index]);
-		}
-
-		return false;
+		return std::ranges::any_of(WideMultiStringView::from_bytes(temp.data(), size),
+		                           [&filterName](std::wstring_view entry)
+		                           {
+			                           return ::EqualsIgnoreCase(filterName, entry);
+		                           });
 	}
 	//
 	// Value doesn't exist, return
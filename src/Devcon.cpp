@@ -6,77 +6,31 @@
 #include <nefarius/neflib/Devcon.hpp>
 #include <nefarius/neflib/GenHandleGuard.hpp>
 
+#include "PropertyScratch.hpp"
+
 
 using namespace nefarius::utilities;
 
 namespace
 {
-	struct DeviceRegistryPropertyResult
-	{
-		wil::unique_hlocal_ptr<uint8_t[]> Data;
-
-		size_t Length;
-
-		DWORD DataType;
-	};
-
-	std::expected<DeviceRegistryPropertyResult, Win32Error> GetDeviceRegistryProperty(
+	//
+	// Reads a SPDRP_* property into the calling thread's scratch buffer, see PropertyScratch.hpp
+	// 
+	std::expected<nefarius::devcon::detail::PropertyView, Win32Error> GetDeviceRegistryProperty(
 		_In_ HDEVINFO DeviceInfoSet,
 		_In_ PSP_DEVINFO_DATA DeviceInfoData,
 		_In_ DWORD Property
 	)
 	{
-		DWORD sizeRequired = 0;
-		DWORD propertyRegDataType;
-
-		//
-		// Query required size
-		// 
-		(void)SetupDiGetDeviceRegistryPropertyW(DeviceInfoSet,
-		                                        DeviceInfoData,
-		                                        Property,
-		                                        &propertyRegDataType,
-		                                        NULL,
-		                                        0,
-		                                        &sizeRequired);
-
-		DWORD win32Error = GetLastError();
+		auto value = nefarius::devcon::detail::ReadDeviceRegistryProperty(DeviceInfoSet, DeviceInfoData, Property);
 
-		//
-		// Property doesn't exist
-		// 
-		if (win32Error == ERROR_INVALID_DATA)
-		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND, "SetupDiGetDeviceRegistryPropertyW"));
-		}
-
-		//
-		// Unexpected status other than required size
-		// 
-		if (win32Error != ERROR_INSUFFICIENT_BUFFER)
-		{
-			return std::unexpected(Win32Error(win32Error, "SetupDiGetDeviceRegistryPropertyW"));
-		}
-
-		auto buffer = wil::make_unique_hlocal_nothrow<uint8_t[]>(sizeRequired);
-
-		//
-		// Query property value
-		// 
-		if (!SetupDiGetDeviceRegistryPropertyW(DeviceInfoSet,
-		                                       DeviceInfoData,
-		                                       Property,
-		                                       &propertyRegDataType,
-		                                       buffer.get(),
-		                                       sizeRequired,
-		                                       &sizeRequired))
+		if (!value)
 		{
-			win32Error = GetLastError();
-			buffer.release();
-			return std::unexpected(Win32Error(win32Error, "SetupDiGetDeviceRegistryPropertyW"));
+			return std::unexpected(Win32Error(static_cast<DWORD>(value.error().value()),
+			                                  "SetupDiGetDeviceRegistryPropertyW"));
 		}
 
-		return DeviceRegistryPropertyResult{std::move(buffer), sizeRequired, propertyRegDataType};
+		return value.value();
 	}
 
 	DWORD Win32FromHResult(HRESULT hr)
@@ -96,149 +50,135 @@ namespace
 		return ERROR_CAN_NOT_COMPLETE;
 	}
 
-	PWSTR wstristr(PCWSTR haystack, PCWSTR needle)
+	//
+	// Lightweight identity used to match an original INF against a driver store copy without
+	// needing to guess at the published oemNN.inf naming scheme.
+	// 
+	struct DriverStoreIdentity
 	{
-		do
-		{
-			PCWSTR h = haystack;
-			PCWSTR n = needle;
-			while (towlower(*h) == towlower(*n) && *n)
-			{
-				h++;
-				n++;
-			}
-			if (*n == 0)
-			{
-				return (PWSTR)haystack;
-			}
-		}
-		while (*haystack++);
-		return nullptr;
-	}
+		std::wstring Provider;
+		std::wstring DriverVer;
+	};
 
 	//
-	// Reads a single string field from an INF's [Version] section (e.g. "Provider", "DriverVer"),
-	// used to build a lightweight identity for matching an original INF against its published
-	// copy inside the driver store. Returns std::nullopt if the key isn't present rather than an
-	// error, since not every INF sets every field.
+	// Reads the identity from the [Version] section; DriverVer is only its first field (the date).
+	// Values are views into the parsed file, so only the two strings kept get allocated.
 	//
-	std::optional<std::wstring> ReadInfVersionField(HINF hInf, PCWSTR key)
+	std::optional<DriverStoreIdentity> ReadDriverStoreIdentity(PCWSTR infPath)
 	{
-		INFCONTEXT ctx;
-
-		if (!SetupFindFirstLineW(hInf, L"Version", key, &ctx))
-		{
-			return std::nullopt;
-		}
-
-		DWORD required = 0;
-		SetupGetStringFieldW(&ctx, 1, nullptr, 0, &required);
+		const auto file = nefarius::devcon::inf::InfFile::Open(infPath);
 
-		if (required == 0)
+		if (!file)
 		{
 			return std::nullopt;
 		}
 
-		std::wstring value(required, L'\0');
+		const auto provider = file->value(u"Version", u"Provider");
+		const auto driverVer = file->value(u"Version", u"DriverVer");
 
-		if (!SetupGetStringFieldW(&ctx, 1, value.data(), required, nullptr))
+		if (!provider || !driverVer || provider->empty() || driverVer->empty())
 		{
 			return std::nullopt;
 		}
 
-		//
-		// SetupGetStringFieldW's required size includes the NUL terminator.
-		// 
-		if (!value.empty() && value.back() == L'\0')
-		{
-			value.pop_back();
-		}
-
-		return value;
+		return DriverStoreIdentity{
+			std::wstring(nefarius::devcon::inf::AsWide(*provider)),
+			std::wstring(nefarius::devcon::inf::AsWide(*driverVer))
+		};
 	}
 
 	//
-	// Lightweight identity used to match an original INF against a driver store copy without
-	// needing to guess at the published oemNN.inf naming scheme.
-	// 
-	struct DriverStoreIdentity
-	{
-		std::wstring Provider;
-		std::wstring DriverVer;
-	};
-
-	std::optional<DriverStoreIdentity> ReadDriverStoreIdentity(PCWSTR infPath)
+	// Same identity taken from the cached analysis
+	//
+	std::optional<DriverStoreIdentity> ReadDriverStoreIdentity(PCWSTR infPath,
+	                                                           nefarius::devcon::inf::InfMetadataCache* cache)
 	{
-		guards::INFHandleGuard hInf(SetupOpenInfFileW(infPath, nullptr, INF_STYLE_WIN4, nullptr));
-
-		if (hInf.is_invalid())
+		if (!cache)
 		{
-			return std::nullopt;
+			return ::ReadDriverStoreIdentity(infPath);
 		}
 
-		auto provider = ::ReadInfVersionField(hInf.get(), L"Provider");
-		auto driverVer = ::ReadInfVersionField(hInf.get(), L"DriverVer");
+		const auto analysis = cache->lookup(infPath);
 
-		if (!provider || !driverVer || provider->empty() || driverVer->empty())
+		if (!analysis || analysis->Provider.empty() || analysis->DriverDate.empty())
 		{
 			return std::nullopt;
 		}
 
-		return DriverStoreIdentity{std::move(*provider), std::move(*driverVer)};
+		return DriverStoreIdentity{
+			std::wstring(nefarius::devcon::inf::AsWide(analysis->Provider)),
+			std::wstring(nefarius::devcon::inf::AsWide(analysis->DriverDate))
+		};
 	}
 
 	bool IdentitiesMatch(const DriverStoreIdentity& a, const DriverStoreIdentity& b)
 	{
-		return _wcsicmp(a.Provider.c_str(), b.Provider.c_str()) == 0 &&
-			_wcsicmp(a.DriverVer.c_str(), b.DriverVer.c_str()) == 0;
+		return casefold::EqualsIgnoreCase(a.Provider, b.Provider) &&
+			casefold::EqualsIgnoreCase(a.DriverVer, b.DriverVer);
+	}
+
+	std::error_code Win32ErrorToErrorCode(const Win32Error& error)
+	{
+		return {static_cast<int>(error.getErrorCode()), std::system_category()};
 	}
 
 	//
-	// Collects every non-inbox package while DriverStoreOfflineEnumDriverPackageW enumerates the
-	// driver store; always returns 1 (continue) since a full inventory is wanted regardless of
-	// what has been found so far.
+	// Hands every package DriverStoreOfflineEnumDriverPackageW reports that passes the filter to
+	// the caller as views into drvstore.dll's buffers; returning 0 ends the enumeration early.
 	// 
-	struct EnumCollectContext
+	struct EnumVisitContext
 	{
-		std::vector<nefarius::devcon::DriverStorePackage> Packages;
+		const nefarius::devcon::DriverStorePackageCallback* Callback;
+		const nefarius::devcon::DriverStorePackageFilter* Filter;
+		bool Stopped = false;
+		std::exception_ptr Exception;
 	};
 
-	int WINAPI EnumCollectCallback(PCWSTR driverPackageInfPath, PVOID enumInfoPtr, PVOID context)
+	int WINAPI EnumVisitCallback(PCWSTR driverPackageInfPath, PVOID enumInfoPtr, PVOID context)
 	{
 		if (!enumInfoPtr || !driverPackageInfPath)
 		{
 			return 0;
 		}
 
-		auto* ctx = static_cast<EnumCollectContext*>(context);
+		auto* ctx = static_cast<EnumVisitContext*>(context);
 		const auto* info = static_cast<const nefarius::utilities::DriverStoreOfflineEnumDriverPackageInfoW*>(
 			enumInfoPtr);
 
-		if (info->InboxInf == 0)
+		const nefarius::devcon::DriverStorePackageView package{
+			driverPackageInfPath,
+			std::wstring_view(info->PublishedInfName,
+			                  wcsnlen(info->PublishedInfName, std::size(info->PublishedInfName))),
+			info->InboxInf != 0,
+			info->ProcessorArchitecture,
+			std::wstring_view(info->LocaleName, wcsnlen(info->LocaleName, std::size(info->LocaleName)))
+		};
+
+		if (!ctx->Filter->matches(package))
 		{
-			try
+			return 1;
+		}
+
+		try
+		{
+			if ((*ctx->Callback)(package))
 			{
-				nefarius::devcon::DriverStorePackage package;
-				package.DriverPackageInfPath = driverPackageInfPath;
-				package.PublishedInfName = std::wstring(info->PublishedInfName,
-					wcsnlen(info->PublishedInfName, std::size(info->PublishedInfName)));
-				package.IsInbox = false;
-				package.ProcessorArchitecture = info->ProcessorArchitecture;
-				package.LocaleName = std::wstring(info->LocaleName,
-					wcsnlen(info->LocaleName, std::size(info->LocaleName)));
-				ctx->Packages.push_back(std::move(package));
-			}
-			catch (const std::bad_alloc&)
-			{
-				//
-				// This callback is invoked directly by drvstore.dll across a C ABI boundary; a
-				// C++ exception must never be allowed to propagate through it.
-				// 
-				return 0;
+				return 1;
 			}
+
+			ctx->Stopped = true;
+		}
+		catch (...)
+		{
+			//
+			// This callback is invoked directly by drvstore.dll across a C ABI boundary; a C++
+			// exception must never be allowed to propagate through it, so it's carried over and
+			// rethrown once the enumeration has returned.
+			// 
+			ctx->Exception = std::current_exception();
 		}
 
-		return 1;
+		return 0;
 	}
 
 	Win32Error NtStatusToWin32Error(const nefarius::utilities::DrvStore& drvStore, LONG status, const char* context)
@@ -499,11 +439,231 @@ namespace
 
 		return IDCANCEL; // equivalent to the user clicking "Restart Later"
 	}
+
+	std::expected<std::wstring, Win32Error> NormaliseInfPath(const std::wstring& fullInfPath)
+	{
+		WCHAR normalisedInfPath[MAX_PATH] = {};
+
+		if (const auto ret = GetFullPathNameW(fullInfPath.c_str(), MAX_PATH, normalisedInfPath, nullptr);
+			(ret >= MAX_PATH) || (ret == FALSE))
+		{
+			return std::unexpected(Win32Error(ERROR_BAD_PATHNAME));
+		}
+
+		return std::wstring(normalisedInfPath);
+	}
+
+	//
+	// Used when the package can't be identified in the store; doesn't require identifying the
+	// store package up front, but (unlike DeleteDriverStorePackage) will also uninstall any device
+	// still actively using this driver.
+	//
+	std::expected<void, Win32Error> UninstallDriverByInf(PCWSTR normalisedInfPath, bool* rebootRequired,
+	                                                    const std::optional<Win32Error>& previousError = std::nullopt)
+	{
+		Newdev newdev;
+		BOOL reboot = FALSE;
+
+		switch (newdev.CallFunction(newdev.fpDiUninstallDriverW, nullptr, normalisedInfPath, 0, &reboot))
+		{
+		case FunctionCallResult::NotAvailable:
+			return std::unexpected(Win32Error(ERROR_INVALID_FUNCTION, "DiUninstallDriverW"));
+		case FunctionCallResult::Failure:
+			if (previousError)
+			{
+				return std::unexpected(Win32Error(previousError->getErrorCode(),
+					std::format("DiUninstallDriverW (after {})",
+						previousError->getErrorMessageA())));
+			}
+			return std::unexpected(Win32Error("DiUninstallDriverW"));
+		case FunctionCallResult::Success:
+			if (rebootRequired)
+			{
+				*rebootRequired = reboot > 0;
+			}
+			return {};
+		}
+
+		return std::unexpected(Win32Error(ERROR_INTERNAL_ERROR));
+	}
+
+	//
+	// Deletes an identified store package via the drvstore.dll offline delete API, falling back to
+	// SetupUninstallOEMInfW. On failure, the offline delete error is preferred over the one of the
+	// fallback, as the more telling one.
+	//
+	std::expected<void, Win32Error> DeleteFromDriverStore(const nefarius::devcon::DriverStorePackage& package)
+	{
+		nefarius::utilities::DrvStore drvStore;
+		std::optional<Win32Error> driverStoreDeleteError;
+
+		if (drvStore.fpDriverStoreOfflineDeleteDriverPackageW)
+		{
+			WCHAR windowsDirectory[MAX_PATH] = {};
+
+			if (GetWindowsDirectoryW(windowsDirectory, MAX_PATH) != 0)
+			{
+				std::wstring driveRoot(windowsDirectory);
+
+				if (driveRoot.size() > 3)
+				{
+					driveRoot.resize(3);
+				}
+
+				const LONG status = drvStore.fpDriverStoreOfflineDeleteDriverPackageW(
+					package.DriverPackageInfPath.c_str(), 0, nullptr, windowsDirectory, driveRoot.c_str());
+
+				if (status >= 0)
+				{
+					return {};
+				}
+
+				//
+				// Fall through to SetupUninstallOEMInfW below, reusing the published name
+				// already resolved by the enumeration. Keep the original failure around in case
+				// every fallback also fails, so it isn't lost behind a possibly-unrelated
+				// GetLastError() from a later API.
+				// 
+				driverStoreDeleteError = ::NtStatusToWin32Error(
+					drvStore, status, "DriverStoreOfflineDeleteDriverPackageW");
+			}
+		}
+
+		if (!package.PublishedInfName.empty() &&
+			SetupUninstallOEMInfW(package.PublishedInfName.c_str(), SUOI_FORCEDELETE, nullptr))
+		{
+			return {};
+		}
+
+		if (driverStoreDeleteError)
+		{
+			return std::unexpected(std::move(*driverStoreDeleteError));
+		}
+
+		return std::unexpected(package.PublishedInfName.empty()
+			                       ? Win32Error(ERROR_INVALID_FUNCTION, "DriverStoreOfflineDeleteDriverPackageW")
+			                       : Win32Error("SetupUninstallOEMInfW"));
+	}
+
+	//
+	// DeleteFromDriverStore, with DiUninstallDriverW on the original INF as the last resort.
+	//
+	std::expected<void, Win32Error> DeleteDriverStorePackage(
+		const nefarius::devcon::DriverStorePackage& package, PCWSTR normalisedInfPath, bool* rebootRequired)
+	{
+		auto deleted = ::DeleteFromDriverStore(package);
+
+		if (deleted)
+		{
+			return {};
+		}
+
+		return ::UninstallDriverByInf(normalisedInfPath, rebootRequired, deleted.error());
+	}
+
+	//
+	// Shared by both RemoveDriverStorePackage flavours; with a cache, the [Version] identities of the
+	// target and every store candidate come from it instead of being parsed by SetupAPI each call.
+	//
+	std::expected<void, Win32Error> RemoveDriverStorePackageByIdentity(
+		const std::wstring& fullInfPath, nefarius::devcon::inf::InfMetadataCache* cache, bool* rebootRequired)
+	{
+		const auto normalisedInfPath = ::NormaliseInfPath(fullInfPath);
+
+		if (!normalisedInfPath)
+		{
+			return std::unexpected(normalisedInfPath.error());
+		}
+
+		//
+		// Surgical path: identify the target package by its [Version] identity, then enumerate the
+		// store to find and delete exactly that package, without touching any device node.
+		// 
+		if (const auto targetIdentity = ::ReadDriverStoreIdentity(normalisedInfPath->c_str(), cache))
+		{
+			if (const auto packages = nefarius::devcon::EnumerateDriverStorePackages())
+			{
+				const auto& pkgList = packages.value();
+
+				const auto match = std::ranges::find_if(pkgList,
+					[&](const nefarius::devcon::DriverStorePackage& candidate)
+					{
+						const auto candidateIdentity = ::ReadDriverStoreIdentity(
+							candidate.DriverPackageInfPath.c_str(), cache);
+						return candidateIdentity && ::IdentitiesMatch(*candidateIdentity, *targetIdentity);
+					});
+
+				if (match == pkgList.end())
+				{
+					//
+					// No matching package in the store; either it was never published this way, or
+					// has already been purged. Either way, there is nothing left to remove.
+					// 
+					return {};
+				}
+
+				return ::DeleteDriverStorePackage(*match, normalisedInfPath->c_str(), rebootRequired);
+			}
+		}
+
+		//
+		// No identity could be read from the original INF at all (targetIdentity itself was empty),
+		// or the store couldn't be enumerated; fall back straight to DiUninstallDriverW.
+		// 
+		return ::UninstallDriverByInf(normalisedInfPath->c_str(), rebootRequired);
+	}
+
+	//
+	// Converts the results of the device tree search to the string type the caller asked for
+	// 
+	template <nefarius::utilities::string_type StringType>
+	std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, Win32Error> ToFindByHwIdResults(
+		std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, std::error_code>&& found)
+	{
+		if (!found)
+		{
+			return std::unexpected(Win32Error(static_cast<DWORD>(found.error().value()), "SetupDiGetClassDevs"));
+		}
+
+		if constexpr (std::is_same_v<StringType, std::wstring>)
+		{
+			return std::move(found.value());
+		}
+		else
+		{
+			std::vector<nefarius::devcon::FindByHwIdResult<StringType>> results;
+			results.reserve(found->size());
+
+			for (const auto& device : found.value())
+			{
+				nefarius::devcon::FindByHwIdResult<StringType> result{};
+
+				for (const auto& entry : device.HardwareIds)
+				{
+					result.HardwareIds.push_back(ConvertToNarrow(entry));
+				}
+
+				result.Name = ConvertToNarrow(device.Name);
+				result.Version.Value = device.Version.Value;
+
+				results.push_back(std::move(result));
+			}
+
+			return results;
+		}
+	}
 }
 
 template <nefarius::utilities::string_type StringType>
 std::expected<void, Win32Error> nefarius::devcon::Create(const StringType& ClassName, const GUID* ClassGuid,
                                                          const WideMultiStringArray& HardwareId)
+{
+	return nefarius::devcon::Create(ClassName, ClassGuid, HardwareId.view());
+}
+
+template <nefarius::utilities::string_type StringType>
+std::expected<void, Win32Error> nefarius::devcon::Create(const StringType& ClassName, const GUID* ClassGuid,
+                                                         WideMultiStringView HardwareId)
 {
 	const std::wstring className = ConvertToWide(ClassName);
 
@@ -540,8 +700,8 @@ std::expected<void, Win32Error> nefarius::devcon::Create(const StringType& Class
 		hDevInfo.get(),
 		&deviceInfoData,
 		SPDRP_HARDWAREID,
-		HardwareId.data(),
-		static_cast<DWORD>(HardwareId.size())
+		reinterpret_cast<const BYTE*>(HardwareId.data()),
+		static_cast<DWORD>(HardwareId.chars() * sizeof(wchar_t))
 	))
 	{
 		return std::unexpected(Win32Error("SetupDiSetDeviceRegistryPropertyW"));
@@ -722,14 +882,12 @@ std::vector<std::expected<void, Win32Error>> nefarius::devcon::UninstallDeviceAn
 			continue;
 		}
 
-		LPWSTR buffer = (LPWSTR)hwIdBuffer.value().Data.get();
-
 		//
 		// find device matching hardware ID
 		// 
-		for (LPWSTR p = buffer; p && *p && (p < &buffer[hwIdBuffer.value().Length]); p += lstrlenW(p) + 1)
+		for (const auto entry : hwIdBuffer->strings().value_or(WideMultiStringView(nullptr, 0)))
 		{
-			if (wstristr(p, hardwareId.c_str()))
+			if (casefold::FindIgnoreCase(entry, hardwareId) != std::wstring_view::npos)
 			{
 				results.push_back(::uninstall_device_and_driver(
 					hDevInfo.get(),
@@ -982,157 +1140,44 @@ template <nefarius::utilities::string_type StringType>
 std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, Win32Error> nefarius::devcon::FindByHwId(
 	const StringType& Matchstring)
 {
-	const std::wstring matchstring = ConvertToWide(Matchstring);
+	SystemDeviceTree tree;
 
-	DWORD total = 0;
-	SP_DEVINFO_DATA spDevInfoData;
-
-	std::vector<FindByHwIdResult<StringType>> results;
-
-	guards::HDEVINFOHandleGuard hDevInfo(SetupDiGetClassDevs(
-		nullptr,
-		nullptr,
-		nullptr,
-		DIGCF_ALLCLASSES | DIGCF_PRESENT
-	));
-
-	if (hDevInfo.is_invalid())
-	{
-		return std::unexpected(Win32Error("SetupDiGetClassDevs"));
-	}
-
-	spDevInfoData.cbSize = sizeof(spDevInfoData);
-
-	for (DWORD devIndex = 0; SetupDiEnumDeviceInfo(hDevInfo.get(), devIndex, &spDevInfoData); devIndex++)
-	{
-		const auto hwIdProperty = GetDeviceRegistryProperty(
-			hDevInfo.get(),
-			&spDevInfoData,
-			SPDRP_HARDWAREID
-		);
-
-		if (!hwIdProperty)
-		{
-			continue;
-		}
-
-		LPWSTR hwIdsBuffer = (LPWSTR)hwIdProperty.value().Data.get();
-
-		std::vector<std::wstring> entries;
-		const WCHAR* p = hwIdsBuffer;
-
-		while (*p)
-		{
-			entries.emplace_back(p);
-			p += wcslen(p) + 1;
-		}
-
-		bool foundMatch = FALSE;
-
-		for (auto& i : entries)
-		{
-			if (i.find(matchstring) != std::wstring::npos)
-			{
-				foundMatch = TRUE;
-				break;
-			}
-		}
-
-		// If we have a match, print out the whole array
-		if (foundMatch)
-		{
-			total++;
-
-			FindByHwIdResult<StringType> result;
-
-			const auto descProperty = GetDeviceRegistryProperty(
-				hDevInfo.get(),
-				&spDevInfoData,
-				SPDRP_DEVICEDESC
-			);
-
-			LPWSTR nameBuffer = NULL;
-			LPCWSTR fallbackName = L"Unknown device";
-
-			//
-			// Try Device Description...
-			// 
-			if (!descProperty)
-			{
-				//
-				// ...then Friendly Name
-				// 
-				const auto nameProperty = GetDeviceRegistryProperty(
-					hDevInfo.get(),
-					&spDevInfoData,
-					SPDRP_FRIENDLYNAME
-				);
-
-				if (!nameProperty)
-				{
-					nameBuffer = (LPWSTR)fallbackName;
-				}
-				else
-				{
-					nameBuffer = (LPWSTR)nameProperty.value().Data.get();
-				}				
-			}
-			else
-			{
-				nameBuffer = (LPWSTR)descProperty.value().Data.get();
-			}
-
-			const auto resultName = std::wstring(nameBuffer);
-
-			if constexpr (std::is_same_v<StringType, std::wstring>)
-			{
-				result.HardwareIds = entries;
-				result.Name = resultName;
-			}
-			else if constexpr (std::is_same_v<StringType, std::string>)
-			{
-				result.HardwareIds.reserve(entries.size());
-				std::transform(entries.begin(), entries.end(), result.HardwareIds.begin(), ConvertWideToANSI);
-				result.Name = ConvertToNarrow(resultName);
-			}
+	return ::ToFindByHwIdResults<StringType>(FindByHwId(tree, ConvertToWide(Matchstring)));
+}
 
-			// Build a list of driver info items that we will retrieve below
-			if (!SetupDiBuildDriverInfoList(hDevInfo.get(), &spDevInfoData, SPDIT_COMPATDRIVER))
-			{
-				results.push_back(result);
-				continue;
-			}
+template <nefarius::utilities::string_type StringType>
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, Win32Error> nefarius::devcon::FindByHwId(
+	const StringType& Matchstring, const inf::DriverMatchIndex& Drivers)
+{
+	SystemDeviceTree tree;
 
-			const auto driverGuard = sg::make_scope_guard([&hDevInfo, &spDevInfoData]() noexcept
-			{
-				SetupDiDestroyDriverInfoList(hDevInfo.get(), &spDevInfoData, SPDIT_COMPATDRIVER);
-			});
+	return ::ToFindByHwIdResults<StringType>(FindByHwId(tree, ConvertToWide(Matchstring), Drivers));
+}
 
-			SCOPE_GUARD_CAPTURE({
-			                    SetupDiDestroyDriverInfoList(hDevInfo.get(), &spDevInfoData, SPDIT_COMPATDRIVER);
-			                    }, &hDevInfo, &spDevInfoData);
+template
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, Win32Error> nefarius::devcon::FindByHwId(
+	const std::wstring& Matchstring, const inf::DriverMatchIndex& Drivers);
 
-			// Get the first info item for this driver
-			SP_DRVINFO_DATA drvInfo = {};
-			drvInfo.cbSize = sizeof(SP_DRVINFO_DATA);
+template
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::string>>, Win32Error> nefarius::devcon::FindByHwId(
+	const std::string& Matchstring, const inf::DriverMatchIndex& Drivers);
 
-			if (!SetupDiEnumDriverInfo(hDevInfo.get(), &spDevInfoData, SPDIT_COMPATDRIVER, 0, &drvInfo))
-			{
-				results.push_back(result);
-				continue;
-			}			
+template <nefarius::utilities::string_type StringType>
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<StringType>>, Win32Error> nefarius::devcon::FindByHwId(
+	const DeviceIndex& Index, const StringType& Matchstring)
+{
+	SystemDeviceTree tree;
 
-			result.Version.Major = (drvInfo.DriverVersion >> 48) & 0xFFFF;
-			result.Version.Minor = (drvInfo.DriverVersion >> 32) & 0xFFFF;
-			result.Version.Build = (drvInfo.DriverVersion >> 16) & 0xFFFF;
-			result.Version.Private = drvInfo.DriverVersion & 0x0000FFFF;
+	return ::ToFindByHwIdResults<StringType>(FindByHwId(tree, Index, ConvertToWide(Matchstring)));
+}
 
-			results.push_back(result);
-		}
-	}
+template
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, Win32Error> nefarius::devcon::FindByHwId(
+	const DeviceIndex& Index, const std::wstring& Matchstring);
 
-	return results;
-}
+template
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::string>>, Win32Error> nefarius::devcon::FindByHwId(
+	const DeviceIndex& Index, const std::string& Matchstring);
 
 template <nefarius::utilities::string_type StringType>
 std::expected<nefarius::devcon::INFClassResult<StringType>, nefarius::utilities::Win32Error> nefarius::
@@ -1206,10 +1251,7 @@ std::expected<void, Win32Error> nefarius::devcon::bluetooth::RestartBthUsbDevice
 		return std::unexpected(enumeratorProperty.error());
 	}
 
-	const LPTSTR buffer = (LPTSTR)enumeratorProperty.value().Data.get();
-	const size_t bufferLength = enumeratorProperty.value().Length;
-
-	WideMultiStringArray enumerator(buffer, bufferLength);
+	const auto enumerator = enumeratorProperty->strings().value_or(WideMultiStringView(nullptr, 0));
 
 	// if device found restart
 	if (enumerator.contains(L"USB"))
@@ -1257,10 +1299,7 @@ std::expected<void, Win32Error> nefarius::devcon::bluetooth::EnableDisableBthUsb
 		return std::unexpected(enumeratorProperty.error());
 	}
 
-	const LPTSTR buffer = (LPTSTR)enumeratorProperty.value().Data.get();
-	const size_t bufferLength = enumeratorProperty.value().Length;
-
-	WideMultiStringArray enumerator(buffer, bufferLength);
+	const auto enumerator = enumeratorProperty->strings().value_or(WideMultiStringView(nullptr, 0));
 
 	// if device found change it's state
 	if (enumerator.contains(L"USB"))
@@ -1292,8 +1331,8 @@ std::expected<void, Win32Error> nefarius::devcon::bluetooth::EnableDisableBthUsb
 	return std::unexpected(Win32Error(ERROR_NOT_FOUND));
 }
 
-std::expected<std::vector<nefarius::devcon::DriverStorePackage>, Win32Error>
-nefarius::devcon::EnumerateDriverStorePackages()
+std::expected<void, Win32Error> nefarius::devcon::EnumerateDriverStorePackages(
+	const DriverStorePackageCallback& Callback, const DriverStorePackageFilter& Filter)
 {
 	nefarius::utilities::DrvStore drvStore;
 
@@ -1309,159 +1348,208 @@ nefarius::devcon::EnumerateDriverStorePackages()
 		return std::unexpected(Win32Error("GetWindowsDirectoryW"));
 	}
 
-	::EnumCollectContext ctx;
+	::EnumVisitContext ctx{&Callback, &Filter};
 
 	const LONG status = drvStore.fpDriverStoreOfflineEnumDriverPackageW(
-		&::EnumCollectCallback, &ctx, windowsDirectory);
+		&::EnumVisitCallback, &ctx, windowsDirectory);
 
-	if (status < 0)
+	if (ctx.Exception)
+	{
+		std::rethrow_exception(ctx.Exception);
+	}
+
+	//
+	// What drvstore.dll reports for an enumeration cut short by its callback is undocumented, so
+	// an early stop is never treated as failure
+	//
+	if (status < 0 && !ctx.Stopped)
 	{
 		return std::unexpected(::NtStatusToWin32Error(drvStore, status, "DriverStoreOfflineEnumDriverPackageW"));
 	}
 
-	return std::move(ctx.Packages);
+	return {};
+}
+
+std::expected<std::vector<nefarius::devcon::DriverStorePackage>, Win32Error>
+nefarius::devcon::EnumerateDriverStorePackages()
+{
+	std::vector<DriverStorePackage> packages;
+	DriverStorePackageFilter filter;
+	filter.IsInbox = false;
+
+	const auto result = EnumerateDriverStorePackages([&packages](const DriverStorePackageView& package)
+	{
+		packages.push_back(package.materialize());
+		return true;
+	}, filter);
+
+	if (!result)
+	{
+		return std::unexpected(result.error());
+	}
+
+	return packages;
 }
 
 template <nefarius::utilities::string_type StringType>
-std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
-	const StringType& FullInfPath, bool* RebootRequired)
+std::expected<nefarius::devcon::DriverStorePackage, Win32Error> nefarius::devcon::FindDriverStorePackage(
+	const StringType& PublishedInfName)
 {
-	const std::wstring fullInfPath = ConvertToWide(FullInfPath);
+	const std::wstring publishedInfName = ConvertToWide(PublishedInfName);
+	std::optional<DriverStorePackage> match;
 
-	WCHAR normalisedInfPath[MAX_PATH] = {};
+	DriverStorePackageFilter filter;
+	filter.PublishedInfName = publishedInfName;
 
-	if (const auto ret = GetFullPathNameW(fullInfPath.c_str(), MAX_PATH, normalisedInfPath, nullptr);
-		(ret >= MAX_PATH) || (ret == FALSE))
+	const auto result = EnumerateDriverStorePackages([&match](const DriverStorePackageView& package)
 	{
-		return std::unexpected(Win32Error(ERROR_BAD_PATHNAME));
+		match = package.materialize();
+		return false;
+	}, filter);
+
+	if (!result)
+	{
+		return std::unexpected(result.error());
 	}
 
-	//
-	// Surgical path: identify the target package by its [Version] identity, then enumerate the
-	// store to find and delete exactly that package, without touching any device node.
-	// 
-	if (const auto targetIdentity = ::ReadDriverStoreIdentity(normalisedInfPath))
+	if (!match)
 	{
-		if (const auto packages = EnumerateDriverStorePackages())
-		{
-			const auto& pkgList = packages.value();
+		return std::unexpected(Win32Error(ERROR_NOT_FOUND));
+	}
 
-			const auto match = std::ranges::find_if(pkgList,
-				[&](const DriverStorePackage& candidate)
-				{
-					const auto candidateIdentity = ::ReadDriverStoreIdentity(candidate.DriverPackageInfPath.c_str());
-					return candidateIdentity && ::IdentitiesMatch(*candidateIdentity, *targetIdentity);
-				});
+	return std::move(*match);
+}
 
-			if (match == pkgList.end())
-			{
-				//
-				// No matching package in the store; either it was never published this way, or
-				// has already been purged. Either way, there is nothing left to remove.
-				// 
-				return {};
-			}
+template
+std::expected<nefarius::devcon::DriverStorePackage, Win32Error> nefarius::devcon::FindDriverStorePackage(
+	const std::wstring& PublishedInfName);
 
-			nefarius::utilities::DrvStore drvStore;
-			std::optional<Win32Error> driverStoreDeleteError;
+template
+std::expected<nefarius::devcon::DriverStorePackage, Win32Error> nefarius::devcon::FindDriverStorePackage(
+	const std::string& PublishedInfName);
 
-			if (drvStore.fpDriverStoreOfflineDeleteDriverPackageW)
-			{
-				WCHAR windowsDirectory[MAX_PATH] = {};
+template <nefarius::utilities::string_type StringType>
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const StringType& FullInfPath, bool* RebootRequired)
+{
+	return ::RemoveDriverStorePackageByIdentity(ConvertToWide(FullInfPath), nullptr, RebootRequired);
+}
 
-				if (GetWindowsDirectoryW(windowsDirectory, MAX_PATH) != 0)
-				{
-					std::wstring driveRoot(windowsDirectory);
+template <nefarius::utilities::string_type StringType>
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const StringType& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired)
+{
+	return ::RemoveDriverStorePackageByIdentity(ConvertToWide(FullInfPath), &Cache, RebootRequired);
+}
 
-					if (driveRoot.size() > 3)
-					{
-						driveRoot.resize(3);
-					}
+template
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const std::wstring& FullInfPath, bool* RebootRequired);
 
-					const LONG status = drvStore.fpDriverStoreOfflineDeleteDriverPackageW(
-						match->DriverPackageInfPath.c_str(), 0, nullptr, windowsDirectory, driveRoot.c_str());
+template
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const std::string& FullInfPath, bool* RebootRequired);
 
-					if (status >= 0)
-					{
-						return {};
-					}
+template
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const std::wstring& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired);
 
-					//
-					// Fall through to SetupUninstallOEMInfW below, reusing the published name
-					// already resolved by the enumeration above. Keep the original failure
-					// around in case every fallback also fails, so it isn't lost behind a
-					// possibly-unrelated GetLastError() from a later API.
-					// 
-					driverStoreDeleteError = ::NtStatusToWin32Error(
-						drvStore, status, "DriverStoreOfflineDeleteDriverPackageW");
-				}
-			}
+template
+std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
+	const std::string& FullInfPath, inf::InfMetadataCache& Cache, bool* RebootRequired);
 
-			if (!match->PublishedInfName.empty() &&
-				SetupUninstallOEMInfW(match->PublishedInfName.c_str(), SUOI_FORCEDELETE, nullptr))
-			{
-				return {};
-			}
+std::expected<void, std::error_code> nefarius::devcon::SystemDriverStore::enumerate(
+	const DriverStorePackageCallback& Callback, const DriverStorePackageFilter& Filter)
+{
+	if (auto result = EnumerateDriverStorePackages(Callback, Filter); !result)
+	{
+		return std::unexpected(::Win32ErrorToErrorCode(result.error()));
+	}
+
+	return {};
+}
 
+std::expected<void, std::error_code> nefarius::devcon::SystemDriverStore::remove(const DriverStorePackage& Package)
+{
+	if (auto result = ::DeleteFromDriverStore(Package); !result)
+	{
+		return std::unexpected(::Win32ErrorToErrorCode(result.error()));
+	}
+
+	return {};
+}
+
+std::vector<std::expected<void, Win32Error>> nefarius::devcon::RemoveDriverStorePackages(
+	std::span<const std::wstring> FullInfPaths, const DriverStoreIndexOptions& Options, bool* RebootRequired)
+{
+	std::vector<std::expected<void, Win32Error>> results;
+	results.reserve(FullInfPaths.size());
+
+	auto index = DriverStoreIndex::Build(Options);
+
+	for (const auto& fullInfPath : FullInfPaths)
+	{
+		const auto normalisedInfPath = ::NormaliseInfPath(fullInfPath);
+
+		if (!normalisedInfPath)
+		{
+			results.emplace_back(std::unexpected(normalisedInfPath.error()));
+			continue;
+		}
+
+		bool reboot = false;
+		const auto matches = index
+			                     ? index->match(*normalisedInfPath, Options.Cache)
+			                     : std::unexpected(index.error());
+
+		if (!matches)
+		{
 			//
-			// Last resort: doesn't require identifying the store package up front, but (unlike
-			// the paths above) will also uninstall any device still actively using this driver.
-			// 
-			Newdev newdev;
-			BOOL reboot = FALSE;
+			// Store not enumerable or original INF unreadable; same fallback as RemoveDriverStorePackage
+			//
+			results.push_back(::UninstallDriverByInf(normalisedInfPath->c_str(), &reboot));
+		}
+		else
+		{
+			//
+			// No match means the package is already gone, which counts as success
+			//
+			std::expected<void, Win32Error> result;
 
-			switch (newdev.CallFunction(newdev.fpDiUninstallDriverW, nullptr, normalisedInfPath, 0, &reboot))
+			for (const auto* package : *matches)
 			{
-			case FunctionCallResult::NotAvailable:
-				return std::unexpected(Win32Error(ERROR_INVALID_FUNCTION, "DiUninstallDriverW"));
-			case FunctionCallResult::Failure:
-				if (driverStoreDeleteError)
+				if (auto deleted = ::DeleteDriverStorePackage(*package, normalisedInfPath->c_str(), &reboot))
 				{
-					return std::unexpected(Win32Error(driverStoreDeleteError->getErrorCode(),
-						std::format("DiUninstallDriverW (after {})",
-							driverStoreDeleteError->getErrorMessageA())));
+					index->remove(*package);
 				}
-				return std::unexpected(Win32Error("DiUninstallDriverW"));
-			case FunctionCallResult::Success:
-				if (RebootRequired)
+				else if (result)
 				{
-					*RebootRequired = reboot > 0;
+					result = std::move(deleted);
 				}
-				return {};
 			}
 
-			return std::unexpected(Win32Error(ERROR_INTERNAL_ERROR));
+			results.push_back(std::move(result));
 		}
-	}
 
-	//
-	// No identity could be read from the original INF at all (targetIdentity itself was empty),
-	// or the store couldn't be enumerated; fall back straight to DiUninstallDriverW.
-	// 
-	Newdev newdev;
-	BOOL reboot = FALSE;
-
-	switch (newdev.CallFunction(newdev.fpDiUninstallDriverW, nullptr, normalisedInfPath, 0, &reboot))
-	{
-	case FunctionCallResult::NotAvailable:
-		return std::unexpected(Win32Error(ERROR_INVALID_FUNCTION, "DiUninstallDriverW"));
-	case FunctionCallResult::Failure:
-		return std::unexpected(Win32Error("DiUninstallDriverW"));
-	case FunctionCallResult::Success:
-		if (RebootRequired)
+		if (RebootRequired && reboot)
 		{
-			*RebootRequired = reboot > 0;
+			*RebootRequired = true;
 		}
-		return {};
 	}
 
-	return std::unexpected(Win32Error(ERROR_INTERNAL_ERROR));
+	return results;
 }
 
-template
-std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
-	const std::wstring& FullInfPath, bool* RebootRequired);
+std::vector<std::expected<void, Win32Error>> nefarius::devcon::RemoveDriverStorePackages(
+	std::span<const std::string> FullInfPaths, const DriverStoreIndexOptions& Options, bool* RebootRequired)
+{
+	std::vector<std::wstring> fullInfPaths;
+	fullInfPaths.reserve(FullInfPaths.size());
 
-template
-std::expected<void, Win32Error> nefarius::devcon::RemoveDriverStorePackage(
-	const std::string& FullInfPath, bool* RebootRequired);
+	for (const auto& fullInfPath : FullInfPaths)
+	{
+		fullInfPaths.push_back(ConvertToWide(fullInfPath));
+	}
+
+	return RemoveDriverStorePackages(fullInfPaths, Options, RebootRequired);
+}
@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <ranges>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DeviceCache.hpp>
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+namespace
+{
+	constexpr uint32_t Win32AlreadyInitialized = 1247; // ERROR_ALREADY_INITIALIZED
+
+	//
+	// Read for every device by the initial sweep; read_device reads the same ones
+	//
+	constexpr std::array CachedProperties{
+		DeviceProperty::InstanceId,
+		DeviceProperty::HardwareIds,
+		DeviceProperty::Service,
+		DeviceProperty::ClassGuid,
+		DeviceProperty::DeviceDesc,
+		DeviceProperty::FriendlyName
+	};
+
+	std::error_code Win32ErrorCode(uint32_t error)
+	{
+		return {static_cast<int>(error), std::system_category()};
+	}
+}
+
+std::expected<void, std::error_code> nefarius::devcon::SyntheticDeviceEvents::start(Sink Target)
+{
+	std::scoped_lock lock(lock_);
+
+	if (sink_)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32AlreadyInitialized));
+	}
+
+	sink_ = std::move(Target);
+
+	return {};
+}
+
+void nefarius::devcon::SyntheticDeviceEvents::stop()
+{
+	std::scoped_lock lock(lock_);
+
+	sink_ = nullptr;
+}
+
+void nefarius::devcon::SyntheticDeviceEvents::post(DeviceEvent Event)
+{
+	//
+	// Delivered under the lock, so stop() can't return while the sink is still running
+	//
+	std::scoped_lock lock(lock_);
+
+	if (sink_)
+	{
+		sink_(std::move(Event));
+	}
+}
+
+size_t nefarius::devcon::DeviceCacheView::shard_of(std::wstring_view Key)
+{
+	//
+	// The top bits of the mixed hash, so the keys of one shard still spread over all buckets of
+	// its map, which picks them by the low bits of the same hash on some standard libraries
+	//
+	constexpr int shardBits = std::bit_width(ShardCount - 1);
+	const uint64_t mixed = static_cast<uint64_t>(std::hash<std::wstring_view>{}(Key)) * 0x9E3779B97F4A7C15ull;
+
+	return static_cast<size_t>(mixed >> (64 - shardBits));
+}
+
+const nefarius::devcon::CachedDevice* nefarius::devcon::DeviceCacheView::find(std::wstring_view InstanceId) const
+{
+	const std::wstring key = casefold::FoldCase(InstanceId);
+	const auto& shard = *shards_[shard_of(key)];
+	const auto found = shard.find(key);
+
+	if (found == shard.end())
+	{
+		return nullptr;
+	}
+
+	return found->second.get();
+}
+
+void nefarius::devcon::DeviceCacheView::for_each(const std::function<void(const CachedDevice& Device)>& Visit) const
+{
+	for (const auto& shard : shards_)
+	{
+		for (const auto& device : *shard | std::views::values)
+		{
+			Visit(*device);
+		}
+	}
+}
+
+nefarius::devcon::DeviceCache::DeviceCache(DeviceTreeBackend& Tree, DeviceEventSource& Events)
+	: tree_(Tree), events_(Events)
+{
+}
+
+std::expected<std::unique_ptr<nefarius::devcon::DeviceCache>, std::error_code> nefarius::devcon::DeviceCache::Create(
+	DeviceTreeBackend& Tree, DeviceEventSource& Events)
+{
+	std::unique_ptr<DeviceCache> cache(new DeviceCache(Tree, Events));
+
+	//
+	// Subscribe before the sweep; whatever changes while it runs is queued and re-read afterwards
+	//
+	if (auto started = Events.start([target = cache.get()](DeviceEvent Event) { target->enqueue(std::move(Event)); });
+		!started)
+	{
+		// not ours to stop; it may be serving another owner
+		return std::unexpected(started.error());
+	}
+
+	cache->started_ = true;
+
+	const auto snapshot = DeviceSnapshot::Capture(Tree, CachedProperties);
+
+	if (!snapshot)
+	{
+		// the destructor stops the source again
+		return std::unexpected(snapshot.error());
+	}
+
+	std::array<std::shared_ptr<DeviceCacheView::Shard>, DeviceCacheView::ShardCount> shards;
+
+	for (auto& shard : shards)
+	{
+		shard = std::make_shared<DeviceCacheView::Shard>();
+		shard->reserve(snapshot->size() / DeviceCacheView::ShardCount);
+	}
+
+	auto view = std::make_shared<DeviceCacheView>();
+
+	for (size_t row = 0; row < snapshot->size(); row++)
+	{
+		const auto instanceId = snapshot->instance_id(row);
+
+		if (instanceId.empty())
+		{
+			continue;
+		}
+
+		auto device = std::make_shared<CachedDevice>();
+		device->InstanceId = instanceId;
+		device->Status = Tree.status(snapshot->node(row)).value_or(DeviceNodeStatus{});
+		device->Name = snapshot->string(row, DeviceProperty::DeviceDesc)
+		                       .or_else([&] { return snapshot->string(row, DeviceProperty::FriendlyName); })
+		                       .value_or(std::wstring_view{});
+		device->Service = snapshot->string(row, DeviceProperty::Service).value_or(std::wstring_view{});
+		device->ClassGuid = snapshot->guid(row, DeviceProperty::ClassGuid);
+
+		if (const auto hardwareIds = snapshot->strings(row, DeviceProperty::HardwareIds))
+		{
+			device->HardwareIds = std::vector<std::wstring>(hardwareIds->begin(), hardwareIds->end());
+		}
+
+		std::wstring key = casefold::FoldCase(instanceId);
+		auto& shard = *shards[DeviceCacheView::shard_of(key)];
+
+		if (shard.insert_or_assign(std::move(key), std::move(device)).second)
+		{
+			view->size_++;
+		}
+	}
+
+	std::ranges::move(shards, view->shards_.begin());
+
+	cache->view_.store(std::move(view), std::memory_order_release);
+	cache->worker_ = std::jthread([target = cache.get()](const std::stop_token& Stop) { target->run(Stop); });
+
+	return cache;
+}
+
+nefarius::devcon::DeviceCache::~DeviceCache()
+{
+	//
+	// No more events may be queued once the worker is gone
+	//
+	if (started_)
+	{
+		events_.stop();
+	}
+
+	if (worker_.joinable())
+	{
+		worker_.request_stop();
+		worker_.join();
+	}
+}
+
+void nefarius::devcon::DeviceCache::flush()
+{
+	std::unique_lock lock(queue_lock_);
+
+	const uint64_t target = queued_;
+
+	applied_signal_.wait(lock, [this, target] { return applied_ >= target; });
+}
+
+void nefarius::devcon::DeviceCache::enqueue(DeviceEvent Event)
+{
+	{
+		std::scoped_lock lock(queue_lock_);
+
+		queue_.push_back(std::move(Event));
+		queued_++;
+	}
+
+	queue_signal_.notify_one();
+}
+
+void nefarius::devcon::DeviceCache::run(const std::stop_token& Stop)
+{
+	std::deque<DeviceEvent> batch;
+
+	while (true)
+	{
+		{
+			std::unique_lock lock(queue_lock_);
+
+			if (!queue_signal_.wait(lock, Stop, [this] { return !queue_.empty(); }))
+			{
+				return;
+			}
+
+			batch.swap(queue_);
+		}
+
+		//
+		// Several events about the same device collapse into one re-read (or removal); only the
+		// last one decides which
+		//
+		std::unordered_map<std::wstring, const DeviceEvent*> latest;
+		latest.reserve(batch.size());
+
+		for (const auto& event : batch)
+		{
+			latest.insert_or_assign(casefold::FoldCase(event.InstanceId), &event);
+		}
+
+		//
+		// Copy-on-write: the new view copies only the shards this batch touches (each at most
+		// once) and shares the others with the current one, which readers may keep using for as
+		// long as they like
+		//
+		const auto current = view_.load(std::memory_order_acquire);
+
+		auto next = std::make_shared<DeviceCacheView>(*current);
+		next->generation_ = current->generation_ + 1;
+
+		std::array<std::shared_ptr<DeviceCacheView::Shard>, DeviceCacheView::ShardCount> touched;
+
+		for (const auto& [key, event] : latest)
+		{
+			std::shared_ptr<const CachedDevice> device;
+
+			if (event->Type != DeviceEventType::Removal)
+			{
+				device = read_device(event->InstanceId);
+			}
+
+			const size_t index = DeviceCacheView::shard_of(key);
+			auto& shard = touched[index];
+
+			if (!shard)
+			{
+				shard = std::make_shared<DeviceCacheView::Shard>(*current->shards_[index]);
+			}
+
+			if (device)
+			{
+				if (shard->insert_or_assign(key, std::move(device)).second)
+				{
+					next->size_++;
+				}
+			}
+			else
+			{
+				next->size_ -= shard->erase(key);
+			}
+		}
+
+		for (size_t index = 0; index < touched.size(); index++)
+		{
+			if (touched[index])
+			{
+				next->shards_[index] = std::move(touched[index]);
+			}
+		}
+
+		view_.store(std::move(next), std::memory_order_release);
+
+		{
+			std::scoped_lock lock(queue_lock_);
+
+			applied_ += batch.size();
+		}
+
+		applied_signal_.notify_all();
+		batch.clear();
+	}
+}
+
+std::shared_ptr<const nefarius::devcon::CachedDevice> nefarius::devcon::DeviceCache::read_device(
+	std::wstring_view InstanceId) const
+{
+	//
+	// Not present (anymore); an arrival of a device that has already left again reads as removal
+	//
+	const auto node = tree_.locate(InstanceId);
+
+	if (!node)
+	{
+		return nullptr;
+	}
+
+	auto device = std::make_shared<CachedDevice>();
+	device->InstanceId = tree_.instance_id(node.value()).value_or(std::wstring(InstanceId));
+	device->Status = tree_.status(node.value()).value_or(DeviceNodeStatus{});
+
+	if (auto name = tree_.property_string(node.value(), DeviceProperty::DeviceDesc))
+	{
+		device->Name = std::move(name.value());
+	}
+	else
+	{
+		device->Name = tree_.property_string(node.value(), DeviceProperty::FriendlyName).value_or(std::wstring{});
+	}
+
+	device->Service = tree_.property_string(node.value(), DeviceProperty::Service).value_or(std::wstring{});
+	device->HardwareIds = tree_.property_strings(node.value(), DeviceProperty::HardwareIds)
+	                           .value_or(std::vector<std::wstring>{});
+
+	if (const auto classGuid = tree_.property_guid(node.value(), DeviceProperty::ClassGuid))
+	{
+		device->ClassGuid = classGuid.value();
+	}
+
+	return device;
+}
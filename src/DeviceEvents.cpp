@@ -0,0 +1,146 @@
+// ReSharper disable CppRedundantQualifier
+#include "pch.h"
+
+#include <devpkey.h>
+
+#include <nefarius/neflib/DeviceCache.hpp>
+
+
+namespace
+{
+	std::error_code Win32ErrorCode(DWORD error)
+	{
+		return {static_cast<int>(error), std::system_category()};
+	}
+
+	std::error_code ConfigRetErrorCode(CONFIGRET cr, DWORD defaultError)
+	{
+		return ::Win32ErrorCode(CM_MapCrToWin32Err(cr, defaultError));
+	}
+
+	//
+	// The device exposing an interface; fails once the interface is gone, which is usually the
+	// case by the time its removal is reported
+	//
+	std::optional<std::wstring> InterfaceInstanceId(PCWSTR symbolicLink)
+	{
+		WCHAR instanceId[MAX_DEVICE_ID_LEN + 1] = {};
+		DEVPROPTYPE type = DEVPROP_TYPE_EMPTY;
+		ULONG size = sizeof(instanceId);
+
+		if (CM_Get_Device_Interface_PropertyW(symbolicLink, &DEVPKEY_Device_InstanceId, &type,
+		                                      reinterpret_cast<PBYTE>(instanceId), &size, 0) != CR_SUCCESS ||
+			type != DEVPROP_TYPE_STRING)
+		{
+			return std::nullopt;
+		}
+
+		return std::wstring(instanceId);
+	}
+}
+
+struct nefarius::devcon::SystemDeviceEvents::Registration
+{
+	Sink Target;
+	HCMNOTIFICATION Instances = nullptr;
+	HCMNOTIFICATION Interfaces = nullptr;
+
+	//
+	// Runs on a thread pool thread of CfgMgr32
+	//
+	static DWORD CALLBACK OnNotification(HCMNOTIFICATION Notification, PVOID Context, CM_NOTIFY_ACTION Action,
+	                                     PCM_NOTIFY_EVENT_DATA EventData, DWORD EventDataSize)
+	{
+		UNREFERENCED_PARAMETER(Notification);
+		UNREFERENCED_PARAMETER(EventDataSize);
+
+		const auto registration = static_cast<const Registration*>(Context);
+
+		switch (Action)
+		{
+		case CM_NOTIFY_ACTION_DEVICEINSTANCEENUMERATED:
+			registration->Target({DeviceEventType::Arrival, EventData->u.DeviceInstance.InstanceId});
+			break;
+		case CM_NOTIFY_ACTION_DEVICEINSTANCESTARTED:
+			registration->Target({DeviceEventType::Started, EventData->u.DeviceInstance.InstanceId});
+			break;
+		case CM_NOTIFY_ACTION_DEVICEINSTANCEREMOVED:
+			registration->Target({DeviceEventType::Removal, EventData->u.DeviceInstance.InstanceId});
+			break;
+		case CM_NOTIFY_ACTION_DEVICEINTERFACEARRIVAL:
+		case CM_NOTIFY_ACTION_DEVICEINTERFACEREMOVAL:
+			if (auto instanceId = ::InterfaceInstanceId(EventData->u.DeviceInterface.SymbolicLink))
+			{
+				registration->Target({DeviceEventType::Changed, std::move(instanceId.value())});
+			}
+			break;
+		default:
+			break;
+		}
+
+		return ERROR_SUCCESS;
+	}
+};
+
+nefarius::devcon::SystemDeviceEvents::~SystemDeviceEvents()
+{
+	stop();
+}
+
+std::expected<void, std::error_code> nefarius::devcon::SystemDeviceEvents::start(Sink Target)
+{
+	if (registration_)
+	{
+		return std::unexpected(::Win32ErrorCode(ERROR_ALREADY_INITIALIZED));
+	}
+
+	auto registration = std::make_unique<Registration>();
+	registration->Target = std::move(Target);
+
+	CM_NOTIFY_FILTER filter = {};
+	filter.cbSize = sizeof(filter);
+	filter.Flags = CM_NOTIFY_FILTER_FLAG_ALL_DEVICE_INSTANCES;
+	filter.FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINSTANCE;
+
+	CONFIGRET cr = CM_Register_Notification(&filter, registration.get(), &Registration::OnNotification,
+	                                        &registration->Instances);
+
+	if (cr != CR_SUCCESS)
+	{
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_CAN_NOT_COMPLETE));
+	}
+
+	filter = {};
+	filter.cbSize = sizeof(filter);
+	filter.Flags = CM_NOTIFY_FILTER_FLAG_ALL_INTERFACE_CLASSES;
+	filter.FilterType = CM_NOTIFY_FILTER_TYPE_DEVICEINTERFACE;
+
+	cr = CM_Register_Notification(&filter, registration.get(), &Registration::OnNotification,
+	                              &registration->Interfaces);
+
+	if (cr != CR_SUCCESS)
+	{
+		CM_Unregister_Notification(registration->Instances);
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_CAN_NOT_COMPLETE));
+	}
+
+	registration_ = std::move(registration);
+
+	return {};
+}
+
+void nefarius::devcon::SystemDeviceEvents::stop()
+{
+	if (!registration_)
+	{
+		return;
+	}
+
+	//
+	// Waits for callbacks in flight, so the sink isn't called anymore afterwards
+	//
+	CM_Unregister_Notification(registration_->Interfaces);
+	CM_Unregister_Notification(registration_->Instances);
+
+	registration_.reset();
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <numeric>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DeviceIndex.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Three folded characters of 21 bits each
+	//
+	uint64_t Trigram(std::wstring_view folded, size_t offset)
+	{
+		constexpr uint64_t mask = 0x1FFFFF;
+
+		return ((static_cast<uint64_t>(folded[offset]) & mask) << 42) |
+			((static_cast<uint64_t>(folded[offset + 1]) & mask) << 21) |
+			(static_cast<uint64_t>(folded[offset + 2]) & mask);
+	}
+
+	//
+	// Rows are added in ascending order, so a row already present is always the last one
+	//
+	void AddRow(std::vector<DeviceIndex::Row>& rows, DeviceIndex::Row row)
+	{
+		if (rows.empty() || rows.back() != row)
+		{
+			rows.push_back(row);
+		}
+	}
+
+	std::span<const DeviceIndex::Row> Lookup(
+		const std::unordered_map<std::wstring, std::vector<DeviceIndex::Row>>& map, std::wstring_view key)
+	{
+		const auto found = map.find(casefold::FoldCase(key));
+
+		if (found == map.end())
+		{
+			return {};
+		}
+
+		return found->second;
+	}
+
+	std::vector<std::wstring> InstanceIds(const DeviceIndex& index, std::span<const DeviceIndex::Row> rows)
+	{
+		std::vector<std::wstring> instances;
+		instances.reserve(rows.size());
+
+		for (const DeviceIndex::Row row : rows)
+		{
+			if (const auto instanceId = index.snapshot().instance_id(row); !instanceId.empty())
+			{
+				instances.emplace_back(instanceId);
+			}
+		}
+
+		return instances;
+	}
+}
+
+size_t nefarius::devcon::DeviceIndex::GuidHash::operator()(const Guid& Value) const
+{
+	uint64_t low = 0;
+	std::memcpy(&low, Value.Data4.data(), sizeof(low));
+
+	return std::hash<uint64_t>{}(
+		(static_cast<uint64_t>(Value.Data1) << 32 | static_cast<uint64_t>(Value.Data2) << 16 | Value.Data3) ^ low);
+}
+
+std::expected<nefarius::devcon::DeviceIndex, std::error_code> nefarius::devcon::DeviceIndex::Build(
+	DeviceTreeBackend& Tree, bool PresentOnly)
+{
+	DeviceSnapshotOptions options;
+	options.PresentOnly = PresentOnly;
+
+	auto snapshot = DeviceSnapshot::Capture(Tree, Properties, options);
+
+	if (!snapshot)
+	{
+		return std::unexpected(snapshot.error());
+	}
+
+	return Build(std::move(snapshot.value()));
+}
+
+nefarius::devcon::DeviceIndex nefarius::devcon::DeviceIndex::Build(DeviceSnapshot Snapshot)
+{
+	DeviceIndex index;
+	index.snapshot_ = std::move(Snapshot);
+
+	const DeviceSnapshot& snapshot = index.snapshot_;
+	const auto rows = static_cast<Row>(snapshot.size());
+
+	index.instance_ids_.reserve(rows);
+
+	std::wstring folded;
+
+	for (Row row = 0; row < rows; row++)
+	{
+		if (const auto instanceId = snapshot.instance_id(row); !instanceId.empty())
+		{
+			index.instance_ids_.emplace(casefold::FoldCase(instanceId), row);
+		}
+
+		if (const auto service = snapshot.string(row, DeviceProperty::Service))
+		{
+			::AddRow(index.services_[casefold::FoldCase(service.value())], row);
+		}
+
+		if (const auto classGuid = snapshot.guid(row, DeviceProperty::ClassGuid))
+		{
+			::AddRow(index.classes_[classGuid.value()], row);
+		}
+
+		if (const auto compatibleIds = snapshot.strings(row, DeviceProperty::CompatibleIds))
+		{
+			for (const auto id : compatibleIds.value())
+			{
+				::AddRow(index.compatible_ids_[casefold::FoldCase(id)], row);
+			}
+		}
+
+		if (const auto hardwareIds = snapshot.strings(row, DeviceProperty::HardwareIds))
+		{
+			for (const auto id : hardwareIds.value())
+			{
+				folded.clear();
+				casefold::AppendFolded(folded, id);
+
+				for (size_t offset = 0; offset + 3 <= folded.size(); offset++)
+				{
+					::AddRow(index.trigrams_[::Trigram(folded, offset)], row);
+				}
+
+				::AddRow(index.hardware_ids_[folded], row);
+			}
+		}
+	}
+
+	return index;
+}
+
+std::optional<nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::by_instance_id(
+	std::wstring_view InstanceId) const
+{
+	const auto found = instance_ids_.find(casefold::FoldCase(InstanceId));
+
+	if (found == instance_ids_.end())
+	{
+		return std::nullopt;
+	}
+
+	return found->second;
+}
+
+std::span<const nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::by_hardware_id(
+	std::wstring_view HardwareId) const
+{
+	return ::Lookup(hardware_ids_, HardwareId);
+}
+
+std::span<const nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::by_compatible_id(
+	std::wstring_view CompatibleId) const
+{
+	return ::Lookup(compatible_ids_, CompatibleId);
+}
+
+std::span<const nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::by_service(
+	std::wstring_view ServiceName) const
+{
+	return ::Lookup(services_, ServiceName);
+}
+
+std::span<const nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::by_class(
+	const Guid& ClassGuid) const
+{
+	const auto found = classes_.find(ClassGuid);
+
+	if (found == classes_.end())
+	{
+		return {};
+	}
+
+	return found->second;
+}
+
+std::vector<nefarius::devcon::DeviceIndex::Row> nefarius::devcon::DeviceIndex::find_hardware_id(
+	std::wstring_view Substring, bool IgnoreCase) const
+{
+	const std::wstring needle = casefold::FoldCase(Substring);
+
+	std::vector<Row> candidates;
+
+	if (needle.size() < 3)
+	{
+		//
+		// Too short for a trigram; every device is a candidate
+		//
+		candidates.resize(snapshot_.size());
+		std::iota(candidates.begin(), candidates.end(), Row{0});
+	}
+	else
+	{
+		//
+		// Only rows having every trigram of the needle can contain it; intersect starting with
+		// the rarest trigram to keep the intermediate results small
+		//
+		std::vector<const Rows*> postings;
+		postings.reserve(needle.size() - 2);
+
+		for (size_t offset = 0; offset + 3 <= needle.size(); offset++)
+		{
+			const auto found = trigrams_.find(::Trigram(needle, offset));
+
+			if (found == trigrams_.end())
+			{
+				return {};
+			}
+
+			postings.push_back(&found->second);
+		}
+
+		std::ranges::sort(postings);
+		postings.erase(std::unique(postings.begin(), postings.end()), postings.end());
+		std::ranges::sort(postings, {}, [](const Rows* rows) { return rows->size(); });
+
+		candidates = *postings.front();
+
+		std::vector<Row> intersection;
+
+		for (size_t index = 1; index < postings.size() && !candidates.empty(); index++)
+		{
+			const Rows& posting = *postings[index];
+
+			//
+			// Common trigrams (like "VID") are in almost every row; probe those instead of
+			// walking them
+			//
+			if (candidates.size() * 16 < posting.size())
+			{
+				std::erase_if(candidates, [&posting](Row row)
+				{
+					return !std::ranges::binary_search(posting, row);
+				});
+				continue;
+			}
+
+			intersection.clear();
+			std::ranges::set_intersection(candidates, posting, std::back_inserter(intersection));
+			candidates.swap(intersection);
+		}
+	}
+
+	//
+	// Trigrams match case-insensitively and may stem from different IDs, so verify every candidate
+	//
+	std::wstring folded;
+
+	std::erase_if(candidates, [&](Row row)
+	{
+		const auto hardwareIds = snapshot_.strings(row, DeviceProperty::HardwareIds);
+
+		if (!hardwareIds)
+		{
+			return true;
+		}
+
+		return std::ranges::none_of(hardwareIds.value(), [&](std::wstring_view id)
+		{
+			if (!IgnoreCase)
+			{
+				return id.find(Substring) != std::wstring_view::npos;
+			}
+
+			folded.clear();
+			casefold::AppendFolded(folded, id);
+
+			return folded.find(needle) != std::wstring::npos;
+		});
+	});
+
+	return candidates;
+}
+
+std::vector<std::wstring> nefarius::devcon::ListDeviceInstancesByService(const DeviceIndex& Index,
+                                                                         std::wstring_view ServiceName)
+{
+	return ::InstanceIds(Index, Index.by_service(ServiceName));
+}
+
+std::vector<std::wstring> nefarius::devcon::ListDeviceInstancesByClass(const DeviceIndex& Index,
+                                                                       const Guid& ClassGuid)
+{
+	return ::InstanceIds(Index, Index.by_class(ClassGuid));
+}
@@ -3,10 +3,6 @@
 // ReSharper disable CppRedundantQualifier
 #include "pch.h"
 
-#include <array>
-#include <functional>
-#include <future>
-#include <thread>
 #include <algorithm>
 
 #include <winioctl.h>
@@ -17,824 +13,501 @@
 #include <nefarius/neflib/DeviceRestart.hpp>
 #include <nefarius/neflib/GenHandleGuard.hpp>
 #include <nefarius/neflib/MiscWinApi.hpp>
+#include <nefarius/neflib/Guid.hpp>
+
+#include "PropertyScratch.hpp"
 
 
 using namespace nefarius::utilities;
 
 namespace
 {
-	//
-	// Bundles the outcome of a single restart strategy attempt, self-contained so it can be
-	// passed by value out of a worker thread without any references to the caller's stack.
-	// 
-	struct StrategyOutcome
+	std::error_code Win32ErrorCode(DWORD error)
 	{
-		std::expected<void, Win32Error> Result;
-
-		bool RebootRequired = false;
-
-		std::wstring VetoName;
+		return {static_cast<int>(error), std::system_category()};
+	}
 
-		PNP_VETO_TYPE VetoType = PNP_VetoTypeUnknown;
-	};
+	std::error_code ConfigRetErrorCode(CONFIGRET cr, DWORD defaultError)
+	{
+		return ::Win32ErrorCode(CM_MapCrToWin32Err(cr, defaultError));
+	}
 
 	//
-	// Runs Fn on a worker thread and waits up to Timeout for it to finish. On timeout the worker
-	// keeps running detached (a stuck SetupDiCallClassInstaller/CM_* call cannot be cancelled),
-	// so the caller must never touch anything the closure references after a timeout is reported.
-	// Templated so it can bound any outcome type that default-constructs and exposes a
-	// std::expected<void, Win32Error> Result member (StrategyOutcome, DetachOutcome, ...).
+	// Raw CONFIGRET codes of failed status queries, so DeviceRestartResult::FinalStatusError
+	// keeps reporting them; compare equal to the Win32 error CM_MapCrToWin32Err maps them to
 	// 
-	template <typename TOutcome>
-	std::optional<TOutcome> RunBounded(std::chrono::milliseconds Timeout, std::function<TOutcome()> Fn)
+	class ConfigRetCategory final : public std::error_category
 	{
-		std::promise<TOutcome> promise;
-		std::future<TOutcome> future = promise.get_future();
-
-		std::thread worker([promise = std::move(promise), fn = std::move(Fn)]() mutable
+	public:
+		const char* name() const noexcept override
 		{
-			try
-			{
-				promise.set_value(fn());
-			}
-			catch (...)
-			{
-				promise.set_exception(std::current_exception());
-			}
-		});
-		worker.detach();
-
-		if (future.wait_for(Timeout) == std::future_status::ready)
-		{
-			try
-			{
-				return future.get();
-			}
-			catch (...)
-			{
-				//
-				// Fn is not expected to throw, but a stuck-thread caller can never be allowed
-				// to propagate an exception out of the no-throw contract of the public APIs.
-				// 
-				TOutcome outcome;
-				outcome.Result = std::unexpected(Win32Error(ERROR_UNHANDLED_EXCEPTION));
-				return outcome;
-			}
+			return "CONFIGRET";
 		}
 
-		return std::nullopt;
-	}
-
-	std::expected<std::wstring, Win32Error> GetDevNodePropertyString(DEVINST DevInst, const DEVPROPKEY& Key)
-	{
-		DEVPROPTYPE type = DEVPROP_TYPE_EMPTY;
-		ULONG size = 0;
-
-		CONFIGRET cr = CM_Get_DevNode_PropertyW(DevInst, &Key, &type, nullptr, &size, 0);
-
-		if (cr == CR_NO_SUCH_VALUE)
+		std::string message(int Value) const override
 		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND, "CM_Get_DevNode_PropertyW"));
+			return std::system_category().message(static_cast<int>(Win32Equivalent(Value)));
 		}
 
-		if (cr != CR_BUFFER_SMALL)
+		std::error_condition default_error_condition(int Value) const noexcept override
 		{
-			return std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                  "CM_Get_DevNode_PropertyW"));
+			return {static_cast<int>(Win32Equivalent(Value)), std::system_category()};
 		}
 
-		std::wstring value(size / sizeof(WCHAR), L'\0');
-
-		cr = CM_Get_DevNode_PropertyW(DevInst, &Key, &type, reinterpret_cast<PBYTE>(value.data()), &size, 0);
-
-		if (cr != CR_SUCCESS)
+	private:
+		static DWORD Win32Equivalent(int Value)
 		{
-			return std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                  "CM_Get_DevNode_PropertyW"));
+			return CM_MapCrToWin32Err(static_cast<CONFIGRET>(Value), ERROR_CAN_NOT_COMPLETE);
 		}
+	};
 
-		if (type != DEVPROP_TYPE_STRING)
-		{
-			return std::unexpected(Win32Error(ERROR_INVALID_DATATYPE, "CM_Get_DevNode_PropertyW"));
-		}
-
-		StripNullCharacters(value);
-
-		return value;
+	std::error_code ConfigRetStatusErrorCode(CONFIGRET cr)
+	{
+		static const ConfigRetCategory category;
+		return {static_cast<int>(cr), category};
 	}
 
-	std::expected<ULONG, Win32Error> GetDevNodePropertyUint32(DEVINST DevInst, const DEVPROPKEY& Key)
+	Win32Error ToWin32Error(const std::error_code& error, std::string additionalMessage = "")
 	{
-		DEVPROPTYPE type = DEVPROP_TYPE_EMPTY;
-		ULONG value = 0;
-		ULONG size = sizeof(value);
-
-		const CONFIGRET cr = CM_Get_DevNode_PropertyW(DevInst, &Key, &type, reinterpret_cast<PBYTE>(&value), &size,
-		                                              0);
-
-		if (cr != CR_SUCCESS)
-		{
-			return std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                  "CM_Get_DevNode_PropertyW"));
-		}
-
-		if (type != DEVPROP_TYPE_UINT32)
-		{
-			return std::unexpected(Win32Error(ERROR_INVALID_DATATYPE, "CM_Get_DevNode_PropertyW"));
-		}
-
-		return value;
+		return Win32Error(static_cast<DWORD>(error.value()), std::move(additionalMessage));
 	}
 
-	std::expected<DEVINST, Win32Error> LocateDevNode(const std::wstring& InstanceId, ULONG Flags)
+	//
+	// Workers abandoned after a timeout keep using the backend, so it has to outlive every call
+	// 
+	nefarius::devcon::SystemDeviceTree& SystemTree()
 	{
-		std::wstring id = InstanceId;
-		DEVINST devInst = 0;
+		static nefarius::devcon::SystemDeviceTree tree;
+		return tree;
+	}
 
-		const CONFIGRET cr = CM_Locate_DevNodeW(&devInst, id.data(), Flags);
+	const DEVPROPKEY& PropertyKey(nefarius::devcon::DeviceProperty property)
+	{
+		using nefarius::devcon::DeviceProperty;
 
-		if (cr != CR_SUCCESS)
+		switch (property)
 		{
-			return std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_NOT_FOUND), "CM_Locate_DevNodeW"));
+		case DeviceProperty::DeviceDesc:
+			return DEVPKEY_Device_DeviceDesc;
+		case DeviceProperty::FriendlyName:
+			return DEVPKEY_Device_FriendlyName;
+		case DeviceProperty::Service:
+			return DEVPKEY_Device_Service;
+		case DeviceProperty::HardwareIds:
+			return DEVPKEY_Device_HardwareIds;
+		case DeviceProperty::CompatibleIds:
+			return DEVPKEY_Device_CompatibleIds;
+		case DeviceProperty::InstanceId:
+			return DEVPKEY_Device_InstanceId;
+		case DeviceProperty::ClassGuid:
+			return DEVPKEY_Device_ClassGuid;
+		default:
+			return DEVPKEY_Device_Address;
 		}
-
-		return devInst;
 	}
 
 	//
-	// Snapshot of a single CM_Get_DevNode_Status observation, self-contained so callers can tell
-	// "device is present but stuck with a problem code" apart from "device is no longer present
-	// at all" (a phantom/removed node) instead of collapsing both into a single bool.
+	// Platform SetupDiGetActualSectionToInstall resolves decorated sections for; the native one,
+	// also for a WOW64 process
 	// 
-	struct DevNodeObservation
+	nefarius::devcon::inf::InfPlatformTarget RunningPlatform()
 	{
-		bool Located = false;
-		///< True if CM_Get_DevNode_Status was actually queried successfully for this devnode;
-		///< Started/HasProblem/ProblemCode are only meaningful when this is true. A device can be
-		///< Located but still have StatusValid == false if the status query itself failed (e.g.
-		///< CR_NO_SUCH_DEVNODE if it vanished between the locate and the status call).
-		bool StatusValid = false;
-		///< CM_Get_DevNode_Status's CONFIGRET when StatusValid is false and Located is true;
-		///< CR_SUCCESS otherwise
-		CONFIGRET StatusError = CR_SUCCESS;
-		bool Started = false;
-		bool HasProblem = false;
-		ULONG ProblemCode = 0;
-	};
+		using nefarius::devcon::inf::InfArchitecture;
 
-	//
-	// A restart strategy reporting success (e.g. CM_Reenumerate_DevNode/SetupDiCallClassInstaller
-	// returning CR_SUCCESS/TRUE) only means the restart *mechanism* didn't error out; it does not
-	// guarantee the device is actually back and working (the driver could fail to load, or the
-	// devnode could settle into a problem state). Polls the devnode status until it reports
-	// DN_STARTED with no DN_HAS_PROBLEM, or Timeout elapses, returning whichever observation was
-	// current at that point (online or not). A device that has disappeared entirely (e.g.
-	// unplugged mid-restart, or a phantom node) is reflected as Located == false rather than as an
-	// error, so the caller can simply try a more invasive strategy, or give up, or - for the final
-	// authoritative re-check in RestartDeviceInstance - treat it as "nothing left to restart"
-	// rather than "stuck, needs a reboot".
-	// 
-	DevNodeObservation PollDevNodeStatus(const std::wstring& InstanceId, std::chrono::milliseconds Timeout)
-	{
-		const auto deadline = std::chrono::steady_clock::now() + Timeout;
+		SYSTEM_INFO info = {};
+		GetNativeSystemInfo(&info);
 
-		for (;;)
+		switch (info.wProcessorArchitecture)
 		{
-			DevNodeObservation observation;
-
-			if (const auto devInst = ::LocateDevNode(InstanceId, CM_LOCATE_DEVNODE_NORMAL); devInst)
-			{
-				observation.Located = true;
-
-				ULONG status = 0;
-				ULONG problemNumber = 0;
-
-				if (const auto statusResult = CM_Get_DevNode_Status(&status, &problemNumber, devInst.value(), 0);
-					statusResult == CR_SUCCESS)
-				{
-					observation.StatusValid = true;
-					observation.Started = (status & DN_STARTED) != 0;
-					observation.HasProblem = (status & DN_HAS_PROBLEM) != 0;
-					observation.ProblemCode = observation.HasProblem ? problemNumber : 0;
-				}
-				else
-				{
-					observation.StatusError = statusResult;
-				}
-			}
-
-			if (observation.Located && observation.StatusValid && observation.Started && !observation.HasProblem)
-			{
-				return observation;
-			}
-
-			const auto now = std::chrono::steady_clock::now();
-
-			if (now >= deadline)
-			{
-				return observation;
-			}
-
-			const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
-			Sleep(static_cast<DWORD>(std::min<std::chrono::milliseconds::rep>(100, remaining.count())));
+		case PROCESSOR_ARCHITECTURE_INTEL:
+			return {InfArchitecture::X86};
+		case PROCESSOR_ARCHITECTURE_IA64:
+			return {InfArchitecture::Ia64};
+		case PROCESSOR_ARCHITECTURE_ARM:
+			return {InfArchitecture::Arm};
+		case PROCESSOR_ARCHITECTURE_ARM64:
+			return {InfArchitecture::Arm64};
+		default:
+			return {InfArchitecture::Amd64};
 		}
 	}
 
-	bool WaitForDeviceOnline(const std::wstring& InstanceId, std::chrono::milliseconds Timeout)
+	//
+	// GUID of the custom class an INF names without a valid ClassGuid, as registered by its
+	// class installer; the registry lookup SetupDiGetINFClassW falls back to. The system-defined
+	// classes are resolved by AnalyzeInf itself.
+	//
+	std::optional<Guid> RegisteredClassGuid(const nefarius::devcon::inf::InfFile& File)
 	{
-		const auto observation = ::PollDevNodeStatus(InstanceId, Timeout);
-		return observation.Located && observation.StatusValid && observation.Started && !observation.HasProblem;
-	}
+		using namespace nefarius::devcon::inf;
 
-	std::wstring GetDeviceFriendlyNameBestEffort(const std::wstring& InstanceId)
-	{
-		const auto devInst = ::LocateDevNode(InstanceId, CM_LOCATE_DEVNODE_PHANTOM);
+		const auto classGuid = File.value(u"Version", u"ClassGuid");
+		const auto className = File.value(u"Version", u"Class");
 
-		if (!devInst)
+		if ((classGuid && ParseGuid(*classGuid)) || !className || className->empty()
+			|| SystemSetupClassGuid(*className))
 		{
-			return {};
+			return std::nullopt;
 		}
 
-		if (auto name = ::GetDevNodePropertyString(devInst.value(), DEVPKEY_Device_FriendlyName); name)
+		const std::wstring name(AsWide(*className));
+		std::vector<GUID> guids(1);
+		DWORD required = 0;
+
+		// several classes may share a name; like SetupDiGetINFClassW, the first one is used
+		while (!SetupDiClassGuidsFromNameW(name.c_str(), guids.data(), static_cast<DWORD>(guids.size()), &required))
 		{
-			return std::move(name.value());
+			if (GetLastError() != ERROR_INSUFFICIENT_BUFFER || required <= guids.size())
+			{
+				return std::nullopt;
+			}
+
+			guids.resize(required);
 		}
 
-		if (auto desc = ::GetDevNodePropertyString(devInst.value(), DEVPKEY_Device_DeviceDesc); desc)
+		if (required == 0)
 		{
-			return std::move(desc.value());
+			return std::nullopt;
 		}
 
-		return {};
+		return Guid(guids.front());
 	}
+}
 
-	//
-	// Extracts the first {xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx} substring, if any, and parses it.
-	// This handles fully-qualified AddReg/DelReg subkeys such as
-	// "SYSTEM\CurrentControlSet\Control\Class\{<guid>}" without needing to validate the
-	// remainder of the path.
-	// 
-	std::expected<GUID, Win32Error> ExtractGuidFromSubkeyPath(const std::wstring& Subkey)
+std::expected<nefarius::devcon::DeviceNode, std::error_code> nefarius::devcon::SystemDeviceTree::locate(
+	std::wstring_view InstanceId, bool Phantom)
+{
+	std::wstring id(InstanceId);
+	DEVINST devInst = 0;
+
+	const CONFIGRET cr = CM_Locate_DevNodeW(&devInst, id.data(),
+	                                        Phantom ? CM_LOCATE_DEVNODE_PHANTOM : CM_LOCATE_DEVNODE_NORMAL);
+
+	if (cr != CR_SUCCESS)
 	{
-		const auto open = Subkey.find(L'{');
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_NOT_FOUND));
+	}
 
-		if (open == std::wstring::npos)
-		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND));
-		}
+	return devInst;
+}
 
-		const auto close = Subkey.find(L'}', open);
+std::expected<std::vector<nefarius::devcon::DeviceNode>, std::error_code>
+nefarius::devcon::SystemDeviceTree::enumerate(bool PresentOnly, const Guid* ClassGuid)
+{
+	const DWORD flags = (ClassGuid ? 0 : DIGCF_ALLCLASSES) | (PresentOnly ? DIGCF_PRESENT : 0);
+	const GUID classGuid = ClassGuid ? static_cast<GUID>(*ClassGuid) : GUID{};
 
-		if (close == std::wstring::npos || close <= open)
-		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND));
-		}
+	guards::HDEVINFOHandleGuard hDevInfo(SetupDiGetClassDevs(ClassGuid ? &classGuid : nullptr, nullptr, nullptr,
+	                                                         flags));
 
-		const std::wstring guidText = Subkey.substr(open, close - open + 1);
+	if (hDevInfo.is_invalid())
+	{
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
+	}
+
+	std::vector<DeviceNode> nodes;
+	SP_DEVINFO_DATA devInfoData = {};
+	devInfoData.cbSize = sizeof(devInfoData);
 
-		return nefarius::winapi::GUIDFromString(ConvertWideToANSI(guidText));
+	for (DWORD index = 0; SetupDiEnumDeviceInfo(hDevInfo.get(), index, &devInfoData); index++)
+	{
+		nodes.push_back(devInfoData.DevInst);
 	}
 
-	//
-	// Scans a single AddReg/DelReg-referenced section for UpperFilters/LowerFilters directives.
-	// 
-	void CollectFiltersFromRegSection(HINF Inf, const std::wstring& SectionName, const GUID& BaseClassGuid,
-	                                  bool HaveBaseClassGuid,
-	                                  std::vector<nefarius::devcon::InfClassFilterTarget>& Results)
+	if (const DWORD lastError = GetLastError(); lastError != ERROR_NO_MORE_ITEMS)
 	{
-		INFCONTEXT ctx;
+		return std::unexpected(::Win32ErrorCode(lastError));
+	}
 
-		if (!SetupFindFirstLineW(Inf, SectionName.c_str(), nullptr, &ctx))
-		{
-			return;
-		}
+	return nodes;
+}
 
-		do
-		{
-			WCHAR root[LINE_LEN] = {};
-			WCHAR subkey[LINE_LEN] = {};
-			WCHAR valueName[LINE_LEN] = {};
-			WCHAR valueData[LINE_LEN] = {};
-
-			//
-			// AddReg/DelReg lines have no key, so field numbering starts at 1: field 1 is the
-			// root, field 2 the subkey, field 3 the value name, field 4 the flags, field 5 the data.
-			// 
-			if (!SetupGetStringFieldW(&ctx, 1, root, LINE_LEN, nullptr))
-			{
-				continue;
-			}
+std::expected<std::wstring, std::error_code> nefarius::devcon::SystemDeviceTree::instance_id(DeviceNode Node)
+{
+	WCHAR instanceId[MAX_DEVICE_ID_LEN] = {};
 
-			//
-			// Subkey (field 2) is legitimately empty for class-relative (HKR) entries
-			// 
-			SetupGetStringFieldW(&ctx, 2, subkey, LINE_LEN, nullptr);
+	if (CM_Get_Device_IDW(Node, instanceId, MAX_DEVICE_ID_LEN, 0) != CR_SUCCESS)
+	{
+		return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
+	}
 
-			if (!SetupGetStringFieldW(&ctx, 3, valueName, LINE_LEN, nullptr))
-			{
-				continue;
-			}
+	return std::wstring(instanceId);
+}
 
-			const bool isUpper = (_wcsicmp(valueName, L"UpperFilters") == 0);
-			const bool isLower = (_wcsicmp(valueName, L"LowerFilters") == 0);
+std::expected<nefarius::devcon::DeviceNode, std::error_code> nefarius::devcon::SystemDeviceTree::parent(
+	DeviceNode Node)
+{
+	DEVINST parent = 0;
 
-			if (!isUpper && !isLower)
-			{
-				continue;
-			}
+	if (const CONFIGRET cr = CM_Get_Parent(&parent, Node, 0); cr != CR_SUCCESS)
+	{
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_NOT_FOUND));
+	}
 
-			GUID targetGuid = {};
-			bool haveTarget = false;
+	return parent;
+}
 
-			if (_wcsicmp(root, L"HKR") == 0 && wcslen(subkey) == 0)
-			{
-				if (HaveBaseClassGuid)
-				{
-					targetGuid = BaseClassGuid;
-					haveTarget = true;
-				}
-			}
-			else if (const auto extracted = ::ExtractGuidFromSubkeyPath(subkey); extracted.has_value())
-			{
-				targetGuid = extracted.value();
-				haveTarget = true;
-			}
+std::expected<nefarius::devcon::DeviceNodeStatus, std::error_code> nefarius::devcon::SystemDeviceTree::status(
+	DeviceNode Node)
+{
+	ULONG status = 0;
+	ULONG problemNumber = 0;
 
-			if (!haveTarget)
-			{
-				continue;
-			}
+	if (const CONFIGRET cr = CM_Get_DevNode_Status(&status, &problemNumber, Node, 0); cr != CR_SUCCESS)
+	{
+		return std::unexpected(::ConfigRetStatusErrorCode(cr));
+	}
 
-			//
-			// UpperFilters/LowerFilters is a REG_MULTI_SZ (flags 0x00010008); an AddReg/DelReg
-			// line may list several filter service names starting at field 5, e.g.
-			// HKR,,"UpperFilters",0x00010008,"filter1","filter2". Emit one target per name; a
-			// DelReg line with no data fields at all (deleting the whole value) still yields a
-			// single target with an empty service name so the affected class isn't lost.
-			// 
-			const DWORD fieldCount = SetupGetFieldCount(&ctx);
-			const auto position = isLower
-				? nefarius::devcon::DeviceClassFilterPosition::Lower
-				: nefarius::devcon::DeviceClassFilterPosition::Upper;
-			bool anyServiceName = false;
-
-			for (DWORD field = 5; field <= fieldCount; field++)
-			{
-				if (!SetupGetStringFieldW(&ctx, field, valueData, LINE_LEN, nullptr) || valueData[0] == L'\0')
-				{
-					continue;
-				}
+	const bool hasProblem = (status & DN_HAS_PROBLEM) != 0;
 
-				anyServiceName = true;
-				Results.push_back(nefarius::devcon::InfClassFilterTarget{targetGuid, position, std::wstring(valueData)});
-			}
+	return DeviceNodeStatus{(status & DN_STARTED) != 0, hasProblem, hasProblem ? problemNumber : 0};
+}
 
-			if (!anyServiceName)
-			{
-				Results.push_back(nefarius::devcon::InfClassFilterTarget{targetGuid, position, std::wstring()});
-			}
-		}
-		while (SetupFindNextLine(&ctx, &ctx));
-	}
+std::expected<std::wstring, std::error_code> nefarius::devcon::SystemDeviceTree::property_string(
+	DeviceNode Node, DeviceProperty Property)
+{
+	const auto value = detail::ReadDevNodeProperty(Node, ::PropertyKey(Property));
 
-	//
-	// Resolves the (possibly multiple) AddReg=/DelReg= referenced sections of a DefaultInstall-style
-	// section and scans each of them.
-	// 
-	void CollectRegDirectiveTargets(HINF Inf, const std::wstring& SectionName, PCWSTR Key, const GUID& BaseClassGuid,
-	                                bool HaveBaseClassGuid, std::vector<nefarius::devcon::InfClassFilterTarget>&
-	                                Results)
+	if (!value)
 	{
-		INFCONTEXT ctx;
+		return std::unexpected(value.error());
+	}
 
-		if (!SetupFindFirstLineW(Inf, SectionName.c_str(), Key, &ctx))
-		{
-			return;
-		}
+	const auto string = value->string();
 
-		do
-		{
-			const DWORD fieldCount = SetupGetFieldCount(&ctx);
+	if (!string)
+	{
+		return std::unexpected(::Win32ErrorCode(ERROR_INVALID_DATATYPE));
+	}
 
-			for (DWORD field = 1; field <= fieldCount; field++)
-			{
-				WCHAR referencedSection[LINE_LEN] = {};
+	return std::wstring(string.value());
+}
 
-				if (!SetupGetStringFieldW(&ctx, field, referencedSection, LINE_LEN, nullptr))
-				{
-					continue;
-				}
+std::expected<std::vector<std::wstring>, std::error_code> nefarius::devcon::SystemDeviceTree::property_strings(
+	DeviceNode Node, DeviceProperty Property)
+{
+	const auto value = detail::ReadDevNodeProperty(Node, ::PropertyKey(Property));
 
-				::CollectFiltersFromRegSection(Inf, referencedSection, BaseClassGuid, HaveBaseClassGuid, Results);
-			}
-		}
-		while (SetupFindNextMatchLineW(&ctx, Key, &ctx));
+	if (!value)
+	{
+		return std::unexpected(value.error());
 	}
 
-	//
-	// Restarts a device via the classic DIF_PROPERTYCHANGE/DICS_PROPCHANGE mechanism. Works for
-	// most bus types but is routinely ignored by drivers that keep a handle open (e.g. HID/keyboard
-	// class drivers), which is why the USB port cycle is attempted first.
-	// 
-	StrategyOutcome TryPropertyChangeRestart(const std::wstring& InstanceId)
+	if (value->type() != DEVPROP_TYPE_STRING_LIST)
 	{
-		StrategyOutcome outcome;
-
-		guards::HDEVINFOHandleGuard hDevInfo(SetupDiCreateDeviceInfoList(nullptr, nullptr));
-
-		if (hDevInfo.is_invalid())
-		{
-			outcome.Result = std::unexpected(Win32Error("SetupDiCreateDeviceInfoList"));
-			return outcome;
-		}
+		return std::unexpected(::Win32ErrorCode(ERROR_INVALID_DATATYPE));
+	}
 
-		SP_DEVINFO_DATA devInfoData = {};
-		devInfoData.cbSize = sizeof(devInfoData);
+	const auto entries = value->strings().value();
 
-		if (!SetupDiOpenDeviceInfoW(hDevInfo.get(), InstanceId.c_str(), nullptr, 0, &devInfoData))
-		{
-			outcome.Result = std::unexpected(Win32Error("SetupDiOpenDeviceInfoW"));
-			return outcome;
-		}
+	return std::vector<std::wstring>(entries.begin(), entries.end());
+}
 
-		SP_PROPCHANGE_PARAMS params = {};
-		params.ClassInstallHeader.cbSize = sizeof(SP_CLASSINSTALL_HEADER);
-		params.ClassInstallHeader.InstallFunction = DIF_PROPERTYCHANGE;
-		params.Scope = DICS_FLAG_GLOBAL;
-		params.StateChange = DICS_PROPCHANGE;
+std::expected<uint32_t, std::error_code> nefarius::devcon::SystemDeviceTree::property_uint32(
+	DeviceNode Node, DeviceProperty Property)
+{
+	const auto value = detail::ReadDevNodeProperty(Node, ::PropertyKey(Property));
 
-		if (!SetupDiSetClassInstallParams(hDevInfo.get(), &devInfoData, &params.ClassInstallHeader, sizeof(params)))
-		{
-			outcome.Result = std::unexpected(Win32Error("SetupDiSetClassInstallParams"));
-			return outcome;
-		}
+	if (!value)
+	{
+		return std::unexpected(value.error());
+	}
 
-		if (!SetupDiCallClassInstaller(DIF_PROPERTYCHANGE, hDevInfo.get(), &devInfoData))
-		{
-			//
-			// Don't inspect the install params below on a failed call: DI_NEEDREBOOT/DI_NEEDRESTART
-			// reflects the outcome of a class installer action that actually ran, and can otherwise
-			// carry stale/incidental flags from this devinfo set that have nothing to do with this
-			// particular (failed) attempt - a false "reboot needed" signal for a device that in fact
-			// was never successfully touched by this strategy.
-			// 
-			outcome.Result = std::unexpected(Win32Error("SetupDiCallClassInstaller"));
-			return outcome;
-		}
+	const auto number = value->uint32();
 
-		SP_DEVINSTALL_PARAMS_W installParams = {};
-		installParams.cbSize = sizeof(installParams);
+	if (!number)
+	{
+		return std::unexpected(::Win32ErrorCode(ERROR_INVALID_DATATYPE));
+	}
 
-		if (SetupDiGetDeviceInstallParamsW(hDevInfo.get(), &devInfoData, &installParams))
-		{
-			outcome.RebootRequired = (installParams.Flags & (DI_NEEDRESTART | DI_NEEDREBOOT)) != 0;
-		}
+	return number.value();
+}
 
-		outcome.Result = {};
-		return outcome;
-	}
+std::expected<nefarius::utilities::Guid, std::error_code> nefarius::devcon::SystemDeviceTree::property_guid(
+	DeviceNode Node, DeviceProperty Property)
+{
+	const auto value = detail::ReadDevNodeProperty(Node, ::PropertyKey(Property));
 
-	//
-	// Bundles the outcome of a single detach attempt. Kept separate from StrategyOutcome (rather
-	// than deriving from it) since RebootRequired has no meaning for a query-remove-subtree call.
-	// 
-	struct DetachOutcome
+	if (!value)
 	{
-		std::expected<void, Win32Error> Result;
-
-		//
-		// Valid immediately after a successful detach, for same-call-chain reenumeration
-		// (TryRemoveAndReenumerate). Do not persist across process boundaries; use
-		// ParentInstanceId (a stable string identifier) for that instead.
-		// 
-		DEVINST ParentDevInst = 0;
+		return std::unexpected(value.error());
+	}
 
-		std::wstring ParentInstanceId;
+	const auto guid = value->guid();
 
-		std::wstring VetoName;
+	if (!guid)
+	{
+		return std::unexpected(::Win32ErrorCode(ERROR_INVALID_DATATYPE));
+	}
 
-		PNP_VETO_TYPE VetoType = PNP_VetoTypeUnknown;
-	};
+	return guid.value();
+}
 
-	struct ReenumerateOutcome
-	{
-		std::expected<void, Win32Error> Result;
-	};
+std::expected<void, std::error_code> nefarius::devcon::SystemDeviceTree::append_property(
+	DeviceNode Node, DeviceProperty Property, std::wstring& Buffer)
+{
+	const bool isList = GetDevicePropertyType(Property) == DevicePropertyType::StringList;
+	const size_t offset = Buffer.size();
 
 	//
-	// Removes a device's devnode sub-tree, releasing any file locks its driver holds, without
-	// re-enumerating the parent. The PnP manager may veto the removal if a driver/application is
-	// actively using the device, in which case the veto reason is surfaced and nothing is torn
-	// down; the removal is never forced.
+	// Read straight into the tail of Buffer, which most values fit into; the size is only probed
+	// (by the failing first read) if one doesn't, and it may grow in between, so that's retried
 	// 
-	DetachOutcome TryDetachDevice(const std::wstring& InstanceId)
-	{
-		DetachOutcome outcome;
+	constexpr size_t initialChars = 256;
 
-		const auto devInst = ::LocateDevNode(InstanceId, CM_LOCATE_DEVNODE_NORMAL);
+	Buffer.resize(offset + initialChars);
 
-		if (!devInst)
-		{
-			outcome.Result = std::unexpected(devInst.error());
-			return outcome;
-		}
+	for (int attempt = 0; attempt < 3; attempt++)
+	{
+		DEVPROPTYPE type = DEVPROP_TYPE_EMPTY;
+		ULONG size = static_cast<ULONG>((Buffer.size() - offset) * sizeof(wchar_t));
 
-		DEVINST parent = 0;
-		CONFIGRET cr = CM_Get_Parent(&parent, devInst.value(), 0);
+		const CONFIGRET cr = CM_Get_DevNode_PropertyW(Node, &::PropertyKey(Property), &type,
+		                                              reinterpret_cast<PBYTE>(Buffer.data() + offset), &size, 0);
 
-		if (cr != CR_SUCCESS)
+		if (cr == CR_BUFFER_SMALL)
 		{
-			outcome.Result = std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_NOT_FOUND), "CM_Get_Parent"));
-			return outcome;
+			Buffer.resize(offset + size / sizeof(wchar_t) + 1);
+			continue;
 		}
 
-		WCHAR parentInstanceId[MAX_DEVICE_ID_LEN] = {};
-
-		if (CM_Get_Device_IDW(parent, parentInstanceId, MAX_DEVICE_ID_LEN, 0) != CR_SUCCESS)
+		if (cr != CR_SUCCESS || type != (isList ? DEVPROP_TYPE_STRING_LIST : DEVPROP_TYPE_STRING))
 		{
-			outcome.Result = std::unexpected(Win32Error(ERROR_NOT_FOUND, "CM_Get_Device_IDW"));
-			return outcome;
-		}
-
-		PNP_VETO_TYPE vetoType = PNP_VetoTypeUnknown;
-		WCHAR vetoName[MAX_PATH] = {};
+			Buffer.resize(offset);
 
-		cr = CM_Query_And_Remove_SubTreeW(devInst.value(), &vetoType, vetoName, MAX_PATH, CM_REMOVE_UI_NOT_OK);
-
-		if (cr == CR_REMOVE_VETOED)
-		{
-			outcome.VetoName = vetoName;
-			outcome.VetoType = vetoType;
-			outcome.Result = std::unexpected(Win32Error(ERROR_CANCELLED, "CM_Query_And_Remove_SubTreeW"));
-			return outcome;
-		}
+			if (cr == CR_SUCCESS)
+			{
+				return std::unexpected(::Win32ErrorCode(ERROR_INVALID_DATATYPE));
+			}
 
-		if (cr != CR_SUCCESS)
-		{
-			outcome.Result = std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                            "CM_Query_And_Remove_SubTreeW"));
-			return outcome;
+			return std::unexpected(cr == CR_NO_SUCH_VALUE
+				                       ? ::Win32ErrorCode(ERROR_NOT_FOUND)
+				                       : ::ConfigRetErrorCode(cr, ERROR_CAN_NOT_COMPLETE));
 		}
 
-		outcome.ParentDevInst = parent;
-		outcome.ParentInstanceId = parentInstanceId;
-		outcome.Result = {};
-		return outcome;
-	}
-
-	ReenumerateOutcome TryReenumerateParent(const std::wstring& ParentInstanceId)
-	{
-		ReenumerateOutcome outcome;
-
-		const auto devInst = ::LocateDevNode(ParentInstanceId, CM_LOCATE_DEVNODE_NORMAL);
+		//
+		// Drop the terminator(s), then keep exactly one behind the last list entry
+		// 
+		size_t end = offset + size / sizeof(wchar_t);
 
-		if (!devInst)
+		while (end > offset && Buffer[end - 1] == L'\0')
 		{
-			outcome.Result = std::unexpected(devInst.error());
-			return outcome;
+			end--;
 		}
 
-		const CONFIGRET cr = CM_Reenumerate_DevNode(devInst.value(), CM_REENUMERATE_SYNCHRONOUS);
+		Buffer.resize(end);
 
-		if (cr != CR_SUCCESS)
+		if (isList && end > offset)
 		{
-			outcome.Result = std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                            "CM_Reenumerate_DevNode"));
-			return outcome;
+			Buffer.push_back(L'\0');
 		}
 
-		outcome.Result = {};
-		return outcome;
+		return {};
 	}
 
-	//
-	// Removes the device sub-tree and forces its parent to re-enumerate. Most invasive restart
-	// strategy; shares TryDetachDevice with the public DetachDeviceInstance API.
-	// 
-	StrategyOutcome TryRemoveAndReenumerate(const std::wstring& InstanceId)
-	{
-		StrategyOutcome outcome;
-
-		const DetachOutcome detach = ::TryDetachDevice(InstanceId);
+	Buffer.resize(offset);
 
-		outcome.VetoName = detach.VetoName;
-		outcome.VetoType = detach.VetoType;
-
-		if (!detach.Result.has_value())
-		{
-			outcome.Result = std::unexpected(detach.Result.error());
-			return outcome;
-		}
-
-		const CONFIGRET cr = CM_Reenumerate_DevNode(detach.ParentDevInst, CM_REENUMERATE_SYNCHRONOUS);
-
-		if (cr != CR_SUCCESS)
-		{
-			outcome.Result = std::unexpected(Win32Error(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE),
-			                                            "CM_Reenumerate_DevNode"));
-			return outcome;
-		}
+	return std::unexpected(::Win32ErrorCode(ERROR_CAN_NOT_COMPLETE));
+}
 
-		outcome.Result = {};
-		return outcome;
-	}
+std::expected<bool, std::error_code> nefarius::devcon::SystemDeviceTree::restart(DeviceNode Node)
+{
+	const auto instanceId = instance_id(Node);
 
-	StrategyOutcome TryUsbPortCycle(const std::wstring& InstanceId)
+	if (!instanceId)
 	{
-		StrategyOutcome outcome;
-		outcome.Result = nefarius::devcon::CycleUsbPortOfDevice(InstanceId);
-		return outcome;
+		return std::unexpected(instanceId.error());
 	}
-}
 
-std::expected<std::vector<std::wstring>, Win32Error> nefarius::devcon::ListDeviceInstancesByClass(
-	const GUID* ClassGuid, bool PresentOnly)
-{
-	const DWORD flags = PresentOnly ? DIGCF_PRESENT : 0;
-
-	guards::HDEVINFOHandleGuard hDevInfo(SetupDiGetClassDevs(ClassGuid, nullptr, nullptr, flags));
+	guards::HDEVINFOHandleGuard hDevInfo(SetupDiCreateDeviceInfoList(nullptr, nullptr));
 
 	if (hDevInfo.is_invalid())
 	{
-		return std::unexpected(Win32Error("SetupDiGetClassDevs"));
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
-	std::vector<std::wstring> instances;
 	SP_DEVINFO_DATA devInfoData = {};
 	devInfoData.cbSize = sizeof(devInfoData);
 
-	for (DWORD index = 0; SetupDiEnumDeviceInfo(hDevInfo.get(), index, &devInfoData); index++)
+	if (!SetupDiOpenDeviceInfoW(hDevInfo.get(), instanceId->c_str(), nullptr, 0, &devInfoData))
 	{
-		WCHAR instanceId[MAX_DEVICE_ID_LEN] = {};
-
-		if (SetupDiGetDeviceInstanceIdW(hDevInfo.get(), &devInfoData, instanceId, MAX_DEVICE_ID_LEN, nullptr))
-		{
-			instances.emplace_back(instanceId);
-		}
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
-	return instances;
-}
-
-std::expected<std::vector<std::wstring>, Win32Error> nefarius::devcon::ListDeviceInstancesByService(
-	const std::wstring& ServiceName, bool PresentOnly)
-{
-	const DWORD flags = DIGCF_ALLCLASSES | (PresentOnly ? DIGCF_PRESENT : 0);
+	SP_PROPCHANGE_PARAMS params = {};
+	params.ClassInstallHeader.cbSize = sizeof(SP_CLASSINSTALL_HEADER);
+	params.ClassInstallHeader.InstallFunction = DIF_PROPERTYCHANGE;
+	params.Scope = DICS_FLAG_GLOBAL;
+	params.StateChange = DICS_PROPCHANGE;
 
-	guards::HDEVINFOHandleGuard hDevInfo(SetupDiGetClassDevs(nullptr, nullptr, nullptr, flags));
-
-	if (hDevInfo.is_invalid())
+	if (!SetupDiSetClassInstallParams(hDevInfo.get(), &devInfoData, &params.ClassInstallHeader, sizeof(params)))
 	{
-		return std::unexpected(Win32Error("SetupDiGetClassDevs"));
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
-	std::vector<std::wstring> instances;
-	SP_DEVINFO_DATA devInfoData = {};
-	devInfoData.cbSize = sizeof(devInfoData);
-
-	for (DWORD index = 0; SetupDiEnumDeviceInfo(hDevInfo.get(), index, &devInfoData); index++)
+	if (!SetupDiCallClassInstaller(DIF_PROPERTYCHANGE, hDevInfo.get(), &devInfoData))
 	{
-		const auto service = ::GetDevNodePropertyString(devInfoData.DevInst, DEVPKEY_Device_Service);
-
-		if (!service || _wcsicmp(service.value().c_str(), ServiceName.c_str()) != 0)
-		{
-			continue;
-		}
-
-		WCHAR instanceId[MAX_DEVICE_ID_LEN] = {};
-
-		if (SetupDiGetDeviceInstanceIdW(hDevInfo.get(), &devInfoData, instanceId, MAX_DEVICE_ID_LEN, nullptr))
-		{
-			instances.emplace_back(instanceId);
-		}
+		//
+		// Don't inspect the install params below on a failed call: DI_NEEDREBOOT/DI_NEEDRESTART
+		// reflects the outcome of a class installer action that actually ran, and can otherwise
+		// carry stale/incidental flags from this devinfo set that have nothing to do with this
+		// particular (failed) attempt - a false "reboot needed" signal for a device that in fact
+		// was never successfully touched by this strategy.
+		// 
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
-	if (const DWORD lastError = GetLastError(); lastError != ERROR_NO_MORE_ITEMS)
+	SP_DEVINSTALL_PARAMS_W installParams = {};
+	installParams.cbSize = sizeof(installParams);
+
+	if (SetupDiGetDeviceInstallParamsW(hDevInfo.get(), &devInfoData, &installParams))
 	{
-		return std::unexpected(Win32Error(lastError, "SetupDiEnumDeviceInfo"));
+		return (installParams.Flags & (DI_NEEDRESTART | DI_NEEDREBOOT)) != 0;
 	}
 
-	return instances;
+	return false;
 }
 
-nefarius::devcon::DetachResult nefarius::devcon::DetachDeviceInstance(
-	const std::wstring& InstanceId, std::chrono::milliseconds Timeout)
+std::expected<void, std::error_code> nefarius::devcon::SystemDeviceTree::remove_subtree(
+	DeviceNode Node, DeviceRemovalVeto& Veto)
 {
-	DetachResult result;
-	result.InstanceId = InstanceId;
-	result.FriendlyName = ::GetDeviceFriendlyNameBestEffort(InstanceId);
+	PNP_VETO_TYPE vetoType = PNP_VetoTypeUnknown;
+	WCHAR vetoName[MAX_PATH] = {};
 
-	auto outcome = ::RunBounded<DetachOutcome>(Timeout, [InstanceId] { return ::TryDetachDevice(InstanceId); });
+	const CONFIGRET cr = CM_Query_And_Remove_SubTreeW(Node, &vetoType, vetoName, MAX_PATH, CM_REMOVE_UI_NOT_OK);
 
-	if (!outcome.has_value())
+	if (cr == CR_REMOVE_VETOED)
 	{
-		result.TimedOut = true;
-		result.LastError = ERROR_TIMEOUT;
-		return result;
+		Veto.Type = static_cast<uint32_t>(vetoType);
+		Veto.Name = vetoName;
+		return std::unexpected(::Win32ErrorCode(ERROR_CANCELLED));
 	}
 
-	if (outcome->Result.has_value())
+	if (cr != CR_SUCCESS)
 	{
-		result.Succeeded = true;
-		result.LastError = ERROR_SUCCESS;
-		result.ParentInstanceId = outcome->ParentInstanceId;
-		return result;
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_CAN_NOT_COMPLETE));
 	}
 
-	result.LastError = outcome->Result.error().getErrorCode();
-	result.VetoName = outcome->VetoName;
-	result.VetoType = outcome->VetoType;
-	return result;
+	return {};
 }
 
-nefarius::devcon::ReenumerateResult nefarius::devcon::ReenumerateParentDevNode(
-	const std::wstring& ParentInstanceId, std::chrono::milliseconds Timeout)
+std::expected<void, std::error_code> nefarius::devcon::SystemDeviceTree::reenumerate(DeviceNode Node)
 {
-	ReenumerateResult result;
-	result.InstanceId = ParentInstanceId;
-
-	auto outcome = ::RunBounded<ReenumerateOutcome>(
-		Timeout, [ParentInstanceId] { return ::TryReenumerateParent(ParentInstanceId); });
-
-	if (!outcome.has_value())
+	if (const CONFIGRET cr = CM_Reenumerate_DevNode(Node, CM_REENUMERATE_SYNCHRONOUS); cr != CR_SUCCESS)
 	{
-		result.TimedOut = true;
-		result.LastError = ERROR_TIMEOUT;
-		return result;
+		return std::unexpected(::ConfigRetErrorCode(cr, ERROR_CAN_NOT_COMPLETE));
 	}
 
-	if (outcome->Result.has_value())
-	{
-		result.Succeeded = true;
-		result.LastError = ERROR_SUCCESS;
-		return result;
-	}
-
-	result.LastError = outcome->Result.error().getErrorCode();
-	return result;
+	return {};
 }
 
-std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std::wstring& InstanceId)
+std::expected<void, std::error_code> nefarius::devcon::SystemDeviceTree::cycle_port(DeviceNode Hub, uint32_t Port)
 {
-	const auto startDevInst = ::LocateDevNode(InstanceId, CM_LOCATE_DEVNODE_PHANTOM);
-
-	if (!startDevInst)
-	{
-		return std::unexpected(startDevInst.error());
-	}
-
-	DEVINST current = startDevInst.value();
-	DEVINST composite = startDevInst.value();
-	DEVINST hub = 0;
-	bool foundHub = false;
-
-	//
-	// Walk up the devnode tree until we hit a USB hub, remembering the last node visited before
-	// it (the "composite" node), whose Device_Address property is the hub's port number.
-	// 
-	for (int depth = 0; depth < 64; depth++)
-	{
-		if (const auto service = ::GetDevNodePropertyString(current, DEVPKEY_Device_Service); service)
-		{
-			if (service.value().starts_with(L"USBHUB") ||
-				_wcsnicmp(service.value().c_str(), L"USBHUB", 6) == 0)
-			{
-				hub = current;
-				foundHub = true;
-				break;
-			}
-		}
-
-		composite = current;
-
-		DEVINST parent = 0;
-		const CONFIGRET cr = CM_Get_Parent(&parent, current, 0);
-
-		if (cr != CR_SUCCESS)
-		{
-			break;
-		}
-
-		current = parent;
-	}
-
-	if (!foundHub)
-	{
-		return std::unexpected(Win32Error(ERROR_NOT_SUPPORTED, "No USB hub ancestor found for device"));
-	}
-
-	const auto port = ::GetDevNodePropertyUint32(composite, DEVPKEY_Device_Address);
-
-	if (!port)
-	{
-		return std::unexpected(port.error());
-	}
-
 	WCHAR hubInstanceId[MAX_DEVICE_ID_LEN] = {};
 
-	if (CM_Get_Device_IDW(hub, hubInstanceId, MAX_DEVICE_ID_LEN, 0) != CR_SUCCESS)
+	if (CM_Get_Device_IDW(Hub, hubInstanceId, MAX_DEVICE_ID_LEN, 0) != CR_SUCCESS)
 	{
-		return std::unexpected(Win32Error(ERROR_NOT_FOUND, "CM_Get_Device_IDW"));
+		return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
 	}
 
 	GUID hubInterfaceGuid = GUID_DEVINTERFACE_USB_HUB;
@@ -852,12 +525,13 @@ std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std
 		if (CM_Get_Device_Interface_List_SizeW(&listLength, &hubInterfaceGuid, hubInstanceId,
 		                                       CM_GET_DEVICE_INTERFACE_LIST_PRESENT) != CR_SUCCESS)
 		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND, "CM_Get_Device_Interface_List_SizeW"));
+			return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
 		}
 
+		// the hub has no live device interface
 		if (listLength <= 1)
 		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND, "USB hub has no live device interface"));
+			return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
 		}
 
 		listBuffer.assign(listLength, L'\0');
@@ -872,7 +546,7 @@ std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std
 
 		if (cr != CR_BUFFER_SMALL || attempt == 2)
 		{
-			return std::unexpected(Win32Error(ERROR_NOT_FOUND, "CM_Get_Device_Interface_ListW"));
+			return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
 		}
 	}
 
@@ -880,7 +554,7 @@ std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std
 
 	if (hubPath.empty())
 	{
-		return std::unexpected(Win32Error(ERROR_NOT_FOUND, "Empty USB hub device interface path"));
+		return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
 	}
 
 	guards::InvalidHandleGuard hubHandle(CreateFileW(
@@ -895,11 +569,11 @@ std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std
 
 	if (hubHandle.is_invalid())
 	{
-		return std::unexpected(Win32Error("CreateFileW"));
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
 	USB_CYCLE_PORT_PARAMS params = {};
-	params.ConnectionIndex = port.value();
+	params.ConnectionIndex = Port;
 
 	DWORD bytesReturned = 0;
 
@@ -916,234 +590,246 @@ std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std
 
 	if (!success)
 	{
-		const DWORD win32Error = GetLastError();
-
-		if (win32Error == ERROR_GEN_FAILURE)
-		{
-			return std::unexpected(Win32Error(win32Error,
-			                                  "IOCTL_USB_HUB_CYCLE_PORT failed, this operation requires administrative privileges"));
-		}
-
-		if (win32Error == ERROR_NO_SUCH_DEVICE)
-		{
-			return std::unexpected(Win32Error(win32Error, "IOCTL_USB_HUB_CYCLE_PORT: port not found"));
-		}
-
-		return std::unexpected(Win32Error(win32Error, "IOCTL_USB_HUB_CYCLE_PORT"));
+		return std::unexpected(::Win32ErrorCode(GetLastError()));
 	}
 
 	if (params.StatusReturned != 0)
 	{
-		return std::unexpected(Win32Error(ERROR_GEN_FAILURE, std::format(
-			                       "IOCTL_USB_HUB_CYCLE_PORT reported a non-zero status: {}", params.StatusReturned)));
+		return std::unexpected(::Win32ErrorCode(ERROR_GEN_FAILURE));
 	}
 
 	return {};
 }
 
-template <nefarius::utilities::string_type StringType>
-std::expected<std::vector<nefarius::devcon::InfClassFilterTarget>, Win32Error>
-nefarius::devcon::GetInfClassFilterTargets(const StringType& FullInfPath)
+std::optional<uint64_t> nefarius::devcon::SystemDeviceTree::compatible_driver_version(DeviceNode Node)
 {
-	const std::wstring fullInfPath = ConvertToWide(FullInfPath);
-
-	WCHAR normalisedInfPath[MAX_PATH] = {};
+	const auto instanceId = instance_id(Node);
 
-	if (const auto ret = GetFullPathNameW(fullInfPath.c_str(), MAX_PATH, normalisedInfPath, nullptr);
-		(ret >= MAX_PATH) || (ret == FALSE))
+	if (!instanceId)
 	{
-		return std::unexpected(Win32Error(ERROR_BAD_PATHNAME));
+		return std::nullopt;
 	}
 
-	guards::INFHandleGuard hInf(SetupOpenInfFileW(normalisedInfPath, nullptr, INF_STYLE_WIN4, nullptr));
+	guards::HDEVINFOHandleGuard hDevInfo(SetupDiCreateDeviceInfoList(nullptr, nullptr));
 
-	if (hInf.is_invalid())
+	if (hDevInfo.is_invalid())
 	{
-		return std::unexpected(Win32Error());
+		return std::nullopt;
 	}
 
-	GUID baseClassGuid = {};
-	bool haveBaseClassGuid = false;
-	std::wstring className(MAX_CLASS_NAME_LEN, L'\0');
+	SP_DEVINFO_DATA devInfoData = {};
+	devInfoData.cbSize = sizeof(devInfoData);
 
-	if (SetupDiGetINFClassW(normalisedInfPath, &baseClassGuid, className.data(),
-	                       (DWORD)className.size(), nullptr))
+	if (!SetupDiOpenDeviceInfoW(hDevInfo.get(), instanceId->c_str(), nullptr, 0, &devInfoData))
 	{
-		haveBaseClassGuid = true;
+		return std::nullopt;
 	}
 
-	std::vector<InfClassFilterTarget> results;
+	// Build a list of driver info items that we will retrieve below
+	if (!SetupDiBuildDriverInfoList(hDevInfo.get(), &devInfoData, SPDIT_COMPATDRIVER))
+	{
+		return std::nullopt;
+	}
 
-	for (const auto* sectionKeyword : {L"DefaultInstall", L"DefaultUninstall"})
+	const auto driverGuard = sg::make_scope_guard([&hDevInfo, &devInfoData]() noexcept
 	{
-		WCHAR resolvedSection[LINE_LEN] = {};
-		DWORD reqSize = 0;
+		SetupDiDestroyDriverInfoList(hDevInfo.get(), &devInfoData, SPDIT_COMPATDRIVER);
+	});
 
-		if (!SetupDiGetActualSectionToInstallW(hInf.get(), sectionKeyword, resolvedSection, LINE_LEN, &reqSize,
-		                                       nullptr))
-		{
-			//
-			// Section not present for this INF/platform combination, not an error condition
-			// 
-			continue;
-		}
+	// Get the first info item for this driver
+	SP_DRVINFO_DATA drvInfo = {};
+	drvInfo.cbSize = sizeof(SP_DRVINFO_DATA);
+
+	if (!SetupDiEnumDriverInfo(hDevInfo.get(), &devInfoData, SPDIT_COMPATDRIVER, 0, &drvInfo))
+	{
+		return std::nullopt;
+	}
+
+	return drvInfo.DriverVersion;
+}
+
+std::expected<std::vector<std::wstring>, Win32Error> nefarius::devcon::ListDeviceInstancesByClass(
+	const GUID* ClassGuid, bool PresentOnly)
+{
+	const DWORD flags = PresentOnly ? DIGCF_PRESENT : 0;
+
+	guards::HDEVINFOHandleGuard hDevInfo(SetupDiGetClassDevs(ClassGuid, nullptr, nullptr, flags));
 
-		::CollectRegDirectiveTargets(hInf.get(), resolvedSection, L"AddReg", baseClassGuid, haveBaseClassGuid,
-		                            results);
-		::CollectRegDirectiveTargets(hInf.get(), resolvedSection, L"DelReg", baseClassGuid, haveBaseClassGuid,
-		                            results);
+	if (hDevInfo.is_invalid())
+	{
+		return std::unexpected(Win32Error("SetupDiGetClassDevs"));
 	}
 
-	std::vector<InfClassFilterTarget> deduped;
+	std::vector<std::wstring> instances;
+	SP_DEVINFO_DATA devInfoData = {};
+	devInfoData.cbSize = sizeof(devInfoData);
 
-	for (auto& target : results)
+	for (DWORD index = 0; SetupDiEnumDeviceInfo(hDevInfo.get(), index, &devInfoData); index++)
 	{
-		const bool alreadyPresent = std::ranges::any_of(deduped, [&](const InfClassFilterTarget& existing)
-		{
-			return IsEqualGUID(existing.ClassGuid, target.ClassGuid)
-				&& existing.Position == target.Position
-				&& _wcsicmp(existing.ServiceName.c_str(), target.ServiceName.c_str()) == 0;
-		});
+		WCHAR instanceId[MAX_DEVICE_ID_LEN] = {};
 
-		if (!alreadyPresent)
+		if (SetupDiGetDeviceInstanceIdW(hDevInfo.get(), &devInfoData, instanceId, MAX_DEVICE_ID_LEN, nullptr))
 		{
-			deduped.push_back(target);
+			instances.emplace_back(instanceId);
 		}
 	}
 
-	return deduped;
+	return instances;
 }
 
-nefarius::devcon::DeviceRestartResult nefarius::devcon::RestartDeviceInstance(
-	const std::wstring& InstanceId, const DeviceRestartOptions& Options)
+std::expected<nefarius::devcon::DeviceSnapshot, Win32Error> nefarius::devcon::SnapshotDevices(
+	const GUID* ClassGuid, std::span<const DeviceProperty> Properties, bool PresentOnly)
 {
-	DeviceRestartResult result;
-	result.InstanceId = InstanceId;
-	result.FriendlyName = ::GetDeviceFriendlyNameBestEffort(InstanceId);
+	DeviceSnapshotOptions options;
+	options.PresentOnly = PresentOnly;
 
-	struct Attempt
+	if (ClassGuid)
 	{
-		RestartStrategy Strategy;
-		bool Enabled;
-		std::function<StrategyOutcome()> Fn;
-	};
+		options.ClassGuid = Guid(*ClassGuid);
+	}
 
-	const std::array<Attempt, 3> attempts{
-		{
-			{
-				RestartStrategy::UsbPortCycle, Options.AllowUsbPortCycle,
-				[InstanceId] { return ::TryUsbPortCycle(InstanceId); }
-			},
-			{
-				RestartStrategy::PropertyChange, Options.AllowPropertyChange,
-				[InstanceId] { return ::TryPropertyChangeRestart(InstanceId); }
-			},
-			{
-				RestartStrategy::RemoveAndReenumerate, Options.AllowRemoveAndReenumerate,
-				[InstanceId] { return ::TryRemoveAndReenumerate(InstanceId); }
-			},
-		}
-	};
+	auto snapshot = DeviceSnapshot::Capture(::SystemTree(), Properties, options);
 
-	//
-	// Tracks the most recent strategy whose *mechanism* actually reported success (independent of
-	// whether WaitForDeviceOnline verified it in time), so the delayed-verification path below can
-	// credit the strategy that plausibly caused the device to come back, instead of whatever was
-	// merely tried last (which may have been vetoed, errored out, or timed out).
-	// 
-	RestartStrategy lastMechanismSucceeded = RestartStrategy::None;
+	if (!snapshot)
+	{
+		return std::unexpected(::ToWin32Error(snapshot.error(), "SetupDiGetClassDevs"));
+	}
+
+	return std::move(snapshot.value());
+}
 
-	for (const auto& attempt : attempts)
+std::expected<nefarius::devcon::DeviceIndex, Win32Error> nefarius::devcon::BuildDeviceIndex(bool PresentOnly)
+{
+	auto index = DeviceIndex::Build(::SystemTree(), PresentOnly);
+
+	if (!index)
 	{
-		if (!attempt.Enabled)
-		{
-			continue;
-		}
+		return std::unexpected(::ToWin32Error(index.error(), "SetupDiGetClassDevs"));
+	}
 
-		result.LastAttempted = attempt.Strategy;
+	return std::move(index.value());
+}
 
-		auto outcome = ::RunBounded<StrategyOutcome>(Options.PerDeviceTimeout, attempt.Fn);
+std::expected<std::vector<std::wstring>, Win32Error> nefarius::devcon::ListDeviceInstancesByService(
+	const std::wstring& ServiceName, bool PresentOnly)
+{
+	auto instances = ListDeviceInstancesByService(::SystemTree(), ServiceName, PresentOnly);
 
-		if (!outcome.has_value())
-		{
-			//
-			// The worker may still be running; never start a second strategy racing against it
-			// 
-			result.TimedOut = true;
-			result.LastError = ERROR_TIMEOUT;
-			break;
-		}
+	if (!instances)
+	{
+		return std::unexpected(::ToWin32Error(instances.error(), "SetupDiEnumDeviceInfo"));
+	}
 
-		if (outcome->Result.has_value())
-		{
-			lastMechanismSucceeded = attempt.Strategy;
-
-			//
-			// Only trust this strategy's RebootRequired signal now that its mechanism actually
-			// succeeded: install-params flags read after a failed attempt can be stale/incidental
-			// and would otherwise let a "device could not be restarted" warning outrank a driver
-			// operation (e.g. service removal) that itself completed cleanly.
-			// 
-			result.RebootRequired = result.RebootRequired || outcome->RebootRequired;
-
-			//
-			// Don't just trust the strategy's own success signal: confirm the device is
-			// actually back online (present, started, no problem code) before declaring
-			// victory. If it isn't (yet), fall through to try any remaining, more invasive
-			// strategy instead of reporting a false positive.
-			// 
-			if (::WaitForDeviceOnline(InstanceId, Options.PostRestartVerifyTimeout))
-			{
-				result.Strategy = attempt.Strategy;
-				result.Succeeded = true;
-				result.LastError = ERROR_SUCCESS;
-				break;
-			}
+	return std::move(instances.value());
+}
 
-			result.LastError = ERROR_DEVICE_NOT_CONNECTED;
-			continue;
-		}
+nefarius::devcon::DetachResult nefarius::devcon::DetachDeviceInstance(
+	const std::wstring& InstanceId, std::chrono::milliseconds Timeout)
+{
+	return DetachDeviceInstance(::SystemTree(), InstanceId, Timeout);
+}
+
+nefarius::devcon::ReenumerateResult nefarius::devcon::ReenumerateParentDevNode(
+	const std::wstring& ParentInstanceId, std::chrono::milliseconds Timeout)
+{
+	return ReenumerateParentDevNode(::SystemTree(), ParentInstanceId, Timeout);
+}
+
+std::expected<void, Win32Error> nefarius::devcon::CycleUsbPortOfDevice(const std::wstring& InstanceId)
+{
+	const auto result = CycleUsbPortOfDevice(::SystemTree(), InstanceId);
 
-		result.LastError = outcome->Result.error().getErrorCode();
-		result.VetoName = outcome->VetoName;
-		result.VetoType = outcome->VetoType;
+	if (result)
+	{
+		return {};
 	}
 
-	//
-	// Every strategy has been exhausted (or none were enabled) without a verified success. Before
-	// reporting failure, take one final authoritative look at the devnode instead of trusting the
-	// last strategy's own (possibly premature) verify window: this is a plain status query, safe
-	// to run even if the last attempt above hit PerDeviceTimeout and its worker is still running
-	// in the background, since it does not touch anything that worker owns. A device that settles
-	// into DN_STARTED with no problem code just a little later than a single strategy's verify
-	// window is reported as Succeeded here rather than as a false failure; a device that is no
-	// longer present at all, or is present but genuinely stuck with a problem code, is reported as
-	// such via DevicePresent/FinalStarted/FinalHasProblem/FinalProblemCode either way.
-	// 
-	const auto finalObservation = ::PollDevNodeStatus(InstanceId, Options.PostRestartVerifyTimeout);
+	switch (result.error().value())
+	{
+	case ERROR_NOT_SUPPORTED:
+		return std::unexpected(::ToWin32Error(result.error(), "No USB hub ancestor found for device"));
+	case ERROR_GEN_FAILURE:
+		return std::unexpected(::ToWin32Error(result.error(),
+		                                      "IOCTL_USB_HUB_CYCLE_PORT failed, this operation requires administrative privileges"));
+	case ERROR_NO_SUCH_DEVICE:
+		return std::unexpected(::ToWin32Error(result.error(), "IOCTL_USB_HUB_CYCLE_PORT: port not found"));
+	default:
+		return std::unexpected(::ToWin32Error(result.error()));
+	}
+}
+
+template <nefarius::utilities::string_type StringType>
+std::expected<std::vector<nefarius::devcon::InfClassFilterTarget>, Win32Error>
+nefarius::devcon::GetInfClassFilterTargets(const StringType& FullInfPath)
+{
+	const inf::InfPlatformTarget running = ::RunningPlatform();
 
-	result.DevicePresent = finalObservation.Located;
-	result.FinalStatusValid = finalObservation.StatusValid;
-	result.FinalStatusError = finalObservation.StatusError;
+	auto results = GetInfClassFilterTargets(FullInfPath, std::span(&running, 1));
 
-	if (finalObservation.StatusValid)
+	if (!results)
 	{
-		result.FinalStarted = finalObservation.Started;
-		result.FinalHasProblem = finalObservation.HasProblem;
-		result.FinalProblemCode = finalObservation.ProblemCode;
+		return std::unexpected(std::move(results.error()));
 	}
 
-	if (!result.Succeeded && finalObservation.Located && finalObservation.StatusValid &&
-		finalObservation.Started && !finalObservation.HasProblem)
+	return std::move(results->front().FilterTargets);
+}
+
+template <nefarius::utilities::string_type StringType>
+std::expected<std::vector<nefarius::devcon::InfPlatformFilterTargets>, Win32Error>
+nefarius::devcon::GetInfClassFilterTargets(const StringType& FullInfPath,
+                                           std::span<const inf::InfPlatformTarget> Targets)
+{
+	const std::wstring fullInfPath = ConvertToWide(FullInfPath);
+
+	WCHAR normalisedInfPath[MAX_PATH] = {};
+
+	if (const auto ret = GetFullPathNameW(fullInfPath.c_str(), MAX_PATH, normalisedInfPath, nullptr);
+		(ret >= MAX_PATH) || (ret == FALSE))
+	{
+		return std::unexpected(Win32Error(ERROR_BAD_PATHNAME));
+	}
+
+	const auto file = inf::InfFile::Open(normalisedInfPath);
+
+	if (!file)
+	{
+		//
+		// OS errors of opening/mapping the file are Win32 codes already; anything else means the
+		// content couldn't be parsed
+		// 
+		const auto& error = file.error();
+
+		return std::unexpected(error.category() == std::system_category()
+			                       ? Win32Error(static_cast<DWORD>(error.value()))
+			                       : Win32Error(ERROR_INVALID_DATA, error.message()));
+	}
+
+	const auto analyses = inf::AnalyzeInf(*file, Targets, ::RegisteredClassGuid(*file));
+
+	std::vector<InfPlatformFilterTargets> results;
+	results.reserve(Targets.size());
+
+	for (size_t index = 0; index < Targets.size(); index++)
 	{
-		result.Succeeded = true;
-		result.LastError = ERROR_SUCCESS;
+		auto& result = results.emplace_back(InfPlatformFilterTargets{Targets[index], {}});
 
-		if (result.Strategy == RestartStrategy::None)
+		for (const auto& filter : analyses[index].FilterTargets)
 		{
-			result.Strategy = lastMechanismSucceeded;
+			result.FilterTargets.push_back(InfClassFilterTarget{
+				filter.ClassGuid,
+				filter.Position == inf::InfFilterPosition::Lower
+					? DeviceClassFilterPosition::Lower
+					: DeviceClassFilterPosition::Upper,
+				std::wstring(inf::AsWide(filter.ServiceName))
+			});
 		}
 	}
 
-	return result;
+	return results;
+}
+
+nefarius::devcon::DeviceRestartResult nefarius::devcon::RestartDeviceInstance(
+	const std::wstring& InstanceId, const DeviceRestartOptions& Options)
+{
+	return RestartDeviceInstance(::SystemTree(), InstanceId, Options);
 }
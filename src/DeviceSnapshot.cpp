@@ -0,0 +1,192 @@
+#include <algorithm>
+
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Initial arena room per string/string list value; the arena grows geometrically beyond that,
+	// so a sweep costs a few reallocations at most
+	//
+	constexpr size_t ExpectedCharsPerValue = 64;
+}
+
+std::expected<nefarius::devcon::DeviceSnapshot, std::error_code> nefarius::devcon::DeviceSnapshot::Capture(
+	DeviceTreeBackend& Tree, std::span<const DeviceProperty> Properties, const DeviceSnapshotOptions& Options)
+{
+	auto nodes = Tree.enumerate(Options.PresentOnly, Options.ClassGuid ? &Options.ClassGuid.value() : nullptr);
+
+	if (!nodes)
+	{
+		return std::unexpected(nodes.error());
+	}
+
+	DeviceSnapshot snapshot;
+	snapshot.nodes_ = std::move(nodes.value());
+
+	const size_t rows = snapshot.nodes_.size();
+	size_t textColumns = 0;
+
+	snapshot.columns_.reserve(Properties.size());
+
+	for (const DeviceProperty property : Properties)
+	{
+		if (snapshot.contains(property))
+		{
+			continue;
+		}
+
+		snapshot.columns_.push_back(Column{property, std::vector<Cell>(rows)});
+
+		switch (GetDevicePropertyType(property))
+		{
+		case DevicePropertyType::String:
+		case DevicePropertyType::StringList:
+			textColumns++;
+			break;
+		case DevicePropertyType::Guid:
+			snapshot.guids_.reserve(rows);
+			break;
+		default:
+			break;
+		}
+	}
+
+	snapshot.arena_.reserve(rows * textColumns * ExpectedCharsPerValue);
+
+	//
+	// Row by row rather than column by column, so every property of a devnode is read while it's
+	// (most likely) still the same device
+	//
+	for (size_t row = 0; row < rows; row++)
+	{
+		const DeviceNode node = snapshot.nodes_[row];
+
+		for (Column& column : snapshot.columns_)
+		{
+			Cell& cell = column.Cells[row];
+
+			switch (GetDevicePropertyType(column.Property))
+			{
+			case DevicePropertyType::String:
+			case DevicePropertyType::StringList:
+				{
+					const size_t offset = snapshot.arena_.size();
+
+					if (!Tree.append_property(node, column.Property, snapshot.arena_))
+					{
+						snapshot.arena_.resize(offset);
+						break;
+					}
+
+					cell = Cell{
+						static_cast<uint32_t>(offset),
+						static_cast<uint32_t>(snapshot.arena_.size() - offset),
+						true
+					};
+					break;
+				}
+			case DevicePropertyType::Uint32:
+				if (const auto value = Tree.property_uint32(node, column.Property))
+				{
+					cell = Cell{value.value(), 0, true};
+				}
+				break;
+			case DevicePropertyType::Guid:
+				if (const auto value = Tree.property_guid(node, column.Property))
+				{
+					cell = Cell{static_cast<uint32_t>(snapshot.guids_.size()), 0, true};
+					snapshot.guids_.push_back(value.value());
+				}
+				break;
+			}
+		}
+	}
+
+	return snapshot;
+}
+
+bool nefarius::devcon::DeviceSnapshot::contains(DeviceProperty Property) const
+{
+	return std::ranges::any_of(columns_, [Property](const Column& column)
+	{
+		return column.Property == Property;
+	});
+}
+
+std::wstring_view nefarius::devcon::DeviceSnapshot::instance_id(size_t Row) const
+{
+	return string(Row, DeviceProperty::InstanceId).value_or(std::wstring_view{});
+}
+
+std::optional<std::wstring_view> nefarius::devcon::DeviceSnapshot::string(size_t Row, DeviceProperty Property) const
+{
+	const Cell* value = cell(Row, Property, DevicePropertyType::String);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return std::wstring_view(arena_).substr(value->Value, value->Length);
+}
+
+std::optional<nefarius::utilities::WideMultiStringView> nefarius::devcon::DeviceSnapshot::strings(
+	size_t Row, DeviceProperty Property) const
+{
+	const Cell* value = cell(Row, Property, DevicePropertyType::StringList);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return WideMultiStringView(arena_.data() + value->Value, value->Length);
+}
+
+std::optional<uint32_t> nefarius::devcon::DeviceSnapshot::uint32(size_t Row, DeviceProperty Property) const
+{
+	const Cell* value = cell(Row, Property, DevicePropertyType::Uint32);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return value->Value;
+}
+
+std::optional<nefarius::utilities::Guid> nefarius::devcon::DeviceSnapshot::guid(
+	size_t Row, DeviceProperty Property) const
+{
+	const Cell* value = cell(Row, Property, DevicePropertyType::Guid);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return guids_[value->Value];
+}
+
+const nefarius::devcon::DeviceSnapshot::Cell* nefarius::devcon::DeviceSnapshot::cell(
+	size_t Row, DeviceProperty Property, DevicePropertyType Type) const
+{
+	if (Row >= nodes_.size() || GetDevicePropertyType(Property) != Type)
+	{
+		return nullptr;
+	}
+
+	const auto column = std::ranges::find(columns_, Property, &Column::Property);
+
+	if (column == columns_.end() || !column->Cells[Row].Present)
+	{
+		return nullptr;
+	}
+
+	return &column->Cells[Row];
+}
@@ -0,0 +1,925 @@
+#include <algorithm>
+#include <array>
+#include <cwchar>
+#include <functional>
+#include <future>
+#include <optional>
+#include <span>
+#include <thread>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DeviceTree.hpp>
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+#include <nefarius/neflib/DeviceIndex.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// The Win32 error codes the engine reports itself; no Windows headers in here
+	//
+	constexpr uint32_t Win32Success = 0; // ERROR_SUCCESS
+	constexpr uint32_t Win32NotSupported = 50; // ERROR_NOT_SUPPORTED
+	constexpr uint32_t Win32UnhandledException = 574; // ERROR_UNHANDLED_EXCEPTION
+	constexpr uint32_t Win32DeviceNotConnected = 1167; // ERROR_DEVICE_NOT_CONNECTED
+	constexpr uint32_t Win32Timeout = 1460; // ERROR_TIMEOUT
+
+	std::error_code Win32ErrorCode(uint32_t error)
+	{
+		return {static_cast<int>(error), std::system_category()};
+	}
+
+	uint32_t ToWin32Error(const std::error_code& error)
+	{
+		if (error.category() == std::system_category())
+		{
+			return static_cast<uint32_t>(error.value());
+		}
+
+		//
+		// A backend-specific code (e.g. SystemDeviceTree's CONFIGRET) names its Win32 equivalent
+		// 
+		const auto condition = error.default_error_condition();
+
+		return condition.category() == std::system_category()
+			       ? static_cast<uint32_t>(condition.value())
+			       : static_cast<uint32_t>(error.value());
+	}
+
+	//
+	// Bundles the outcome of a single restart strategy attempt, self-contained so it can be
+	// passed by value out of a worker thread without any references to the caller's stack.
+	//
+	struct StrategyOutcome
+	{
+		std::expected<void, std::error_code> Result;
+
+		bool RebootRequired = false;
+
+		DeviceRemovalVeto Veto;
+	};
+
+	//
+	// Runs Fn on a worker thread and waits up to Timeout for it to finish. On timeout the worker
+	// keeps running detached (a stuck SetupDiCallClassInstaller/CM_* call cannot be cancelled),
+	// so the caller must never touch anything the closure references after a timeout is reported.
+	// Templated so it can bound any outcome type that default-constructs and exposes a
+	// std::expected<void, std::error_code> Result member (StrategyOutcome, DetachOutcome, ...).
+	//
+	template <typename TOutcome>
+	std::optional<TOutcome> RunBounded(std::chrono::milliseconds Timeout, std::function<TOutcome()> Fn)
+	{
+		std::promise<TOutcome> promise;
+		std::future<TOutcome> future = promise.get_future();
+
+		std::thread worker([promise = std::move(promise), fn = std::move(Fn)]() mutable
+		{
+			try
+			{
+				promise.set_value(fn());
+			}
+			catch (...)
+			{
+				promise.set_exception(std::current_exception());
+			}
+		});
+		worker.detach();
+
+		if (future.wait_for(Timeout) == std::future_status::ready)
+		{
+			try
+			{
+				return future.get();
+			}
+			catch (...)
+			{
+				//
+				// Fn is not expected to throw, but a stuck-thread caller can never be allowed
+				// to propagate an exception out of the no-throw contract of the public APIs.
+				//
+				TOutcome outcome;
+				outcome.Result = std::unexpected(::Win32ErrorCode(Win32UnhandledException));
+				return outcome;
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	//
+	// Snapshot of a single status observation, self-contained so callers can tell "device is
+	// present but stuck with a problem code" apart from "device is no longer present at all" (a
+	// phantom/removed node) instead of collapsing both into a single bool.
+	//
+	struct DevNodeObservation
+	{
+		bool Located = false;
+		///< True if the status was actually queried successfully for this devnode;
+		///< Started/HasProblem/ProblemCode are only meaningful when this is true. A device can be
+		///< Located but still have StatusValid == false if the status query itself failed (e.g.
+		///< if it vanished between the locate and the status call).
+		bool StatusValid = false;
+		///< Error of the status query when StatusValid is false and Located is true, as reported
+		///< by the backend; empty otherwise
+		std::error_code StatusError;
+		bool Started = false;
+		bool HasProblem = false;
+		uint32_t ProblemCode = 0;
+	};
+
+	//
+	// A restart strategy reporting success (e.g. CM_Reenumerate_DevNode/SetupDiCallClassInstaller
+	// returning CR_SUCCESS/TRUE) only means the restart *mechanism* didn't error out; it does not
+	// guarantee the device is actually back and working (the driver could fail to load, or the
+	// devnode could settle into a problem state). Polls the devnode status until it reports
+	// DN_STARTED with no DN_HAS_PROBLEM, or Timeout elapses, returning whichever observation was
+	// current at that point (online or not). A device that has disappeared entirely (e.g.
+	// unplugged mid-restart, or a phantom node) is reflected as Located == false rather than as an
+	// error, so the caller can simply try a more invasive strategy, or give up, or - for the final
+	// authoritative re-check in RestartDeviceInstance - treat it as "nothing left to restart"
+	// rather than "stuck, needs a reboot".
+	//
+	DevNodeObservation PollDevNodeStatus(DeviceTreeBackend& tree, const std::wstring& instanceId,
+	                                     std::chrono::milliseconds timeout)
+	{
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		for (;;)
+		{
+			DevNodeObservation observation;
+
+			if (const auto node = tree.locate(instanceId); node)
+			{
+				observation.Located = true;
+
+				if (const auto status = tree.status(node.value()); status)
+				{
+					observation.StatusValid = true;
+					observation.Started = status->Started;
+					observation.HasProblem = status->HasProblem;
+					observation.ProblemCode = status->HasProblem ? status->ProblemCode : 0;
+				}
+				else
+				{
+					observation.StatusError = status.error();
+				}
+			}
+
+			if (observation.Located && observation.StatusValid && observation.Started && !observation.HasProblem)
+			{
+				return observation;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+
+			if (now >= deadline)
+			{
+				return observation;
+			}
+
+			const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+			std::this_thread::sleep_for(std::min(std::chrono::milliseconds(100), remaining));
+		}
+	}
+
+	bool WaitForDeviceOnline(DeviceTreeBackend& tree, const std::wstring& instanceId,
+	                         std::chrono::milliseconds timeout)
+	{
+		const auto observation = ::PollDevNodeStatus(tree, instanceId, timeout);
+		return observation.Located && observation.StatusValid && observation.Started && !observation.HasProblem;
+	}
+
+	std::wstring GetDeviceFriendlyNameBestEffort(DeviceTreeBackend& tree, const std::wstring& instanceId)
+	{
+		const auto node = tree.locate(instanceId, true);
+
+		if (!node)
+		{
+			return {};
+		}
+
+		if (auto name = tree.property_string(node.value(), DeviceProperty::FriendlyName); name)
+		{
+			return std::move(name.value());
+		}
+
+		if (auto desc = tree.property_string(node.value(), DeviceProperty::DeviceDesc); desc)
+		{
+			return std::move(desc.value());
+		}
+
+		return {};
+	}
+
+	//
+	// Services of the USB hub drivers (USBHUB, USBHUB3, ...)
+	//
+	bool IsUsbHubService(std::wstring_view service)
+	{
+		constexpr std::wstring_view prefix = L"usbhub";
+
+		return service.size() >= prefix.size() &&
+			casefold::EqualsIgnoreCase(service.substr(0, prefix.size()), prefix);
+	}
+
+	//
+	// Bundles the outcome of a single detach attempt. Kept separate from StrategyOutcome (rather
+	// than deriving from it) since RebootRequired has no meaning for a query-remove-subtree call.
+	//
+	struct DetachOutcome
+	{
+		std::expected<void, std::error_code> Result;
+
+		//
+		// Valid immediately after a successful detach, for same-call-chain reenumeration
+		// (TryRemoveAndReenumerate). Do not persist across process boundaries; use
+		// ParentInstanceId (a stable string identifier) for that instead.
+		//
+		DeviceNode ParentNode = 0;
+
+		std::wstring ParentInstanceId;
+
+		DeviceRemovalVeto Veto;
+	};
+
+	struct ReenumerateOutcome
+	{
+		std::expected<void, std::error_code> Result;
+	};
+
+	//
+	// Removes a device's devnode sub-tree, releasing any file locks its driver holds, without
+	// re-enumerating the parent. The PnP manager may veto the removal if a driver/application is
+	// actively using the device, in which case the veto reason is surfaced and nothing is torn
+	// down; the removal is never forced.
+	//
+	DetachOutcome TryDetachDevice(DeviceTreeBackend& tree, const std::wstring& instanceId)
+	{
+		DetachOutcome outcome;
+
+		const auto node = tree.locate(instanceId);
+
+		if (!node)
+		{
+			outcome.Result = std::unexpected(node.error());
+			return outcome;
+		}
+
+		const auto parent = tree.parent(node.value());
+
+		if (!parent)
+		{
+			outcome.Result = std::unexpected(parent.error());
+			return outcome;
+		}
+
+		auto parentInstanceId = tree.instance_id(parent.value());
+
+		if (!parentInstanceId)
+		{
+			outcome.Result = std::unexpected(parentInstanceId.error());
+			return outcome;
+		}
+
+		if (const auto removed = tree.remove_subtree(node.value(), outcome.Veto); !removed)
+		{
+			outcome.Result = std::unexpected(removed.error());
+			return outcome;
+		}
+
+		outcome.ParentNode = parent.value();
+		outcome.ParentInstanceId = std::move(parentInstanceId.value());
+		outcome.Result = {};
+		return outcome;
+	}
+
+	ReenumerateOutcome TryReenumerateParent(DeviceTreeBackend& tree, const std::wstring& parentInstanceId)
+	{
+		ReenumerateOutcome outcome;
+
+		const auto node = tree.locate(parentInstanceId);
+
+		if (!node)
+		{
+			outcome.Result = std::unexpected(node.error());
+			return outcome;
+		}
+
+		outcome.Result = tree.reenumerate(node.value());
+		return outcome;
+	}
+
+	//
+	// Restarts a device via the classic DIF_PROPERTYCHANGE/DICS_PROPCHANGE mechanism. Works for
+	// most bus types but is routinely ignored by drivers that keep a handle open (e.g. HID/keyboard
+	// class drivers), which is why the USB port cycle is attempted first.
+	//
+	StrategyOutcome TryPropertyChangeRestart(DeviceTreeBackend& tree, const std::wstring& instanceId)
+	{
+		StrategyOutcome outcome;
+
+		const auto node = tree.locate(instanceId);
+
+		if (!node)
+		{
+			outcome.Result = std::unexpected(node.error());
+			return outcome;
+		}
+
+		const auto restarted = tree.restart(node.value());
+
+		if (!restarted)
+		{
+			outcome.Result = std::unexpected(restarted.error());
+			return outcome;
+		}
+
+		outcome.RebootRequired = restarted.value();
+		outcome.Result = {};
+		return outcome;
+	}
+
+	//
+	// Removes the device sub-tree and forces its parent to re-enumerate. Most invasive restart
+	// strategy; shares TryDetachDevice with the public DetachDeviceInstance API.
+	//
+	StrategyOutcome TryRemoveAndReenumerate(DeviceTreeBackend& tree, const std::wstring& instanceId)
+	{
+		StrategyOutcome outcome;
+
+		DetachOutcome detach = ::TryDetachDevice(tree, instanceId);
+
+		outcome.Veto = std::move(detach.Veto);
+
+		if (!detach.Result.has_value())
+		{
+			outcome.Result = std::unexpected(detach.Result.error());
+			return outcome;
+		}
+
+		outcome.Result = tree.reenumerate(detach.ParentNode);
+		return outcome;
+	}
+
+	StrategyOutcome TryUsbPortCycle(DeviceTreeBackend& tree, const std::wstring& instanceId)
+	{
+		StrategyOutcome outcome;
+		outcome.Result = nefarius::devcon::CycleUsbPortOfDevice(tree, instanceId);
+		return outcome;
+	}
+
+	//
+	// A device found by FindByHwId; the names are read from the tree unless the snapshot has
+	// them. resolveVersion gets the snapshot row and its hardware IDs and yields the version of
+	// the driver that would bind to the device, if any.
+	//
+	template <typename VersionResolver>
+	FindByHwIdResult<std::wstring> MakeFindByHwIdResult(DeviceTreeBackend* tree, const DeviceSnapshot& snapshot,
+	                                                    size_t row, VersionResolver& resolveVersion)
+	{
+		const auto readName = [tree, &snapshot, row](DeviceProperty property) -> std::optional<std::wstring>
+		{
+			if (snapshot.contains(property))
+			{
+				return snapshot.string(row, property).transform([](std::wstring_view name)
+				{
+					return std::wstring(name);
+				});
+			}
+
+			if (!tree)
+			{
+				return std::nullopt;
+			}
+
+			auto name = tree->property_string(snapshot.node(row), property);
+
+			return name ? std::optional(std::move(name.value())) : std::nullopt;
+		};
+
+		FindByHwIdResult<std::wstring> result{};
+
+		if (const auto hwIds = snapshot.strings(row, DeviceProperty::HardwareIds))
+		{
+			result.HardwareIds = std::vector<std::wstring>(hwIds->begin(), hwIds->end());
+		}
+
+		//
+		// Try Device Description, then Friendly Name
+		//
+		if (auto desc = readName(DeviceProperty::DeviceDesc); desc)
+		{
+			result.Name = std::move(desc.value());
+		}
+		else if (auto name = readName(DeviceProperty::FriendlyName); name)
+		{
+			result.Name = std::move(name.value());
+		}
+		else
+		{
+			result.Name = L"Unknown device";
+		}
+
+		if (const auto version = resolveVersion(snapshot, row, result.HardwareIds))
+		{
+			result.Version.Major = (*version >> 48) & 0xFFFF;
+			result.Version.Minor = (*version >> 32) & 0xFFFF;
+			result.Version.Build = (*version >> 16) & 0xFFFF;
+			result.Version.Private = *version & 0x0000FFFF;
+		}
+
+		return result;
+	}
+
+	//
+	// Shared by both FindByHwId flavours without an index. The hardware IDs of every device are
+	// read in one snapshot sweep, everything else only for the matches.
+	//
+	template <typename VersionResolver>
+	std::expected<std::vector<FindByHwIdResult<std::wstring>>, std::error_code> FindDevicesByHwId(
+		DeviceTreeBackend& tree, std::wstring_view matchstring, VersionResolver&& resolveVersion)
+	{
+		constexpr std::array properties{DeviceProperty::HardwareIds};
+
+		const auto snapshot = DeviceSnapshot::Capture(tree, properties);
+
+		if (!snapshot)
+		{
+			return std::unexpected(snapshot.error());
+		}
+
+		std::vector<FindByHwIdResult<std::wstring>> results;
+
+		for (size_t row = 0; row < snapshot->size(); row++)
+		{
+			const auto hwIds = snapshot->strings(row, DeviceProperty::HardwareIds);
+
+			if (!hwIds)
+			{
+				continue;
+			}
+
+			const bool foundMatch = std::ranges::any_of(hwIds.value(), [matchstring](std::wstring_view entry)
+			{
+				return entry.find(matchstring) != std::wstring_view::npos;
+			});
+
+			if (foundMatch)
+			{
+				results.push_back(::MakeFindByHwIdResult(&tree, snapshot.value(), row, resolveVersion));
+			}
+		}
+
+		return results;
+	}
+
+	//
+	// DriverMatchIndex takes UTF-16 IDs; views of the wide strings where wchar_t is UTF-16,
+	// converted copies (IDs are ASCII in practice) where it's UTF-32
+	//
+	class Utf16Ids
+	{
+	public:
+		explicit Utf16Ids(const std::vector<std::wstring>& ids)
+		{
+#if WCHAR_MAX <= 0xFFFF
+			for (const auto& id : ids)
+			{
+				views_.push_back(inf::AsUtf16(id));
+			}
+#else
+			storage_.reserve(ids.size());
+
+			for (const auto& id : ids)
+			{
+				auto& converted = storage_.emplace_back();
+
+				for (const wchar_t c : id)
+				{
+					converted.push_back(c > 0xFFFF ? u'\uFFFD' : static_cast<char16_t>(c));
+				}
+
+				views_.push_back(converted);
+			}
+#endif
+		}
+
+		[[nodiscard]] std::span<const std::u16string_view> views() const
+		{
+			return views_;
+		}
+
+	private:
+#if WCHAR_MAX > 0xFFFF
+		std::vector<std::u16string> storage_;
+#endif
+		std::vector<std::u16string_view> views_;
+	};
+
+	std::optional<uint64_t> BestDriverVersion(const inf::DriverMatchIndex& drivers,
+	                                          const std::vector<std::wstring>& hwIds,
+	                                          const std::vector<std::wstring>& compatIds)
+	{
+		const Utf16Ids hardwareIds(hwIds);
+		const Utf16Ids compatibleIds(compatIds);
+
+		const auto match = drivers.best(hardwareIds.views(), compatibleIds.views());
+
+		if (!match)
+		{
+			return std::nullopt;
+		}
+
+		return match->DriverVersion;
+	}
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeBackend::append_property(
+	DeviceNode Node, DeviceProperty Property, std::wstring& Buffer)
+{
+	if (GetDevicePropertyType(Property) == DevicePropertyType::String)
+	{
+		const auto value = property_string(Node, Property);
+
+		if (!value)
+		{
+			return std::unexpected(value.error());
+		}
+
+		Buffer.append(value.value());
+		return {};
+	}
+
+	const auto values = property_strings(Node, Property);
+
+	if (!values)
+	{
+		return std::unexpected(values.error());
+	}
+
+	for (const auto& entry : values.value())
+	{
+		Buffer.append(entry);
+		Buffer.push_back(L'\0');
+	}
+
+	return {};
+}
+
+std::expected<std::vector<std::wstring>, std::error_code> nefarius::devcon::ListDeviceInstancesByService(
+	DeviceTreeBackend& Tree, std::wstring_view ServiceName, bool PresentOnly)
+{
+	constexpr std::array properties{DeviceProperty::Service};
+
+	DeviceSnapshotOptions options;
+	options.PresentOnly = PresentOnly;
+
+	const auto snapshot = DeviceSnapshot::Capture(Tree, properties, options);
+
+	if (!snapshot)
+	{
+		return std::unexpected(snapshot.error());
+	}
+
+	std::vector<std::wstring> instances;
+
+	for (size_t row = 0; row < snapshot->size(); row++)
+	{
+		const auto service = snapshot->string(row, DeviceProperty::Service);
+
+		if (!service || !casefold::EqualsIgnoreCase(service.value(), ServiceName))
+		{
+			continue;
+		}
+
+		if (auto instanceId = Tree.instance_id(snapshot->node(row)); instanceId)
+		{
+			instances.push_back(std::move(instanceId.value()));
+		}
+	}
+
+	return instances;
+}
+
+std::expected<void, std::error_code> nefarius::devcon::CycleUsbPortOfDevice(DeviceTreeBackend& Tree,
+                                                                            const std::wstring& InstanceId)
+{
+	const auto start = Tree.locate(InstanceId, true);
+
+	if (!start)
+	{
+		return std::unexpected(start.error());
+	}
+
+	DeviceNode current = start.value();
+	DeviceNode composite = start.value();
+	std::optional<DeviceNode> hub;
+
+	//
+	// Walk up the devnode tree until we hit a USB hub, remembering the last node visited before
+	// it (the "composite" node), whose Device_Address property is the hub's port number.
+	//
+	for (int depth = 0; depth < 64; depth++)
+	{
+		if (const auto service = Tree.property_string(current, DeviceProperty::Service);
+			service && ::IsUsbHubService(service.value()))
+		{
+			hub = current;
+			break;
+		}
+
+		composite = current;
+
+		const auto parent = Tree.parent(current);
+
+		if (!parent)
+		{
+			break;
+		}
+
+		current = parent.value();
+	}
+
+	if (!hub)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotSupported));
+	}
+
+	const auto port = Tree.property_uint32(composite, DeviceProperty::Address);
+
+	if (!port)
+	{
+		return std::unexpected(port.error());
+	}
+
+	return Tree.cycle_port(hub.value(), port.value());
+}
+
+nefarius::devcon::DetachResult nefarius::devcon::DetachDeviceInstance(
+	DeviceTreeBackend& Tree, const std::wstring& InstanceId, std::chrono::milliseconds Timeout)
+{
+	DetachResult result;
+	result.InstanceId = InstanceId;
+	result.FriendlyName = ::GetDeviceFriendlyNameBestEffort(Tree, InstanceId);
+
+	auto outcome = ::RunBounded<DetachOutcome>(Timeout, [&Tree, InstanceId]
+	{
+		return ::TryDetachDevice(Tree, InstanceId);
+	});
+
+	if (!outcome.has_value())
+	{
+		result.TimedOut = true;
+		result.LastError = Win32Timeout;
+		return result;
+	}
+
+	if (outcome->Result.has_value())
+	{
+		result.Succeeded = true;
+		result.LastError = Win32Success;
+		result.ParentInstanceId = std::move(outcome->ParentInstanceId);
+		return result;
+	}
+
+	result.LastError = ::ToWin32Error(outcome->Result.error());
+	result.VetoName = std::move(outcome->Veto.Name);
+	result.VetoType = outcome->Veto.Type;
+	return result;
+}
+
+nefarius::devcon::ReenumerateResult nefarius::devcon::ReenumerateParentDevNode(
+	DeviceTreeBackend& Tree, const std::wstring& ParentInstanceId, std::chrono::milliseconds Timeout)
+{
+	ReenumerateResult result;
+	result.InstanceId = ParentInstanceId;
+
+	auto outcome = ::RunBounded<ReenumerateOutcome>(Timeout, [&Tree, ParentInstanceId]
+	{
+		return ::TryReenumerateParent(Tree, ParentInstanceId);
+	});
+
+	if (!outcome.has_value())
+	{
+		result.TimedOut = true;
+		result.LastError = Win32Timeout;
+		return result;
+	}
+
+	if (outcome->Result.has_value())
+	{
+		result.Succeeded = true;
+		result.LastError = Win32Success;
+		return result;
+	}
+
+	result.LastError = ::ToWin32Error(outcome->Result.error());
+	return result;
+}
+
+nefarius::devcon::DeviceRestartResult nefarius::devcon::RestartDeviceInstance(
+	DeviceTreeBackend& Tree, const std::wstring& InstanceId, const DeviceRestartOptions& Options)
+{
+	DeviceRestartResult result;
+	result.InstanceId = InstanceId;
+	result.FriendlyName = ::GetDeviceFriendlyNameBestEffort(Tree, InstanceId);
+
+	struct Attempt
+	{
+		RestartStrategy Strategy;
+		bool Enabled;
+		std::function<StrategyOutcome()> Fn;
+	};
+
+	const std::array<Attempt, 3> attempts{
+		{
+			{
+				RestartStrategy::UsbPortCycle, Options.AllowUsbPortCycle,
+				[&Tree, InstanceId] { return ::TryUsbPortCycle(Tree, InstanceId); }
+			},
+			{
+				RestartStrategy::PropertyChange, Options.AllowPropertyChange,
+				[&Tree, InstanceId] { return ::TryPropertyChangeRestart(Tree, InstanceId); }
+			},
+			{
+				RestartStrategy::RemoveAndReenumerate, Options.AllowRemoveAndReenumerate,
+				[&Tree, InstanceId] { return ::TryRemoveAndReenumerate(Tree, InstanceId); }
+			},
+		}
+	};
+
+	//
+	// Tracks the most recent strategy whose *mechanism* actually reported success (independent of
+	// whether WaitForDeviceOnline verified it in time), so the delayed-verification path below can
+	// credit the strategy that plausibly caused the device to come back, instead of whatever was
+	// merely tried last (which may have been vetoed, errored out, or timed out).
+	//
+	RestartStrategy lastMechanismSucceeded = RestartStrategy::None;
+
+	for (const auto& attempt : attempts)
+	{
+		if (!attempt.Enabled)
+		{
+			continue;
+		}
+
+		result.LastAttempted = attempt.Strategy;
+
+		auto outcome = ::RunBounded<StrategyOutcome>(Options.PerDeviceTimeout, attempt.Fn);
+
+		if (!outcome.has_value())
+		{
+			//
+			// The worker may still be running; never start a second strategy racing against it
+			//
+			result.TimedOut = true;
+			result.LastError = Win32Timeout;
+			break;
+		}
+
+		if (outcome->Result.has_value())
+		{
+			lastMechanismSucceeded = attempt.Strategy;
+
+			//
+			// Only trust this strategy's RebootRequired signal now that its mechanism actually
+			// succeeded: install-params flags read after a failed attempt can be stale/incidental
+			// and would otherwise let a "device could not be restarted" warning outrank a driver
+			// operation (e.g. service removal) that itself completed cleanly.
+			//
+			result.RebootRequired = result.RebootRequired || outcome->RebootRequired;
+
+			//
+			// Don't just trust the strategy's own success signal: confirm the device is
+			// actually back online (present, started, no problem code) before declaring
+			// victory. If it isn't (yet), fall through to try any remaining, more invasive
+			// strategy instead of reporting a false positive.
+			//
+			if (::WaitForDeviceOnline(Tree, InstanceId, Options.PostRestartVerifyTimeout))
+			{
+				result.Strategy = attempt.Strategy;
+				result.Succeeded = true;
+				result.LastError = Win32Success;
+				break;
+			}
+
+			result.LastError = Win32DeviceNotConnected;
+			continue;
+		}
+
+		result.LastError = ::ToWin32Error(outcome->Result.error());
+		result.VetoName = std::move(outcome->Veto.Name);
+		result.VetoType = outcome->Veto.Type;
+	}
+
+	//
+	// Every strategy has been exhausted (or none were enabled) without a verified success. Before
+	// reporting failure, take one final authoritative look at the devnode instead of trusting the
+	// last strategy's own (possibly premature) verify window: this is a plain status query, safe
+	// to run even if the last attempt above hit PerDeviceTimeout and its worker is still running
+	// in the background, since it does not touch anything that worker owns. A device that settles
+	// into DN_STARTED with no problem code just a little later than a single strategy's verify
+	// window is reported as Succeeded here rather than as a false failure; a device that is no
+	// longer present at all, or is present but genuinely stuck with a problem code, is reported as
+	// such via DevicePresent/FinalStarted/FinalHasProblem/FinalProblemCode either way.
+	//
+	const auto finalObservation = ::PollDevNodeStatus(Tree, InstanceId, Options.PostRestartVerifyTimeout);
+
+	result.DevicePresent = finalObservation.Located;
+	result.FinalStatusValid = finalObservation.StatusValid;
+	result.FinalStatusError = static_cast<uint32_t>(finalObservation.StatusError.value());
+	result.FinalStatusWin32Error = finalObservation.StatusError
+		                               ? ::ToWin32Error(finalObservation.StatusError)
+		                               : Win32Success;
+
+	if (finalObservation.StatusValid)
+	{
+		result.FinalStarted = finalObservation.Started;
+		result.FinalHasProblem = finalObservation.HasProblem;
+		result.FinalProblemCode = finalObservation.ProblemCode;
+	}
+
+	if (!result.Succeeded && finalObservation.Located && finalObservation.StatusValid &&
+		finalObservation.Started && !finalObservation.HasProblem)
+	{
+		result.Succeeded = true;
+		result.LastError = Win32Success;
+
+		if (result.Strategy == RestartStrategy::None)
+		{
+			result.Strategy = lastMechanismSucceeded;
+		}
+	}
+
+	return result;
+}
+
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, std::error_code>
+nefarius::devcon::FindByHwId(DeviceTreeBackend& Tree, std::wstring_view Matchstring)
+{
+	return ::FindDevicesByHwId(Tree, Matchstring, [&Tree](const DeviceSnapshot& snapshot, size_t row,
+	                                                      const std::vector<std::wstring>&)
+	{
+		return Tree.compatible_driver_version(snapshot.node(row));
+	});
+}
+
+std::expected<std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>>, std::error_code>
+nefarius::devcon::FindByHwId(DeviceTreeBackend& Tree, std::wstring_view Matchstring,
+                             const inf::DriverMatchIndex& Drivers)
+{
+	return ::FindDevicesByHwId(Tree, Matchstring, [&Tree, &Drivers](const DeviceSnapshot& snapshot, size_t row,
+	                                                                const std::vector<std::wstring>& hwIds)
+	{
+		const auto compatIds = Tree.property_strings(snapshot.node(row), DeviceProperty::CompatibleIds);
+
+		return ::BestDriverVersion(Drivers, hwIds, compatIds ? compatIds.value() : std::vector<std::wstring>{});
+	});
+}
+
+std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>> nefarius::devcon::FindByHwId(
+	DeviceTreeBackend& Tree, const DeviceIndex& Index, std::wstring_view Matchstring)
+{
+	auto resolveVersion = [&Tree](const DeviceSnapshot& snapshot, size_t row, const std::vector<std::wstring>&)
+	{
+		return Tree.compatible_driver_version(snapshot.node(row));
+	};
+
+	std::vector<FindByHwIdResult<std::wstring>> results;
+
+	for (const DeviceIndex::Row row : Index.find_hardware_id(Matchstring))
+	{
+		results.push_back(::MakeFindByHwIdResult(&Tree, Index.snapshot(), row, resolveVersion));
+	}
+
+	return results;
+}
+
+std::vector<nefarius::devcon::FindByHwIdResult<std::wstring>> nefarius::devcon::FindByHwId(
+	const DeviceIndex& Index, std::wstring_view Matchstring, const inf::DriverMatchIndex& Drivers)
+{
+	auto resolveVersion = [&Drivers](const DeviceSnapshot& snapshot, size_t row,
+	                                 const std::vector<std::wstring>& hwIds)
+	{
+		std::vector<std::wstring> compatIds;
+
+		if (const auto entries = snapshot.strings(row, DeviceProperty::CompatibleIds))
+		{
+			compatIds = std::vector<std::wstring>(entries->begin(), entries->end());
+		}
+
+		return ::BestDriverVersion(Drivers, hwIds, compatIds);
+	};
+
+	std::vector<FindByHwIdResult<std::wstring>> results;
+
+	for (const DeviceIndex::Row row : Index.find_hardware_id(Matchstring))
+	{
+		results.push_back(::MakeFindByHwIdResult(nullptr, Index.snapshot(), row, resolveVersion));
+	}
+
+	return results;
+}
@@ -0,0 +1,619 @@
+#include <algorithm>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DeviceTree.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Win32 error codes reported like the CfgMgr32 calls behind SystemDeviceTree would
+	//
+	constexpr uint32_t Win32InvalidParameter = 87; // ERROR_INVALID_PARAMETER
+	constexpr uint32_t Win32AlreadyExists = 183; // ERROR_ALREADY_EXISTS
+	constexpr uint32_t Win32NoSuchDevice = 433; // ERROR_NO_SUCH_DEVICE
+	constexpr uint32_t Win32NotFound = 1168; // ERROR_NOT_FOUND
+	constexpr uint32_t Win32Cancelled = 1223; // ERROR_CANCELLED
+
+	constexpr DeviceNode RootNode = 0;
+
+	std::error_code Win32ErrorCode(uint32_t error)
+	{
+		return {static_cast<int>(error), std::system_category()};
+	}
+
+	void SimulateLatency(std::chrono::milliseconds latency)
+	{
+		if (latency.count() > 0)
+		{
+			std::this_thread::sleep_for(latency);
+		}
+	}
+}
+
+nefarius::devcon::DeviceTreeSimulator::DeviceTreeSimulator()
+{
+	SimulatedDevice root;
+	root.InstanceId = L"HTREE\\ROOT\\0";
+
+	ids_.emplace(casefold::FoldCase(root.InstanceId), RootNode);
+	nodes_.push_back(NodeState{std::move(root), RootNode, {}, false, {}});
+}
+
+std::expected<nefarius::devcon::DeviceNode, std::error_code> nefarius::devcon::DeviceTreeSimulator::add(
+	SimulatedDevice Device)
+{
+	std::unique_lock lock(lock_);
+
+	auto key = casefold::FoldCase(Device.InstanceId);
+
+	if (ids_.contains(key))
+	{
+		return std::unexpected(::Win32ErrorCode(Win32AlreadyExists));
+	}
+
+	DeviceNode parent = RootNode;
+
+	if (!Device.ParentInstanceId.empty())
+	{
+		const auto found = ids_.find(casefold::FoldCase(Device.ParentInstanceId));
+
+		if (found == ids_.end())
+		{
+			return std::unexpected(::Win32ErrorCode(Win32NotFound));
+		}
+
+		parent = found->second;
+	}
+
+	const auto node = static_cast<DeviceNode>(nodes_.size());
+
+	nodes_.push_back(NodeState{std::move(Device), parent, {}, false, {}});
+	nodes_[parent].Children.push_back(node);
+	ids_.emplace(std::move(key), node);
+
+	return node;
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeSimulator::update(
+	std::wstring_view InstanceId, const std::function<void(SimulatedDevice& Device)>& Change)
+{
+	std::unique_lock lock(lock_);
+
+	const auto found = ids_.find(casefold::FoldCase(InstanceId));
+
+	if (found == ids_.end())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	Change(nodes_[found->second].Device);
+
+	return {};
+}
+
+std::optional<nefarius::devcon::SimulatedDevice> nefarius::devcon::DeviceTreeSimulator::find(
+	std::wstring_view InstanceId) const
+{
+	std::shared_lock lock(lock_);
+
+	const auto found = ids_.find(casefold::FoldCase(InstanceId));
+
+	if (found == ids_.end())
+	{
+		return std::nullopt;
+	}
+
+	return nodes_[found->second].Device;
+}
+
+size_t nefarius::devcon::DeviceTreeSimulator::size() const
+{
+	std::shared_lock lock(lock_);
+
+	return nodes_.size();
+}
+
+nefarius::devcon::DeviceTreeSimulatorStats nefarius::devcon::DeviceTreeSimulator::stats() const
+{
+	return DeviceTreeSimulatorStats{
+		counters_.PropertyReads.load(),
+		counters_.StatusQueries.load(),
+		counters_.Restarts.load(),
+		counters_.Removals.load(),
+		counters_.Vetoes.load(),
+		counters_.Reenumerations.load(),
+		counters_.PortCycles.load()
+	};
+}
+
+std::expected<nefarius::devcon::DeviceNode, std::error_code> nefarius::devcon::DeviceTreeSimulator::locate(
+	std::wstring_view InstanceId, bool Phantom)
+{
+	std::shared_lock lock(lock_);
+
+	const auto found = ids_.find(casefold::FoldCase(InstanceId));
+
+	if (found == ids_.end())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	const NodeState& node = nodes_[found->second];
+
+	if (!Phantom && (!node.Device.Present || node.Removed))
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return found->second;
+}
+
+std::expected<std::vector<nefarius::devcon::DeviceNode>, std::error_code>
+nefarius::devcon::DeviceTreeSimulator::enumerate(bool PresentOnly, const Guid* ClassGuid)
+{
+	std::shared_lock lock(lock_);
+
+	std::vector<DeviceNode> nodes;
+	nodes.reserve(nodes_.size());
+
+	for (DeviceNode node = 0; node < nodes_.size(); node++)
+	{
+		const NodeState& state = nodes_[node];
+
+		if (PresentOnly && (!state.Device.Present || state.Removed))
+		{
+			continue;
+		}
+
+		if (ClassGuid && state.Device.ClassGuid != *ClassGuid)
+		{
+			continue;
+		}
+
+		nodes.push_back(node);
+	}
+
+	return nodes;
+}
+
+std::expected<std::wstring, std::error_code> nefarius::devcon::DeviceTreeSimulator::instance_id(DeviceNode Node)
+{
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	return nodes_[Node].Device.InstanceId;
+}
+
+std::expected<nefarius::devcon::DeviceNode, std::error_code> nefarius::devcon::DeviceTreeSimulator::parent(
+	DeviceNode Node)
+{
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (Node == RootNode)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return nodes_[Node].Parent;
+}
+
+std::expected<nefarius::devcon::DeviceNodeStatus, std::error_code> nefarius::devcon::DeviceTreeSimulator::status(
+	DeviceNode Node)
+{
+	++counters_.StatusQueries;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size() || !nodes_[Node].Device.Present || nodes_[Node].Removed)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	const NodeState& node = nodes_[Node];
+
+	return DeviceNodeStatus{
+		node.Device.Started && std::chrono::steady_clock::now() >= node.OnlineAt,
+		node.Device.ProblemCode != 0,
+		node.Device.ProblemCode
+	};
+}
+
+std::expected<std::wstring, std::error_code> nefarius::devcon::DeviceTreeSimulator::property_string(
+	DeviceNode Node, DeviceProperty Property)
+{
+	++counters_.PropertyReads;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	const SimulatedDevice& device = nodes_[Node].Device;
+	const std::wstring* value = nullptr;
+
+	switch (Property)
+	{
+	case DeviceProperty::DeviceDesc:
+		value = &device.DeviceDesc;
+		break;
+	case DeviceProperty::FriendlyName:
+		value = &device.FriendlyName;
+		break;
+	case DeviceProperty::Service:
+		value = &device.Service;
+		break;
+	case DeviceProperty::InstanceId:
+		value = &device.InstanceId;
+		break;
+	default:
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (value->empty())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return *value;
+}
+
+std::expected<std::vector<std::wstring>, std::error_code>
+nefarius::devcon::DeviceTreeSimulator::property_strings(DeviceNode Node, DeviceProperty Property)
+{
+	++counters_.PropertyReads;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	const SimulatedDevice& device = nodes_[Node].Device;
+	const std::vector<std::wstring>* value = nullptr;
+
+	switch (Property)
+	{
+	case DeviceProperty::HardwareIds:
+		value = &device.HardwareIds;
+		break;
+	case DeviceProperty::CompatibleIds:
+		value = &device.CompatibleIds;
+		break;
+	default:
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (value->empty())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return *value;
+}
+
+std::expected<uint32_t, std::error_code> nefarius::devcon::DeviceTreeSimulator::property_uint32(
+	DeviceNode Node, DeviceProperty Property)
+{
+	++counters_.PropertyReads;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size() || Property != DeviceProperty::Address)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (!nodes_[Node].Device.Address)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return *nodes_[Node].Device.Address;
+}
+
+std::expected<nefarius::utilities::Guid, std::error_code> nefarius::devcon::DeviceTreeSimulator::property_guid(
+	DeviceNode Node, DeviceProperty Property)
+{
+	++counters_.PropertyReads;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size() || Property != DeviceProperty::ClassGuid)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (!nodes_[Node].Device.ClassGuid)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	return *nodes_[Node].Device.ClassGuid;
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeSimulator::append_property(
+	DeviceNode Node, DeviceProperty Property, std::wstring& Buffer)
+{
+	++counters_.PropertyReads;
+
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	const SimulatedDevice& device = nodes_[Node].Device;
+	const std::wstring* value = nullptr;
+	const std::vector<std::wstring>* values = nullptr;
+
+	switch (Property)
+	{
+	case DeviceProperty::DeviceDesc:
+		value = &device.DeviceDesc;
+		break;
+	case DeviceProperty::FriendlyName:
+		value = &device.FriendlyName;
+		break;
+	case DeviceProperty::Service:
+		value = &device.Service;
+		break;
+	case DeviceProperty::InstanceId:
+		value = &device.InstanceId;
+		break;
+	case DeviceProperty::HardwareIds:
+		values = &device.HardwareIds;
+		break;
+	case DeviceProperty::CompatibleIds:
+		values = &device.CompatibleIds;
+		break;
+	default:
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (value)
+	{
+		if (value->empty())
+		{
+			return std::unexpected(::Win32ErrorCode(Win32NotFound));
+		}
+
+		Buffer.append(*value);
+		return {};
+	}
+
+	if (values->empty())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	for (const auto& entry : *values)
+	{
+		Buffer.append(entry);
+		Buffer.push_back(L'\0');
+	}
+
+	return {};
+}
+
+std::expected<bool, std::error_code> nefarius::devcon::DeviceTreeSimulator::restart(DeviceNode Node)
+{
+	++counters_.Restarts;
+
+	::SimulateLatency(latency(Node));
+
+	std::unique_lock lock(lock_);
+
+	if (Node >= nodes_.size() || !nodes_[Node].Device.Present || nodes_[Node].Removed)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	const SimulatedDevice& device = nodes_[Node].Device;
+
+	if (device.RestartError != 0)
+	{
+		return std::unexpected(::Win32ErrorCode(device.RestartError));
+	}
+
+	if (device.RequiresReboot)
+	{
+		return true;
+	}
+
+	if (!device.IgnoresPropertyChange)
+	{
+		start_subtree(Node, std::chrono::steady_clock::now());
+	}
+
+	return false;
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeSimulator::remove_subtree(
+	DeviceNode Node, DeviceRemovalVeto& Veto)
+{
+	++counters_.Removals;
+
+	::SimulateLatency(latency(Node));
+
+	std::unique_lock lock(lock_);
+
+	if (Node >= nodes_.size() || !nodes_[Node].Device.Present || nodes_[Node].Removed)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	if (Node == RootNode)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32InvalidParameter));
+	}
+
+	if (nodes_[Node].Device.RemoveError != 0)
+	{
+		return std::unexpected(::Win32ErrorCode(nodes_[Node].Device.RemoveError));
+	}
+
+	//
+	// The query-remove goes to every devnode of the sub-tree; any of them can veto
+	//
+	std::vector<DeviceNode> subtree{Node};
+
+	for (size_t index = 0; index < subtree.size(); index++)
+	{
+		const NodeState& node = nodes_[subtree[index]];
+
+		if (node.Removed || !node.Device.Present)
+		{
+			continue;
+		}
+
+		if (node.Device.RemovalVeto)
+		{
+			++counters_.Vetoes;
+			Veto = *node.Device.RemovalVeto;
+			return std::unexpected(::Win32ErrorCode(Win32Cancelled));
+		}
+
+		subtree.insert(subtree.end(), node.Children.begin(), node.Children.end());
+	}
+
+	for (const DeviceNode node : subtree)
+	{
+		nodes_[node].Removed = true;
+	}
+
+	return {};
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeSimulator::reenumerate(DeviceNode Node)
+{
+	++counters_.Reenumerations;
+
+	::SimulateLatency(latency(Node));
+
+	std::unique_lock lock(lock_);
+
+	if (Node >= nodes_.size() || !nodes_[Node].Device.Present || nodes_[Node].Removed)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	if (nodes_[Node].Device.ReenumerateError != 0)
+	{
+		return std::unexpected(::Win32ErrorCode(nodes_[Node].Device.ReenumerateError));
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+
+	for (const DeviceNode child : nodes_[Node].Children)
+	{
+		if (nodes_[child].Removed)
+		{
+			start_subtree(child, now);
+		}
+	}
+
+	return {};
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DeviceTreeSimulator::cycle_port(DeviceNode Hub, uint32_t Port)
+{
+	++counters_.PortCycles;
+
+	::SimulateLatency(latency(Hub));
+
+	std::unique_lock lock(lock_);
+
+	if (Hub >= nodes_.size() || !nodes_[Hub].Device.Present || nodes_[Hub].Removed)
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NotFound));
+	}
+
+	if (nodes_[Hub].Device.CyclePortError != 0)
+	{
+		return std::unexpected(::Win32ErrorCode(nodes_[Hub].Device.CyclePortError));
+	}
+
+	const auto& children = nodes_[Hub].Children;
+
+	const auto attached = std::ranges::find_if(children, [this, Port](DeviceNode child)
+	{
+		const NodeState& node = nodes_[child];
+		return node.Device.Present && node.Device.Address == Port;
+	});
+
+	if (attached == children.end())
+	{
+		return std::unexpected(::Win32ErrorCode(Win32NoSuchDevice));
+	}
+
+	start_subtree(*attached, std::chrono::steady_clock::now());
+
+	return {};
+}
+
+std::optional<uint64_t> nefarius::devcon::DeviceTreeSimulator::compatible_driver_version(DeviceNode Node)
+{
+	std::shared_lock lock(lock_);
+
+	if (Node >= nodes_.size())
+	{
+		return std::nullopt;
+	}
+
+	return nodes_[Node].Device.DriverVersion;
+}
+
+std::chrono::milliseconds nefarius::devcon::DeviceTreeSimulator::latency(DeviceNode Node) const
+{
+	std::shared_lock lock(lock_);
+
+	return Node < nodes_.size() ? nodes_[Node].Device.OperationLatency : std::chrono::milliseconds(0);
+}
+
+void nefarius::devcon::DeviceTreeSimulator::start_subtree(DeviceNode Node,
+                                                          std::chrono::steady_clock::time_point Now)
+{
+	std::vector<DeviceNode> pending{Node};
+
+	while (!pending.empty())
+	{
+		NodeState& node = nodes_[pending.back()];
+		pending.pop_back();
+
+		if (!node.Device.Present)
+		{
+			continue;
+		}
+
+		node.Removed = false;
+		node.Device.Started = true;
+		node.OnlineAt = Now + node.Device.StartLatency;
+
+		if (!node.Device.ProblemSurvivesRestart)
+		{
+			node.Device.ProblemCode = 0;
+		}
+
+		pending.insert(pending.end(), node.Children.begin(), node.Children.end());
+	}
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <tuple>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DriverMatchIndex.hpp>
+
+
+using namespace nefarius::devcon::inf;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Rank components, see DriverMatch::Rank
+	//
+	constexpr uint32_t RankModelCompatibleId = 0x1000;
+	constexpr uint32_t RankDeviceCompatibleId = 0x2000;
+	constexpr uint32_t MaxRankedDeviceIdIndex = 0xF;
+	constexpr uint32_t MaxRankedModelIdIndex = 0xFF;
+
+	void AssignFolded(std::u16string& key, std::u16string_view value)
+	{
+		key.resize(value.size());
+		casefold::FoldCase(value, key.data());
+	}
+
+	//
+	// Parses the separated decimal numbers of a DriverVer field; missing trailing parts stay 0.
+	// False if anything else is in the way or a part exceeds the limit.
+	//
+	template <size_t Count>
+	bool ParseNumberParts(std::u16string_view value, std::u16string_view separators, uint32_t limit,
+	                      std::array<uint32_t, Count>& parts)
+	{
+		parts.fill(0);
+
+		if (value.empty())
+		{
+			return false;
+		}
+
+		size_t part = 0;
+
+		for (const char16_t c : value)
+		{
+			if (separators.find(c) != std::u16string_view::npos)
+			{
+				if (++part == Count)
+				{
+					return false;
+				}
+			}
+			else if (c >= u'0' && c <= u'9')
+			{
+				parts[part] = parts[part] * 10 + (c - u'0');
+
+				if (parts[part] > limit)
+				{
+					return false;
+				}
+			}
+			else if (c != u' ' && c != u'\t')
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	//
+	// DriverVer date "mm/dd/yyyy" (or "mm-dd-yyyy") as yyyymmdd, so dates compare as integers
+	//
+	uint32_t PackDriverDate(std::u16string_view date)
+	{
+		std::array<uint32_t, 3> parts;
+
+		if (!ParseNumberParts(date, u"/-", 9999, parts) || parts[0] < 1 || parts[0] > 12 || parts[1] < 1 ||
+			parts[1] > 31)
+		{
+			return 0;
+		}
+
+		return parts[2] * 10000 + parts[0] * 100 + parts[1];
+	}
+
+	//
+	// DriverVer version "w.x.y.z" packed into 16 bits per part, most significant first
+	//
+	uint64_t PackDriverVersion(std::u16string_view version)
+	{
+		std::array<uint32_t, 4> parts;
+
+		if (!ParseNumberParts(version, u".", 0xFFFF, parts))
+		{
+			return 0;
+		}
+
+		return static_cast<uint64_t>(parts[0]) << 48 | static_cast<uint64_t>(parts[1]) << 32 |
+			static_cast<uint64_t>(parts[2]) << 16 | parts[3];
+	}
+}
+
+nefarius::devcon::inf::DriverMatchIndex nefarius::devcon::inf::DriverMatchIndex::Build(
+	std::span<const std::filesystem::path> InfPaths, const InfBatchOptions& Options)
+{
+	DriverMatchIndex index;
+
+	(void)AnalyzeInfFiles(InfPaths, [&index](const std::filesystem::path& path,
+	                                         std::expected<InfAnalysis, std::error_code>&& result)
+	{
+		if (result)
+		{
+			index.add(path, std::move(*result));
+		}
+
+		return true;
+	}, Options);
+
+	return index;
+}
+
+nefarius::devcon::inf::DriverMatchIndex nefarius::devcon::inf::DriverMatchIndex::Build(
+	std::span<const std::filesystem::path> InfPaths, InfMetadataCache& Cache)
+{
+	DriverMatchIndex index;
+
+	for (const auto& path : InfPaths)
+	{
+		if (auto analysis = Cache.lookup(path))
+		{
+			index.add(path, std::move(*analysis));
+		}
+	}
+
+	return index;
+}
+
+std::expected<nefarius::devcon::inf::DriverMatchIndex, std::error_code> nefarius::devcon::inf::DriverMatchIndex::BuildFromDirectory(
+	const std::filesystem::path& Directory, const InfBatchOptions& Options)
+{
+	DriverMatchIndex index;
+
+	const auto stats = AnalyzeInfDirectory(Directory, [&index](const std::filesystem::path& path,
+	                                                           std::expected<InfAnalysis, std::error_code>&& result)
+	{
+		if (result)
+		{
+			index.add(path, std::move(*result));
+		}
+
+		return true;
+	}, Options);
+
+	if (!stats)
+	{
+		return std::unexpected(stats.error());
+	}
+
+	return index;
+}
+
+void nefarius::devcon::inf::DriverMatchIndex::add(std::filesystem::path InfPath, InfAnalysis Analysis)
+{
+	const auto inf = static_cast<uint32_t>(infs_.size());
+	const uint32_t date = ::PackDriverDate(Analysis.DriverDate);
+	const uint64_t version = ::PackDriverVersion(Analysis.DriverVersion);
+
+	auto& entry = infs_.emplace_back(IndexedInf{std::move(InfPath), std::move(Analysis), date, version});
+	std::u16string key;
+
+	for (uint32_t model = 0; model < entry.Analysis.Models.size(); ++model)
+	{
+		const auto& ids = entry.Analysis.Models[model].HardwareIds;
+
+		for (uint32_t id = 0; id < ids.size(); ++id)
+		{
+			if (ids[id].empty())
+			{
+				continue;
+			}
+
+			::AssignFolded(key, ids[id]);
+			postings_[key].push_back({inf, model, id});
+		}
+	}
+}
+
+std::vector<nefarius::devcon::inf::DriverMatch> nefarius::devcon::inf::DriverMatchIndex::match(
+	std::span<const std::u16string_view> HardwareIds, std::span<const std::u16string_view> CompatibleIds) const
+{
+	std::vector<DriverMatch> matches;
+	std::u16string key;
+
+	const auto collect = [&](std::span<const std::u16string_view> deviceIds, uint32_t baseRank)
+	{
+		for (size_t deviceId = 0; deviceId < deviceIds.size(); ++deviceId)
+		{
+			::AssignFolded(key, deviceIds[deviceId]);
+
+			const auto postings = postings_.find(key);
+
+			if (postings == postings_.end())
+			{
+				continue;
+			}
+
+			for (const auto& posting : postings->second)
+			{
+				const auto& inf = infs_[posting.Inf];
+				const uint32_t rank = baseRank | (posting.IdIndex > 0 ? RankModelCompatibleId : 0) |
+					std::min<uint32_t>(static_cast<uint32_t>(deviceId), MaxRankedDeviceIdIndex) << 8 |
+					std::min(posting.IdIndex, MaxRankedModelIdIndex);
+
+				matches.push_back({
+					&inf.Path, &inf.Analysis, &inf.Analysis.Models[posting.Model], rank, inf.DriverDate,
+					inf.DriverVersion
+				});
+			}
+		}
+	};
+
+	collect(HardwareIds, 0);
+	collect(CompatibleIds, RankDeviceCompatibleId);
+
+	//
+	// A model can match through several IDs; it only counts with its best rank
+	//
+	std::ranges::sort(matches, [](const DriverMatch& lhs, const DriverMatch& rhs)
+	{
+		if (lhs.Model != rhs.Model)
+		{
+			return std::less<>{}(lhs.Model, rhs.Model);
+		}
+
+		return lhs.Rank < rhs.Rank;
+	});
+
+	const auto duplicates = std::ranges::unique(matches, {}, &DriverMatch::Model);
+	matches.erase(duplicates.begin(), duplicates.end());
+
+	std::ranges::sort(matches, [](const DriverMatch& lhs, const DriverMatch& rhs)
+	{
+		if (lhs.Rank != rhs.Rank)
+		{
+			return lhs.Rank < rhs.Rank;
+		}
+
+		if (lhs.DriverDate != rhs.DriverDate)
+		{
+			return lhs.DriverDate > rhs.DriverDate;
+		}
+
+		if (lhs.DriverVersion != rhs.DriverVersion)
+		{
+			return lhs.DriverVersion > rhs.DriverVersion;
+		}
+
+		// deterministic order of otherwise equal candidates
+		return std::tie(*lhs.InfPath, lhs.Model->InstallSection) < std::tie(*rhs.InfPath, rhs.Model->InstallSection);
+	});
+
+	return matches;
+}
+
+std::optional<nefarius::devcon::inf::DriverMatch> nefarius::devcon::inf::DriverMatchIndex::best(
+	std::span<const std::u16string_view> HardwareIds, std::span<const std::u16string_view> CompatibleIds) const
+{
+	auto matches = match(HardwareIds, CompatibleIds);
+
+	if (matches.empty())
+	{
+		return std::nullopt;
+	}
+
+	return matches.front();
+}
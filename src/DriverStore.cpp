@@ -0,0 +1,666 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/Guid.hpp>
+#include <nefarius/neflib/DriverStore.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	constexpr std::string_view IndexFileName = "drvstore.idx";
+	constexpr std::string_view IndexHeader = "NEFDRVST\t1";
+
+	//
+	// Directory name component the real store uses for a PROCESSOR_ARCHITECTURE_* value
+	//
+	std::string_view ArchitectureName(unsigned short architecture)
+	{
+		switch (architecture)
+		{
+		case 0:
+			return "x86";
+		case 5:
+			return "arm";
+		case 6:
+			return "ia64";
+		case 9:
+			return "amd64";
+		case 12:
+			return "arm64";
+		default:
+			return "neutral";
+		}
+	}
+
+	std::expected<uint64_t, std::error_code> ContentHash(const std::filesystem::path& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+
+		if (!in)
+		{
+			return std::unexpected(std::make_error_code(std::errc::no_such_file_or_directory));
+		}
+
+		uint64_t hash = 14695981039346656037ull;
+		std::array<char, 64 * 1024> buffer;
+
+		while (in)
+		{
+			in.read(buffer.data(), buffer.size());
+
+			for (std::streamsize i = 0; i < in.gcount(); ++i)
+			{
+				hash = (hash ^ static_cast<uint8_t>(buffer[static_cast<size_t>(i)])) * 1099511628211ull;
+			}
+		}
+
+		if (in.bad())
+		{
+			return std::unexpected(std::make_error_code(std::errc::io_error));
+		}
+
+		return hash;
+	}
+
+	//
+	// Package paths are looked up as strings, so every one is kept in a single spelling: lexically
+	// normal with preferred separators. Paths read back from the index file carry '/' and would
+	// otherwise not match the ones publish() builds on Windows.
+	//
+	std::wstring NormalizedPath(const std::filesystem::path& path)
+	{
+		return std::filesystem::path(path).make_preferred().lexically_normal().wstring();
+	}
+
+	std::string HexDigits(uint64_t value)
+	{
+		constexpr char hex[] = "0123456789abcdef";
+		std::string digits(16, '0');
+
+		for (size_t i = digits.size(); i-- > 0; value >>= 4)
+		{
+			digits[i] = hex[value & 0x0F];
+		}
+
+		return digits;
+	}
+
+	//
+	// The index file is UTF-8; std::filesystem::path does the conversion from and to the native
+	// wide encoding on every platform
+	//
+	std::string ToUtf8(std::wstring_view value)
+	{
+		const std::u8string utf8 = std::filesystem::path(value).u8string();
+		return {utf8.begin(), utf8.end()};
+	}
+
+	std::wstring FromUtf8(std::string_view value)
+	{
+		return std::filesystem::path(std::u8string(value.begin(), value.end())).wstring();
+	}
+
+	//
+	// NN of a published "oemNN.inf"
+	//
+	std::optional<unsigned> OemNumber(std::wstring_view publishedInfName)
+	{
+		constexpr std::wstring_view prefix = L"oem";
+		constexpr std::wstring_view suffix = L".inf";
+
+		if (publishedInfName.size() <= prefix.size() + suffix.size()
+			|| !casefold::EqualsIgnoreCase(publishedInfName.substr(0, prefix.size()), prefix)
+			|| !casefold::EqualsIgnoreCase(publishedInfName.substr(publishedInfName.size() - suffix.size()), suffix))
+		{
+			return std::nullopt;
+		}
+
+		const std::wstring_view digits = publishedInfName.substr(
+			prefix.size(), publishedInfName.size() - prefix.size() - suffix.size());
+		unsigned number = 0;
+
+		for (const wchar_t c : digits)
+		{
+			if (c < L'0' || c > L'9' || number > 100000000)
+			{
+				return std::nullopt;
+			}
+
+			number = number * 10 + static_cast<unsigned>(c - L'0');
+		}
+
+		return number;
+	}
+
+	std::vector<std::string_view> SplitTabs(std::string_view line, size_t maxFields)
+	{
+		std::vector<std::string_view> fields;
+
+		while (fields.size() + 1 < maxFields)
+		{
+			const size_t tab = line.find('\t');
+
+			if (tab == std::string_view::npos)
+			{
+				break;
+			}
+
+			fields.push_back(line.substr(0, tab));
+			line.remove_prefix(tab + 1);
+		}
+
+		fields.push_back(line);
+
+		return fields;
+	}
+
+	//
+	// DriverStoreIndex key: the identity fields case-folded per code point, so a plain hash map can
+	// hold it, and separated by NUL, which INF values can't contain
+	//
+	std::u16string FoldedIdentityKey(const nefarius::devcon::inf::InfAnalysis& identity, std::u16string_view infName)
+	{
+		std::u16string key;
+
+		const auto appendFolded = [&key](std::u16string_view value)
+		{
+			casefold::AppendFolded(key, value);
+			key.push_back(u'\0');
+		};
+
+		appendFolded(identity.Provider);
+		appendFolded(identity.DriverDate);
+		appendFolded(identity.DriverVersion);
+		appendFolded(infName);
+
+		if (identity.ClassGuid)
+		{
+			std::array<char16_t, BracedGuidStringLength> guid;
+			FormatGuid(*identity.ClassGuid, guid.data());
+			appendFolded(std::u16string_view(guid.data(), guid.size()));
+		}
+		else
+		{
+			appendFolded(identity.ClassName);
+		}
+
+		return key;
+	}
+
+	std::expected<nefarius::devcon::inf::InfAnalysis, std::error_code> AnalyzeInfFile(
+		const std::filesystem::path& infPath, nefarius::devcon::inf::InfMetadataCache* cache)
+	{
+		if (cache)
+		{
+			return cache->lookup(infPath);
+		}
+
+		const auto file = nefarius::devcon::inf::InfFile::Open(infPath);
+
+		if (!file)
+		{
+			return std::unexpected(file.error());
+		}
+
+		return nefarius::devcon::inf::AnalyzeInf(*file);
+	}
+}
+
+
+bool nefarius::devcon::DriverStorePackageFilter::matches(const DriverStorePackageView& Package) const
+{
+	return (!PublishedInfName || casefold::EqualsIgnoreCase(Package.PublishedInfName, *PublishedInfName))
+		&& (!ProcessorArchitecture || Package.ProcessorArchitecture == *ProcessorArchitecture)
+		&& (!LocaleName || casefold::EqualsIgnoreCase(Package.LocaleName, *LocaleName))
+		&& (!IsInbox || Package.IsInbox == *IsInbox);
+}
+
+std::expected<nefarius::devcon::DriverStoreEmulator, std::error_code> nefarius::devcon::DriverStoreEmulator::Open(
+	const std::filesystem::path& Root)
+{
+	std::error_code error;
+	const std::filesystem::path absolute = std::filesystem::absolute(Root, error);
+
+	if (error)
+	{
+		return std::unexpected(error);
+	}
+
+	// normalized without a trailing separator, so package paths made from it are normalized too
+	const std::filesystem::path root = (absolute / "").make_preferred().lexically_normal().parent_path();
+
+	for (const auto* directory : {"FileRepository", "INF"})
+	{
+		std::filesystem::create_directories(root / directory, error);
+
+		if (error)
+		{
+			return std::unexpected(error);
+		}
+	}
+
+	DriverStoreEmulator store(root);
+	std::ifstream in(root / IndexFileName, std::ios::binary);
+
+	if (!in)
+	{
+		// a new store
+		return store;
+	}
+
+	std::string line;
+
+	if (!std::getline(in, line) || line != IndexHeader)
+	{
+		return std::unexpected(std::make_error_code(std::errc::bad_message));
+	}
+
+	//
+	// published name, architecture, inbox flag, locale, INF path relative to the root
+	//
+	while (std::getline(in, line))
+	{
+		if (line.empty())
+		{
+			continue;
+		}
+
+		const auto fields = ::SplitTabs(line, 5);
+		unsigned short architecture = 0;
+
+		if (fields.size() != 5 || fields[0].empty() || fields[4].empty()
+			|| std::from_chars(fields[1].data(), fields[1].data() + fields[1].size(), architecture).ec != std::errc{}
+			|| (fields[2] != "0" && fields[2] != "1"))
+		{
+			return std::unexpected(std::make_error_code(std::errc::bad_message));
+		}
+
+		store.add(DriverStorePackage{
+			(root / std::filesystem::path(std::u8string(fields[4].begin(), fields[4].end()))).wstring(),
+			::FromUtf8(fields[0]),
+			fields[2] == "1",
+			architecture,
+			::FromUtf8(fields[3])
+		});
+	}
+
+	if (in.bad())
+	{
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+	}
+
+	//
+	// Numbers below the highest one in use that no package holds are handed out first
+	//
+	for (unsigned number = 0; number < store.next_oem_number_; ++number)
+	{
+		store.free_oem_numbers_.insert(number);
+	}
+
+	for (const auto& package : store.packages_)
+	{
+		if (const auto number = ::OemNumber(package.PublishedInfName); number && !package.IsInbox)
+		{
+			store.free_oem_numbers_.erase(*number);
+		}
+	}
+
+	store.dirty_ = false;
+
+	return store;
+}
+
+void nefarius::devcon::DriverStoreEmulator::add(DriverStorePackage Package)
+{
+	if (const auto number = ::OemNumber(Package.PublishedInfName); number && !Package.IsInbox)
+	{
+		next_oem_number_ = std::max(next_oem_number_, *number + 1);
+	}
+
+	// both the loaded and the published packages pass through here
+	Package.DriverPackageInfPath = ::NormalizedPath(Package.DriverPackageInfPath);
+	positions_.emplace(Package.DriverPackageInfPath, packages_.size());
+	packages_.push_back(std::move(Package));
+	dirty_ = true;
+}
+
+std::expected<nefarius::devcon::DriverStorePackage, std::error_code> nefarius::devcon::DriverStoreEmulator::publish(
+	const std::filesystem::path& InfPath, const DriverStorePublishOptions& Options)
+{
+	const auto hash = ::ContentHash(InfPath);
+
+	if (!hash)
+	{
+		return std::unexpected(hash.error());
+	}
+
+	const std::filesystem::path infName = InfPath.filename();
+	std::filesystem::path packageDirectory = root_ / "FileRepository" / infName;
+	packageDirectory += "_";
+	packageDirectory += ::ArchitectureName(Options.ProcessorArchitecture);
+	packageDirectory += "_";
+	packageDirectory += ::HexDigits(*hash);
+
+	const std::filesystem::path packageInfPath = packageDirectory / infName;
+
+	if (const auto existing = positions_.find(::NormalizedPath(packageInfPath)); existing != positions_.end())
+	{
+		return packages_[existing->second];
+	}
+
+	std::wstring publishedInfName;
+
+	if (Options.IsInbox)
+	{
+		publishedInfName = infName.wstring();
+
+		if (std::ranges::any_of(packages_, [&](const DriverStorePackage& package)
+		{
+			return casefold::EqualsIgnoreCase(package.PublishedInfName, publishedInfName);
+		}))
+		{
+			return std::unexpected(std::make_error_code(std::errc::file_exists));
+		}
+	}
+	else
+	{
+		const unsigned number = free_oem_numbers_.empty() ? next_oem_number_ : *free_oem_numbers_.begin();
+		publishedInfName = L"oem" + std::to_wstring(number) + L".inf";
+	}
+
+	std::error_code error;
+
+	std::filesystem::create_directories(packageDirectory, error);
+
+	if (!error)
+	{
+		std::filesystem::copy_file(InfPath, packageInfPath, std::filesystem::copy_options::overwrite_existing,
+		                           error);
+	}
+
+	if (!error)
+	{
+		std::filesystem::copy_file(InfPath, root_ / "INF" / publishedInfName,
+		                           std::filesystem::copy_options::overwrite_existing, error);
+	}
+
+	if (error)
+	{
+		std::error_code ignored;
+		std::filesystem::remove_all(packageDirectory, ignored);
+		return std::unexpected(error);
+	}
+
+	if (!Options.IsInbox && !free_oem_numbers_.empty())
+	{
+		free_oem_numbers_.erase(free_oem_numbers_.begin());
+	}
+
+	add(DriverStorePackage{
+		packageInfPath.wstring(),
+		std::move(publishedInfName),
+		Options.IsInbox,
+		Options.ProcessorArchitecture,
+		Options.LocaleName
+	});
+
+	return packages_.back();
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DriverStoreEmulator::enumerate(
+	const DriverStorePackageCallback& Callback, const DriverStorePackageFilter& Filter)
+{
+	for (const auto& package : packages_)
+	{
+		const DriverStorePackageView view{
+			package.DriverPackageInfPath,
+			package.PublishedInfName,
+			package.IsInbox,
+			package.ProcessorArchitecture,
+			package.LocaleName
+		};
+
+		if (Filter.matches(view) && !Callback(view))
+		{
+			break;
+		}
+	}
+
+	return {};
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DriverStoreEmulator::remove(const DriverStorePackage& Package)
+{
+	// the caller's copy may be spelled differently, e.g. built by hand
+	const auto entry = positions_.find(::NormalizedPath(Package.DriverPackageInfPath));
+
+	if (entry == positions_.end())
+	{
+		return std::unexpected(std::make_error_code(std::errc::no_such_file_or_directory));
+	}
+
+	const size_t position = entry->second;
+	const DriverStorePackage& stored = packages_[position];
+	std::error_code error;
+
+	std::filesystem::remove_all(std::filesystem::path(stored.DriverPackageInfPath).parent_path(), error);
+
+	if (!error)
+	{
+		std::filesystem::remove(root_ / "INF" / stored.PublishedInfName, error);
+	}
+
+	if (error)
+	{
+		return std::unexpected(error);
+	}
+
+	if (const auto number = ::OemNumber(stored.PublishedInfName); number && !stored.IsInbox)
+	{
+		free_oem_numbers_.insert(*number);
+	}
+
+	//
+	// The last package takes the freed slot; enumeration order is unspecified anyway
+	//
+	positions_.erase(entry);
+
+	if (position + 1 != packages_.size())
+	{
+		packages_[position] = std::move(packages_.back());
+		positions_[packages_[position].DriverPackageInfPath] = position;
+	}
+
+	packages_.pop_back();
+	dirty_ = true;
+
+	return {};
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DriverStoreEmulator::save()
+{
+	if (!dirty_)
+	{
+		return {};
+	}
+
+	const std::filesystem::path indexPath = root_ / IndexFileName;
+	std::filesystem::path temporary = indexPath;
+	temporary += ".tmp";
+
+	std::error_code error;
+
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out << IndexHeader << '\n';
+
+		for (const auto& package : packages_)
+		{
+			const std::u8string relative = std::filesystem::path(package.DriverPackageInfPath)
+			                               .lexically_relative(root_).generic_u8string();
+
+			out << ::ToUtf8(package.PublishedInfName) << '\t'
+				<< package.ProcessorArchitecture << '\t'
+				<< (package.IsInbox ? '1' : '0') << '\t'
+				<< ::ToUtf8(package.LocaleName) << '\t'
+				<< std::string_view(reinterpret_cast<const char*>(relative.data()), relative.size()) << '\n';
+		}
+
+		out.close();
+
+		if (!out)
+		{
+			error = std::make_error_code(std::errc::io_error);
+		}
+	}
+
+	if (!error)
+	{
+		std::filesystem::rename(temporary, indexPath, error);
+	}
+
+	if (error)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(temporary, ignored);
+		return std::unexpected(error);
+	}
+
+	dirty_ = false;
+
+	return {};
+}
+
+std::expected<nefarius::devcon::DriverStoreIndex, std::error_code> nefarius::devcon::DriverStoreIndex::Build(
+	DriverStoreBackend& Store, const DriverStoreIndexOptions& Options)
+{
+	DriverStoreIndex index;
+	DriverStorePackageFilter filter;
+	filter.IsInbox = false;
+
+	const auto enumerated = Store.enumerate([&index](const DriverStorePackageView& package)
+	{
+		index.packages_.push_back(package.materialize());
+		return true;
+	}, filter);
+
+	if (!enumerated)
+	{
+		return std::unexpected(enumerated.error());
+	}
+
+	index.removed_.assign(index.packages_.size(), false);
+
+	if (Options.Cache)
+	{
+		for (size_t package = 0; package < index.packages_.size(); ++package)
+		{
+			if (const auto identity = Options.Cache->lookup(index.packages_[package].DriverPackageInfPath))
+			{
+				index.insert(*identity, package);
+			}
+		}
+
+		return index;
+	}
+
+	//
+	// Results arrive in completion order, hence the way back from path to package
+	//
+	std::vector<std::filesystem::path> paths;
+	std::unordered_map<std::filesystem::path::string_type, size_t> positions;
+
+	paths.reserve(index.packages_.size());
+
+	for (size_t package = 0; package < index.packages_.size(); ++package)
+	{
+		const auto& path = paths.emplace_back(index.packages_[package].DriverPackageInfPath);
+		positions.emplace(path.native(), package);
+	}
+
+	inf::InfBatchOptions batchOptions;
+	batchOptions.Threads = Options.Threads;
+
+	inf::AnalyzeInfFiles(paths,
+		[&](const std::filesystem::path& path, std::expected<inf::InfAnalysis, std::error_code>&& result)
+		{
+			//
+			// Packages whose INF can't be read stay in the snapshot, they just never match
+			//
+			if (result)
+			{
+				index.insert(*result, positions.at(path.native()));
+			}
+
+			return true;
+		}, batchOptions);
+
+	return index;
+}
+
+#if defined(_WIN32)
+std::expected<nefarius::devcon::DriverStoreIndex, std::error_code> nefarius::devcon::DriverStoreIndex::Build(
+	const DriverStoreIndexOptions& Options)
+{
+	SystemDriverStore store;
+	return Build(store, Options);
+}
+#endif
+
+void nefarius::devcon::DriverStoreIndex::insert(const inf::InfAnalysis& Identity, size_t Package)
+{
+	const std::filesystem::path infPath(packages_[Package].DriverPackageInfPath);
+
+	identities_.emplace(::FoldedIdentityKey(Identity, infPath.filename().u16string()), Package);
+}
+
+std::vector<const nefarius::devcon::DriverStorePackage*> nefarius::devcon::DriverStoreIndex::find(
+	const inf::InfAnalysis& Identity, std::u16string_view InfName) const
+{
+	std::vector<const DriverStorePackage*> matches;
+	const auto [first, last] = identities_.equal_range(::FoldedIdentityKey(Identity, InfName));
+
+	for (auto entry = first; entry != last; ++entry)
+	{
+		if (!removed_[entry->second])
+		{
+			matches.push_back(&packages_[entry->second]);
+		}
+	}
+
+	// enumeration order rather than hash map order
+	std::ranges::sort(matches);
+
+	return matches;
+}
+
+std::expected<std::vector<const nefarius::devcon::DriverStorePackage*>, std::error_code>
+nefarius::devcon::DriverStoreIndex::match(const std::filesystem::path& OriginalInfPath,
+                                          inf::InfMetadataCache* Cache) const
+{
+	const auto identity = ::AnalyzeInfFile(OriginalInfPath, Cache);
+
+	if (!identity)
+	{
+		return std::unexpected(identity.error());
+	}
+
+	return find(*identity, OriginalInfPath.filename().u16string());
+}
+
+void nefarius::devcon::DriverStoreIndex::remove(const DriverStorePackage& Package)
+{
+	if (packages_.empty() || &Package < packages_.data() || &Package >= packages_.data() + packages_.size())
+	{
+		return;
+	}
+
+	removed_[static_cast<size_t>(&Package - packages_.data())] = true;
+}
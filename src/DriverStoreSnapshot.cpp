@@ -0,0 +1,429 @@
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/DriverStoreSnapshot.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities;
+
+static_assert(std::endian::native == std::endian::little, "snapshot records are copied as-is");
+
+namespace
+{
+	//
+	// File layout: SnapshotHeader, PackageRecord[PackageCount] sorted by folded published name and
+	// finally StringLength wchar_t code units every StringRef points into.
+	//
+	constexpr char SnapshotMagic[8] = {'N', 'E', 'F', 'D', 'S', 'S', 'N', 'P'};
+	constexpr uint32_t SnapshotFormatVersion = 1;
+
+	constexpr uint16_t PackageIsInbox = 0x1;
+
+	struct StringRef
+	{
+		uint32_t Offset;
+		uint32_t Length;
+	};
+
+	struct SnapshotHeader
+	{
+		char Magic[8];
+		uint32_t FormatVersion;
+		uint32_t CharSize;
+		uint32_t PackageCount;
+		uint32_t StringLength;
+	};
+
+	struct PackageRecord
+	{
+		StringRef DriverPackageInfPath;
+		StringRef PublishedInfName;
+		StringRef LocaleName;
+		uint16_t ProcessorArchitecture;
+		uint16_t Flags;
+	};
+
+	bool PackagesEqual(const DriverStorePackageView& lhs, const DriverStorePackageView& rhs)
+	{
+		return lhs.ProcessorArchitecture == rhs.ProcessorArchitecture
+			&& lhs.IsInbox == rhs.IsInbox
+			&& casefold::EqualsIgnoreCase(lhs.DriverPackageInfPath, rhs.DriverPackageInfPath)
+			&& casefold::EqualsIgnoreCase(lhs.LocaleName, rhs.LocaleName);
+	}
+}
+
+namespace nefarius::devcon::detail
+{
+	struct DriverStoreSnapshotData
+	{
+		std::vector<PackageRecord> Records;
+		std::wstring Strings;
+
+		[[nodiscard]] std::wstring_view String(const StringRef& Ref) const
+		{
+			return std::wstring_view(Strings).substr(Ref.Offset, Ref.Length);
+		}
+
+		[[nodiscard]] DriverStorePackageView View(const PackageRecord& Record) const
+		{
+			return DriverStorePackageView{
+				String(Record.DriverPackageInfPath),
+				String(Record.PublishedInfName),
+				(Record.Flags & PackageIsInbox) != 0,
+				Record.ProcessorArchitecture,
+				String(Record.LocaleName)
+			};
+		}
+	};
+}
+
+namespace
+{
+	class SnapshotBuilder
+	{
+	public:
+		void add(const DriverStorePackageView& Package)
+		{
+			data_->Records.push_back(PackageRecord{
+				intern(Package.DriverPackageInfPath),
+				intern(Package.PublishedInfName),
+				intern(Package.LocaleName),
+				Package.ProcessorArchitecture,
+				static_cast<uint16_t>(Package.IsInbox ? PackageIsInbox : 0)
+			});
+		}
+
+		std::unique_ptr<nefarius::devcon::detail::DriverStoreSnapshotData> finish()
+		{
+			auto& data = *data_;
+
+			const auto name = [&data](const PackageRecord& record)
+			{
+				return data.String(record.PublishedInfName);
+			};
+
+			//
+			// Stable, so of duplicate names the one enumerated first survives
+			//
+			std::ranges::stable_sort(data.Records, [&name](const PackageRecord& lhs, const PackageRecord& rhs)
+			{
+				return casefold::CompareIgnoreCase(name(lhs), name(rhs)) < 0;
+			});
+
+			const auto duplicates = std::ranges::unique(data.Records,
+			                                            [&name](const PackageRecord& lhs, const PackageRecord& rhs)
+			                                            {
+				                                            return casefold::EqualsIgnoreCase(name(lhs), name(rhs));
+			                                            });
+
+			data.Records.erase(duplicates.begin(), duplicates.end());
+			data.Records.shrink_to_fit();
+
+			return std::move(data_);
+		}
+
+	private:
+		//
+		// Locale names repeat for nearly every package and are stored once
+		//
+		StringRef intern(std::wstring_view Value)
+		{
+			if (Value.empty())
+			{
+				return {};
+			}
+
+			if (const auto existing = interned_.find(std::wstring(Value)); existing != interned_.end())
+			{
+				return existing->second;
+			}
+
+			const StringRef value{static_cast<uint32_t>(data_->Strings.size()), static_cast<uint32_t>(Value.size())};
+			data_->Strings.append(Value);
+			interned_.emplace(Value, value);
+
+			return value;
+		}
+
+		std::unique_ptr<nefarius::devcon::detail::DriverStoreSnapshotData> data_ =
+			std::make_unique<nefarius::devcon::detail::DriverStoreSnapshotData>();
+		std::unordered_map<std::wstring, StringRef> interned_;
+	};
+
+	bool RefInBounds(const StringRef& ref, size_t stringLength)
+	{
+		return ref.Offset <= stringLength && ref.Length <= stringLength - ref.Offset;
+	}
+}
+
+
+nefarius::devcon::DriverStoreSnapshot::DriverStoreSnapshot()
+	: data_(std::make_unique<detail::DriverStoreSnapshotData>())
+{
+}
+
+nefarius::devcon::DriverStoreSnapshot::DriverStoreSnapshot(std::unique_ptr<detail::DriverStoreSnapshotData> Data)
+	: data_(std::move(Data))
+{
+}
+
+nefarius::devcon::DriverStoreSnapshot::DriverStoreSnapshot(DriverStoreSnapshot&& Other) noexcept = default;
+
+nefarius::devcon::DriverStoreSnapshot& nefarius::devcon::DriverStoreSnapshot::operator=(
+	DriverStoreSnapshot&& Other) noexcept = default;
+
+nefarius::devcon::DriverStoreSnapshot::~DriverStoreSnapshot() = default;
+
+std::expected<nefarius::devcon::DriverStoreSnapshot, std::error_code> nefarius::devcon::DriverStoreSnapshot::Capture(
+	DriverStoreBackend& Store, const DriverStorePackageFilter& Filter)
+{
+	SnapshotBuilder builder;
+
+	const auto enumerated = Store.enumerate([&builder](const DriverStorePackageView& package)
+	{
+		builder.add(package);
+		return true;
+	}, Filter);
+
+	if (!enumerated)
+	{
+		return std::unexpected(enumerated.error());
+	}
+
+	return DriverStoreSnapshot(builder.finish());
+}
+
+nefarius::devcon::DriverStoreSnapshot nefarius::devcon::DriverStoreSnapshot::FromPackages(
+	std::span<const DriverStorePackage> Packages)
+{
+	SnapshotBuilder builder;
+
+	for (const auto& package : Packages)
+	{
+		builder.add(DriverStorePackageView{
+			package.DriverPackageInfPath,
+			package.PublishedInfName,
+			package.IsInbox,
+			package.ProcessorArchitecture,
+			package.LocaleName
+		});
+	}
+
+	return DriverStoreSnapshot(builder.finish());
+}
+
+std::expected<nefarius::devcon::DriverStoreSnapshot, std::error_code> nefarius::devcon::DriverStoreSnapshot::Load(
+	const std::filesystem::path& File)
+{
+	std::error_code error;
+	const auto fileSize = std::filesystem::file_size(File, error);
+
+	if (error)
+	{
+		return std::unexpected(error);
+	}
+
+	const auto corrupt = std::make_error_code(std::errc::bad_message);
+	SnapshotHeader header{};
+
+	if (fileSize < sizeof(header))
+	{
+		return std::unexpected(corrupt);
+	}
+
+	std::ifstream in(File, std::ios::binary);
+	in.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+	if (!in)
+	{
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+	}
+
+	if (std::memcmp(header.Magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0
+		|| header.FormatVersion != SnapshotFormatVersion
+		|| header.CharSize != sizeof(wchar_t)
+		|| fileSize != sizeof(header) + uint64_t{header.PackageCount} * sizeof(PackageRecord)
+		+ uint64_t{header.StringLength} * sizeof(wchar_t))
+	{
+		return std::unexpected(corrupt);
+	}
+
+	auto data = std::make_unique<detail::DriverStoreSnapshotData>();
+	data->Records.resize(header.PackageCount);
+	data->Strings.resize(header.StringLength);
+
+	in.read(reinterpret_cast<char*>(data->Records.data()),
+	        static_cast<std::streamsize>(data->Records.size() * sizeof(PackageRecord)));
+	in.read(reinterpret_cast<char*>(data->Strings.data()),
+	        static_cast<std::streamsize>(data->Strings.size() * sizeof(wchar_t)));
+
+	if (!in)
+	{
+		return std::unexpected(std::make_error_code(std::errc::io_error));
+	}
+
+	//
+	// Every view has to stay inside the string table, and the merge relies on the order
+	//
+	for (size_t index = 0; index < data->Records.size(); ++index)
+	{
+		const auto& record = data->Records[index];
+
+		if (!::RefInBounds(record.DriverPackageInfPath, data->Strings.size())
+			|| !::RefInBounds(record.PublishedInfName, data->Strings.size())
+			|| !::RefInBounds(record.LocaleName, data->Strings.size()))
+		{
+			return std::unexpected(corrupt);
+		}
+
+		if (index > 0 && casefold::CompareIgnoreCase(data->String(data->Records[index - 1].PublishedInfName),
+		                                             data->String(record.PublishedInfName)) >= 0)
+		{
+			return std::unexpected(corrupt);
+		}
+	}
+
+	return DriverStoreSnapshot(std::move(data));
+}
+
+std::expected<void, std::error_code> nefarius::devcon::DriverStoreSnapshot::save(
+	const std::filesystem::path& File) const
+{
+	SnapshotHeader header{};
+	std::memcpy(header.Magic, SnapshotMagic, sizeof(SnapshotMagic));
+	header.FormatVersion = SnapshotFormatVersion;
+	header.CharSize = sizeof(wchar_t);
+	header.PackageCount = static_cast<uint32_t>(data_->Records.size());
+	header.StringLength = static_cast<uint32_t>(data_->Strings.size());
+
+	//
+	// Written next to the target and renamed over it, so readers never see a partial file
+	//
+	std::filesystem::path temporary = File;
+	temporary += ".tmp";
+
+	std::error_code error;
+
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		out.write(reinterpret_cast<const char*>(data_->Records.data()),
+		          static_cast<std::streamsize>(data_->Records.size() * sizeof(PackageRecord)));
+		out.write(reinterpret_cast<const char*>(data_->Strings.data()),
+		          static_cast<std::streamsize>(data_->Strings.size() * sizeof(wchar_t)));
+		out.close();
+
+		if (!out)
+		{
+			error = std::make_error_code(std::errc::io_error);
+		}
+	}
+
+	if (!error)
+	{
+		std::filesystem::rename(temporary, File, error);
+	}
+
+	if (error)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(temporary, ignored);
+		return std::unexpected(error);
+	}
+
+	return {};
+}
+
+size_t nefarius::devcon::DriverStoreSnapshot::size() const
+{
+	return data_ ? data_->Records.size() : 0;
+}
+
+nefarius::devcon::DriverStorePackageView nefarius::devcon::DriverStoreSnapshot::operator[](size_t Index) const
+{
+	return data_->View(data_->Records[Index]);
+}
+
+std::optional<nefarius::devcon::DriverStorePackageView> nefarius::devcon::DriverStoreSnapshot::find(
+	std::wstring_view PublishedInfName) const
+{
+	if (!data_)
+	{
+		return std::nullopt;
+	}
+
+	const auto& data = *data_;
+	const auto record = std::ranges::lower_bound(data.Records, PublishedInfName,
+	                                             [](std::wstring_view lhs, std::wstring_view rhs)
+	                                             {
+		                                             return casefold::CompareIgnoreCase(lhs, rhs) < 0;
+	                                             },
+	                                             [&data](const PackageRecord& entry)
+	                                             {
+		                                             return data.String(entry.PublishedInfName);
+	                                             });
+
+	if (record == data.Records.end() ||
+		!casefold::EqualsIgnoreCase(data.String(record->PublishedInfName), PublishedInfName))
+	{
+		return std::nullopt;
+	}
+
+	return data.View(*record);
+}
+
+nefarius::devcon::DriverStoreDiff nefarius::devcon::DiffDriverStore(const DriverStoreSnapshot& Old,
+                                                                    const DriverStoreSnapshot& New)
+{
+	DriverStoreDiff diff;
+	size_t oldIndex = 0;
+	size_t newIndex = 0;
+
+	while (oldIndex < Old.size() && newIndex < New.size())
+	{
+		const auto oldPackage = Old[oldIndex];
+		const auto newPackage = New[newIndex];
+		const auto order = casefold::CompareIgnoreCase(oldPackage.PublishedInfName, newPackage.PublishedInfName);
+
+		if (order < 0)
+		{
+			diff.Removed.push_back(oldPackage.materialize());
+			++oldIndex;
+		}
+		else if (order > 0)
+		{
+			diff.Added.push_back(newPackage.materialize());
+			++newIndex;
+		}
+		else
+		{
+			if (!::PackagesEqual(oldPackage, newPackage))
+			{
+				diff.Changed.push_back(DriverStorePackageChange{oldPackage.materialize(), newPackage.materialize()});
+			}
+
+			++oldIndex;
+			++newIndex;
+		}
+	}
+
+	for (; oldIndex < Old.size(); ++oldIndex)
+	{
+		diff.Removed.push_back(Old[oldIndex].materialize());
+	}
+
+	for (; newIndex < New.size(); ++newIndex)
+	{
+		diff.Added.push_back(New[newIndex].materialize());
+	}
+
+	return diff;
+}
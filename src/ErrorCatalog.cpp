@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <iterator>
+
+#include <nefarius/neflib/ErrorCatalog.hpp>
+
+
+namespace
+{
+	struct CatalogEntry
+	{
+		uint32_t Code;
+		std::string_view Symbol;
+		std::string_view Message;
+	};
+
+	//
+	// Sorted by code, looked up with a binary search
+	//
+	constexpr CatalogEntry Catalog[] = {
+		{0, "ERROR_SUCCESS", "The operation completed successfully."},
+		{2, "ERROR_FILE_NOT_FOUND", "The system cannot find the file specified."},
+		{3, "ERROR_PATH_NOT_FOUND", "The system cannot find the path specified."},
+		{5, "ERROR_ACCESS_DENIED", "Access is denied."},
+		{6, "ERROR_INVALID_HANDLE", "The handle is invalid."},
+		{8, "ERROR_NOT_ENOUGH_MEMORY", "Not enough memory resources are available to process this command."},
+		{13, "ERROR_INVALID_DATA", "The data is invalid."},
+		{21, "ERROR_NOT_READY", "The device is not ready."},
+		{31, "ERROR_GEN_FAILURE", "A device attached to the system is not functioning."},
+		{32, "ERROR_SHARING_VIOLATION",
+		 "The process cannot access the file because it is being used by another process."},
+		{50, "ERROR_NOT_SUPPORTED", "The request is not supported."},
+		{87, "ERROR_INVALID_PARAMETER", "The parameter is incorrect."},
+		{122, "ERROR_INSUFFICIENT_BUFFER", "The data area passed to a system call is too small."},
+		{161, "ERROR_BAD_PATHNAME", "The specified path is invalid."},
+		{183, "ERROR_ALREADY_EXISTS", "Cannot create a file when that file already exists."},
+		{234, "ERROR_MORE_DATA", "More data is available."},
+		{259, "ERROR_NO_MORE_ITEMS", "No more data is available."},
+		{1003, "ERROR_CAN_NOT_COMPLETE", "Cannot complete this function."},
+		{1051, "ERROR_DEPENDENT_SERVICES_RUNNING",
+		 "A stop control has been sent to a service that other running services are dependent on."},
+		{1052, "ERROR_INVALID_SERVICE_CONTROL", "The requested control is not valid for this service."},
+		{1053, "ERROR_SERVICE_REQUEST_TIMEOUT",
+		 "The service did not respond to the start or control request in a timely fashion."},
+		{1055, "ERROR_SERVICE_DATABASE_LOCKED", "The service database is locked."},
+		{1056, "ERROR_SERVICE_ALREADY_RUNNING", "An instance of the service is already running."},
+		{1058, "ERROR_SERVICE_DISABLED",
+		 "The service cannot be started, either because it is disabled or because it has no enabled devices associated with it."},
+		{1059, "ERROR_CIRCULAR_DEPENDENCY", "Circular service dependency was specified."},
+		{1060, "ERROR_SERVICE_DOES_NOT_EXIST", "The specified service does not exist as an installed service."},
+		{1061, "ERROR_SERVICE_CANNOT_ACCEPT_CTRL", "The service cannot accept control messages at this time."},
+		{1062, "ERROR_SERVICE_NOT_ACTIVE", "The service has not been started."},
+		{1068, "ERROR_SERVICE_DEPENDENCY_FAIL", "The dependency service or group failed to start."},
+		{1072, "ERROR_SERVICE_MARKED_FOR_DELETE", "The specified service has been marked for deletion."},
+		{1073, "ERROR_SERVICE_EXISTS", "The specified service already exists."},
+		{1077, "ERROR_SERVICE_NEVER_STARTED", "No attempts to start the service have been made since the last boot."},
+		{1078, "ERROR_DUPLICATE_SERVICE_NAME",
+		 "The name is already in use as either a service name or a service display name."},
+		{1167, "ERROR_DEVICE_NOT_CONNECTED", "The device is not connected."},
+		{1168, "ERROR_NOT_FOUND", "Element not found."},
+		{1223, "ERROR_CANCELLED", "The operation was canceled by the user."},
+		{1275, "ERROR_DRIVER_BLOCKED", "This driver has been blocked from loading."},
+		{1300, "ERROR_NOT_ALL_ASSIGNED", "Not all privileges or groups referenced are assigned to the caller."},
+		{1314, "ERROR_PRIVILEGE_NOT_HELD", "A required privilege is not held by the client."},
+		{1359, "ERROR_INTERNAL_ERROR", "An internal error occurred."},
+		{1460, "ERROR_TIMEOUT", "This operation returned because the timeout period expired."},
+		{1705, "RPC_S_INVALID_STRING_UUID", "The string universal unique identifier (UUID) is invalid."},
+		{3010, "ERROR_SUCCESS_REBOOT_REQUIRED",
+		 "The requested operation is successful. Changes will not be effective until the system is rebooted."},
+		{4319, "ERROR_DEVICE_NOT_AVAILABLE", "The device is not ready for use."},
+		{0xE0000000, "ERROR_EXPECTED_SECTION_NAME",
+		 "A non-empty line was encountered in the INF before the start of a section."},
+		{0xE0000001, "ERROR_BAD_SECTION_NAME_LINE",
+		 "A section name marker in the INF is not complete, or does not exist on a line by itself."},
+		{0xE0000002, "ERROR_SECTION_NAME_TOO_LONG",
+		 "An INF section was encountered whose name exceeds the maximum section name length."},
+		{0xE0000003, "ERROR_GENERAL_SYNTAX", "The syntax of the INF is invalid."},
+		{0xE0000100, "ERROR_WRONG_INF_STYLE", "The style of the INF is different than what was requested."},
+		{0xE0000101, "ERROR_SECTION_NOT_FOUND", "The required section was not found in the INF."},
+		{0xE0000102, "ERROR_LINE_NOT_FOUND", "The required line was not found in the INF."},
+		{0xE0000200, "ERROR_NO_ASSOCIATED_CLASS",
+		 "The INF or the device information set or element does not have an associated install class."},
+		{0xE0000201, "ERROR_CLASS_MISMATCH",
+		 "The INF or the device information set or element does not match the specified install class."},
+		{0xE0000202, "ERROR_DUPLICATE_FOUND",
+		 "An existing device was found that is a duplicate of the device being manually installed."},
+		{0xE0000203, "ERROR_NO_DRIVER_SELECTED",
+		 "There is no driver selected for the device information set or element."},
+		{0xE0000204, "ERROR_KEY_DOES_NOT_EXIST", "The requested device registry key does not exist."},
+		{0xE0000205, "ERROR_INVALID_DEVINST_NAME", "The device instance name is invalid."},
+		{0xE0000206, "ERROR_INVALID_CLASS", "The install class is not present or is invalid."},
+		{0xE0000207, "ERROR_DEVINST_ALREADY_EXISTS",
+		 "The device instance cannot be created because it already exists."},
+		{0xE0000208, "ERROR_DEVINFO_NOT_REGISTERED",
+		 "The operation cannot be performed on a device information element that has not been registered."},
+		{0xE0000209, "ERROR_INVALID_REG_PROPERTY", "The device property code is invalid."},
+		{0xE000020A, "ERROR_NO_INF", "The INF from which a driver list is to be built does not exist."},
+		{0xE000020B, "ERROR_NO_SUCH_DEVINST", "The device instance does not exist in the hardware tree."},
+		{0xE0000214, "ERROR_DI_BAD_PATH", "The specified path does not contain any applicable device INFs."},
+		{0xE0000217, "ERROR_BAD_SERVICE_INSTALLSECT", "A service installation section in this INF is invalid."},
+		{0xE0000219, "ERROR_NO_ASSOCIATED_SERVICE",
+		 "The installation failed because a function driver was not specified for this device instance."},
+		{0xE000021E, "ERROR_NO_SUCH_INTERFACE_CLASS", "This interface class does not exist in the system."},
+		{0xE0000225, "ERROR_NO_SUCH_DEVICE_INTERFACE", "The requested device interface is not present in the system."},
+		{0xE0000228, "ERROR_NO_COMPAT_DRIVERS", "There are no compatible drivers for this device."},
+		{0xE000022C, "ERROR_INVALID_FILTER_DRIVER", "One of the filter drivers installed for this device is invalid."},
+		{0xE000022F, "ERROR_NO_CATALOG_FOR_OEM_INF",
+		 "The third-party INF does not contain digital signature information."},
+		{0xE0000231, "ERROR_NOT_DISABLEABLE", "The device cannot be disabled."},
+		{0xE0000232, "ERROR_CANT_REMOVE_DEVINST", "The device could not be dynamically removed."},
+		{0xE0000234, "ERROR_DRIVER_NONNATIVE", "Driver is not intended for this platform."},
+		{0xE0000235, "ERROR_IN_WOW64", "Operation not allowed in WOW64."},
+		{0xE0000239, "ERROR_UNKNOWN_EXCEPTION", "An unknown exception was encountered."},
+		{0xE000023A, "ERROR_PNP_REGISTRY_ERROR",
+		 "A problem was encountered when accessing the Plug and Play registry database."},
+		{0xE000023C, "ERROR_NOT_AN_INSTALLED_OEM_INF",
+		 "The specified file is not an installed original equipment manufacturer (OEM) INF."},
+		{0xE000023D, "ERROR_INF_IN_USE_BY_DEVICES", "One or more devices are presently installed using the specified INF."},
+		{0xE0000247, "ERROR_DRIVER_STORE_ADD_FAILED",
+		 "An error occurred while attempting to add the driver package to the driver store."},
+		{0xE0000248, "ERROR_DEVICE_INSTALL_BLOCKED", "The installation was prohibited by Group Policy."},
+		{0xE000024B, "ERROR_FILE_HASH_NOT_IN_CATALOG", "The hash for the file is not present in the specified catalog file."},
+		{0xE000024C, "ERROR_DRIVER_STORE_DELETE_FAILED",
+		 "An error occurred while attempting to delete the driver package from the driver store."},
+	};
+
+	static_assert(std::ranges::is_sorted(Catalog, {}, &CatalogEntry::Code));
+
+	const CatalogEntry* FindEntry(uint32_t Code)
+	{
+		const auto entry = std::ranges::lower_bound(Catalog, Code, {}, &CatalogEntry::Code);
+
+		return entry != std::end(Catalog) && entry->Code == Code ? entry : nullptr;
+	}
+}
+
+std::string_view nefarius::utilities::errors::FallbackMessage(uint32_t Code)
+{
+	const auto entry = ::FindEntry(Code);
+
+	return entry ? entry->Message : std::string_view();
+}
+
+std::string_view nefarius::utilities::errors::FallbackSymbol(uint32_t Code)
+{
+	const auto entry = ::FindEntry(Code);
+
+	return entry ? entry->Symbol : std::string_view();
+}
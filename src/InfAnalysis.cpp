@@ -0,0 +1,1065 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/InfAnalysis.hpp>
+
+
+using namespace nefarius::devcon::inf;
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Scans a single AddReg/DelReg-referenced section for UpperFilters/LowerFilters directives.
+	// Lines have no key, so field 1 is the root, 2 the subkey, 3 the value name, 4 the flags and
+	// 5+ the data (one filter service per field for REG_MULTI_SZ).
+	//
+	void CollectFiltersFromRegSection(const InfFile& File, std::u16string_view SectionName,
+	                                  const std::optional<Guid>& BaseClassGuid, std::vector<InfFilterTarget>& Results)
+	{
+		const auto section = File.section(SectionName);
+
+		if (!section)
+		{
+			return;
+		}
+
+		for (const auto line : *section)
+		{
+			if (line.field_count() < 3)
+			{
+				continue;
+			}
+
+			const auto valueName = line.field(3);
+			const bool isUpper = casefold::EqualsIgnoreCase(valueName, u"UpperFilters");
+			const bool isLower = casefold::EqualsIgnoreCase(valueName, u"LowerFilters");
+
+			if (!isUpper && !isLower)
+			{
+				continue;
+			}
+
+			const auto root = line.field(1);
+			const auto subkey = line.field(2);
+			std::optional<Guid> targetGuid;
+
+			if (casefold::EqualsIgnoreCase(root, u"HKR") && subkey.empty())
+			{
+				// class-relative entry of a class installer section
+				targetGuid = BaseClassGuid;
+			}
+			else if (const auto open = subkey.find(u'{'); open != std::u16string_view::npos)
+			{
+				// fully-qualified "SYSTEM\CurrentControlSet\Control\Class\{<guid>}" path
+				if (const auto close = subkey.find(u'}', open); close != std::u16string_view::npos)
+				{
+					targetGuid = ParseGuid(subkey.substr(open, close - open + 1));
+				}
+			}
+
+			if (!targetGuid)
+			{
+				continue;
+			}
+
+			const auto position = isLower ? InfFilterPosition::Lower : InfFilterPosition::Upper;
+			bool anyServiceName = false;
+
+			for (size_t field = 5; field <= line.field_count(); field++)
+			{
+				if (const auto serviceName = line.field(field); !serviceName.empty())
+				{
+					anyServiceName = true;
+					Results.push_back(InfFilterTarget{*targetGuid, position, std::u16string(serviceName)});
+				}
+			}
+
+			//
+			// A DelReg line removing the whole value still names the affected class
+			//
+			if (!anyServiceName)
+			{
+				Results.push_back(InfFilterTarget{*targetGuid, position, std::u16string()});
+			}
+		}
+	}
+
+	std::u16string_view ArchitectureName(InfArchitecture Architecture)
+	{
+		switch (Architecture)
+		{
+		case InfArchitecture::X86:
+			return u"x86";
+		case InfArchitecture::Ia64:
+			return u"ia64";
+		case InfArchitecture::Arm:
+			return u"arm";
+		case InfArchitecture::Arm64:
+			return u"arm64";
+		default:
+			return u"amd64";
+		}
+	}
+
+	//
+	// A TargetOSVersion decoration of a [Manufacturer] entry:
+	// NT[Architecture][.[OSMajorVersion][.[OSMinorVersion][.[ProductType][.[SuiteMask][.[BuildNumber]]]]]]
+	//
+	struct ModelsDecoration
+	{
+		std::optional<InfArchitecture> Architecture;
+		uint32_t MajorVersion = 0;
+		uint32_t MinorVersion = 0;
+		uint32_t ProductType = 0;
+		uint32_t BuildNumber = 0;
+	};
+
+	//
+	// Decimal, or hexadecimal with a 0x prefix like ProductType and SuiteMask are usually written;
+	// empty means unspecified
+	//
+	std::optional<uint32_t> ParseDecorationNumber(std::u16string_view text)
+	{
+		uint32_t base = 10;
+
+		if (text.size() > 2 && text[0] == u'0' && (text[1] == u'x' || text[1] == u'X'))
+		{
+			base = 16;
+			text.remove_prefix(2);
+		}
+
+		uint64_t value = 0;
+
+		for (const char16_t c : text)
+		{
+			uint32_t digit;
+
+			if (c >= u'0' && c <= u'9')
+			{
+				digit = c - u'0';
+			}
+			else if (base == 16 && c >= u'a' && c <= u'f')
+			{
+				digit = c - u'a' + 10;
+			}
+			else if (base == 16 && c >= u'A' && c <= u'F')
+			{
+				digit = c - u'A' + 10;
+			}
+			else
+			{
+				return std::nullopt;
+			}
+
+			value = value * base + digit;
+
+			if (value > UINT32_MAX)
+			{
+				return std::nullopt;
+			}
+		}
+
+		return static_cast<uint32_t>(value);
+	}
+
+	std::optional<ModelsDecoration> ParseDecoration(std::u16string_view decoration)
+	{
+		if (decoration.size() < 2 || !casefold::EqualsIgnoreCase(decoration.substr(0, 2), u"NT"))
+		{
+			return std::nullopt;
+		}
+
+		decoration.remove_prefix(2);
+
+		ModelsDecoration result;
+		const auto architectureEnd = std::min(decoration.find(u'.'), decoration.size());
+
+		if (const auto architecture = decoration.substr(0, architectureEnd); !architecture.empty())
+		{
+			for (const auto candidate : {
+				     InfArchitecture::X86, InfArchitecture::Amd64, InfArchitecture::Ia64, InfArchitecture::Arm,
+				     InfArchitecture::Arm64
+			     })
+			{
+				if (casefold::EqualsIgnoreCase(architecture, ::ArchitectureName(candidate)))
+				{
+					result.Architecture = candidate;
+				}
+			}
+
+			if (!result.Architecture)
+			{
+				return std::nullopt;
+			}
+		}
+
+		decoration.remove_prefix(architectureEnd);
+
+		uint32_t* const fields[] = {
+			&result.MajorVersion, &result.MinorVersion, &result.ProductType, nullptr, &result.BuildNumber
+		};
+
+		for (auto* const field : fields)
+		{
+			if (decoration.empty())
+			{
+				break;
+			}
+
+			// skip the '.' that got us here
+			decoration.remove_prefix(1);
+
+			const auto end = std::min(decoration.find(u'.'), decoration.size());
+			const auto number = ::ParseDecorationNumber(decoration.substr(0, end));
+
+			if (!number)
+			{
+				return std::nullopt;
+			}
+
+			// the suite mask isn't evaluated
+			if (field)
+			{
+				*field = *number;
+			}
+
+			decoration.remove_prefix(end);
+		}
+
+		return decoration.empty() ? std::optional(result) : std::nullopt;
+	}
+
+	bool DecorationAppliesTo(const ModelsDecoration& decoration, const InfPlatformTarget& target)
+	{
+		if (decoration.Architecture && *decoration.Architecture != target.Architecture)
+		{
+			return false;
+		}
+
+		if (target.OsMajorVersion == 0)
+		{
+			return true;
+		}
+
+		const auto required = std::tuple(decoration.MajorVersion, decoration.MinorVersion, decoration.BuildNumber);
+		const auto actual = std::tuple(uint32_t{target.OsMajorVersion}, uint32_t{target.OsMinorVersion},
+		                               target.OsBuildNumber);
+
+		return required <= actual
+			&& (decoration.ProductType == 0 || target.ProductType == 0 || decoration.ProductType == target.ProductType);
+	}
+
+	//
+	// Of several applicable decorations the one targeting the highest OS version wins, then the
+	// architecture-specific one, then the one restricted to a product type, like
+	// SetupAPI chooses
+	//
+	bool IsBetterDecoration(const ModelsDecoration& candidate, const ModelsDecoration& current)
+	{
+		return std::tuple(candidate.MajorVersion, candidate.MinorVersion, candidate.BuildNumber,
+		                  candidate.Architecture.has_value(), candidate.ProductType != 0)
+			> std::tuple(current.MajorVersion, current.MinorVersion, current.BuildNumber,
+			             current.Architecture.has_value(), current.ProductType != 0);
+	}
+
+	void CollectModelsFromSection(const InfFile& File, std::u16string_view SectionName, std::vector<InfModel>& Models)
+	{
+		const auto section = File.section(SectionName);
+
+		if (!section)
+		{
+			return;
+		}
+
+		for (const auto line : *section)
+		{
+			if (line.field_count() < 2)
+			{
+				continue;
+			}
+
+			InfModel model;
+			model.Description = line.key();
+			model.InstallSection = line.field(1);
+
+			//
+			// The hardware ID may be left empty for a model that is only matched by compatible IDs
+			//
+			model.HardwareIds.emplace_back(line.field(2));
+
+			for (size_t field = 3; field <= line.field_count(); field++)
+			{
+				if (const auto id = line.field(field); !id.empty())
+				{
+					model.HardwareIds.emplace_back(id);
+				}
+			}
+
+			if (model.HardwareIds.size() == 1 && model.HardwareIds.front().empty())
+			{
+				continue;
+			}
+
+			//
+			// The same device is commonly listed in several OS-version-specific sections
+			//
+			const bool alreadyPresent = std::ranges::any_of(Models, [&](const InfModel& existing)
+			{
+				return casefold::EqualsIgnoreCase(existing.InstallSection, model.InstallSection)
+					&& casefold::EqualsIgnoreCase(existing.HardwareIds.front(), model.HardwareIds.front());
+			});
+
+			if (!alreadyPresent)
+			{
+				Models.push_back(std::move(model));
+			}
+		}
+	}
+
+	//
+	// [Manufacturer] lines are "%Mfg% = ModelsSection[, Decoration...]"; an entry without
+	// decorations refers to the undecorated section, otherwise to ModelsSection.Decoration. Without
+	// an OS version in the target every decoration of the architecture is used, with one only the
+	// best applicable decoration of each entry, as on a system running that version.
+	//
+	void CollectModels(const InfFile& File, const InfPlatformTarget& Target, std::vector<InfModel>& Models)
+	{
+		const auto manufacturer = File.section(u"Manufacturer");
+
+		if (!manufacturer)
+		{
+			return;
+		}
+
+		for (const auto line : *manufacturer)
+		{
+			const auto modelsSection = line.field(1);
+
+			if (modelsSection.empty())
+			{
+				continue;
+			}
+
+			if (line.field_count() < 2)
+			{
+				::CollectModelsFromSection(File, modelsSection, Models);
+				continue;
+			}
+
+			std::optional<std::u16string_view> best;
+			ModelsDecoration bestDecoration;
+
+			for (size_t field = 2; field <= line.field_count(); field++)
+			{
+				const auto decoration = line.field(field);
+				const auto parsed = ::ParseDecoration(decoration);
+
+				if (!parsed || !::DecorationAppliesTo(*parsed, Target))
+				{
+					continue;
+				}
+
+				if (Target.OsMajorVersion == 0)
+				{
+					std::u16string decorated(modelsSection);
+					decorated.push_back(u'.');
+					decorated.append(decoration);
+
+					::CollectModelsFromSection(File, decorated, Models);
+				}
+				else if (!best || ::IsBetterDecoration(*parsed, bestDecoration))
+				{
+					best = decoration;
+					bestDecoration = *parsed;
+				}
+			}
+
+			if (best)
+			{
+				std::u16string decorated(modelsSection);
+				decorated.push_back(u'.');
+				decorated.append(*best);
+
+				::CollectModelsFromSection(File, decorated, Models);
+			}
+		}
+	}
+
+	struct BatchItem
+	{
+		std::filesystem::path Path;
+		///< Set if the entry couldn't be enumerated; delivered as is instead of being analyzed
+		std::error_code Error;
+	};
+
+	struct BatchResult
+	{
+		std::filesystem::path Path;
+		std::expected<InfAnalysis, std::error_code> Result;
+	};
+
+	//
+	// Fixed set of workers with one deque each. Items are dealt round-robin; a worker takes from
+	// the back of its own deque and, once that runs dry, steals from the front of the others, so
+	// a few huge INFs landing on the same worker don't hold up the rest of the batch.
+	//
+	class WorkStealingPool
+	{
+	public:
+		WorkStealingPool(unsigned Threads, std::function<void(BatchItem&&)> Work) : work_(std::move(Work))
+		{
+			for (unsigned index = 0; index < Threads; ++index)
+			{
+				queues_.push_back(std::make_unique<Queue>());
+			}
+
+			for (unsigned index = 0; index < Threads; ++index)
+			{
+				workers_.emplace_back([this, index] { run(index); });
+			}
+		}
+
+		WorkStealingPool(const WorkStealingPool&) = delete;
+		WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+		// Finishes the queued items, then joins the workers
+		~WorkStealingPool()
+		{
+			{
+				std::lock_guard lock(wakeLock_);
+				stopping_ = true;
+			}
+
+			wake_.notify_all();
+			workers_.clear();
+		}
+
+		void submit(BatchItem&& Item)
+		{
+			{
+				Queue& queue = *queues_[next_++ % queues_.size()];
+				std::lock_guard lock(queue.Lock);
+				queue.Items.push_back(std::move(Item));
+			}
+
+			{
+				std::lock_guard lock(wakeLock_);
+				++pending_;
+			}
+
+			wake_.notify_one();
+		}
+
+	private:
+		struct Queue
+		{
+			std::mutex Lock;
+			std::deque<BatchItem> Items;
+		};
+
+		bool take(size_t Self, BatchItem& Item)
+		{
+			{
+				Queue& own = *queues_[Self];
+				std::lock_guard lock(own.Lock);
+
+				if (!own.Items.empty())
+				{
+					Item = std::move(own.Items.back());
+					own.Items.pop_back();
+					return true;
+				}
+			}
+
+			for (size_t offset = 1; offset < queues_.size(); ++offset)
+			{
+				Queue& victim = *queues_[(Self + offset) % queues_.size()];
+				std::lock_guard lock(victim.Lock);
+
+				if (!victim.Items.empty())
+				{
+					Item = std::move(victim.Items.front());
+					victim.Items.pop_front();
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		void run(size_t Self)
+		{
+			for (;;)
+			{
+				{
+					std::unique_lock lock(wakeLock_);
+					wake_.wait(lock, [this] { return pending_ > 0 || stopping_; });
+
+					if (pending_ == 0)
+					{
+						return;
+					}
+
+					//
+					// Claims one item; it may sit in any of the deques (and be taken by another
+					// worker in the meantime), but there is always one left for each claim
+					//
+					--pending_;
+				}
+
+				BatchItem item;
+
+				while (!take(Self, item))
+				{
+					std::this_thread::yield();
+				}
+
+				work_(std::move(item));
+			}
+		}
+
+		std::function<void(BatchItem&&)> work_;
+		std::vector<std::unique_ptr<Queue>> queues_;
+		size_t next_{0};
+
+		std::mutex wakeLock_;
+		std::condition_variable wake_;
+		size_t pending_{0};
+		bool stopping_{false};
+
+		// declared last so the workers are joined before anything they use is destroyed
+		std::vector<std::jthread> workers_;
+	};
+
+	//
+	// Completed results, handed from the workers to the thread that runs the batch
+	//
+	class ResultChannel
+	{
+	public:
+		void push(BatchResult&& Result)
+		{
+			{
+				std::lock_guard lock(lock_);
+				results_.push_back(std::move(Result));
+			}
+
+			ready_.notify_one();
+		}
+
+		BatchResult pop()
+		{
+			std::unique_lock lock(lock_);
+			ready_.wait(lock, [this] { return !results_.empty(); });
+
+			BatchResult result = std::move(results_.front());
+			results_.pop_front();
+
+			return result;
+		}
+
+		std::optional<BatchResult> try_pop()
+		{
+			std::lock_guard lock(lock_);
+
+			if (results_.empty())
+			{
+				return std::nullopt;
+			}
+
+			BatchResult result = std::move(results_.front());
+			results_.pop_front();
+
+			return result;
+		}
+
+	private:
+		std::mutex lock_;
+		std::condition_variable ready_;
+		std::deque<BatchResult> results_;
+	};
+
+	//
+	// Runs a batch over the paths produced by Next (std::nullopt once exhausted). The calling
+	// thread produces the items and consumes the results, submitting only while fewer than
+	// MaxInFlight items are outstanding.
+	//
+	template <typename Source>
+	InfBatchStats RunBatch(Source&& Next, const InfBatchCallback& Callback, const InfBatchOptions& Options)
+	{
+		const unsigned threads = Options.Threads != 0
+			                         ? Options.Threads
+			                         : std::max(1u, std::thread::hardware_concurrency());
+		const size_t maxInFlight = Options.MaxInFlight != 0 ? Options.MaxInFlight : size_t{threads} * 4;
+
+		InfBatchStats stats;
+		std::atomic<bool> stopped{false};
+		ResultChannel results;
+
+		WorkStealingPool pool(threads, [&](BatchItem&& Item)
+		{
+			// after a stop the remaining items are only drained, not analyzed
+			if (stopped.load(std::memory_order_relaxed))
+			{
+				results.push(BatchResult{std::move(Item.Path), std::unexpected(
+					                         std::make_error_code(std::errc::operation_canceled))});
+				return;
+			}
+
+			auto file = InfFile::Open(Item.Path, Options.Open);
+
+			if (!file)
+			{
+				results.push(BatchResult{std::move(Item.Path), std::unexpected(file.error())});
+				return;
+			}
+
+			results.push(BatchResult{std::move(Item.Path), AnalyzeInf(*file, Options.Target)});
+		});
+
+		size_t inFlight = 0;
+
+		const auto deliver = [&](BatchResult&& Result)
+		{
+			--inFlight;
+
+			if (stats.Stopped)
+			{
+				return;
+			}
+
+			++(Result.Result ? stats.Analyzed : stats.Failed);
+
+			if (!Callback(Result.Path, std::move(Result.Result)))
+			{
+				stats.Stopped = true;
+				stopped.store(true, std::memory_order_relaxed);
+			}
+		};
+
+		while (!stats.Stopped)
+		{
+			std::optional<BatchItem> item = Next();
+
+			if (!item)
+			{
+				break;
+			}
+
+			if (item->Error)
+			{
+				++stats.Inaccessible;
+
+				if (!Callback(item->Path, std::unexpected(item->Error)))
+				{
+					stats.Stopped = true;
+					stopped.store(true, std::memory_order_relaxed);
+				}
+
+				continue;
+			}
+
+			while (inFlight >= maxInFlight)
+			{
+				deliver(results.pop());
+			}
+
+			if (stats.Stopped)
+			{
+				break;
+			}
+
+			pool.submit(std::move(*item));
+			++inFlight;
+
+			while (auto ready = results.try_pop())
+			{
+				deliver(std::move(*ready));
+			}
+		}
+
+		while (inFlight > 0)
+		{
+			deliver(results.pop());
+		}
+
+		return stats;
+	}
+
+	template <typename CharT>
+	bool HasInfExtension(const std::basic_string<CharT>& Extension)
+	{
+		constexpr char expected[] = ".inf";
+
+		return Extension.size() == 4 && std::equal(Extension.begin(), Extension.end(), expected,
+		                                           [](CharT Lhs, char Rhs)
+		                                           {
+			                                           return (Lhs >= CharT('A') && Lhs <= CharT('Z')
+				                                                   ? Lhs + (CharT('a') - CharT('A'))
+				                                                   : Lhs) == CharT(Rhs);
+		                                           });
+	}
+
+	struct SetupClass
+	{
+		std::u16string_view Name;
+		std::string_view ClassGuid;
+	};
+
+	//
+	// The system-defined device setup classes (see "System-Defined Device Setup Classes Available
+	// to Vendors" in the WDK documentation), whose GUIDs are the same on every Windows installation
+	//
+	constexpr SetupClass SystemSetupClasses[] = {
+		{u"1394", "{6bdd1fc1-810f-11d0-bec7-08002be2092f}"},
+		{u"Adapter", "{4d36e964-e325-11ce-bfc1-08002be10318}"},
+		{u"AudioEndpoint", "{c166523c-fe0c-4a94-a586-f1a80cfbbf3e}"},
+		{u"Battery", "{72631e54-78a4-11d0-bcf7-00aa00b7b32a}"},
+		{u"Biometric", "{53d29ef7-377c-4d14-864b-eb3a85769359}"},
+		{u"Bluetooth", "{e0cbf06c-cd8b-4647-bb8a-263b43f0f974}"},
+		{u"Camera", "{ca3e7ab9-b4c3-4ae6-8251-579ef933890f}"},
+		{u"CDROM", "{4d36e965-e325-11ce-bfc1-08002be10318}"},
+		{u"Computer", "{4d36e966-e325-11ce-bfc1-08002be10318}"},
+		{u"DiskDrive", "{4d36e967-e325-11ce-bfc1-08002be10318}"},
+		{u"Display", "{4d36e968-e325-11ce-bfc1-08002be10318}"},
+		{u"Extension", "{e2f84ce7-8efa-411c-aa69-97454ca4cb57}"},
+		{u"FDC", "{4d36e969-e325-11ce-bfc1-08002be10318}"},
+		{u"Firmware", "{f2e7dd72-6468-4e36-b6f1-6488f42c1b52}"},
+		{u"FloppyDisk", "{4d36e980-e325-11ce-bfc1-08002be10318}"},
+		{u"HDC", "{4d36e96a-e325-11ce-bfc1-08002be10318}"},
+		{u"HIDClass", "{745a17a0-74d3-11d0-b6fe-00a0c90f57da}"},
+		{u"Image", "{6bdd1fc6-810f-11d0-bec7-08002be2092f}"},
+		{u"Infrared", "{6bdd1fc5-810f-11d0-bec7-08002be2092f}"},
+		{u"Keyboard", "{4d36e96b-e325-11ce-bfc1-08002be10318}"},
+		{u"Media", "{4d36e96c-e325-11ce-bfc1-08002be10318}"},
+		{u"MediumChanger", "{ce5939ae-ebde-11d0-b181-0000f8753ec4}"},
+		{u"Modem", "{4d36e96d-e325-11ce-bfc1-08002be10318}"},
+		{u"Monitor", "{4d36e96e-e325-11ce-bfc1-08002be10318}"},
+		{u"Mouse", "{4d36e96f-e325-11ce-bfc1-08002be10318}"},
+		{u"MTD", "{4d36e970-e325-11ce-bfc1-08002be10318}"},
+		{u"Multifunction", "{4d36e971-e325-11ce-bfc1-08002be10318}"},
+		{u"MultiportSerial", "{50906cb8-ba12-11d1-bf5d-0000f805f530}"},
+		{u"Net", "{4d36e972-e325-11ce-bfc1-08002be10318}"},
+		{u"NetClient", "{4d36e973-e325-11ce-bfc1-08002be10318}"},
+		{u"NetService", "{4d36e974-e325-11ce-bfc1-08002be10318}"},
+		{u"NetTrans", "{4d36e975-e325-11ce-bfc1-08002be10318}"},
+		{u"PCMCIA", "{4d36e977-e325-11ce-bfc1-08002be10318}"},
+		{u"Ports", "{4d36e978-e325-11ce-bfc1-08002be10318}"},
+		{u"Printer", "{4d36e979-e325-11ce-bfc1-08002be10318}"},
+		{u"PrintQueue", "{1ed2bbf9-11f0-4084-b21f-ad83a8e6dcdc}"},
+		{u"Processor", "{50127dc3-0f36-415e-a6cc-4cb3be910b65}"},
+		{u"SCSIAdapter", "{4d36e97b-e325-11ce-bfc1-08002be10318}"},
+		{u"SecurityAccelerator", "{268c95a1-edfe-11d3-95c3-0010dc4050a5}"},
+		{u"SecurityDevices", "{d94ee5d8-d189-4994-83d2-f68d7d41b0e6}"},
+		{u"Sensor", "{5175d334-c371-4806-b3ba-71fd53c9258d}"},
+		{u"SmartCardReader", "{50dd5230-ba8a-11d1-bf5d-0000f805f530}"},
+		{u"SoftwareComponent", "{5c4c3332-344d-483c-8739-259e934c9cc8}"},
+		{u"SoftwareDevice", "{62f9c741-b25a-46ce-b54c-9bccce08b6f2}"},
+		{u"System", "{4d36e97d-e325-11ce-bfc1-08002be10318}"},
+		{u"TapeDrive", "{6d807884-7d21-11cf-801c-08002be10318}"},
+		{u"USB", "{36fc9e60-c465-11cf-8056-444553540000}"},
+		{u"USBDevice", "{88bae032-5a81-49f0-bc3d-a4ff138216d6}"},
+		{u"Volume", "{71a27cdd-812a-11d0-bec7-08002be2092f}"},
+		{u"WPD", "{eec5ad98-8080-425f-922a-dabf3de3f69a}"},
+	};
+
+	static_assert(std::ranges::all_of(SystemSetupClasses, [](const SetupClass& Class)
+	{
+		return ParseGuid(Class.ClassGuid).has_value();
+	}));
+
+	//
+	// [Version] identity, shared by every target an INF is analyzed for. The class is resolved
+	// like SetupDiGetINFClass does: ClassGuid first, then the GUID registered for the Class name.
+	//
+	InfAnalysis AnalyzeVersion(const InfFile& File, const std::optional<Guid>& NamedClassGuid)
+	{
+		InfAnalysis analysis;
+
+		if (const auto version = File.section(u"Version"))
+		{
+			if (const auto line = version->find(u"ClassGuid"))
+			{
+				analysis.ClassGuid = ParseGuid(line->field(1));
+			}
+
+			if (const auto line = version->find(u"Class"))
+			{
+				analysis.ClassName = line->field(1);
+			}
+
+			if (!analysis.ClassGuid && !analysis.ClassName.empty())
+			{
+				analysis.ClassGuid = SystemSetupClassGuid(analysis.ClassName);
+
+				if (!analysis.ClassGuid)
+				{
+					analysis.ClassGuid = NamedClassGuid;
+				}
+			}
+
+			if (const auto line = version->find(u"Provider"))
+			{
+				analysis.Provider = line->field(1);
+			}
+
+			if (const auto line = version->find(u"DriverVer"))
+			{
+				analysis.DriverDate = line->field(1);
+				analysis.DriverVersion = line->field(2);
+			}
+		}
+
+		return analysis;
+	}
+
+	//
+	// The DefaultInstall and DefaultUninstall variants a target resolves to
+	//
+	struct DefaultSections
+	{
+		std::optional<InfSection> Install;
+		std::optional<InfSection> Uninstall;
+
+		bool operator==(const DefaultSections& Other) const
+		{
+			return SameSection(Install, Other.Install) && SameSection(Uninstall, Other.Uninstall);
+		}
+
+	private:
+		//
+		// Name views point into the section table, so they are unique per section of one InfFile
+		//
+		static bool SameSection(const std::optional<InfSection>& Lhs, const std::optional<InfSection>& Rhs)
+		{
+			return Lhs.has_value() == Rhs.has_value() && (!Lhs || Lhs->name().data() == Rhs->name().data());
+		}
+	};
+
+	DefaultSections ResolveDefaultSections(const InfFile& File, const InfPlatformTarget& Target)
+	{
+		return {
+			File.resolve_install_section(u"DefaultInstall", Target),
+			File.resolve_install_section(u"DefaultUninstall", Target)
+		};
+	}
+
+	std::vector<InfFilterTarget> CollectFilterTargets(const InfFile& File, const std::optional<Guid>& ClassGuid,
+	                                                  const DefaultSections& Sections)
+	{
+		std::vector<InfFilterTarget> targets;
+
+		for (const auto* section : {&Sections.Install, &Sections.Uninstall})
+		{
+			if (!*section)
+			{
+				continue;
+			}
+
+			for (const auto line : **section)
+			{
+				if (!casefold::EqualsIgnoreCase(line.key(), u"AddReg")
+					&& !casefold::EqualsIgnoreCase(line.key(), u"DelReg"))
+				{
+					continue;
+				}
+
+				for (size_t field = 1; field <= line.field_count(); field++)
+				{
+					if (const auto referenced = line.field(field); !referenced.empty())
+					{
+						::CollectFiltersFromRegSection(File, referenced, ClassGuid, targets);
+					}
+				}
+			}
+		}
+
+		std::vector<InfFilterTarget> deduped;
+
+		for (auto& target : targets)
+		{
+			const bool alreadyPresent = std::ranges::any_of(deduped, [&](const InfFilterTarget& existing)
+			{
+				return existing.ClassGuid == target.ClassGuid
+					&& existing.Position == target.Position
+					&& casefold::EqualsIgnoreCase(existing.ServiceName, target.ServiceName);
+			});
+
+			if (!alreadyPresent)
+			{
+				deduped.push_back(std::move(target));
+			}
+		}
+
+		return deduped;
+	}
+}
+
+std::optional<Guid> nefarius::devcon::inf::SystemSetupClassGuid(std::u16string_view ClassName)
+{
+	const auto known = std::ranges::find_if(SystemSetupClasses, [&](const SetupClass& Class)
+	{
+		return casefold::EqualsIgnoreCase(Class.Name, ClassName);
+	});
+
+	if (known == std::ranges::end(SystemSetupClasses))
+	{
+		return std::nullopt;
+	}
+
+	return ParseGuid(known->ClassGuid);
+}
+
+nefarius::devcon::inf::InfAnalysis nefarius::devcon::inf::AnalyzeInf(const InfFile& File,
+                                                                     const InfPlatformTarget& Target,
+                                                                     const std::optional<Guid>& NamedClassGuid)
+{
+	InfAnalysis analysis = ::AnalyzeVersion(File, NamedClassGuid);
+
+	analysis.FilterTargets = ::CollectFilterTargets(File, analysis.ClassGuid, ::ResolveDefaultSections(File, Target));
+	::CollectModels(File, Target, analysis.Models);
+
+	return analysis;
+}
+
+std::vector<nefarius::devcon::inf::InfAnalysis> nefarius::devcon::inf::AnalyzeInf(
+	const InfFile& File, std::span<const InfPlatformTarget> Targets, const std::optional<Guid>& NamedClassGuid)
+{
+	const InfAnalysis version = ::AnalyzeVersion(File, NamedClassGuid);
+
+	std::vector<InfAnalysis> analyses;
+	std::vector<DefaultSections> resolved;
+	analyses.reserve(Targets.size());
+	resolved.reserve(Targets.size());
+
+	for (const auto& target : Targets)
+	{
+		InfAnalysis& analysis = analyses.emplace_back(version);
+		const auto& sections = resolved.emplace_back(::ResolveDefaultSections(File, target));
+
+		//
+		// Targets commonly only differ in OS version, which doesn't affect the install sections
+		//
+		const auto previous = std::ranges::find(resolved.begin(), resolved.end() - 1, sections);
+
+		if (previous != resolved.end() - 1)
+		{
+			analysis.FilterTargets = analyses[previous - resolved.begin()].FilterTargets;
+		}
+		else
+		{
+			analysis.FilterTargets = ::CollectFilterTargets(File, analysis.ClassGuid, sections);
+		}
+
+		::CollectModels(File, target, analysis.Models);
+	}
+
+	return analyses;
+}
+
+nefarius::devcon::inf::InfBatchStats nefarius::devcon::inf::AnalyzeInfFiles(
+	std::span<const std::filesystem::path> Paths, const InfBatchCallback& Callback, const InfBatchOptions& Options)
+{
+	size_t next = 0;
+
+	return ::RunBatch([&]() -> std::optional<BatchItem>
+	{
+		if (next == Paths.size())
+		{
+			return std::nullopt;
+		}
+
+		return BatchItem{Paths[next++], {}};
+	}, Callback, Options);
+}
+
+std::expected<nefarius::devcon::inf::InfBatchStats, std::error_code> nefarius::devcon::inf::AnalyzeInfDirectory(
+	const std::filesystem::path& Directory, const InfBatchCallback& Callback, const InfBatchOptions& Options)
+{
+	namespace fs = std::filesystem;
+
+	std::error_code error;
+	fs::directory_iterator root(Directory, error);
+
+	if (error)
+	{
+		return std::unexpected(error);
+	}
+
+	//
+	// One plain iterator per open directory instead of a recursive_directory_iterator, which
+	// (with libstdc++) turns into the end iterator on the first error. This way a directory that
+	// can't be opened or read to the end only loses its own entries; each such failure is
+	// delivered to the callback with the directory's path.
+	//
+	std::vector<fs::directory_iterator> open;
+	std::deque<BatchItem> failures;
+	open.push_back(std::move(root));
+
+	return ::RunBatch([&]() -> std::optional<BatchItem>
+	{
+		while (failures.empty() && !open.empty())
+		{
+			fs::directory_iterator& top = open.back();
+
+			if (top == fs::directory_iterator())
+			{
+				open.pop_back();
+				continue;
+			}
+
+			const fs::directory_entry entry = *top;
+
+			if (top.increment(error); error)
+			{
+				// the rest of this directory is lost, the entry in hand is still processed
+				failures.push_back(BatchItem{entry.path().parent_path(), error});
+				open.pop_back();
+			}
+
+			std::error_code typeError;
+
+			// symbolic links to directories aren't followed, like recursive_directory_iterator
+			if (entry.is_directory(typeError) && !entry.is_symlink(typeError))
+			{
+				if (!Options.Recursive)
+				{
+					continue;
+				}
+
+				if (fs::directory_iterator subdirectory(entry.path(), error); error)
+				{
+					failures.push_back(BatchItem{entry.path(), error});
+				}
+				else
+				{
+					open.push_back(std::move(subdirectory));
+				}
+
+				continue;
+			}
+
+			if (entry.is_regular_file(typeError) && ::HasInfExtension(entry.path().extension().native()))
+			{
+				return BatchItem{entry.path(), {}};
+			}
+		}
+
+		if (failures.empty())
+		{
+			return std::nullopt;
+		}
+
+		BatchItem failure = std::move(failures.front());
+		failures.pop_front();
+		return failure;
+	}, Callback, Options);
+}
@@ -0,0 +1,1011 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/InfFile.hpp>
+#include <nefarius/neflib/Transcode.hpp>
+
+#include "MappedFile.hpp"
+
+
+using namespace nefarius::devcon::inf;
+using namespace nefarius::utilities;
+
+static_assert(std::endian::native == std::endian::little, "UTF-16LE content is used in place");
+
+namespace
+{
+	struct FoldedHash
+	{
+		size_t operator()(std::u16string_view Value) const
+		{
+			return casefold::HashIgnoreCase(Value);
+		}
+	};
+
+	struct FoldedEqual
+	{
+		bool operator()(std::u16string_view Lhs, std::u16string_view Rhs) const
+		{
+			return casefold::EqualsIgnoreCase(Lhs, Rhs);
+		}
+	};
+
+	template <typename T>
+	using FoldedMap = std::unordered_map<std::u16string_view, T, FoldedHash, FoldedEqual>;
+
+	//
+	// Windows-1252 code points of 0x80-0x9F; the rest of the code page maps 1:1 to Latin-1.
+	// Unassigned bytes are kept as the C1 control of the same value, like MultiByteToWideChar.
+	//
+	constexpr char16_t Cp1252High[32] = {
+		0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+		0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+		0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+		0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+	};
+
+	bool IsValidUtf8(const unsigned char* Data, size_t Length)
+	{
+		for (size_t i = 0; i < Length;)
+		{
+			const unsigned char lead = Data[i];
+
+			if (lead < 0x80)
+			{
+				++i;
+				continue;
+			}
+
+			size_t count;
+			uint32_t codePoint;
+
+			if (lead >= 0xC2 && lead <= 0xDF)
+			{
+				count = 1;
+				codePoint = lead & 0x1F;
+			}
+			else if (lead >= 0xE0 && lead <= 0xEF)
+			{
+				count = 2;
+				codePoint = lead & 0x0F;
+			}
+			else if (lead >= 0xF0 && lead <= 0xF4)
+			{
+				count = 3;
+				codePoint = lead & 0x07;
+			}
+			else
+			{
+				return false;
+			}
+
+			if (Length - i <= count)
+			{
+				return false;
+			}
+
+			for (size_t k = 1; k <= count; ++k)
+			{
+				if ((Data[i + k] & 0xC0) != 0x80)
+				{
+					return false;
+				}
+
+				codePoint = codePoint << 6 | (Data[i + k] & 0x3F);
+			}
+
+			// overlong forms, surrogates and code points past U+10FFFF
+			if ((count == 2 && codePoint < 0x800) || (count == 3 && codePoint < 0x10000)
+				|| (codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+			{
+				return false;
+			}
+
+			i += count + 1;
+		}
+
+		return true;
+	}
+
+	bool IsInlineWhitespace(char16_t Char)
+	{
+		// 0x1A is the legacy end-of-file marker some old INFs still carry
+		return Char == u' ' || Char == u'\t' || Char == u'\x1A' || Char == u'\0';
+	}
+
+	bool IsLineBreak(char16_t Char)
+	{
+		return Char == u'\r' || Char == u'\n';
+	}
+}
+
+namespace nefarius::devcon::inf::detail
+{
+	struct FieldEntry
+	{
+		///< Trimmed field text as written
+		uint32_t Offset;
+		uint32_t Length;
+		///< A single quoted string without escapes; the value is the text between the quotes
+		bool Unquote;
+		///< Contains quotes, %strkey% tokens or line continuations and must be cooked before use
+		bool NeedsCooking;
+	};
+
+	struct LineEntry
+	{
+		uint32_t Section;
+		///< Slot of the key (empty if there is none); the values follow it
+		uint32_t FirstField;
+		uint32_t FieldCount;
+		uint32_t LineNumber;
+		bool HasKey;
+	};
+
+	struct SectionEntry
+	{
+		uint32_t NameOffset;
+		uint32_t NameLength;
+		uint32_t FirstLine;
+		uint32_t LineCount;
+	};
+
+	using CookedSlots = std::unique_ptr<std::atomic<const std::u16string*>[]>;
+
+	struct InfData
+	{
+		nefarius::utilities::detail::MappedFile Mapping;
+		std::u16string Decoded;
+		std::u16string_view Text;
+		InfEncoding Encoding{InfEncoding::Ansi};
+
+		std::vector<SectionEntry> Sections;
+		FoldedMap<uint32_t> SectionIndex;
+		std::vector<LineEntry> Lines;
+		std::vector<FieldEntry> Fields;
+
+		///< [Strings] key to index into StringFields
+		FoldedMap<uint32_t> Strings;
+		///< Value field of each [Strings] entry
+		std::vector<uint32_t> StringFields;
+
+		//
+		// Cooked values are computed without holding the lock (expanding a field may need to
+		// cook a [Strings] value first) and published through per-field slots, so readers of an
+		// already cooked field never block; the deque never moves its elements
+		//
+		CookedSlots CookedFields;
+		CookedSlots CookedStrings;
+		std::mutex CookLock;
+		std::deque<std::u16string> Cooked;
+
+		[[nodiscard]] std::u16string_view Raw(const FieldEntry& Field) const
+		{
+			return Text.substr(Field.Offset, Field.Length);
+		}
+
+		//
+		// Unquotes and joins continued lines; expands %strkey% tokens unless this is a [Strings]
+		// value itself, which is substituted as-is
+		//
+		[[nodiscard]] std::u16string Cook(std::u16string_view Raw, bool Expand) const
+		{
+			std::u16string result;
+			result.reserve(Raw.size());
+			bool inQuotes = false;
+
+			for (size_t i = 0; i < Raw.size(); ++i)
+			{
+				const char16_t c = Raw[i];
+
+				if (c == u'"')
+				{
+					if (inQuotes && i + 1 < Raw.size() && Raw[i + 1] == u'"')
+					{
+						result.push_back(u'"');
+						++i;
+					}
+					else
+					{
+						inQuotes = !inQuotes;
+					}
+
+					continue;
+				}
+
+				if (c == u'\\' && !inQuotes)
+				{
+					size_t next = i + 1;
+
+					while (next < Raw.size() && ::IsInlineWhitespace(Raw[next]))
+					{
+						++next;
+					}
+
+					if (next < Raw.size() && ::IsLineBreak(Raw[next]))
+					{
+						// drop the line break and the indentation of the continued line
+						if (Raw[next] == u'\r' && next + 1 < Raw.size() && Raw[next + 1] == u'\n')
+						{
+							++next;
+						}
+
+						++next;
+
+						while (next < Raw.size() && ::IsInlineWhitespace(Raw[next]))
+						{
+							++next;
+						}
+
+						i = next - 1;
+						continue;
+					}
+				}
+
+				if (c == u'%' && Expand)
+				{
+					const size_t close = Raw.find(u'%', i + 1);
+
+					if (close != std::u16string_view::npos)
+					{
+						if (close == i + 1)
+						{
+							result.push_back(u'%');
+						}
+						else if (const auto value = LookupString(Raw.substr(i + 1, close - i - 1)))
+						{
+							result.append(*value);
+						}
+						else
+						{
+							// unknown keys are left in place, like SetupAPI does
+							result.append(Raw.substr(i, close - i + 1));
+						}
+
+						i = close;
+						continue;
+					}
+				}
+
+				result.push_back(c);
+			}
+
+			return result;
+		}
+
+		std::u16string_view Publish(std::atomic<const std::u16string*>& Slot, std::u16string Value) const
+		{
+			auto& self = const_cast<InfData&>(*this);
+			std::lock_guard lock(self.CookLock);
+
+			// another thread may have cooked the same value meanwhile
+			if (const auto existing = Slot.load(std::memory_order_acquire))
+			{
+				return *existing;
+			}
+
+			const std::u16string* stored = &self.Cooked.emplace_back(std::move(Value));
+			Slot.store(stored, std::memory_order_release);
+
+			return *stored;
+		}
+
+		[[nodiscard]] std::u16string_view Value(const FieldEntry& Field, std::atomic<const std::u16string*>& Slot,
+		                                        bool Expand) const
+		{
+			const auto raw = Raw(Field);
+
+			if (Field.Unquote)
+			{
+				return raw.substr(1, raw.size() - 2);
+			}
+
+			if (!Field.NeedsCooking)
+			{
+				return raw;
+			}
+
+			if (const auto cooked = Slot.load(std::memory_order_acquire))
+			{
+				return *cooked;
+			}
+
+			return Publish(Slot, Cook(raw, Expand));
+		}
+
+		[[nodiscard]] std::u16string_view FieldValue(uint32_t Index) const
+		{
+			return Value(Fields[Index], CookedFields[Index], true);
+		}
+
+		[[nodiscard]] std::optional<std::u16string_view> LookupString(std::u16string_view Key) const
+		{
+			const auto entry = Strings.find(Key);
+
+			if (entry == Strings.end())
+			{
+				return std::nullopt;
+			}
+
+			return Value(Fields[StringFields[entry->second]], CookedStrings[entry->second], false);
+		}
+	};
+}
+
+using nefarius::devcon::inf::detail::InfData;
+using nefarius::devcon::inf::detail::FieldEntry;
+using nefarius::devcon::inf::detail::LineEntry;
+using nefarius::devcon::inf::detail::SectionEntry;
+
+namespace
+{
+	constexpr uint32_t NoSection = UINT32_MAX;
+
+	void DecodeUtf16(InfData& Data, const unsigned char* Bytes, size_t Length, bool BigEndian, bool Borrow)
+	{
+		const size_t count = Length / sizeof(char16_t);
+
+		if (Borrow && !BigEndian && reinterpret_cast<uintptr_t>(Bytes) % alignof(char16_t) == 0)
+		{
+			Data.Text = {reinterpret_cast<const char16_t*>(Bytes), count};
+			return;
+		}
+
+		Data.Decoded.resize(count);
+		std::memcpy(Data.Decoded.data(), Bytes, count * sizeof(char16_t));
+
+		if (BigEndian)
+		{
+			for (auto& c : Data.Decoded)
+			{
+				c = static_cast<char16_t>(c << 8 | c >> 8);
+			}
+		}
+
+		Data.Text = Data.Decoded;
+	}
+
+	//
+	// Detects the encoding like SetupAPI does (BOM, else ANSI), except that BOM-less content
+	// which is valid UTF-8 and not pure ASCII is taken as UTF-8, and ANSI means Windows-1252
+	// instead of the current code page so the result doesn't depend on the machine.
+	//
+	void Decode(InfData& Data, std::span<const std::byte> Content, bool Borrow)
+	{
+		const auto* bytes = reinterpret_cast<const unsigned char*>(Content.data());
+		const size_t length = Content.size();
+
+		if (length >= 2 && bytes[0] == 0xFF && bytes[1] == 0xFE)
+		{
+			Data.Encoding = InfEncoding::Utf16LE;
+			::DecodeUtf16(Data, bytes + 2, length - 2, false, Borrow);
+			return;
+		}
+
+		if (length >= 2 && bytes[0] == 0xFE && bytes[1] == 0xFF)
+		{
+			Data.Encoding = InfEncoding::Utf16BE;
+			::DecodeUtf16(Data, bytes + 2, length - 2, true, Borrow);
+			return;
+		}
+
+		// BOM-less UTF-16 starts with an ASCII character ('[' or ';' in practice)
+		if (length >= 2 && bytes[0] != 0 && bytes[0] < 0x80 && bytes[1] == 0)
+		{
+			Data.Encoding = InfEncoding::Utf16LE;
+			::DecodeUtf16(Data, bytes, length, false, Borrow);
+			return;
+		}
+
+		const char* narrow = reinterpret_cast<const char*>(bytes);
+		size_t narrowLength = length;
+
+		if (length >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF)
+		{
+			narrow += 3;
+			narrowLength -= 3;
+			Data.Encoding = InfEncoding::Utf8;
+		}
+		else
+		{
+			const size_t ascii = transcode::CountAsciiPrefix(narrow, narrowLength);
+
+			Data.Encoding = ascii < narrowLength && ::IsValidUtf8(bytes + ascii, narrowLength - ascii)
+				                ? InfEncoding::Utf8
+				                : InfEncoding::Ansi;
+		}
+
+		if (Data.Encoding == InfEncoding::Utf8)
+		{
+			Data.Decoded.resize(transcode::Utf16LengthFromUtf8(narrow, narrowLength));
+			transcode::Utf8ToUtf16(narrow, narrowLength, Data.Decoded.data());
+		}
+		else
+		{
+			Data.Decoded.resize(narrowLength);
+
+			for (size_t i = transcode::WidenAsciiPrefix(narrow, narrowLength, Data.Decoded.data());
+			     i < narrowLength; ++i)
+			{
+				const auto c = static_cast<unsigned char>(narrow[i]);
+				Data.Decoded[i] = c >= 0x80 && c < 0xA0 ? Cp1252High[c - 0x80] : static_cast<char16_t>(c);
+			}
+		}
+
+		Data.Text = Data.Decoded;
+	}
+
+	// Start of the line following the one Position is on
+	size_t NextLine(std::u16string_view Text, size_t Position)
+	{
+		while (Position < Text.size() && !::IsLineBreak(Text[Position]))
+		{
+			++Position;
+		}
+
+		if (Position < Text.size() && Text[Position] == u'\r')
+		{
+			++Position;
+		}
+
+		if (Position < Text.size() && Text[Position] == u'\n')
+		{
+			++Position;
+		}
+
+		return Position;
+	}
+
+	FieldEntry MakeField(std::u16string_view Text, size_t Begin, size_t End, bool NeedsCooking, uint32_t Quotes)
+	{
+		while (Begin < End && ::IsInlineWhitespace(Text[Begin]))
+		{
+			++Begin;
+		}
+
+		while (End > Begin && ::IsInlineWhitespace(Text[End - 1]))
+		{
+			--End;
+		}
+
+		const bool simpleQuoted = !NeedsCooking && Quotes == 2 && End - Begin >= 2
+			&& Text[Begin] == u'"' && Text[End - 1] == u'"';
+
+		return FieldEntry{
+			static_cast<uint32_t>(Begin),
+			static_cast<uint32_t>(End - Begin),
+			simpleQuoted,
+			!simpleQuoted && (NeedsCooking || Quotes > 0)
+		};
+	}
+
+	uint32_t AddSection(InfData& Data, size_t Begin, size_t End)
+	{
+		while (Begin < End && ::IsInlineWhitespace(Data.Text[Begin]))
+		{
+			++Begin;
+		}
+
+		while (End > Begin && ::IsInlineWhitespace(Data.Text[End - 1]))
+		{
+			--End;
+		}
+
+		const auto [entry, inserted] = Data.SectionIndex.try_emplace(
+			Data.Text.substr(Begin, End - Begin), static_cast<uint32_t>(Data.Sections.size()));
+
+		if (inserted)
+		{
+			Data.Sections.push_back(SectionEntry{
+				static_cast<uint32_t>(Begin), static_cast<uint32_t>(End - Begin), 0, 0
+			});
+		}
+
+		return entry->second;
+	}
+
+	//
+	// Splits a logical line (which may continue over several physical ones) into an optional
+	// key and its comma-separated fields. Returns the start of the next line.
+	//
+	size_t ParseLine(InfData& Data, uint32_t Section, size_t Start, uint32_t& LineNumber)
+	{
+		const std::u16string_view text = Data.Text;
+		LineEntry line{Section, static_cast<uint32_t>(Data.Fields.size()), 0, LineNumber, false};
+
+		Data.Fields.push_back(FieldEntry{static_cast<uint32_t>(Start), 0, false, false});
+
+		size_t fieldStart = Start;
+		bool needsCooking = false;
+		uint32_t quotes = 0;
+		bool inQuotes = false;
+		bool anyContent = false;
+		bool anySeparator = false;
+		size_t i = Start;
+
+		const auto finishField = [&](size_t End)
+		{
+			Data.Fields.push_back(::MakeField(text, fieldStart, End, needsCooking, quotes));
+			++line.FieldCount;
+			needsCooking = false;
+			quotes = 0;
+		};
+
+		while (i < text.size())
+		{
+			const char16_t c = text[i];
+
+			if (inQuotes)
+			{
+				// an unterminated quote ends with the line
+				if (::IsLineBreak(c))
+				{
+					break;
+				}
+
+				if (c == u'"')
+				{
+					if (i + 1 < text.size() && text[i + 1] == u'"')
+					{
+						needsCooking = true;
+						i += 2;
+						continue;
+					}
+
+					inQuotes = false;
+					++quotes;
+				}
+				else if (c == u'%')
+				{
+					needsCooking = true;
+				}
+
+				++i;
+				continue;
+			}
+
+			if (::IsLineBreak(c) || c == u';')
+			{
+				break;
+			}
+
+			if (!::IsInlineWhitespace(c))
+			{
+				anyContent = true;
+			}
+
+			if (c == u'"')
+			{
+				inQuotes = true;
+				++quotes;
+			}
+			else if (c == u'%')
+			{
+				needsCooking = true;
+			}
+			else if (c == u'\\')
+			{
+				size_t next = i + 1;
+
+				while (next < text.size() && ::IsInlineWhitespace(text[next]))
+				{
+					++next;
+				}
+
+				if (next == text.size() || ::IsLineBreak(text[next]) || text[next] == u';')
+				{
+					const size_t continued = ::NextLine(text, next);
+					++LineNumber;
+
+					// usually the break follows a comma, otherwise the field spans both lines
+					if (::MakeField(text, fieldStart, i, false, 0).Length == 0)
+					{
+						fieldStart = continued;
+					}
+					else
+					{
+						needsCooking = true;
+					}
+
+					i = continued;
+					continue;
+				}
+			}
+			else if (c == u'=' && !line.HasKey && !anySeparator)
+			{
+				Data.Fields[line.FirstField] = ::MakeField(text, fieldStart, i, needsCooking, quotes);
+				line.HasKey = true;
+				fieldStart = i + 1;
+				needsCooking = false;
+				quotes = 0;
+			}
+			else if (c == u',')
+			{
+				finishField(i);
+				anySeparator = true;
+				fieldStart = i + 1;
+			}
+
+			++i;
+		}
+
+		finishField(i);
+
+		if (anyContent)
+		{
+			Data.Lines.push_back(line);
+		}
+		else
+		{
+			Data.Fields.resize(line.FirstField);
+		}
+
+		return ::NextLine(text, i);
+	}
+
+	void CollectStrings(InfData& Data, std::u16string_view SectionName)
+	{
+		const auto section = Data.SectionIndex.find(SectionName);
+
+		if (section == Data.SectionIndex.end())
+		{
+			return;
+		}
+
+		const SectionEntry& entry = Data.Sections[section->second];
+
+		for (uint32_t index = entry.FirstLine; index < entry.FirstLine + entry.LineCount; ++index)
+		{
+			const LineEntry& line = Data.Lines[index];
+
+			if (!line.HasKey || line.FieldCount == 0)
+			{
+				continue;
+			}
+
+			const FieldEntry& keyField = Data.Fields[line.FirstField];
+			std::u16string_view key = Data.Raw(keyField);
+
+			if (keyField.Unquote)
+			{
+				key = key.substr(1, key.size() - 2);
+			}
+			else if (keyField.NeedsCooking)
+			{
+				// not yet shared with any reader, so no locking needed
+				key = Data.Cooked.emplace_back(Data.Cook(key, false));
+			}
+
+			const auto [existing, inserted] = Data.Strings.try_emplace(
+				key, static_cast<uint32_t>(Data.StringFields.size()));
+
+			if (inserted)
+			{
+				Data.StringFields.push_back(line.FirstField + 1);
+			}
+			else
+			{
+				// language-specific entries are collected last and replace the neutral ones
+				Data.StringFields[existing->second] = line.FirstField + 1;
+			}
+		}
+	}
+
+	std::error_code Parse(InfData& Data, const InfOpenOptions& Options)
+	{
+		const std::u16string_view text = Data.Text;
+
+		if (text.size() >= UINT32_MAX)
+		{
+			return std::make_error_code(std::errc::file_too_large);
+		}
+
+		uint32_t section = NoSection;
+		uint32_t lineNumber = 0;
+
+		for (size_t position = 0; position < text.size();)
+		{
+			++lineNumber;
+
+			size_t start = position;
+
+			while (start < text.size() && ::IsInlineWhitespace(text[start]))
+			{
+				++start;
+			}
+
+			if (start < text.size() && text[start] == u'[')
+			{
+				size_t close = start + 1;
+
+				while (close < text.size() && text[close] != u']' && !::IsLineBreak(text[close]))
+				{
+					++close;
+				}
+
+				// a header without its closing bracket is ignored along with its section
+				section = close < text.size() && text[close] == u']'
+					          ? ::AddSection(Data, start + 1, close)
+					          : NoSection;
+
+				position = ::NextLine(text, close);
+				continue;
+			}
+
+			// lines before the first section header carry no meaning
+			if (section == NoSection)
+			{
+				position = ::NextLine(text, start);
+				continue;
+			}
+
+			position = ::ParseLine(Data, section, start, lineNumber);
+		}
+
+		//
+		// Lines are collected in file order; group them by section so same-named sections are
+		// merged and every section is a contiguous range
+		//
+		for (const auto& line : Data.Lines)
+		{
+			++Data.Sections[line.Section].LineCount;
+		}
+
+		uint32_t first = 0;
+
+		for (auto& entry : Data.Sections)
+		{
+			entry.FirstLine = first;
+			first += entry.LineCount;
+		}
+
+		std::vector<LineEntry> grouped(Data.Lines.size());
+		std::vector<uint32_t> fill(Data.Sections.size(), 0);
+
+		for (const auto& line : Data.Lines)
+		{
+			const SectionEntry& entry = Data.Sections[line.Section];
+			grouped[entry.FirstLine + fill[line.Section]++] = line;
+		}
+
+		Data.Lines = std::move(grouped);
+
+		::CollectStrings(Data, u"Strings");
+
+		if (Options.LanguageId != 0)
+		{
+			constexpr char16_t hex[] = u"0123456789abcdef";
+			std::u16string localized = u"Strings.";
+
+			for (int shift = 12; shift >= 0; shift -= 4)
+			{
+				localized.push_back(hex[Options.LanguageId >> shift & 0x0F]);
+			}
+
+			::CollectStrings(Data, localized);
+		}
+
+		Data.CookedFields = std::make_unique<std::atomic<const std::u16string*>[]>(Data.Fields.size());
+		Data.CookedStrings = std::make_unique<std::atomic<const std::u16string*>[]>(Data.StringFields.size());
+
+		return {};
+	}
+}
+
+bool nefarius::devcon::inf::InfLine::has_key() const
+{
+	return data_->Lines[index_].HasKey;
+}
+
+std::u16string_view nefarius::devcon::inf::InfLine::key() const
+{
+	return field(0);
+}
+
+size_t nefarius::devcon::inf::InfLine::field_count() const
+{
+	return data_->Lines[index_].FieldCount;
+}
+
+std::u16string_view nefarius::devcon::inf::InfLine::field(size_t Index) const
+{
+	const LineEntry& line = data_->Lines[index_];
+
+	if (Index > line.FieldCount)
+	{
+		return {};
+	}
+
+	return data_->FieldValue(line.FirstField + static_cast<uint32_t>(Index));
+}
+
+std::u16string_view nefarius::devcon::inf::InfLine::raw_field(size_t Index) const
+{
+	const LineEntry& line = data_->Lines[index_];
+
+	if (Index > line.FieldCount)
+	{
+		return {};
+	}
+
+	return data_->Raw(data_->Fields[line.FirstField + Index]);
+}
+
+uint32_t nefarius::devcon::inf::InfLine::line_number() const
+{
+	return data_->Lines[index_].LineNumber;
+}
+
+std::u16string_view nefarius::devcon::inf::InfSection::name() const
+{
+	const SectionEntry& entry = data_->Sections[section_];
+
+	return data_->Text.substr(entry.NameOffset, entry.NameLength);
+}
+
+std::optional<nefarius::devcon::inf::InfLine> nefarius::devcon::inf::InfSection::find(std::u16string_view Key) const
+{
+	for (const auto line : *this)
+	{
+		if (line.has_key() && casefold::EqualsIgnoreCase(line.key(), Key))
+		{
+			return line;
+		}
+	}
+
+	return std::nullopt;
+}
+
+nefarius::devcon::inf::InfFile::InfFile(std::unique_ptr<detail::InfData> Data) : data_(std::move(Data))
+{
+}
+
+nefarius::devcon::inf::InfFile::InfFile(InfFile&& Other) noexcept = default;
+
+nefarius::devcon::inf::InfFile& nefarius::devcon::inf::InfFile::operator=(InfFile&& Other) noexcept = default;
+
+nefarius::devcon::inf::InfFile::~InfFile() = default;
+
+std::expected<nefarius::devcon::inf::InfFile, std::error_code> nefarius::devcon::inf::InfFile::Open(
+	const std::filesystem::path& Path, const InfOpenOptions& Options)
+{
+	auto data = std::make_unique<InfData>();
+
+	if (const auto error = data->Mapping.map(Path))
+	{
+		return std::unexpected(error);
+	}
+
+	::Decode(*data, data->Mapping.bytes(), true);
+
+	if (const auto error = ::Parse(*data, Options))
+	{
+		return std::unexpected(error);
+	}
+
+	return InfFile(std::move(data));
+}
+
+std::expected<nefarius::devcon::inf::InfFile, std::error_code> nefarius::devcon::inf::InfFile::FromBuffer(
+	std::span<const std::byte> Content, const InfOpenOptions& Options)
+{
+	auto data = std::make_unique<InfData>();
+
+	::Decode(*data, Content, false);
+
+	if (const auto error = ::Parse(*data, Options))
+	{
+		return std::unexpected(error);
+	}
+
+	return InfFile(std::move(data));
+}
+
+nefarius::devcon::inf::InfEncoding nefarius::devcon::inf::InfFile::encoding() const
+{
+	return data_->Encoding;
+}
+
+std::optional<nefarius::devcon::inf::InfSection> nefarius::devcon::inf::InfFile::section(
+	std::u16string_view Name) const
+{
+	const auto entry = data_->SectionIndex.find(Name);
+
+	if (entry == data_->SectionIndex.end())
+	{
+		return std::nullopt;
+	}
+
+	const SectionEntry& section = data_->Sections[entry->second];
+
+	return InfSection(data_.get(), entry->second, section.FirstLine, section.LineCount);
+}
+
+std::vector<nefarius::devcon::inf::InfSection> nefarius::devcon::inf::InfFile::sections() const
+{
+	std::vector<InfSection> result;
+	result.reserve(data_->Sections.size());
+
+	for (uint32_t index = 0; index < data_->Sections.size(); ++index)
+	{
+		const SectionEntry& section = data_->Sections[index];
+		result.push_back(InfSection(data_.get(), index, section.FirstLine, section.LineCount));
+	}
+
+	return result;
+}
+
+std::optional<std::u16string_view> nefarius::devcon::inf::InfFile::value(
+	std::u16string_view Section, std::u16string_view Key) const
+{
+	const auto section = this->section(Section);
+
+	if (!section)
+	{
+		return std::nullopt;
+	}
+
+	const auto line = section->find(Key);
+
+	if (!line)
+	{
+		return std::nullopt;
+	}
+
+	return line->field(1);
+}
+
+std::optional<std::u16string_view> nefarius::devcon::inf::InfFile::string(std::u16string_view Key) const
+{
+	return data_->LookupString(Key);
+}
+
+std::optional<nefarius::devcon::inf::InfSection> nefarius::devcon::inf::InfFile::resolve_install_section(
+	std::u16string_view Base, const InfPlatformTarget& Target) const
+{
+	std::u16string_view decoration;
+
+	switch (Target.Architecture)
+	{
+	case InfArchitecture::X86:
+		decoration = u".NTx86";
+		break;
+	case InfArchitecture::Amd64:
+		decoration = u".NTamd64";
+		break;
+	case InfArchitecture::Ia64:
+		decoration = u".NTia64";
+		break;
+	case InfArchitecture::Arm:
+		decoration = u".NTarm";
+		break;
+	case InfArchitecture::Arm64:
+		decoration = u".NTarm64";
+		break;
+	}
+
+	std::u16string candidate(Base);
+	candidate.append(decoration);
+
+	if (auto decorated = section(candidate))
+	{
+		return decorated;
+	}
+
+	candidate.resize(Base.size());
+	candidate.append(u".NT");
+
+	if (auto decorated = section(candidate))
+	{
+		return decorated;
+	}
+
+	return section(Base);
+}
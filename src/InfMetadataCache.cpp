@@ -0,0 +1,851 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/InfMetadataCache.hpp>
+
+#include "MappedFile.hpp"
+
+
+using namespace nefarius::devcon::inf;
+using namespace nefarius::utilities;
+
+static_assert(std::endian::native == std::endian::little, "the cache file is read in place");
+
+namespace
+{
+	//
+	// File layout: CacheHeader, EntryRecord[EntryCount] sorted by KeyHash, FilterRecord[FilterCount],
+	// ModelRecord[ModelCount], StringRef[IdCount] (the hardware IDs of all models) and finally
+	// StringLength UTF-16 code units every StringRef points into. Records are only ever copied out
+	// with memcpy, so nothing but the 2-byte alignment of the string table is assumed.
+	//
+	constexpr char CacheMagic[8] = {'N', 'E', 'F', 'I', 'N', 'F', 'M', 'C'};
+	constexpr uint32_t CacheFormatVersion = 2;
+
+	constexpr uint32_t EntryHasClassGuid = 0x1;
+	constexpr uint32_t EntryHasContentHash = 0x2;
+
+	struct StringRef
+	{
+		uint32_t Offset;
+		uint32_t Length;
+	};
+
+	struct CacheHeader
+	{
+		char Magic[8];
+		uint32_t FormatVersion;
+		uint32_t Architecture;
+		uint32_t OsVersion;
+		uint32_t OsBuildNumber;
+		uint32_t ProductType;
+		uint32_t LanguageId;
+		uint32_t EntryCount;
+		uint32_t FilterCount;
+		uint32_t ModelCount;
+		uint32_t IdCount;
+		uint32_t StringLength;
+	};
+
+	uint32_t PackOsVersion(const InfPlatformTarget& target)
+	{
+		return uint32_t{target.OsMajorVersion} << 16 | target.OsMinorVersion;
+	}
+
+	struct EntryRecord
+	{
+		uint32_t KeyHash;
+		uint32_t Flags;
+		StringRef Path;
+		uint64_t Size;
+		int64_t LastWriteTime;
+		uint64_t ContentHash;
+		Guid ClassGuid;
+		StringRef ClassName;
+		StringRef Provider;
+		StringRef DriverDate;
+		StringRef DriverVersion;
+		uint32_t FirstFilter;
+		uint32_t FilterCount;
+		uint32_t FirstModel;
+		uint32_t ModelCount;
+	};
+
+	struct FilterRecord
+	{
+		Guid ClassGuid;
+		uint32_t Position;
+		StringRef ServiceName;
+	};
+
+	struct ModelRecord
+	{
+		StringRef Description;
+		StringRef InstallSection;
+		uint32_t FirstId;
+		uint32_t IdCount;
+	};
+
+	static_assert(sizeof(CacheHeader) == 52 && sizeof(EntryRecord) == 104 && sizeof(FilterRecord) == 28
+		&& sizeof(ModelRecord) == 24 && sizeof(StringRef) == 8, "records must be free of padding");
+
+	struct FileStamp
+	{
+		uint64_t Size;
+		int64_t LastWriteTime;
+		std::optional<uint64_t> ContentHash;
+	};
+
+	struct CachedEntry
+	{
+		FileStamp Stamp;
+		InfAnalysis Analysis;
+	};
+
+	//
+	// Paths are compared like the file system does; the hash is folded either way so it can be
+	// stored in the file independent of the platform it was written on
+	//
+	bool KeyEquals(std::u16string_view Lhs, std::u16string_view Rhs)
+	{
+#if defined(_WIN32)
+		return casefold::EqualsIgnoreCase(Lhs, Rhs);
+#else
+		return Lhs == Rhs;
+#endif
+	}
+
+	uint32_t KeyHash(std::u16string_view Key)
+	{
+		return static_cast<uint32_t>(casefold::HashIgnoreCase(Key));
+	}
+
+	struct KeyHasher
+	{
+		size_t operator()(std::u16string_view Key) const
+		{
+			return casefold::HashIgnoreCase(Key);
+		}
+	};
+
+	struct KeyEqual
+	{
+		bool operator()(std::u16string_view Lhs, std::u16string_view Rhs) const
+		{
+			return ::KeyEquals(Lhs, Rhs);
+		}
+	};
+
+	std::u16string MakeKey(const std::filesystem::path& Path)
+	{
+		std::error_code error;
+		const std::filesystem::path absolute = std::filesystem::absolute(Path, error);
+
+		return (error ? Path : absolute).lexically_normal().u16string();
+	}
+
+	std::expected<FileStamp, std::error_code> ReadStamp(const std::filesystem::path& Path)
+	{
+		std::error_code error;
+		const auto size = std::filesystem::file_size(Path, error);
+
+		if (error)
+		{
+			return std::unexpected(error);
+		}
+
+		const auto lastWriteTime = std::filesystem::last_write_time(Path, error);
+
+		if (error)
+		{
+			return std::unexpected(error);
+		}
+
+		return FileStamp{size, static_cast<int64_t>(lastWriteTime.time_since_epoch().count()), std::nullopt};
+	}
+
+	//
+	// 64-bit FNV-1a over the raw file content
+	//
+	std::expected<uint64_t, std::error_code> HashFileContent(const std::filesystem::path& Path)
+	{
+		nefarius::utilities::detail::MappedFile mapping;
+
+		if (const auto error = mapping.map(Path))
+		{
+			return std::unexpected(error);
+		}
+
+		uint64_t hash = 0xCBF29CE484222325ull;
+
+		for (const std::byte value : mapping.bytes())
+		{
+			hash = (hash ^ static_cast<uint8_t>(value)) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	//
+	// Validated read-only view of a cache file; default-constructed it's an empty cache
+	//
+	class CacheImage
+	{
+	public:
+		CacheImage() = default;
+
+		static CacheImage Validate(std::span<const std::byte> Bytes, const InfMetadataCacheOptions& Options)
+		{
+			CacheImage image;
+
+			if (Bytes.size() < sizeof(CacheHeader))
+			{
+				return {};
+			}
+
+			image.bytes_ = Bytes;
+			image.header_ = image.read<CacheHeader>(0);
+
+			const CacheHeader& header = image.header_;
+
+			if (std::memcmp(header.Magic, CacheMagic, sizeof(CacheMagic)) != 0
+				|| header.FormatVersion != CacheFormatVersion
+				|| header.Architecture != static_cast<uint32_t>(Options.Target.Architecture)
+				|| header.OsVersion != ::PackOsVersion(Options.Target)
+				|| header.OsBuildNumber != Options.Target.OsBuildNumber
+				|| header.ProductType != Options.Target.ProductType
+				|| header.LanguageId != Options.Open.LanguageId)
+			{
+				return {};
+			}
+
+			image.filters_ = sizeof(CacheHeader) + uint64_t{header.EntryCount} * sizeof(EntryRecord);
+			image.models_ = image.filters_ + uint64_t{header.FilterCount} * sizeof(FilterRecord);
+			image.ids_ = image.models_ + uint64_t{header.ModelCount} * sizeof(ModelRecord);
+			image.strings_ = image.ids_ + uint64_t{header.IdCount} * sizeof(StringRef);
+
+			if (image.strings_ + uint64_t{header.StringLength} * sizeof(char16_t) != Bytes.size())
+			{
+				return {};
+			}
+
+			const auto validString = [&](const StringRef& Value)
+			{
+				return uint64_t{Value.Offset} + Value.Length <= header.StringLength;
+			};
+
+			const auto validRange = [](uint32_t First, uint32_t Count, uint32_t Total)
+			{
+				return uint64_t{First} + Count <= Total;
+			};
+
+			uint32_t previousHash = 0;
+
+			for (uint32_t index = 0; index < header.EntryCount; ++index)
+			{
+				const auto entry = image.entry(index);
+
+				if (entry.KeyHash < previousHash
+					|| !validString(entry.Path) || !validString(entry.ClassName) || !validString(entry.Provider)
+					|| !validString(entry.DriverDate) || !validString(entry.DriverVersion)
+					|| !validRange(entry.FirstFilter, entry.FilterCount, header.FilterCount)
+					|| !validRange(entry.FirstModel, entry.ModelCount, header.ModelCount))
+				{
+					return {};
+				}
+
+				previousHash = entry.KeyHash;
+			}
+
+			for (uint32_t index = 0; index < header.FilterCount; ++index)
+			{
+				if (!validString(image.filter(index).ServiceName))
+				{
+					return {};
+				}
+			}
+
+			for (uint32_t index = 0; index < header.ModelCount; ++index)
+			{
+				const auto model = image.model(index);
+
+				if (!validString(model.Description) || !validString(model.InstallSection)
+					|| !validRange(model.FirstId, model.IdCount, header.IdCount))
+				{
+					return {};
+				}
+			}
+
+			for (uint32_t index = 0; index < header.IdCount; ++index)
+			{
+				if (!validString(image.id(index)))
+				{
+					return {};
+				}
+			}
+
+			return image;
+		}
+
+		[[nodiscard]] uint32_t size() const
+		{
+			return header_.EntryCount;
+		}
+
+		[[nodiscard]] EntryRecord entry(uint32_t Index) const
+		{
+			return read<EntryRecord>(sizeof(CacheHeader) + uint64_t{Index} * sizeof(EntryRecord));
+		}
+
+		[[nodiscard]] std::u16string_view string(const StringRef& Value) const
+		{
+			return {reinterpret_cast<const char16_t*>(bytes_.data() + strings_) + Value.Offset, Value.Length};
+		}
+
+		[[nodiscard]] std::optional<EntryRecord> find(std::u16string_view Key) const
+		{
+			const uint32_t hash = ::KeyHash(Key);
+			uint32_t first = 0;
+			uint32_t count = size();
+
+			while (count > 0)
+			{
+				const uint32_t step = count / 2;
+
+				if (entry(first + step).KeyHash < hash)
+				{
+					first += step + 1;
+					count -= step + 1;
+				}
+				else
+				{
+					count = step;
+				}
+			}
+
+			for (; first < size(); ++first)
+			{
+				const auto candidate = entry(first);
+
+				if (candidate.KeyHash != hash)
+				{
+					break;
+				}
+
+				if (::KeyEquals(string(candidate.Path), Key))
+				{
+					return candidate;
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		[[nodiscard]] CachedEntry decode(const EntryRecord& Entry) const
+		{
+			CachedEntry cached{
+				FileStamp{Entry.Size, Entry.LastWriteTime, std::nullopt},
+				InfAnalysis{}
+			};
+
+			if (Entry.Flags & EntryHasContentHash)
+			{
+				cached.Stamp.ContentHash = Entry.ContentHash;
+			}
+
+			InfAnalysis& analysis = cached.Analysis;
+
+			if (Entry.Flags & EntryHasClassGuid)
+			{
+				analysis.ClassGuid = Entry.ClassGuid;
+			}
+
+			analysis.ClassName = string(Entry.ClassName);
+			analysis.Provider = string(Entry.Provider);
+			analysis.DriverDate = string(Entry.DriverDate);
+			analysis.DriverVersion = string(Entry.DriverVersion);
+
+			for (uint32_t index = 0; index < Entry.FilterCount; ++index)
+			{
+				const auto record = filter(Entry.FirstFilter + index);
+
+				analysis.FilterTargets.push_back(InfFilterTarget{
+					record.ClassGuid,
+					record.Position != 0 ? InfFilterPosition::Lower : InfFilterPosition::Upper,
+					std::u16string(string(record.ServiceName))
+				});
+			}
+
+			for (uint32_t index = 0; index < Entry.ModelCount; ++index)
+			{
+				const auto record = model(Entry.FirstModel + index);
+				InfModel decoded{std::u16string(string(record.Description)),
+				                 std::u16string(string(record.InstallSection)), {}};
+
+				for (uint32_t idIndex = 0; idIndex < record.IdCount; ++idIndex)
+				{
+					decoded.HardwareIds.emplace_back(string(id(record.FirstId + idIndex)));
+				}
+
+				analysis.Models.push_back(std::move(decoded));
+			}
+
+			return cached;
+		}
+
+	private:
+		template <typename T>
+		[[nodiscard]] T read(uint64_t Offset) const
+		{
+			T value;
+			std::memcpy(&value, bytes_.data() + Offset, sizeof(T));
+			return value;
+		}
+
+		[[nodiscard]] FilterRecord filter(uint32_t Index) const
+		{
+			return read<FilterRecord>(filters_ + uint64_t{Index} * sizeof(FilterRecord));
+		}
+
+		[[nodiscard]] ModelRecord model(uint32_t Index) const
+		{
+			return read<ModelRecord>(models_ + uint64_t{Index} * sizeof(ModelRecord));
+		}
+
+		[[nodiscard]] StringRef id(uint32_t Index) const
+		{
+			return read<StringRef>(ids_ + uint64_t{Index} * sizeof(StringRef));
+		}
+
+		std::span<const std::byte> bytes_;
+		CacheHeader header_{};
+		uint64_t filters_{0};
+		uint64_t models_{0};
+		uint64_t ids_{0};
+		uint64_t strings_{0};
+	};
+
+	//
+	// Serializes entries in the order they are added, which must be ascending by KeyHash
+	//
+	class ImageWriter
+	{
+	public:
+		void add(std::u16string_view Key, const FileStamp& Stamp, const InfAnalysis& Analysis)
+		{
+			EntryRecord entry{};
+			entry.KeyHash = ::KeyHash(Key);
+			entry.Path = intern(Key);
+			entry.Size = Stamp.Size;
+			entry.LastWriteTime = Stamp.LastWriteTime;
+
+			if (Stamp.ContentHash)
+			{
+				entry.Flags |= EntryHasContentHash;
+				entry.ContentHash = *Stamp.ContentHash;
+			}
+
+			if (Analysis.ClassGuid)
+			{
+				entry.Flags |= EntryHasClassGuid;
+				entry.ClassGuid = *Analysis.ClassGuid;
+			}
+
+			entry.ClassName = intern(Analysis.ClassName);
+			entry.Provider = intern(Analysis.Provider);
+			entry.DriverDate = intern(Analysis.DriverDate);
+			entry.DriverVersion = intern(Analysis.DriverVersion);
+
+			entry.FirstFilter = static_cast<uint32_t>(filters_.size());
+			entry.FilterCount = static_cast<uint32_t>(Analysis.FilterTargets.size());
+
+			for (const auto& target : Analysis.FilterTargets)
+			{
+				filters_.push_back(FilterRecord{
+					target.ClassGuid,
+					target.Position == InfFilterPosition::Lower ? 1u : 0u,
+					intern(target.ServiceName)
+				});
+			}
+
+			entry.FirstModel = static_cast<uint32_t>(models_.size());
+			entry.ModelCount = static_cast<uint32_t>(Analysis.Models.size());
+
+			for (const auto& model : Analysis.Models)
+			{
+				ModelRecord record{};
+				record.Description = intern(model.Description);
+				record.InstallSection = intern(model.InstallSection);
+				record.FirstId = static_cast<uint32_t>(ids_.size());
+				record.IdCount = static_cast<uint32_t>(model.HardwareIds.size());
+
+				for (const auto& id : model.HardwareIds)
+				{
+					ids_.push_back(intern(id));
+				}
+
+				models_.push_back(record);
+			}
+
+			entries_.push_back(entry);
+		}
+
+		[[nodiscard]] std::vector<std::byte> finish(const InfMetadataCacheOptions& Options) const
+		{
+			CacheHeader header{};
+			std::memcpy(header.Magic, CacheMagic, sizeof(CacheMagic));
+			header.FormatVersion = CacheFormatVersion;
+			header.Architecture = static_cast<uint32_t>(Options.Target.Architecture);
+			header.OsVersion = ::PackOsVersion(Options.Target);
+			header.OsBuildNumber = Options.Target.OsBuildNumber;
+			header.ProductType = Options.Target.ProductType;
+			header.LanguageId = Options.Open.LanguageId;
+			header.EntryCount = static_cast<uint32_t>(entries_.size());
+			header.FilterCount = static_cast<uint32_t>(filters_.size());
+			header.ModelCount = static_cast<uint32_t>(models_.size());
+			header.IdCount = static_cast<uint32_t>(ids_.size());
+			header.StringLength = static_cast<uint32_t>(strings_.size());
+
+			std::vector<std::byte> bytes;
+			bytes.reserve(sizeof(CacheHeader) + entries_.size() * sizeof(EntryRecord)
+				+ filters_.size() * sizeof(FilterRecord) + models_.size() * sizeof(ModelRecord)
+				+ ids_.size() * sizeof(StringRef) + strings_.size() * sizeof(char16_t));
+
+			append(bytes, &header, 1);
+			append(bytes, entries_.data(), entries_.size());
+			append(bytes, filters_.data(), filters_.size());
+			append(bytes, models_.data(), models_.size());
+			append(bytes, ids_.data(), ids_.size());
+			append(bytes, strings_.data(), strings_.size());
+
+			return bytes;
+		}
+
+	private:
+		template <typename T>
+		static void append(std::vector<std::byte>& Bytes, const T* Values, size_t Count)
+		{
+			const auto* first = reinterpret_cast<const std::byte*>(Values);
+			Bytes.insert(Bytes.end(), first, first + Count * sizeof(T));
+		}
+
+		//
+		// Identical strings (providers, class names, install sections) are stored once
+		//
+		StringRef intern(std::u16string_view Value)
+		{
+			if (Value.empty())
+			{
+				return {};
+			}
+
+			if (const auto existing = interned_.find(std::u16string(Value)); existing != interned_.end())
+			{
+				return existing->second;
+			}
+
+			const StringRef value{static_cast<uint32_t>(strings_.size()), static_cast<uint32_t>(Value.size())};
+			strings_.append(Value);
+			interned_.emplace(Value, value);
+
+			return value;
+		}
+
+		std::vector<EntryRecord> entries_;
+		std::vector<FilterRecord> filters_;
+		std::vector<ModelRecord> models_;
+		std::vector<StringRef> ids_;
+		std::u16string strings_;
+		std::unordered_map<std::u16string, StringRef> interned_;
+	};
+}
+
+namespace nefarius::devcon::inf::detail
+{
+	struct InfMetadataCacheData
+	{
+		std::filesystem::path CachePath;
+		InfMetadataCacheOptions Options;
+
+		mutable std::mutex Lock;
+		nefarius::utilities::detail::MappedFile Mapping;
+		CacheImage Image;
+		//
+		// Entries added or refreshed since the last save, overriding the image; std::nullopt
+		// marks an invalidated entry
+		//
+		std::unordered_map<std::u16string, std::optional<CachedEntry>, KeyHasher, KeyEqual> Overlay;
+		bool Dirty{false};
+
+		std::atomic<size_t> Hits{0};
+		std::atomic<size_t> Misses{0};
+
+		std::error_code Load()
+		{
+			Image = {};
+			Mapping.reset();
+
+			if (const auto error = Mapping.map(CachePath))
+			{
+				return error == std::errc::no_such_file_or_directory ? std::error_code() : error;
+			}
+
+			Image = CacheImage::Validate(Mapping.bytes(), Options);
+
+			return {};
+		}
+
+		std::optional<CachedEntry> Find(std::u16string_view Key) const
+		{
+			if (const auto entry = Overlay.find(std::u16string(Key)); entry != Overlay.end())
+			{
+				return entry->second;
+			}
+
+			if (const auto record = Image.find(Key))
+			{
+				return Image.decode(*record);
+			}
+
+			return std::nullopt;
+		}
+	};
+}
+
+nefarius::devcon::inf::InfMetadataCache::InfMetadataCache(std::unique_ptr<detail::InfMetadataCacheData> Data)
+	: data_(std::move(Data))
+{
+}
+
+nefarius::devcon::inf::InfMetadataCache::InfMetadataCache(InfMetadataCache&& Other) noexcept = default;
+
+nefarius::devcon::inf::InfMetadataCache& nefarius::devcon::inf::InfMetadataCache::operator=(
+	InfMetadataCache&& Other) noexcept = default;
+
+nefarius::devcon::inf::InfMetadataCache::~InfMetadataCache() = default;
+
+std::expected<nefarius::devcon::inf::InfMetadataCache, std::error_code> nefarius::devcon::inf::InfMetadataCache::Open(
+	const std::filesystem::path& CacheFile, const InfMetadataCacheOptions& Options)
+{
+	auto data = std::make_unique<detail::InfMetadataCacheData>();
+	data->CachePath = CacheFile;
+	data->Options = Options;
+
+	if (const auto error = data->Load())
+	{
+		return std::unexpected(error);
+	}
+
+	return InfMetadataCache(std::move(data));
+}
+
+std::expected<nefarius::devcon::inf::InfAnalysis, std::error_code> nefarius::devcon::inf::InfMetadataCache::lookup(
+	const std::filesystem::path& InfPath)
+{
+	auto& data = *data_;
+	const std::u16string key = ::MakeKey(InfPath);
+	const std::filesystem::path path(key);
+
+	const auto stamp = ::ReadStamp(path);
+
+	if (!stamp)
+	{
+		return std::unexpected(stamp.error());
+	}
+
+	std::optional<CachedEntry> cached;
+
+	{
+		std::lock_guard lock(data.Lock);
+		cached = data.Find(key);
+	}
+
+	if (cached && cached->Stamp.Size == stamp->Size)
+	{
+		if (cached->Stamp.LastWriteTime == stamp->LastWriteTime)
+		{
+			++data.Hits;
+			return std::move(cached->Analysis);
+		}
+
+		//
+		// Touched but possibly unchanged; hashing is still a lot cheaper than parsing
+		//
+		if (data.Options.Validation == InfCacheValidation::ContentHash && cached->Stamp.ContentHash)
+		{
+			if (const auto hash = ::HashFileContent(path); hash && *hash == *cached->Stamp.ContentHash)
+			{
+				++data.Hits;
+
+				cached->Stamp.LastWriteTime = stamp->LastWriteTime;
+
+				std::lock_guard lock(data.Lock);
+				data.Overlay.insert_or_assign(key, cached);
+				data.Dirty = true;
+
+				return std::move(cached->Analysis);
+			}
+		}
+	}
+
+	++data.Misses;
+
+	//
+	// Stamped before parsing; should the file change in between, the entry is merely reparsed
+	// on the next lookup instead of serving stale content
+	//
+	FileStamp fresh = *stamp;
+
+	if (data.Options.Validation == InfCacheValidation::ContentHash)
+	{
+		const auto hash = ::HashFileContent(path);
+
+		if (!hash)
+		{
+			return std::unexpected(hash.error());
+		}
+
+		fresh.ContentHash = *hash;
+	}
+
+	const auto file = InfFile::Open(path, data.Options.Open);
+
+	if (!file)
+	{
+		return std::unexpected(file.error());
+	}
+
+	InfAnalysis analysis = AnalyzeInf(*file, data.Options.Target);
+
+	std::lock_guard lock(data.Lock);
+	data.Overlay.insert_or_assign(key, CachedEntry{fresh, analysis});
+	data.Dirty = true;
+
+	return analysis;
+}
+
+void nefarius::devcon::inf::InfMetadataCache::invalidate(const std::filesystem::path& InfPath)
+{
+	std::lock_guard lock(data_->Lock);
+	data_->Overlay.insert_or_assign(::MakeKey(InfPath), std::nullopt);
+	data_->Dirty = true;
+}
+
+std::expected<void, std::error_code> nefarius::devcon::inf::InfMetadataCache::save()
+{
+	auto& data = *data_;
+	std::lock_guard lock(data.Lock);
+
+	if (!data.Dirty)
+	{
+		return {};
+	}
+
+	struct PendingEntry
+	{
+		uint32_t Hash;
+		std::u16string_view Key;
+		const CachedEntry* Entry;
+	};
+
+	std::vector<CachedEntry> retained;
+	std::vector<PendingEntry> pending;
+
+	retained.reserve(data.Image.size());
+
+	for (uint32_t index = 0; index < data.Image.size(); ++index)
+	{
+		const auto record = data.Image.entry(index);
+		const auto key = data.Image.string(record.Path);
+		std::error_code error;
+
+		if (data.Overlay.contains(std::u16string(key)) || !std::filesystem::exists(std::filesystem::path(key), error))
+		{
+			continue;
+		}
+
+		retained.push_back(data.Image.decode(record));
+		pending.push_back(PendingEntry{record.KeyHash, key, &retained.back()});
+	}
+
+	for (const auto& [key, entry] : data.Overlay)
+	{
+		if (entry)
+		{
+			pending.push_back(PendingEntry{::KeyHash(key), key, &*entry});
+		}
+	}
+
+	std::ranges::sort(pending, {}, &PendingEntry::Hash);
+
+	ImageWriter writer;
+
+	for (const auto& entry : pending)
+	{
+		writer.add(entry.Key, entry.Entry->Stamp, entry.Entry->Analysis);
+	}
+
+	const std::vector<std::byte> bytes = writer.finish(data.Options);
+
+	//
+	// Written next to the target and renamed over it, so readers never see a partial file. The
+	// current mapping has to go first since Windows refuses to replace a mapped file.
+	//
+	data.Image = {};
+	data.Mapping.reset();
+
+	std::filesystem::path temporary = data.CachePath;
+	temporary += ".tmp";
+
+	std::error_code error;
+
+	{
+		std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		out.close();
+
+		if (!out)
+		{
+			error = std::make_error_code(std::errc::io_error);
+		}
+	}
+
+	if (!error)
+	{
+		std::filesystem::rename(temporary, data.CachePath, error);
+	}
+
+	if (error)
+	{
+		std::error_code ignored;
+		std::filesystem::remove(temporary, ignored);
+	}
+
+	//
+	// Maps whatever is on disk now; after a failure that's the previous file, still covered by
+	// the overlay which is kept for another attempt
+	//
+	const auto loadError = data.Load();
+
+	if (error || loadError)
+	{
+		return std::unexpected(error ? error : loadError);
+	}
+
+	data.Overlay.clear();
+	data.Dirty = false;
+
+	return {};
+}
+
+nefarius::devcon::inf::InfMetadataCacheStats nefarius::devcon::inf::InfMetadataCache::stats() const
+{
+	return InfMetadataCacheStats{data_->Hits.load(), data_->Misses.load()};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//
+// Shared by the portable translation units that read files (InfFile.cpp, InfMetadataCache.cpp)
+//
+namespace nefarius::utilities::detail
+{
+	//
+	// Read-only mapping of a whole file; empty files aren't mapped at all
+	//
+	class MappedFile
+	{
+	public:
+		MappedFile() = default;
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& Other) noexcept
+			: data_(std::exchange(Other.data_, nullptr)), size_(std::exchange(Other.size_, 0))
+		{
+		}
+
+		MappedFile& operator=(MappedFile&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				reset();
+				data_ = std::exchange(Other.data_, nullptr);
+				size_ = std::exchange(Other.size_, 0);
+			}
+
+			return *this;
+		}
+
+		~MappedFile()
+		{
+			reset();
+		}
+
+		void reset()
+		{
+			if (data_ == nullptr)
+			{
+				return;
+			}
+
+#if defined(_WIN32)
+			UnmapViewOfFile(data_);
+#else
+			munmap(const_cast<std::byte*>(data_), size_);
+#endif
+
+			data_ = nullptr;
+			size_ = 0;
+		}
+
+		std::error_code map(const std::filesystem::path& Path)
+		{
+#if defined(_WIN32)
+			const HANDLE file = CreateFileW(Path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+			                                nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+			if (file == INVALID_HANDLE_VALUE)
+			{
+				return {static_cast<int>(GetLastError()), std::system_category()};
+			}
+
+			LARGE_INTEGER size{};
+			std::error_code error;
+
+			if (!GetFileSizeEx(file, &size))
+			{
+				error = {static_cast<int>(GetLastError()), std::system_category()};
+			}
+			else if (size.QuadPart > 0)
+			{
+				if (const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr))
+				{
+					data_ = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+
+					if (data_ == nullptr)
+					{
+						error = {static_cast<int>(GetLastError()), std::system_category()};
+					}
+
+					size_ = static_cast<size_t>(size.QuadPart);
+					CloseHandle(mapping);
+				}
+				else
+				{
+					error = {static_cast<int>(GetLastError()), std::system_category()};
+				}
+			}
+
+			CloseHandle(file);
+
+			return error;
+#else
+			const int file = open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+
+			if (file < 0)
+			{
+				return {errno, std::system_category()};
+			}
+
+			struct stat status{};
+			std::error_code error;
+
+			if (fstat(file, &status) != 0)
+			{
+				error = {errno, std::system_category()};
+			}
+			else if (status.st_size > 0)
+			{
+				void* data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+
+				if (data == MAP_FAILED)
+				{
+					error = {errno, std::system_category()};
+				}
+				else
+				{
+					data_ = static_cast<const std::byte*>(data);
+					size_ = static_cast<size_t>(status.st_size);
+				}
+			}
+
+			close(file);
+
+			return error;
+#endif
+		}
+
+		[[nodiscard]] std::span<const std::byte> bytes() const
+		{
+			return {data_, data_ ? size_ : 0};
+		}
+
+	private:
+		const std::byte* data_{nullptr};
+		size_t size_{0};
+	};
+}
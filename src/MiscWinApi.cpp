@@ -2,41 +2,19 @@
 #include "pch.h"
 
 #include <nefarius/neflib/MiscWinApi.hpp>
+#include <nefarius/neflib/Guid.hpp>
 
 using namespace nefarius::utilities;
 
-namespace
-{
-	using GUIDFromString_t = BOOL(WINAPI*)(_In_ LPCSTR, _Out_ LPGUID);
-}
-
 std::expected<GUID, Win32Error> nefarius::winapi::GUIDFromString(const std::string& input)
 {
-	GUID guid = {};
-
-	// try without brackets...
-	if (UuidFromStringA(RPC_CSTR(input.data()), &guid) == RPC_S_INVALID_STRING_UUID)
+	// accepts both the braced and unbraced form
+	if (const auto guid = ParseGuid(std::string_view(input)); guid.has_value())
 	{
-		const HMODULE shell32 = LoadLibraryA("Shell32.dll");
-
-		if (shell32 == nullptr)
-		{
-			return std::unexpected(Win32Error("LoadLibraryA"));
-		}
-
-		SCOPE_GUARD_CAPTURE({ FreeLibrary(shell32); }, shell32);
-
-		const auto pFnGUIDFromString = reinterpret_cast<GUIDFromString_t>(
-			GetProcAddress(shell32, MAKEINTRESOURCEA(703)));
-
-		// ...finally try with brackets
-		if (!pFnGUIDFromString(input.c_str(), &guid))
-		{
-			return std::unexpected(Win32Error("pFnGUIDFromString"));
-		}
+		return *guid;
 	}
 
-	return guid;
+	return std::unexpected(Win32Error(RPC_S_INVALID_STRING_UUID));
 }
 
 SYSTEM_INFO nefarius::winapi::SafeGetNativeSystemInfo()
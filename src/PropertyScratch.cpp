@@ -0,0 +1,206 @@
+// ReSharper disable CppRedundantQualifier
+#include "pch.h"
+
+#include <cstring>
+
+#include "PropertyScratch.hpp"
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// Room of a fresh scratch buffer; fits the hardware ID lists of practically every device
+	// 
+	constexpr size_t InitialScratchBytes = 1024;
+
+	//
+	// A property may grow between the read reporting its size and the next one; give up after
+	// that many attempts
+	// 
+	constexpr int MaxReadAttempts = 3;
+
+	std::error_code Win32ErrorCode(DWORD error)
+	{
+		return {static_cast<int>(error), std::system_category()};
+	}
+
+	//
+	// Per thread, so concurrent readers never contend; only ever grows, so after the first few
+	// reads a property read doesn't allocate anymore
+	// 
+	std::vector<BYTE>& Scratch()
+	{
+		thread_local std::vector<BYTE> scratch(InitialScratchBytes);
+		return scratch;
+	}
+
+	DEVPROPTYPE FromRegistryType(DWORD type)
+	{
+		switch (type)
+		{
+		case REG_SZ:
+		case REG_EXPAND_SZ:
+			return DEVPROP_TYPE_STRING;
+		case REG_MULTI_SZ:
+			return DEVPROP_TYPE_STRING_LIST;
+		case REG_DWORD:
+			return DEVPROP_TYPE_UINT32;
+		default:
+			return DEVPROP_TYPE_BINARY;
+		}
+	}
+
+	template <typename T>
+	std::optional<T> FixedSizeValue(std::span<const BYTE> data)
+	{
+		if (data.size() != sizeof(T))
+		{
+			return std::nullopt;
+		}
+
+		T value;
+		std::memcpy(&value, data.data(), sizeof(T));
+		return value;
+	}
+}
+
+std::optional<std::wstring_view> nefarius::devcon::detail::PropertyView::string() const
+{
+	if (type_ != DEVPROP_TYPE_STRING)
+	{
+		return std::nullopt;
+	}
+
+	std::wstring_view value(reinterpret_cast<const wchar_t*>(data_.data()), data_.size() / sizeof(wchar_t));
+
+	while (!value.empty() && value.back() == L'\0')
+	{
+		value.remove_suffix(1);
+	}
+
+	return value;
+}
+
+std::optional<nefarius::utilities::WideMultiStringView> nefarius::devcon::detail::PropertyView::strings() const
+{
+	if (type_ != DEVPROP_TYPE_STRING_LIST && type_ != DEVPROP_TYPE_STRING)
+	{
+		return std::nullopt;
+	}
+
+	return WideMultiStringView::from_bytes(data_.data(), data_.size());
+}
+
+std::optional<uint32_t> nefarius::devcon::detail::PropertyView::uint32() const
+{
+	if (type_ != DEVPROP_TYPE_UINT32)
+	{
+		return std::nullopt;
+	}
+
+	return ::FixedSizeValue<uint32_t>(data_);
+}
+
+std::optional<nefarius::utilities::Guid> nefarius::devcon::detail::PropertyView::guid() const
+{
+	if (type_ != DEVPROP_TYPE_GUID)
+	{
+		return std::nullopt;
+	}
+
+	const auto value = ::FixedSizeValue<GUID>(data_);
+
+	if (!value)
+	{
+		return std::nullopt;
+	}
+
+	return Guid(value.value());
+}
+
+std::optional<FILETIME> nefarius::devcon::detail::PropertyView::filetime() const
+{
+	if (type_ != DEVPROP_TYPE_FILETIME)
+	{
+		return std::nullopt;
+	}
+
+	return ::FixedSizeValue<FILETIME>(data_);
+}
+
+std::expected<nefarius::devcon::detail::PropertyView, std::error_code>
+nefarius::devcon::detail::ReadDevNodeProperty(DEVINST DevInst, const DEVPROPKEY& Key)
+{
+	auto& scratch = ::Scratch();
+
+	//
+	// Read into whatever room the scratch buffer has; only if that's too small, the failed read
+	// reported the size to grow it to
+	// 
+	for (int attempt = 0; attempt < MaxReadAttempts; attempt++)
+	{
+		DEVPROPTYPE type = DEVPROP_TYPE_EMPTY;
+		ULONG size = static_cast<ULONG>(scratch.size());
+
+		const CONFIGRET cr = CM_Get_DevNode_PropertyW(DevInst, &Key, &type, scratch.data(), &size, 0);
+
+		if (cr == CR_SUCCESS)
+		{
+			return PropertyView(type, std::span<const BYTE>(scratch.data(), size));
+		}
+
+		if (cr == CR_NO_SUCH_VALUE)
+		{
+			return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
+		}
+
+		if (cr != CR_BUFFER_SMALL)
+		{
+			return std::unexpected(::Win32ErrorCode(CM_MapCrToWin32Err(cr, ERROR_CAN_NOT_COMPLETE)));
+		}
+
+		scratch.resize(size);
+	}
+
+	return std::unexpected(::Win32ErrorCode(ERROR_INSUFFICIENT_BUFFER));
+}
+
+std::expected<nefarius::devcon::detail::PropertyView, std::error_code>
+nefarius::devcon::detail::ReadDeviceRegistryProperty(HDEVINFO DeviceInfoSet, PSP_DEVINFO_DATA DeviceInfoData,
+                                                     DWORD Property)
+{
+	auto& scratch = ::Scratch();
+
+	for (int attempt = 0; attempt < MaxReadAttempts; attempt++)
+	{
+		DWORD type = REG_NONE;
+		DWORD size = 0;
+
+		if (SetupDiGetDeviceRegistryPropertyW(DeviceInfoSet, DeviceInfoData, Property, &type, scratch.data(),
+		                                      static_cast<DWORD>(scratch.size()), &size))
+		{
+			return PropertyView(::FromRegistryType(type), std::span<const BYTE>(scratch.data(), size));
+		}
+
+		const DWORD win32Error = GetLastError();
+
+		//
+		// Property doesn't exist
+		// 
+		if (win32Error == ERROR_INVALID_DATA)
+		{
+			return std::unexpected(::Win32ErrorCode(ERROR_NOT_FOUND));
+		}
+
+		if (win32Error != ERROR_INSUFFICIENT_BUFFER)
+		{
+			return std::unexpected(::Win32ErrorCode(win32Error));
+		}
+
+		scratch.resize(size);
+	}
+
+	return std::unexpected(::Win32ErrorCode(ERROR_INSUFFICIENT_BUFFER));
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include <nefarius/neflib/Guid.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
+
+//
+// Shared by the translation units that read device properties (Devcon.cpp, DeviceRestart.cpp);
+// relies on the Windows headers of pch.h
+//
+namespace nefarius::devcon::detail
+{
+	//
+	// A property value read into the calling thread's scratch buffer; only valid until the next
+	// read on the same thread, so copy out whatever has to outlive it. The typed accessors yield
+	// std::nullopt if the value is of a different type.
+	//
+	class PropertyView
+	{
+	public:
+		PropertyView(DEVPROPTYPE Type, std::span<const BYTE> Data)
+			: type_(Type), data_(Data)
+		{
+		}
+
+		[[nodiscard]] DEVPROPTYPE type() const
+		{
+			return type_;
+		}
+
+		[[nodiscard]] std::span<const BYTE> bytes() const
+		{
+			return data_;
+		}
+
+		// DEVPROP_TYPE_STRING, without the terminator
+		[[nodiscard]] std::optional<std::wstring_view> string() const;
+
+		// DEVPROP_TYPE_STRING_LIST, or a DEVPROP_TYPE_STRING as a list of one
+		[[nodiscard]] std::optional<nefarius::utilities::WideMultiStringView> strings() const;
+
+		// DEVPROP_TYPE_UINT32
+		[[nodiscard]] std::optional<uint32_t> uint32() const;
+
+		// DEVPROP_TYPE_GUID
+		[[nodiscard]] std::optional<nefarius::utilities::Guid> guid() const;
+
+		// DEVPROP_TYPE_FILETIME
+		[[nodiscard]] std::optional<FILETIME> filetime() const;
+
+	private:
+		DEVPROPTYPE type_;
+		std::span<const BYTE> data_;
+	};
+
+	//
+	// Reads a devnode property; fails with ERROR_NOT_FOUND if it isn't set
+	//
+	std::expected<PropertyView, std::error_code> ReadDevNodeProperty(DEVINST DevInst, const DEVPROPKEY& Key);
+
+	//
+	// Reads a SPDRP_* property, reported with the DEVPROPTYPE matching its registry type
+	// (REG_SZ/REG_EXPAND_SZ as DEVPROP_TYPE_STRING, REG_MULTI_SZ as DEVPROP_TYPE_STRING_LIST,
+	// REG_DWORD as DEVPROP_TYPE_UINT32, anything else as DEVPROP_TYPE_BINARY); fails with
+	// ERROR_NOT_FOUND if it isn't set
+	//
+	std::expected<PropertyView, std::error_code> ReadDeviceRegistryProperty(HDEVINFO DeviceInfoSet,
+	                                                                        PSP_DEVINFO_DATA DeviceInfoData,
+	                                                                        DWORD Property);
+}
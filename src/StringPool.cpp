@@ -0,0 +1,258 @@
+// ReSharper disable CppRedundantQualifier
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nefarius/neflib/StringPool.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	//
+	// A handle packs the shard in its low bits and the slot index (+1, so 0 stays the null
+	// handle) above them. Slots live in chunks that double in size and are never moved or freed,
+	// so a handle can be resolved without taking the shard lock; only interning and dropping the
+	// last reference do.
+	//
+	constexpr uint32_t ShardBits = 4;
+	constexpr uint32_t ShardCount = 1u << ShardBits;
+	constexpr uint32_t FirstChunkBits = 6;
+	constexpr uint32_t MaxChunks = 32 - ShardBits - FirstChunkBits;
+	constexpr uint32_t MaxSlots = (1u << (32 - ShardBits)) - 1;
+
+	struct Slot
+	{
+		std::atomic<uint32_t> Refs{0};
+		wchar_t* Data{nullptr};
+		size_t Length{0};
+	};
+
+	struct Shard
+	{
+		std::mutex Lock;
+		std::unordered_map<std::wstring_view, uint32_t> Index;
+		std::vector<uint32_t> FreeSlots;
+		uint32_t NextSlot{0};
+		std::atomic<Slot*> Chunks[MaxChunks]{};
+	};
+
+	struct Pool
+	{
+		Shard Shards[ShardCount];
+		std::atomic<size_t> Live{0};
+	};
+
+	//
+	// Deliberately leaked so InternedString objects with static storage duration can still
+	// release their references during process shutdown
+	//
+	Pool& GetPool()
+	{
+		static Pool* pool = new Pool();
+		return *pool;
+	}
+
+	Slot& SlotOf(const Shard& shard, uint32_t index)
+	{
+		const uint32_t biased = index + (1u << FirstChunkBits);
+		const uint32_t chunk = static_cast<uint32_t>(std::bit_width(biased)) - 1 - FirstChunkBits;
+		const uint32_t offset = biased - ((1u << FirstChunkBits) << chunk);
+
+		return shard.Chunks[chunk].load(std::memory_order_acquire)[offset];
+	}
+
+	void EnsureChunk(Shard& shard, uint32_t index)
+	{
+		const uint32_t biased = index + (1u << FirstChunkBits);
+		const uint32_t chunk = static_cast<uint32_t>(std::bit_width(biased)) - 1 - FirstChunkBits;
+
+		if (!shard.Chunks[chunk].load(std::memory_order_relaxed))
+		{
+			shard.Chunks[chunk].store(new Slot[(1u << FirstChunkBits) << chunk], std::memory_order_release);
+		}
+	}
+
+	uint32_t MakeHandle(uint32_t shard, uint32_t index)
+	{
+		return ((index + 1) << ShardBits) | shard;
+	}
+
+	Shard& ShardOf(uint32_t handle)
+	{
+		return GetPool().Shards[handle & (ShardCount - 1)];
+	}
+
+	uint32_t IndexOf(uint32_t handle)
+	{
+		return (handle >> ShardBits) - 1;
+	}
+
+	uint32_t Acquire(std::wstring_view value)
+	{
+		if (value.empty())
+		{
+			return InternedString::NullHandle;
+		}
+
+		Pool& pool = GetPool();
+		const auto shardIndex = static_cast<uint32_t>(std::hash<std::wstring_view>{}(value) & (ShardCount - 1));
+		Shard& shard = pool.Shards[shardIndex];
+
+		std::lock_guard lock(shard.Lock);
+
+		if (const auto existing = shard.Index.find(value); existing != shard.Index.end())
+		{
+			::SlotOf(shard, existing->second).Refs.fetch_add(1, std::memory_order_relaxed);
+			return ::MakeHandle(shardIndex, existing->second);
+		}
+
+		uint32_t index;
+
+		if (!shard.FreeSlots.empty())
+		{
+			index = shard.FreeSlots.back();
+			shard.FreeSlots.pop_back();
+		}
+		else
+		{
+			if (shard.NextSlot >= MaxSlots)
+			{
+				throw std::length_error("String pool shard exhausted");
+			}
+
+			index = shard.NextSlot++;
+			::EnsureChunk(shard, index);
+		}
+
+		auto* data = new wchar_t[value.size() + 1];
+		std::copy(value.begin(), value.end(), data);
+		data[value.size()] = L'\0';
+
+		Slot& slot = ::SlotOf(shard, index);
+		slot.Data = data;
+		slot.Length = value.size();
+		slot.Refs.store(1, std::memory_order_relaxed);
+
+		shard.Index.emplace(std::wstring_view(data, value.size()), index);
+		pool.Live.fetch_add(1, std::memory_order_relaxed);
+
+		return ::MakeHandle(shardIndex, index);
+	}
+
+	void AddRef(uint32_t handle)
+	{
+		if (handle != InternedString::NullHandle)
+		{
+			::SlotOf(::ShardOf(handle), ::IndexOf(handle)).Refs.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	void Release(uint32_t handle)
+	{
+		if (handle == InternedString::NullHandle)
+		{
+			return;
+		}
+
+		Shard& shard = ::ShardOf(handle);
+		const uint32_t index = ::IndexOf(handle);
+		Slot& slot = ::SlotOf(shard, index);
+
+		if (slot.Refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		{
+			return;
+		}
+
+		std::lock_guard lock(shard.Lock);
+
+		//
+		// Between dropping to zero and taking the lock, Acquire may have revived the entry (and
+		// another release may even have freed it already), so only free what is still unused
+		//
+		if (slot.Refs.load(std::memory_order_relaxed) != 0 || slot.Data == nullptr)
+		{
+			return;
+		}
+
+		shard.Index.erase(std::wstring_view(slot.Data, slot.Length));
+		delete[] slot.Data;
+		slot.Data = nullptr;
+		slot.Length = 0;
+		shard.FreeSlots.push_back(index);
+		GetPool().Live.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
+
+nefarius::utilities::InternedString::InternedString(std::wstring_view Value) : handle_(::Acquire(Value))
+{
+}
+
+nefarius::utilities::InternedString::InternedString(const InternedString& Other) : handle_(Other.handle_)
+{
+	::AddRef(handle_);
+}
+
+nefarius::utilities::InternedString::InternedString(InternedString&& Other) noexcept : handle_(Other.handle_)
+{
+	Other.handle_ = NullHandle;
+}
+
+nefarius::utilities::InternedString& nefarius::utilities::InternedString::operator=(const InternedString& Other)
+{
+	if (handle_ != Other.handle_)
+	{
+		::AddRef(Other.handle_);
+		::Release(handle_);
+		handle_ = Other.handle_;
+	}
+
+	return *this;
+}
+
+nefarius::utilities::InternedString& nefarius::utilities::InternedString::operator=(
+	InternedString&& Other) noexcept
+{
+	if (this != &Other)
+	{
+		::Release(handle_);
+		handle_ = Other.handle_;
+		Other.handle_ = NullHandle;
+	}
+
+	return *this;
+}
+
+nefarius::utilities::InternedString::~InternedString()
+{
+	::Release(handle_);
+}
+
+std::wstring_view nefarius::utilities::InternedString::view() const
+{
+	if (handle_ == NullHandle)
+	{
+		return {};
+	}
+
+	const Slot& slot = ::SlotOf(::ShardOf(handle_), ::IndexOf(handle_));
+	return {slot.Data, slot.Length};
+}
+
+const wchar_t* nefarius::utilities::InternedString::c_str() const
+{
+	return handle_ == NullHandle ? L"" : view().data();
+}
+
+size_t nefarius::utilities::InternedString::PoolSize()
+{
+	return GetPool().Live.load(std::memory_order_relaxed);
+}
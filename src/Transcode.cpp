@@ -0,0 +1,864 @@
+// ReSharper disable CppClangTidyClangDiagnosticCastAlign
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <nefarius/neflib/Transcode.hpp>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NEFLIB_TRANSCODE_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#include <immintrin.h>
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#define NEFLIB_TRANSCODE_NEON
+#include <arm_neon.h>
+#endif
+
+//
+// MSVC allows using any intrinsic in any function, GCC/Clang require the instruction set to be
+// enabled per function so the rest of the binary stays runnable on older CPUs.
+//
+#if defined(NEFLIB_TRANSCODE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NEFLIB_TARGET_SSE2 __attribute__((target("sse2")))
+#define NEFLIB_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define NEFLIB_TARGET_SSE2
+#define NEFLIB_TARGET_AVX2
+#endif
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	constexpr char32_t ReplacementCharacter = 0xFFFD;
+
+	struct KernelTable
+	{
+		transcode::Kernel Kind;
+		size_t (*CountAscii16)(const char16_t*, size_t);
+		size_t (*CountAscii8)(const char*, size_t);
+		size_t (*NarrowAscii)(const char16_t*, size_t, char*);
+		size_t (*WidenAscii)(const char*, size_t, char16_t*);
+	};
+
+	//
+	// Scalar kernel, also used by the vector kernels to finish off their tails
+	//
+
+	size_t CountAscii16Scalar(const char16_t* src, size_t len)
+	{
+		size_t i = 0;
+		while (i < len && src[i] < 0x80)
+		{
+			i++;
+		}
+		return i;
+	}
+
+	size_t CountAscii8Scalar(const char* src, size_t len)
+	{
+		size_t i = 0;
+		while (i < len && static_cast<uint8_t>(src[i]) < 0x80)
+		{
+			i++;
+		}
+		return i;
+	}
+
+	size_t NarrowAsciiScalar(const char16_t* src, size_t len, char* dst)
+	{
+		size_t i = 0;
+		while (i < len && src[i] < 0x80)
+		{
+			dst[i] = static_cast<char>(src[i]);
+			i++;
+		}
+		return i;
+	}
+
+	size_t WidenAsciiScalar(const char* src, size_t len, char16_t* dst)
+	{
+		size_t i = 0;
+		while (i < len && static_cast<uint8_t>(src[i]) < 0x80)
+		{
+			dst[i] = static_cast<char16_t>(src[i]);
+			i++;
+		}
+		return i;
+	}
+
+	constexpr KernelTable ScalarKernel{
+		transcode::Kernel::Scalar, CountAscii16Scalar, CountAscii8Scalar, NarrowAsciiScalar, WidenAsciiScalar
+	};
+
+#if defined(NEFLIB_TRANSCODE_X86)
+
+	//
+	// SSE2 kernel: 8 UTF-16 units/16 bytes per iteration. A block is only ever stored once it is
+	// known to be all-ASCII, so no kernel writes past the prefix length it reports.
+	//
+
+	NEFLIB_TARGET_SSE2 size_t CountAscii16SSE2(const char16_t* src, size_t len)
+	{
+		const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+
+		for (; i + 8 <= len; i += 8)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask), zero)) != 0xFFFF)
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii16Scalar(src + i, len - i);
+	}
+
+	NEFLIB_TARGET_SSE2 size_t CountAscii8SSE2(const char* src, size_t len)
+	{
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			if (_mm_movemask_epi8(v) != 0)
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii8Scalar(src + i, len - i);
+	}
+
+	NEFLIB_TARGET_SSE2 size_t NarrowAsciiSSE2(const char16_t* src, size_t len, char* dst)
+	{
+		const __m128i mask = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+			const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+			const __m128i nonAscii = _mm_or_si128(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+
+			if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, zero)) != 0xFFFF)
+			{
+				break;
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+		}
+
+		return i + NarrowAsciiScalar(src + i, len - i, dst + i);
+	}
+
+	NEFLIB_TARGET_SSE2 size_t WidenAsciiSSE2(const char* src, size_t len, char16_t* dst)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+			if (_mm_movemask_epi8(v) != 0)
+			{
+				break;
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(v, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(v, zero));
+		}
+
+		return i + WidenAsciiScalar(src + i, len - i, dst + i);
+	}
+
+	constexpr KernelTable SSE2Kernel{
+		transcode::Kernel::SSE2, CountAscii16SSE2, CountAscii8SSE2, NarrowAsciiSSE2, WidenAsciiSSE2
+	};
+
+	//
+	// AVX2 kernel: 16 UTF-16 units/32 bytes per iteration, SSE2 kernel handles the remainder
+	//
+
+	NEFLIB_TARGET_AVX2 size_t CountAscii16AVX2(const char16_t* src, size_t len)
+	{
+		const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			if (!_mm256_testz_si256(v, mask))
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii16SSE2(src + i, len - i);
+	}
+
+	NEFLIB_TARGET_AVX2 size_t CountAscii8AVX2(const char* src, size_t len)
+	{
+		size_t i = 0;
+
+		for (; i + 32 <= len; i += 32)
+		{
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			if (_mm256_movemask_epi8(v) != 0)
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii8SSE2(src + i, len - i);
+	}
+
+	NEFLIB_TARGET_AVX2 size_t NarrowAsciiAVX2(const char16_t* src, size_t len, char* dst)
+	{
+		const __m256i mask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+		size_t i = 0;
+
+		for (; i + 32 <= len; i += 32)
+		{
+			const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+			const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+
+			if (!_mm256_testz_si256(_mm256_or_si256(lo, hi), mask))
+			{
+				break;
+			}
+
+			//
+			// packus operates per 128-bit lane, restore linear order afterwards
+			//
+			const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+		}
+
+		return i + NarrowAsciiSSE2(src + i, len - i, dst + i);
+	}
+
+	NEFLIB_TARGET_AVX2 size_t WidenAsciiAVX2(const char* src, size_t len, char16_t* dst)
+	{
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+			if (_mm_movemask_epi8(v) != 0)
+			{
+				break;
+			}
+
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_cvtepu8_epi16(v));
+		}
+
+		return i + WidenAsciiScalar(src + i, len - i, dst + i);
+	}
+
+	constexpr KernelTable AVX2Kernel{
+		transcode::Kernel::AVX2, CountAscii16AVX2, CountAscii8AVX2, NarrowAsciiAVX2, WidenAsciiAVX2
+	};
+
+	bool CpuHasSSE2()
+	{
+#if defined(_M_X64) || defined(__x86_64__)
+		return true;
+#elif defined(_MSC_VER) && !defined(__clang__)
+		int regs[4] = {};
+		__cpuid(regs, 1);
+		return (regs[3] & (1 << 26)) != 0;
+#else
+		return __builtin_cpu_supports("sse2");
+#endif
+	}
+
+	bool CpuHasAVX2()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int regs[4] = {};
+		__cpuid(regs, 0);
+
+		if (regs[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(regs, 1);
+
+		//
+		// OSXSAVE + AVX, and the OS must actually preserve the YMM state across context switches
+		//
+		constexpr int osxsaveAndAvx = (1 << 27) | (1 << 28);
+		if ((regs[2] & osxsaveAndAvx) != osxsaveAndAvx || (_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+#elif defined(NEFLIB_TRANSCODE_NEON)
+
+	//
+	// NEON kernel: 8 UTF-16 units/16 bytes per iteration
+	//
+
+	size_t CountAscii16NEON(const char16_t* src, size_t len)
+	{
+		size_t i = 0;
+
+		for (; i + 8 <= len; i += 8)
+		{
+			const uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+			if (vmaxvq_u16(v) >= 0x80)
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii16Scalar(src + i, len - i);
+	}
+
+	size_t CountAscii8NEON(const char* src, size_t len)
+	{
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+			if (vmaxvq_u8(v) >= 0x80)
+			{
+				break;
+			}
+		}
+
+		return i + CountAscii8Scalar(src + i, len - i);
+	}
+
+	size_t NarrowAsciiNEON(const char16_t* src, size_t len, char* dst)
+	{
+		size_t i = 0;
+
+		for (; i + 8 <= len; i += 8)
+		{
+			const uint16x8_t v = vld1q_u16(reinterpret_cast<const uint16_t*>(src + i));
+
+			if (vmaxvq_u16(v) >= 0x80)
+			{
+				break;
+			}
+
+			vst1_u8(reinterpret_cast<uint8_t*>(dst + i), vmovn_u16(v));
+		}
+
+		return i + NarrowAsciiScalar(src + i, len - i, dst + i);
+	}
+
+	size_t WidenAsciiNEON(const char* src, size_t len, char16_t* dst)
+	{
+		size_t i = 0;
+
+		for (; i + 16 <= len; i += 16)
+		{
+			const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+
+			if (vmaxvq_u8(v) >= 0x80)
+			{
+				break;
+			}
+
+			vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), vmovl_u8(vget_low_u8(v)));
+			vst1q_u16(reinterpret_cast<uint16_t*>(dst + i + 8), vmovl_u8(vget_high_u8(v)));
+		}
+
+		return i + WidenAsciiScalar(src + i, len - i, dst + i);
+	}
+
+	constexpr KernelTable NEONKernel{
+		transcode::Kernel::NEON, CountAscii16NEON, CountAscii8NEON, NarrowAsciiNEON, WidenAsciiNEON
+	};
+
+#endif
+
+	const KernelTable* FindKernel(transcode::Kernel kernel)
+	{
+		switch (kernel)
+		{
+		case transcode::Kernel::Scalar:
+			return &ScalarKernel;
+#if defined(NEFLIB_TRANSCODE_X86)
+		case transcode::Kernel::SSE2:
+			return CpuHasSSE2() ? &SSE2Kernel : nullptr;
+		case transcode::Kernel::AVX2:
+			return CpuHasSSE2() && CpuHasAVX2() ? &AVX2Kernel : nullptr;
+		case transcode::Kernel::Auto:
+			if (const auto* avx2 = FindKernel(transcode::Kernel::AVX2))
+			{
+				return avx2;
+			}
+			if (const auto* sse2 = FindKernel(transcode::Kernel::SSE2))
+			{
+				return sse2;
+			}
+			return &ScalarKernel;
+#elif defined(NEFLIB_TRANSCODE_NEON)
+		case transcode::Kernel::NEON:
+		case transcode::Kernel::Auto:
+			return &NEONKernel;
+#else
+		case transcode::Kernel::Auto:
+			return &ScalarKernel;
+#endif
+		default:
+			return nullptr;
+		}
+	}
+
+	std::atomic<const KernelTable*> g_ActiveKernel{nullptr};
+
+	const KernelTable& ActiveKernel()
+	{
+		const KernelTable* table = g_ActiveKernel.load(std::memory_order_acquire);
+
+		if (table == nullptr)
+		{
+			//
+			// Racing initializers all arrive at the same answer, whoever stores last wins
+			//
+			table = FindKernel(transcode::Kernel::Auto);
+			g_ActiveKernel.store(table, std::memory_order_release);
+		}
+
+		return *table;
+	}
+
+	bool IsHighSurrogate(char16_t unit)
+	{
+		return unit >= 0xD800 && unit <= 0xDBFF;
+	}
+
+	bool IsLowSurrogate(char16_t unit)
+	{
+		return unit >= 0xDC00 && unit <= 0xDFFF;
+	}
+
+	//
+	// Decodes one code point at src[0], returns the number of units consumed
+	//
+	size_t DecodeUtf16(const char16_t* src, size_t len, char32_t& codePoint)
+	{
+		const char16_t unit = src[0];
+
+		if (IsHighSurrogate(unit))
+		{
+			if (len > 1 && IsLowSurrogate(src[1]))
+			{
+				codePoint = 0x10000 + ((static_cast<char32_t>(unit) - 0xD800) << 10) + (src[1] - 0xDC00);
+				return 2;
+			}
+
+			codePoint = ReplacementCharacter;
+			return 1;
+		}
+
+		codePoint = IsLowSurrogate(unit) ? ReplacementCharacter : unit;
+		return 1;
+	}
+
+	//
+	// Decodes one code point at src[0], returns the number of bytes consumed. Invalid input is
+	// replaced following the Unicode "maximal subpart" practice: every byte that could still
+	// have started a valid sequence is consumed together, everything else yields its own U+FFFD.
+	//
+	size_t DecodeUtf8(const uint8_t* src, size_t len, char32_t& codePoint)
+	{
+		const uint8_t lead = src[0];
+
+		if (lead < 0x80)
+		{
+			codePoint = lead;
+			return 1;
+		}
+
+		size_t needed;
+		uint8_t lower = 0x80, upper = 0xBF;
+
+		if (lead >= 0xC2 && lead <= 0xDF)
+		{
+			needed = 1;
+			codePoint = lead & 0x1F;
+		}
+		else if (lead >= 0xE0 && lead <= 0xEF)
+		{
+			needed = 2;
+			codePoint = lead & 0x0F;
+			if (lead == 0xE0)
+			{
+				lower = 0xA0;
+			}
+			else if (lead == 0xED)
+			{
+				upper = 0x9F; // no encoded surrogates
+			}
+		}
+		else if (lead >= 0xF0 && lead <= 0xF4)
+		{
+			needed = 3;
+			codePoint = lead & 0x07;
+			if (lead == 0xF0)
+			{
+				lower = 0x90;
+			}
+			else if (lead == 0xF4)
+			{
+				upper = 0x8F; // nothing above U+10FFFF
+			}
+		}
+		else
+		{
+			codePoint = ReplacementCharacter;
+			return 1;
+		}
+
+		for (size_t i = 1; i <= needed; i++)
+		{
+			if (i >= len || src[i] < lower || src[i] > upper)
+			{
+				codePoint = ReplacementCharacter;
+				return i;
+			}
+
+			codePoint = (codePoint << 6) | (src[i] & 0x3F);
+			lower = 0x80;
+			upper = 0xBF;
+		}
+
+		return needed + 1;
+	}
+
+	char32_t DecodeUtf32(char32_t unit)
+	{
+		return (unit >= 0xD800 && unit <= 0xDFFF) || unit > 0x10FFFF ? ReplacementCharacter : unit;
+	}
+
+	size_t Utf8EncodedLength(char32_t codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			return 1;
+		}
+		if (codePoint < 0x800)
+		{
+			return 2;
+		}
+		return codePoint < 0x10000 ? 3 : 4;
+	}
+
+	size_t EncodeUtf8(char32_t codePoint, char* dst)
+	{
+		if (codePoint < 0x80)
+		{
+			dst[0] = static_cast<char>(codePoint);
+			return 1;
+		}
+		if (codePoint < 0x800)
+		{
+			dst[0] = static_cast<char>(0xC0 | (codePoint >> 6));
+			dst[1] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			return 2;
+		}
+		if (codePoint < 0x10000)
+		{
+			dst[0] = static_cast<char>(0xE0 | (codePoint >> 12));
+			dst[1] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			dst[2] = static_cast<char>(0x80 | (codePoint & 0x3F));
+			return 3;
+		}
+		dst[0] = static_cast<char>(0xF0 | (codePoint >> 18));
+		dst[1] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		dst[2] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		dst[3] = static_cast<char>(0x80 | (codePoint & 0x3F));
+		return 4;
+	}
+}
+
+bool nefarius::utilities::transcode::IsKernelSupported(Kernel Kernel)
+{
+	return ::FindKernel(Kernel) != nullptr;
+}
+
+bool nefarius::utilities::transcode::SelectKernel(Kernel Kernel)
+{
+	const auto* table = ::FindKernel(Kernel);
+
+	if (table == nullptr)
+	{
+		return false;
+	}
+
+	g_ActiveKernel.store(table, std::memory_order_release);
+	return true;
+}
+
+nefarius::utilities::transcode::Kernel nefarius::utilities::transcode::GetActiveKernel()
+{
+	return ::ActiveKernel().Kind;
+}
+
+size_t nefarius::utilities::transcode::CountAsciiPrefix(const char16_t* Source, size_t Length)
+{
+	return ::ActiveKernel().CountAscii16(Source, Length);
+}
+
+size_t nefarius::utilities::transcode::CountAsciiPrefix(const char* Source, size_t Length)
+{
+	return ::ActiveKernel().CountAscii8(Source, Length);
+}
+
+size_t nefarius::utilities::transcode::NarrowAsciiPrefix(const char16_t* Source, size_t Length, char* Destination)
+{
+	return ::ActiveKernel().NarrowAscii(Source, Length, Destination);
+}
+
+size_t nefarius::utilities::transcode::WidenAsciiPrefix(const char* Source, size_t Length, char16_t* Destination)
+{
+	return ::ActiveKernel().WidenAscii(Source, Length, Destination);
+}
+
+size_t nefarius::utilities::transcode::Utf8LengthFromUtf16(const char16_t* Source, size_t Length)
+{
+	const auto& kernel = ::ActiveKernel();
+	size_t total = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = kernel.CountAscii16(Source + i, Length - i);
+		i += ascii;
+		total += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf16(Source + i, Length - i, codePoint);
+		total += ::Utf8EncodedLength(codePoint);
+	}
+
+	return total;
+}
+
+size_t nefarius::utilities::transcode::Utf16LengthFromUtf8(const char* Source, size_t Length)
+{
+	const auto& kernel = ::ActiveKernel();
+	const auto* bytes = reinterpret_cast<const uint8_t*>(Source);
+	size_t total = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = kernel.CountAscii8(Source + i, Length - i);
+		i += ascii;
+		total += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf8(bytes + i, Length - i, codePoint);
+		total += codePoint >= 0x10000 ? 2 : 1;
+	}
+
+	return total;
+}
+
+size_t nefarius::utilities::transcode::Utf16ToUtf8(const char16_t* Source, size_t Length, char* Destination)
+{
+	const auto& kernel = ::ActiveKernel();
+	size_t written = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = kernel.NarrowAscii(Source + i, Length - i, Destination + written);
+		i += ascii;
+		written += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf16(Source + i, Length - i, codePoint);
+		written += ::EncodeUtf8(codePoint, Destination + written);
+	}
+
+	return written;
+}
+
+size_t nefarius::utilities::transcode::Utf8ToUtf16(const char* Source, size_t Length, char16_t* Destination)
+{
+	const auto& kernel = ::ActiveKernel();
+	const auto* bytes = reinterpret_cast<const uint8_t*>(Source);
+	size_t written = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = kernel.WidenAscii(Source + i, Length - i, Destination + written);
+		i += ascii;
+		written += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf8(bytes + i, Length - i, codePoint);
+
+		if (codePoint >= 0x10000)
+		{
+			codePoint -= 0x10000;
+			Destination[written++] = static_cast<char16_t>(0xD800 + (codePoint >> 10));
+			Destination[written++] = static_cast<char16_t>(0xDC00 + (codePoint & 0x3FF));
+		}
+		else
+		{
+			Destination[written++] = static_cast<char16_t>(codePoint);
+		}
+	}
+
+	return written;
+}
+
+size_t nefarius::utilities::transcode::CountAsciiPrefix(const char32_t* Source, size_t Length)
+{
+	size_t i = 0;
+
+	while (i < Length && Source[i] < 0x80)
+	{
+		i++;
+	}
+
+	return i;
+}
+
+size_t nefarius::utilities::transcode::NarrowAsciiPrefix(const char32_t* Source, size_t Length, char* Destination)
+{
+	size_t i = 0;
+
+	for (; i < Length && Source[i] < 0x80; i++)
+	{
+		Destination[i] = static_cast<char>(Source[i]);
+	}
+
+	return i;
+}
+
+size_t nefarius::utilities::transcode::WidenAsciiPrefix(const char* Source, size_t Length, char32_t* Destination)
+{
+	const size_t ascii = ::ActiveKernel().CountAscii8(Source, Length);
+
+	for (size_t i = 0; i < ascii; i++)
+	{
+		Destination[i] = static_cast<char32_t>(Source[i]);
+	}
+
+	return ascii;
+}
+
+size_t nefarius::utilities::transcode::Utf8LengthFromUtf32(const char32_t* Source, size_t Length)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < Length; i++)
+	{
+		total += ::Utf8EncodedLength(::DecodeUtf32(Source[i]));
+	}
+
+	return total;
+}
+
+size_t nefarius::utilities::transcode::Utf32LengthFromUtf8(const char* Source, size_t Length)
+{
+	const auto& kernel = ::ActiveKernel();
+	const auto* bytes = reinterpret_cast<const uint8_t*>(Source);
+	size_t total = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = kernel.CountAscii8(Source + i, Length - i);
+		i += ascii;
+		total += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf8(bytes + i, Length - i, codePoint);
+		total++;
+	}
+
+	return total;
+}
+
+size_t nefarius::utilities::transcode::Utf32ToUtf8(const char32_t* Source, size_t Length, char* Destination)
+{
+	size_t written = 0;
+
+	for (size_t i = 0; i < Length; i++)
+	{
+		written += ::EncodeUtf8(::DecodeUtf32(Source[i]), Destination + written);
+	}
+
+	return written;
+}
+
+size_t nefarius::utilities::transcode::Utf8ToUtf32(const char* Source, size_t Length, char32_t* Destination)
+{
+	const auto* bytes = reinterpret_cast<const uint8_t*>(Source);
+	size_t written = 0;
+	size_t i = 0;
+
+	while (i < Length)
+	{
+		const size_t ascii = nefarius::utilities::transcode::WidenAsciiPrefix(
+			Source + i, Length - i, Destination + written);
+		i += ascii;
+		written += ascii;
+
+		if (i == Length)
+		{
+			break;
+		}
+
+		char32_t codePoint;
+		i += ::DecodeUtf8(bytes + i, Length - i, codePoint);
+		Destination[written++] = codePoint;
+	}
+
+	return written;
+}
@@ -1,20 +1,277 @@
-#include "pch.h"
+#include <algorithm>
+#include <climits>
+#include <cwchar>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#endif
 
 #include <nefarius/neflib/UniUtil.hpp>
+#include <nefarius/neflib/Transcode.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+#if WCHAR_MAX <= 0xFFFF
+	//
+	// wchar_t is UTF-16 on Windows
+	//
+	using WideUnit = char16_t;
+#else
+	//
+	// wchar_t is UTF-32 on glibc and most other Unixes
+	//
+	using WideUnit = char32_t;
+#endif
+
+	static_assert(sizeof(wchar_t) == sizeof(WideUnit), "UTF-16 or UTF-32 wchar_t expected");
+
+	const WideUnit* AsUnits(const wchar_t* str)
+	{
+		return reinterpret_cast<const WideUnit*>(str);
+	}
+
+	WideUnit* AsUnits(wchar_t* str)
+	{
+		return reinterpret_cast<WideUnit*>(str);
+	}
+
+	size_t Utf8LengthFromWide(std::wstring_view Rest)
+	{
+#if WCHAR_MAX <= 0xFFFF
+		return transcode::Utf8LengthFromUtf16(::AsUnits(Rest.data()), Rest.size());
+#else
+		return transcode::Utf8LengthFromUtf32(::AsUnits(Rest.data()), Rest.size());
+#endif
+	}
+
+	void WideToUtf8(std::wstring_view Rest, char* Output)
+	{
+#if WCHAR_MAX <= 0xFFFF
+		transcode::Utf16ToUtf8(::AsUnits(Rest.data()), Rest.size(), Output);
+#else
+		transcode::Utf32ToUtf8(::AsUnits(Rest.data()), Rest.size(), Output);
+#endif
+	}
+
+	size_t WideLengthFromUtf8(std::string_view Rest)
+	{
+#if WCHAR_MAX <= 0xFFFF
+		return transcode::Utf16LengthFromUtf8(Rest.data(), Rest.size());
+#else
+		return transcode::Utf32LengthFromUtf8(Rest.data(), Rest.size());
+#endif
+	}
+
+	void Utf8ToWide(std::string_view Rest, wchar_t* Output)
+	{
+#if WCHAR_MAX <= 0xFFFF
+		transcode::Utf8ToUtf16(Rest.data(), Rest.size(), ::AsUnits(Output));
+#else
+		transcode::Utf8ToUtf32(Rest.data(), Rest.size(), ::AsUnits(Output));
+#endif
+	}
+
+#if defined(_WIN32)
+	int ClampToInt(size_t value)
+	{
+		return static_cast<int>(std::min<size_t>(value, INT_MAX));
+	}
+
+	size_t NarrowCodePage(std::wstring_view Rest, std::span<char> Output)
+	{
+		if (!Output.empty())
+		{
+			const int written = WideCharToMultiByte(CP_ACP, 0, Rest.data(), ::ClampToInt(Rest.size()),
+			                                        Output.data(), ::ClampToInt(Output.size()), NULL, NULL);
+
+			if (written > 0)
+			{
+				return written;
+			}
+		}
+
+		return WideCharToMultiByte(CP_ACP, 0, Rest.data(), ::ClampToInt(Rest.size()), NULL, 0, NULL, NULL);
+	}
+
+	size_t WidenCodePage(std::string_view Rest, std::span<wchar_t> Output)
+	{
+		if (!Output.empty())
+		{
+			const int written = MultiByteToWideChar(CP_ACP, 0, Rest.data(), ::ClampToInt(Rest.size()),
+			                                        Output.data(), ::ClampToInt(Output.size()));
 
+			if (written > 0)
+			{
+				return written;
+			}
+		}
+
+		return MultiByteToWideChar(CP_ACP, 0, Rest.data(), ::ClampToInt(Rest.size()), NULL, 0);
+	}
+#endif
+
+	//
+	// Converts what is left after the ASCII prefix. Returns the required size and only writes
+	// if that fits into Output, so an empty Output is a pure size query.
+	// 
+	size_t NarrowRemainder(std::wstring_view Rest, std::span<char> Output)
+	{
+#if defined(_WIN32)
+		if (GetACP() != CP_UTF8)
+		{
+			return ::NarrowCodePage(Rest, Output);
+		}
+#endif
+
+		const size_t required = ::Utf8LengthFromWide(Rest);
+
+		if (required <= Output.size())
+		{
+			::WideToUtf8(Rest, Output.data());
+		}
+
+		return required;
+	}
+
+	size_t WidenRemainder(std::string_view Rest, std::span<wchar_t> Output)
+	{
+#if defined(_WIN32)
+		if (GetACP() != CP_UTF8)
+		{
+			return ::WidenCodePage(Rest, Output);
+		}
+#endif
+
+		const size_t required = ::WideLengthFromUtf8(Rest);
+
+		if (required <= Output.size())
+		{
+			::Utf8ToWide(Rest, Output.data());
+		}
+
+		return required;
+	}
+}
+
+//
+// Every Windows ANSI code page is a superset of 7-bit ASCII, so the pure-ASCII prefix (for
+// hardware/instance IDs that is typically the whole string) is converted by the vectorized
+// transcoder without asking the OS. Whatever remains starts at a non-ASCII character, which is
+// always a valid split point for stateless code pages. Under the UTF-8 ANSI code page the
+// portable transcoder handles the remainder too, since its output is identical to the OS one;
+// other platforms always take that path.
+//
+
+size_t nefarius::utilities::ConvertToNarrow(std::wstring_view Input, std::span<char> Output)
+{
+	const size_t ascii = transcode::NarrowAsciiPrefix(
+		::AsUnits(Input.data()), std::min(Input.size(), Output.size()), Output.data());
+
+	if (ascii == Input.size())
+	{
+		return ascii;
+	}
+
+	return ascii + ::NarrowRemainder(Input.substr(ascii), Output.subspan(ascii));
+}
+
+size_t nefarius::utilities::ConvertToWide(std::string_view Input, std::span<wchar_t> Output)
+{
+	const size_t ascii = transcode::WidenAsciiPrefix(
+		Input.data(), std::min(Input.size(), Output.size()), ::AsUnits(Output.data()));
+
+	if (ascii == Input.size())
+	{
+		return ascii;
+	}
+
+	return ascii + ::WidenRemainder(Input.substr(ascii), Output.subspan(ascii));
+}
+
+//
+// The string is first grown by one output unit per input unit, which is exact for ASCII and
+// enough for every SBCS code page; only a remainder that expands needs a second pass.
+// 
+
+std::string& nefarius::utilities::AppendNarrow(std::string& Output, std::wstring_view Input)
+{
+	const size_t offset = Output.size();
+	Output.resize(offset + Input.size());
+
+	const size_t ascii = transcode::NarrowAsciiPrefix(::AsUnits(Input.data()), Input.size(), Output.data() + offset);
+
+	if (ascii == Input.size())
+	{
+		return Output;
+	}
+
+	const auto rest = Input.substr(ascii);
+	const size_t start = offset + ascii;
+	const size_t required = ::NarrowRemainder(rest, std::span(Output.data() + start, rest.size()));
+
+	Output.resize(start + required);
+
+	if (required > rest.size())
+	{
+		::NarrowRemainder(rest, std::span(Output.data() + start, required));
+	}
+
+	return Output;
+}
+
+std::wstring& nefarius::utilities::AppendWide(std::wstring& Output, std::string_view Input)
+{
+	const size_t offset = Output.size();
+	Output.resize(offset + Input.size());
+
+	const size_t ascii = transcode::WidenAsciiPrefix(Input.data(), Input.size(), ::AsUnits(Output.data() + offset));
+
+	if (ascii == Input.size())
+	{
+		return Output;
+	}
+
+	const auto rest = Input.substr(ascii);
+	const size_t start = offset + ascii;
+	const size_t required = ::WidenRemainder(rest, std::span(Output.data() + start, rest.size()));
+
+	Output.resize(start + required);
+
+	if (required > rest.size())
+	{
+		::WidenRemainder(rest, std::span(Output.data() + start, required));
+	}
+
+	return Output;
+}
+
+std::string_view nefarius::utilities::detail::ConvertToNarrowScratch(std::wstring_view Input)
+{
+	thread_local std::string scratch;
+
+	scratch.clear();
+	return nefarius::utilities::AppendNarrow(scratch, Input);
+}
+
+std::wstring_view nefarius::utilities::detail::ConvertToWideScratch(std::string_view Input)
+{
+	thread_local std::wstring scratch;
+
+	scratch.clear();
+	return nefarius::utilities::AppendWide(scratch, Input);
+}
 
 std::string nefarius::utilities::ConvertWideToANSI(const std::wstring& wide)
 {
-	int count = WideCharToMultiByte(CP_ACP, 0, wide.c_str(), (int)wide.length(), NULL, 0, NULL, NULL);
-	std::string str(count, 0);
-	WideCharToMultiByte(CP_ACP, 0, wide.c_str(), -1, &str[0], count, NULL, NULL);
-	return str;
+	return nefarius::utilities::ConvertToNarrow(std::wstring_view(wide));
 }
 
 std::wstring nefarius::utilities::ConvertAnsiToWide(const std::string& narrow)
 {
-	int count = MultiByteToWideChar(CP_ACP, 0, narrow.c_str(), (int)narrow.length(), NULL, 0);
-	std::wstring wstr(count, 0);
-	MultiByteToWideChar(CP_ACP, 0, narrow.c_str(), (int)narrow.length(), &wstr[0], count);
-	return wstr;
+	return nefarius::utilities::ConvertToWide(std::string_view(narrow));
 }
@@ -0,0 +1,105 @@
+// ReSharper disable CppRedundantQualifier
+#include "pch.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <nefarius/neflib/ErrorCatalog.hpp>
+#include <nefarius/neflib/Win32Error.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	struct CachedMessage
+	{
+		std::string Narrow;
+		std::wstring Wide;
+	};
+
+	//
+	// Entries are never evicted (the set of distinct codes a process runs into is small), so the
+	// views handed out stay valid; node-based map storage isn't moved by rehashing
+	//
+	struct MessageCache
+	{
+		std::shared_mutex Lock;
+		std::unordered_map<uint64_t, CachedMessage> Entries;
+	};
+
+	//
+	// Deliberately leaked so errors can still be formatted during process shutdown
+	//
+	MessageCache& GetCache()
+	{
+		static MessageCache* cache = new MessageCache();
+		return *cache;
+	}
+
+	CachedMessage FormatSystemMessage(DWORD ErrorCode, LANGID Language)
+	{
+		wchar_t* messageBuffer = nullptr;
+		const DWORD messageSize = FormatMessageW(
+			FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+			NULL,
+			ErrorCode,
+			Language,
+			(LPWSTR)&messageBuffer,
+			0,
+			NULL
+		);
+
+		if (messageBuffer != nullptr)
+		{
+			SCOPE_GUARD_CAPTURE({ LocalFree(messageBuffer); }, messageBuffer);
+
+			if (messageSize > 0)
+			{
+				const std::wstring_view message(messageBuffer, messageSize);
+
+				return CachedMessage{ConvertToNarrow(message), std::wstring(message)};
+			}
+		}
+
+		const std::string_view fallback = errors::FallbackMessage(ErrorCode);
+
+		return CachedMessage{std::string(fallback), ConvertToWide(fallback)};
+	}
+
+	const CachedMessage& LookupMessage(DWORD ErrorCode, LANGID Language)
+	{
+		MessageCache& cache = GetCache();
+		const uint64_t key = static_cast<uint64_t>(ErrorCode) << 16 | Language;
+
+		{
+			std::shared_lock lock(cache.Lock);
+
+			if (const auto entry = cache.Entries.find(key); entry != cache.Entries.end())
+			{
+				return entry->second;
+			}
+		}
+
+		//
+		// Formatted outside the lock; should another thread have won the race in the meantime,
+		// its entry is kept and this one discarded
+		//
+		CachedMessage message = ::FormatSystemMessage(ErrorCode, Language);
+
+		std::unique_lock lock(cache.Lock);
+
+		return cache.Entries.try_emplace(key, std::move(message)).first->second;
+	}
+}
+
+std::string_view nefarius::utilities::Win32Error::SystemMessageA(DWORD ErrorCode, LANGID Language)
+{
+	return ::LookupMessage(ErrorCode, Language).Narrow;
+}
+
+std::wstring_view nefarius::utilities::Win32Error::SystemMessageW(DWORD ErrorCode, LANGID Language)
+{
+	return ::LookupMessage(ErrorCode, Language).Wide;
+}
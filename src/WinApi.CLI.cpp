@@ -38,7 +38,7 @@ std::expected<nefarius::winapi::cli::CliArgsResult, Win32Error> nefarius::winapi
 
 	for (int i = 0; i < nArgs; i++)
 	{
-		narrow.push_back(ConvertWideToANSI(std::wstring(argList[i])));
+		narrow.push_back(ConvertToNarrow(std::wstring_view(argList[i])));
 	}
 
 	return CliArgsResult{std::move(narrow)};
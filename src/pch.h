@@ -26,6 +26,7 @@
 #include <expected>
 #include <algorithm>
 #include <variant>
+#include <span>
 
 //
 // Vcpkg dependencies
@@ -44,14 +45,32 @@
 // 
 #include <nefarius/neflib/AnyString.hpp>
 #include <nefarius/neflib/UniUtil.hpp>
+#include <nefarius/neflib/Transcode.hpp>
+#include <nefarius/neflib/CaseFolding.hpp>
+#include <nefarius/neflib/Guid.hpp>
 #include <nefarius/neflib/HDEVINFOHandleGuard.hpp>
 #include <nefarius/neflib/HKEYHandleGuard.hpp>
 #include <nefarius/neflib/INFHandleGuard.hpp>
 #include <nefarius/neflib/GenHandleGuard.hpp>
 #include <nefarius/neflib/LibraryHelper.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
 #include <nefarius/neflib/MultiStringArray.hpp>
+#include <nefarius/neflib/MultiStringSet.hpp>
+#include <nefarius/neflib/StringPool.hpp>
+#include <nefarius/neflib/ErrorCatalog.hpp>
+#include <nefarius/neflib/InfFile.hpp>
+#include <nefarius/neflib/InfAnalysis.hpp>
+#include <nefarius/neflib/InfMetadataCache.hpp>
+#include <nefarius/neflib/DriverStore.hpp>
+#include <nefarius/neflib/DriverStoreSnapshot.hpp>
+#include <nefarius/neflib/DriverMatchIndex.hpp>
+#include <nefarius/neflib/DeviceTree.hpp>
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+#include <nefarius/neflib/DeviceIndex.hpp>
+#include <nefarius/neflib/DeviceCache.hpp>
 #include <nefarius/neflib/Win32Error.hpp>
 #include <nefarius/neflib/ClassFilter.hpp>
 #include <nefarius/neflib/Devcon.hpp>
 #include <nefarius/neflib/DeviceRestart.hpp>
 #include <nefarius/neflib/MiscWinApi.hpp>
+#include <nefarius/neflib/InternedResults.hpp>
@@ -0,0 +1,187 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DeviceCache.hpp>
+
+
+using namespace nefarius::devcon;
+
+namespace
+{
+	constexpr int ErrorAlreadyInitialized = 1247; // ERROR_ALREADY_INITIALIZED
+
+	//
+	// A hub with a thousand devices on a DeviceTreeSimulator, and the source to report changes
+	// of it through
+	//
+	class CachedTree : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			SimulatedDevice hub;
+			hub.InstanceId = L"USB\\ROOT_HUB30\\0";
+			hub.Service = L"USBHUB3";
+			ASSERT_TRUE(tree_.add(hub));
+
+			for (int port = 1; port <= 1000; port++)
+			{
+				ASSERT_TRUE(tree_.add(Device(port)));
+			}
+		}
+
+		static SimulatedDevice Device(int port)
+		{
+			SimulatedDevice device;
+			device.InstanceId = L"USB\\VID_045E&PID_" + std::to_wstring(port) + L"\\S";
+			device.ParentInstanceId = L"USB\\ROOT_HUB30\\0";
+			device.Address = port;
+			device.Service = L"HidUsb";
+			device.HardwareIds = {L"USB\\VID_045E&PID_" + std::to_wstring(port)};
+			device.DeviceDesc = L"Device " + std::to_wstring(port);
+			return device;
+		}
+
+		DeviceTreeSimulator tree_;
+		SyntheticDeviceEvents events_;
+	};
+}
+
+TEST_F(CachedTree, InitialSweep)
+{
+	const auto cache = DeviceCache::Create(tree_, events_);
+	ASSERT_TRUE(cache);
+
+	const auto view = (*cache)->view();
+
+	// the hub, the devices and the root devnode
+	EXPECT_EQ(view->size(), 1002u);
+	EXPECT_EQ(view->generation(), 0u);
+
+	const auto device = view->find(L"usb\\vid_045e&pid_42\\s");
+
+	ASSERT_NE(device, nullptr);
+	EXPECT_EQ(device->InstanceId, L"USB\\VID_045E&PID_42\\S");
+	EXPECT_EQ(device->Name, L"Device 42");
+	EXPECT_EQ(device->Service, L"HidUsb");
+	EXPECT_EQ(device->HardwareIds, (std::vector<std::wstring>{L"USB\\VID_045E&PID_42"}));
+	EXPECT_TRUE(device->Status.Started);
+
+	size_t visited = 0;
+	view->for_each([&](const CachedDevice&) { visited++; });
+	EXPECT_EQ(visited, view->size());
+}
+
+TEST_F(CachedTree, EventsPublishNewViews)
+{
+	const auto cache = DeviceCache::Create(tree_, events_);
+	ASSERT_TRUE(cache);
+
+	const auto before = (*cache)->view();
+
+	ASSERT_TRUE(tree_.add(Device(1001)));
+	events_.post(DeviceEventType::Arrival, L"USB\\VID_045E&PID_1001\\S");
+
+	ASSERT_TRUE(DetachDeviceInstance(tree_, L"USB\\VID_045E&PID_7\\S").Succeeded);
+	events_.post(DeviceEventType::Removal, L"USB\\VID_045E&PID_7\\S");
+
+	ASSERT_TRUE(tree_.update(L"USB\\VID_045E&PID_9\\S", [](SimulatedDevice& device)
+	{
+		device.DeviceDesc = L"Renamed";
+	}));
+	events_.post(DeviceEventType::Changed, L"usb\\vid_045e&pid_9\\s");
+
+	(*cache)->flush();
+
+	const auto after = (*cache)->view();
+
+	EXPECT_GT(after->generation(), before->generation());
+	EXPECT_EQ(after->size(), 1002u);
+	EXPECT_NE(after->find(L"USB\\VID_045E&PID_1001\\S"), nullptr);
+	EXPECT_EQ(after->find(L"USB\\VID_045E&PID_7\\S"), nullptr);
+	EXPECT_EQ(after->find(L"USB\\VID_045E&PID_9\\S")->Name, L"Renamed");
+
+	// the previous view is unchanged, and devices no event named are shared with it
+	EXPECT_EQ(before->size(), 1002u);
+	EXPECT_EQ(before->find(L"USB\\VID_045E&PID_1001\\S"), nullptr);
+	EXPECT_NE(before->find(L"USB\\VID_045E&PID_7\\S"), nullptr);
+	EXPECT_EQ(before->find(L"USB\\VID_045E&PID_9\\S")->Name, L"Device 9");
+	EXPECT_EQ(before->find(L"USB\\VID_045E&PID_500\\S"), after->find(L"USB\\VID_045E&PID_500\\S"));
+}
+
+TEST_F(CachedTree, EventsOfAnAbsentDeviceRemoveIt)
+{
+	const auto cache = DeviceCache::Create(tree_, events_);
+	ASSERT_TRUE(cache);
+
+	ASSERT_TRUE(DetachDeviceInstance(tree_, L"USB\\VID_045E&PID_3\\S").Succeeded);
+
+	// arrived and left again before the batch was applied
+	events_.post(DeviceEventType::Arrival, L"USB\\VID_045E&PID_3\\S");
+	events_.post(DeviceEventType::Arrival, L"USB\\VID_045E&PID_NONE\\S");
+	(*cache)->flush();
+
+	const auto view = (*cache)->view();
+
+	EXPECT_EQ(view->find(L"USB\\VID_045E&PID_3\\S"), nullptr);
+	EXPECT_EQ(view->find(L"USB\\VID_045E&PID_NONE\\S"), nullptr);
+	EXPECT_EQ(view->size(), 1001u);
+}
+
+TEST_F(CachedTree, ReadersSeeConsistentViewsWhileEventsApply)
+{
+	const auto cache = DeviceCache::Create(tree_, events_);
+	ASSERT_TRUE(cache);
+
+	std::jthread reader([&](const std::stop_token& stop)
+	{
+		while (!stop.stop_requested())
+		{
+			const auto view = (*cache)->view();
+			size_t visited = 0;
+			view->for_each([&](const CachedDevice&) { visited++; });
+			EXPECT_EQ(visited, view->size());
+		}
+	});
+
+	for (int port = 1; port <= 1000; port++)
+	{
+		events_.post(DeviceEventType::Changed, L"USB\\VID_045E&PID_" + std::to_wstring(port) + L"\\S");
+	}
+
+	(*cache)->flush();
+	reader.request_stop();
+	reader.join();
+
+	EXPECT_EQ((*cache)->view()->size(), 1002u);
+}
+
+TEST_F(CachedTree, FailedStartLeavesAnotherOwnersSourceRunning)
+{
+	std::vector<std::wstring> received;
+	ASSERT_TRUE(events_.start([&](DeviceEvent Event) { received.push_back(std::move(Event.InstanceId)); }));
+
+	{
+		const auto cache = DeviceCache::Create(tree_, events_);
+
+		ASSERT_FALSE(cache);
+		EXPECT_EQ(cache.error().value(), ErrorAlreadyInitialized);
+	}
+
+	events_.post(DeviceEventType::Changed, L"USB\\VID_045E&PID_1\\S");
+
+	EXPECT_EQ(received, (std::vector<std::wstring>{L"USB\\VID_045E&PID_1\\S"}));
+	events_.stop();
+}
+
+TEST_F(CachedTree, DestructionStopsTheSource)
+{
+	ASSERT_TRUE(DeviceCache::Create(tree_, events_));
+
+	// the cache is gone and has stopped the source, so it can be started again
+	EXPECT_TRUE(events_.start([](DeviceEvent) {}));
+	events_.stop();
+}
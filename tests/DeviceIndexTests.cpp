@@ -0,0 +1,181 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DeviceIndex.hpp>
+#include <nefarius/neflib/Guid.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities::literals;
+
+namespace
+{
+	constexpr auto UsbClass = "{36fc9e60-c465-11cf-8056-444553540000}"_guid;
+	constexpr auto XnaClass = "{d61ca365-5af4-4486-998b-9db4734c6ca3}"_guid;
+
+	//
+	// A hub with an Xbox 360 controller, a device whose hardware IDs have every trigram of
+	// "E&PID" between them but not the string itself, 20 filler devices so "VID" is common, and
+	// a phantom
+	//
+	class IndexedTree : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			SimulatedDevice hub;
+			hub.InstanceId = L"USB\\ROOT_HUB30\\0";
+			hub.Service = L"USBHUB3";
+			hub.ClassGuid = UsbClass;
+			ASSERT_TRUE(tree_.add(hub));
+
+			SimulatedDevice pad;
+			pad.InstanceId = L"USB\\VID_045E&PID_028E\\1";
+			pad.ParentInstanceId = hub.InstanceId;
+			pad.Service = L"xusb22";
+			pad.ClassGuid = XnaClass;
+			pad.HardwareIds = {L"USB\\VID_045E&PID_028E&REV_0114", L"USB\\VID_045E&PID_028E"};
+			pad.CompatibleIds = {L"USB\\Class_FF&SubClass_5D&Prot_01", L"USB\\Class_FF"};
+			ASSERT_TRUE(tree_.add(pad));
+
+			SimulatedDevice decoy;
+			decoy.InstanceId = L"ROOT\\DECOY\\0000";
+			decoy.HardwareIds = {L"ACPI\\VEN_E&P", L"ROOT\\&PID"};
+			ASSERT_TRUE(tree_.add(decoy));
+
+			for (int port = 1; port <= 20; port++)
+			{
+				SimulatedDevice filler;
+				filler.InstanceId = L"USB\\VID_1234&PID_" + std::to_wstring(1000 + port) + L"\\F";
+				filler.ParentInstanceId = hub.InstanceId;
+				filler.Address = port;
+				filler.Service = L"HidUsb";
+				filler.ClassGuid = UsbClass;
+				filler.HardwareIds = {L"USB\\VID_1234&PID_" + std::to_wstring(1000 + port)};
+				ASSERT_TRUE(tree_.add(filler));
+			}
+
+			SimulatedDevice rare;
+			rare.InstanceId = L"USB\\VID_XYZW\\R";
+			rare.ParentInstanceId = hub.InstanceId;
+			rare.HardwareIds = {L"USB\\VID_XYZW"};
+			ASSERT_TRUE(tree_.add(rare));
+
+			SimulatedDevice phantom;
+			phantom.InstanceId = L"USB\\VID_045E&PID_0719\\P";
+			phantom.ParentInstanceId = hub.InstanceId;
+			phantom.Service = L"xusb22";
+			phantom.HardwareIds = {L"USB\\VID_045E&PID_0719"};
+			phantom.Present = false;
+			ASSERT_TRUE(tree_.add(phantom));
+
+			auto index = DeviceIndex::Build(tree_);
+			ASSERT_TRUE(index);
+			index_ = std::move(index.value());
+		}
+
+		std::vector<std::wstring> Find(std::wstring_view substring, bool ignoreCase = false) const
+		{
+			std::vector<std::wstring> found;
+
+			for (const auto row : index_.find_hardware_id(substring, ignoreCase))
+			{
+				found.emplace_back(index_.snapshot().instance_id(row));
+			}
+
+			return found;
+		}
+
+		std::wstring InstanceId(DeviceIndex::Row row) const
+		{
+			return std::wstring(index_.snapshot().instance_id(row));
+		}
+
+		DeviceTreeSimulator tree_;
+		DeviceIndex index_;
+	};
+}
+
+TEST_F(IndexedTree, ByInstanceIdIgnoresCaseAndSkipsPhantoms)
+{
+	const auto pad = index_.by_instance_id(L"usb\\vid_045e&pid_028e\\1");
+
+	ASSERT_TRUE(pad);
+	EXPECT_EQ(InstanceId(*pad), L"USB\\VID_045E&PID_028E\\1");
+	EXPECT_FALSE(index_.by_instance_id(L"USB\\VID_045E&PID_0719\\P"));
+	EXPECT_FALSE(index_.by_instance_id(L"USB\\VID_045E&PID_028E"));
+
+	// the root devnode, the hub, the controller, the decoy, the filler and the rare device
+	EXPECT_EQ(index_.size(), 25u);
+}
+
+TEST_F(IndexedTree, PhantomsAreIndexedOnRequest)
+{
+	const auto all = DeviceIndex::Build(tree_, false);
+
+	ASSERT_TRUE(all);
+	EXPECT_EQ(all->size(), 26u);
+	EXPECT_TRUE(all->by_instance_id(L"USB\\VID_045E&PID_0719\\P"));
+	EXPECT_EQ(ListDeviceInstancesByService(*all, L"XUSB22"),
+	          (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1", L"USB\\VID_045E&PID_0719\\P"}));
+}
+
+TEST_F(IndexedTree, ExactLookups)
+{
+	const auto pad = index_.by_instance_id(L"USB\\VID_045E&PID_028E\\1");
+	ASSERT_TRUE(pad);
+
+	const auto byHardwareId = index_.by_hardware_id(L"usb\\vid_045e&pid_028e");
+
+	ASSERT_EQ(byHardwareId.size(), 1u);
+	EXPECT_EQ(byHardwareId[0], *pad);
+	EXPECT_EQ(index_.by_compatible_id(L"USB\\CLASS_FF").size(), 1u);
+	EXPECT_TRUE(index_.by_hardware_id(L"USB\\VID_045E").empty());
+
+	EXPECT_EQ(ListDeviceInstancesByService(index_, L"XUSB22"),
+	          (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_EQ(index_.by_service(L"hidusb").size(), 20u);
+	EXPECT_TRUE(index_.by_service(L"kbdhid").empty());
+
+	EXPECT_EQ(ListDeviceInstancesByClass(index_, XnaClass), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_EQ(index_.by_class(UsbClass).size(), 21u);
+	EXPECT_TRUE(index_.by_class("{4d36e97d-e325-11ce-bfc1-08002be10318}"_guid).empty());
+}
+
+TEST_F(IndexedTree, FindMatchesCaseOnRequest)
+{
+	EXPECT_EQ(Find(L"VID_045E&PID_028E"), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_TRUE(Find(L"vid_045e&pid_028e").empty());
+	EXPECT_EQ(Find(L"vid_045e&pid_028e", true), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_TRUE(Find(L"VID_045E&PID_0719").empty());
+	EXPECT_TRUE(Find(L"QQQ", true).empty());
+}
+
+TEST_F(IndexedTree, ShortNeedlesCheckEveryDevice)
+{
+	EXPECT_EQ(Find(L"5E"), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_TRUE(Find(L"5e").empty());
+	EXPECT_EQ(Find(L"5e", true), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+
+	// every device with a hardware ID
+	EXPECT_EQ(Find(L"").size(), 23u);
+}
+
+TEST_F(IndexedTree, CandidatesWithTrigramsFromDifferentIdsAreRejected)
+{
+	// the decoy has "E&P" in one ID and "&PI", "PID" in another, so it's a candidate
+	EXPECT_EQ(Find(L"E&PID"), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_EQ(Find(L"e&pid", true), (std::vector<std::wstring>{L"USB\\VID_045E&PID_028E\\1"}));
+	EXPECT_EQ(Find(L"VEN_E&P"), (std::vector<std::wstring>{L"ROOT\\DECOY\\0000"}));
+}
+
+TEST_F(IndexedTree, RareTrigramsProbeCommonOnes)
+{
+	// "XYZ" is in one row, "VID" in 22; the common posting is probed instead of intersected
+	EXPECT_EQ(Find(L"VID_XYZ"), (std::vector<std::wstring>{L"USB\\VID_XYZW\\R"}));
+	EXPECT_EQ(Find(L"vid_xyzw", true), (std::vector<std::wstring>{L"USB\\VID_XYZW\\R"}));
+	EXPECT_TRUE(Find(L"VID_XYZWV").empty());
+	EXPECT_EQ(Find(L"VID_1234&PID_1007"), (std::vector<std::wstring>{L"USB\\VID_1234&PID_1007\\F"}));
+}
@@ -0,0 +1,201 @@
+#include <array>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DeviceSnapshot.hpp>
+#include <nefarius/neflib/Guid.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace nefarius::utilities::literals;
+
+namespace
+{
+	constexpr auto UsbClass = "{36fc9e60-c465-11cf-8056-444553540000}"_guid;
+	constexpr auto HidClass = "{745a17a0-74d3-11d0-b6fe-00a0c90f57da}"_guid;
+
+	//
+	// A hub, a composite device with every property set, a HID interface with only some of them
+	// and a phantom
+	//
+	class SnapshotTree : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			SimulatedDevice hub;
+			hub.InstanceId = L"USB\\ROOT_HUB30\\0";
+			hub.Service = L"USBHUB3";
+			hub.ClassGuid = UsbClass;
+			ASSERT_TRUE(tree_.add(hub));
+
+			SimulatedDevice composite;
+			composite.InstanceId = L"USB\\VID_1234&PID_0002\\A";
+			composite.ParentInstanceId = hub.InstanceId;
+			composite.Address = 3;
+			composite.Service = L"usbccgp";
+			composite.ClassGuid = UsbClass;
+			composite.DeviceDesc = L"USB Composite Device";
+			composite.FriendlyName = L"Keyboard Hub";
+			composite.HardwareIds = {L"USB\\VID_1234&PID_0002&REV_0100", L"USB\\VID_1234&PID_0002"};
+			composite.CompatibleIds = {L"USB\\COMPOSITE"};
+			ASSERT_TRUE(tree_.add(composite));
+
+			SimulatedDevice keyboard;
+			keyboard.InstanceId = L"HID\\VID_1234&PID_0002&MI_00\\1";
+			keyboard.ParentInstanceId = composite.InstanceId;
+			keyboard.ClassGuid = HidClass;
+			ASSERT_TRUE(tree_.add(keyboard));
+
+			SimulatedDevice phantom;
+			phantom.InstanceId = L"HID\\VID_1234&PID_0002&MI_01\\1";
+			phantom.ParentInstanceId = composite.InstanceId;
+			phantom.ClassGuid = HidClass;
+			phantom.Present = false;
+			ASSERT_TRUE(tree_.add(phantom));
+		}
+
+		static std::vector<std::wstring> InstanceIds(const DeviceSnapshot& snapshot)
+		{
+			std::vector<std::wstring> ids;
+
+			for (size_t row = 0; row < snapshot.size(); row++)
+			{
+				ids.emplace_back(snapshot.instance_id(row));
+			}
+
+			return ids;
+		}
+
+		static size_t RowOf(const DeviceSnapshot& snapshot, std::wstring_view instanceId)
+		{
+			for (size_t row = 0; row < snapshot.size(); row++)
+			{
+				if (snapshot.instance_id(row) == instanceId)
+				{
+					return row;
+				}
+			}
+
+			return snapshot.size();
+		}
+
+		DeviceTreeSimulator tree_;
+	};
+}
+
+TEST_F(SnapshotTree, DuplicatePropertiesAreReadOnce)
+{
+	constexpr std::array properties{
+		DeviceProperty::InstanceId, DeviceProperty::Service, DeviceProperty::Service, DeviceProperty::InstanceId
+	};
+
+	const auto before = tree_.stats().PropertyReads;
+	const auto snapshot = DeviceSnapshot::Capture(tree_, properties);
+
+	ASSERT_TRUE(snapshot);
+	EXPECT_EQ(snapshot->size(), 4u);
+
+	// two columns for the root devnode, the hub, the composite device and the keyboard
+	EXPECT_EQ(tree_.stats().PropertyReads - before, 8u);
+	EXPECT_TRUE(snapshot->contains(DeviceProperty::Service));
+	EXPECT_FALSE(snapshot->contains(DeviceProperty::HardwareIds));
+
+	const size_t composite = RowOf(*snapshot, L"USB\\VID_1234&PID_0002\\A");
+
+	ASSERT_LT(composite, snapshot->size());
+	EXPECT_EQ(snapshot->string(composite, DeviceProperty::Service), L"usbccgp");
+}
+
+TEST_F(SnapshotTree, MissingPropertiesAreMissingFromTheRow)
+{
+	constexpr std::array properties{
+		DeviceProperty::InstanceId, DeviceProperty::DeviceDesc, DeviceProperty::FriendlyName,
+		DeviceProperty::Service, DeviceProperty::HardwareIds, DeviceProperty::CompatibleIds,
+		DeviceProperty::Address, DeviceProperty::ClassGuid
+	};
+
+	const auto snapshot = DeviceSnapshot::Capture(tree_, properties);
+	ASSERT_TRUE(snapshot);
+
+	const size_t composite = RowOf(*snapshot, L"USB\\VID_1234&PID_0002\\A");
+	const size_t keyboard = RowOf(*snapshot, L"HID\\VID_1234&PID_0002&MI_00\\1");
+
+	ASSERT_LT(composite, snapshot->size());
+	ASSERT_LT(keyboard, snapshot->size());
+
+	EXPECT_EQ(snapshot->string(composite, DeviceProperty::DeviceDesc), L"USB Composite Device");
+	EXPECT_EQ(snapshot->string(composite, DeviceProperty::FriendlyName), L"Keyboard Hub");
+	EXPECT_EQ(snapshot->uint32(composite, DeviceProperty::Address), 3u);
+	EXPECT_EQ(snapshot->guid(composite, DeviceProperty::ClassGuid), UsbClass);
+
+	const auto hardwareIds = snapshot->strings(composite, DeviceProperty::HardwareIds);
+
+	ASSERT_TRUE(hardwareIds);
+	EXPECT_EQ(std::vector<std::wstring>(hardwareIds->begin(), hardwareIds->end()),
+	          (std::vector<std::wstring>{L"USB\\VID_1234&PID_0002&REV_0100", L"USB\\VID_1234&PID_0002"}));
+
+	EXPECT_EQ(snapshot->string(keyboard, DeviceProperty::DeviceDesc), std::nullopt);
+	EXPECT_EQ(snapshot->string(keyboard, DeviceProperty::Service), std::nullopt);
+	EXPECT_FALSE(snapshot->strings(keyboard, DeviceProperty::HardwareIds));
+	EXPECT_EQ(snapshot->uint32(keyboard, DeviceProperty::Address), std::nullopt);
+	EXPECT_EQ(snapshot->guid(keyboard, DeviceProperty::ClassGuid), HidClass);
+
+	// rows past the end have nothing
+	EXPECT_EQ(snapshot->string(snapshot->size(), DeviceProperty::InstanceId), std::nullopt);
+	EXPECT_TRUE(snapshot->instance_id(snapshot->size()).empty());
+}
+
+TEST_F(SnapshotTree, TypeMismatchReturnsNothing)
+{
+	constexpr std::array properties{
+		DeviceProperty::InstanceId, DeviceProperty::HardwareIds, DeviceProperty::Address, DeviceProperty::ClassGuid
+	};
+
+	const auto snapshot = DeviceSnapshot::Capture(tree_, properties);
+	ASSERT_TRUE(snapshot);
+
+	const size_t composite = RowOf(*snapshot, L"USB\\VID_1234&PID_0002\\A");
+
+	ASSERT_LT(composite, snapshot->size());
+	EXPECT_EQ(snapshot->string(composite, DeviceProperty::HardwareIds), std::nullopt);
+	EXPECT_FALSE(snapshot->strings(composite, DeviceProperty::InstanceId));
+	EXPECT_EQ(snapshot->uint32(composite, DeviceProperty::ClassGuid), std::nullopt);
+	EXPECT_EQ(snapshot->guid(composite, DeviceProperty::Address), std::nullopt);
+	EXPECT_EQ(snapshot->string(composite, DeviceProperty::Address), std::nullopt);
+}
+
+TEST_F(SnapshotTree, ClassAndPresenceFilters)
+{
+	constexpr std::array properties{DeviceProperty::InstanceId};
+
+	DeviceSnapshotOptions options;
+	options.ClassGuid = HidClass;
+
+	const auto present = DeviceSnapshot::Capture(tree_, properties, options);
+
+	ASSERT_TRUE(present);
+	EXPECT_EQ(InstanceIds(*present), (std::vector<std::wstring>{L"HID\\VID_1234&PID_0002&MI_00\\1"}));
+
+	options.PresentOnly = false;
+
+	const auto all = DeviceSnapshot::Capture(tree_, properties, options);
+
+	ASSERT_TRUE(all);
+	EXPECT_EQ(InstanceIds(*all), (std::vector<std::wstring>{
+		          L"HID\\VID_1234&PID_0002&MI_00\\1", L"HID\\VID_1234&PID_0002&MI_01\\1"}));
+
+	options.ClassGuid = "{4d36e97d-e325-11ce-bfc1-08002be10318}"_guid;
+
+	const auto none = DeviceSnapshot::Capture(tree_, properties, options);
+
+	ASSERT_TRUE(none);
+	EXPECT_TRUE(none->empty());
+
+	const auto everything = DeviceSnapshot::Capture(tree_, properties, DeviceSnapshotOptions{{}, false});
+
+	ASSERT_TRUE(everything);
+	EXPECT_EQ(everything->size(), 5u);
+}
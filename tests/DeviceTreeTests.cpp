@@ -0,0 +1,304 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DeviceTree.hpp>
+
+
+using namespace nefarius::devcon;
+using namespace std::chrono_literals;
+
+namespace
+{
+	constexpr uint32_t ErrorCancelled = 1223; // ERROR_CANCELLED
+	constexpr uint32_t ErrorNotSupported = 50; // ERROR_NOT_SUPPORTED
+	constexpr uint32_t VetoDevice = 6; // PNP_VetoDevice
+
+	//
+	// A root hub with a composite device on port 3 and a keyboard interface below it
+	//
+	class SimulatedKeyboard : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			SimulatedDevice hub;
+			hub.InstanceId = L"USB\\ROOT_HUB30\\1";
+			hub.Service = L"USBHUB3";
+			ASSERT_TRUE(tree_.add(hub));
+
+			SimulatedDevice composite;
+			composite.InstanceId = L"USB\\VID_1234&PID_0002\\A";
+			composite.ParentInstanceId = hub.InstanceId;
+			composite.Address = 3;
+			composite.Service = L"usbccgp";
+			composite.HardwareIds = {L"USB\\VID_1234&PID_0002&REV_0100", L"USB\\VID_1234&PID_0002"};
+			composite.DeviceDesc = L"USB Composite Device";
+			composite.DriverVersion = 0x0001000200030004ull;
+			ASSERT_TRUE(tree_.add(composite));
+
+			SimulatedDevice keyboard;
+			keyboard.InstanceId = L"HID\\VID_1234&PID_0002&MI_00\\1";
+			keyboard.ParentInstanceId = composite.InstanceId;
+			keyboard.Service = L"kbdhid";
+			keyboard.IgnoresPropertyChange = true;
+			keyboard.RemovalVeto = DeviceRemovalVeto{VetoDevice, L"\\Device\\KeyboardClass0"};
+			keyboard.Started = false;
+			keyboard.ProblemCode = 10;
+			ASSERT_TRUE(tree_.add(keyboard));
+
+			options_.PostRestartVerifyTimeout = 50ms;
+		}
+
+		DeviceTreeSimulator tree_;
+		DeviceRestartOptions options_;
+	};
+}
+
+TEST_F(SimulatedKeyboard, DuplicateInstanceIdIsRejected)
+{
+	SimulatedDevice duplicate;
+	duplicate.InstanceId = L"usb\\root_hub30\\1";
+
+	EXPECT_FALSE(tree_.add(duplicate));
+}
+
+TEST_F(SimulatedKeyboard, VetoedRestartReportsTheVetoAndTheFinalStatus)
+{
+	options_.AllowUsbPortCycle = false;
+
+	const auto result = RestartDeviceInstance(tree_, L"hid\\vid_1234&pid_0002&mi_00\\1", options_);
+
+	EXPECT_FALSE(result.Succeeded);
+	EXPECT_EQ(result.LastAttempted, RestartStrategy::RemoveAndReenumerate);
+	EXPECT_EQ(result.LastError, ErrorCancelled);
+	EXPECT_EQ(result.VetoType, VetoDevice);
+	EXPECT_EQ(result.VetoName, L"\\Device\\KeyboardClass0");
+	EXPECT_TRUE(result.DevicePresent);
+	EXPECT_TRUE(result.FinalStatusValid);
+	EXPECT_EQ(result.FinalStatusError, 0u);
+	EXPECT_EQ(result.FinalStatusWin32Error, 0u);
+	EXPECT_TRUE(result.FinalHasProblem);
+	EXPECT_EQ(result.FinalProblemCode, 10u);
+}
+
+TEST_F(SimulatedKeyboard, PortCycleRestartsTheDevice)
+{
+	const auto result = RestartDeviceInstance(tree_, L"HID\\VID_1234&PID_0002&MI_00\\1", options_);
+
+	EXPECT_TRUE(result.Succeeded);
+	EXPECT_EQ(result.Strategy, RestartStrategy::UsbPortCycle);
+	EXPECT_TRUE(result.FinalStarted);
+	EXPECT_FALSE(result.FinalHasProblem);
+	EXPECT_EQ(tree_.stats().PortCycles, 1u);
+}
+
+TEST_F(SimulatedKeyboard, DetachAndReenumerate)
+{
+	ASSERT_TRUE(tree_.update(L"HID\\VID_1234&PID_0002&MI_00\\1", [](SimulatedDevice& device)
+	{
+		device.RemovalVeto.reset();
+	}));
+
+	const auto detached = DetachDeviceInstance(tree_, L"USB\\VID_1234&PID_0002\\A");
+
+	ASSERT_TRUE(detached.Succeeded);
+	EXPECT_EQ(detached.ParentInstanceId, L"USB\\ROOT_HUB30\\1");
+	EXPECT_FALSE(tree_.locate(L"HID\\VID_1234&PID_0002&MI_00\\1"));
+	EXPECT_TRUE(tree_.locate(L"HID\\VID_1234&PID_0002&MI_00\\1", true));
+	EXPECT_TRUE(ListDeviceInstancesByService(tree_, L"KBDHID")->empty());
+	EXPECT_EQ(ListDeviceInstancesByService(tree_, L"KBDHID", false)->size(), 1u);
+
+	const auto reenumerated = ReenumerateParentDevNode(tree_, detached.ParentInstanceId);
+
+	EXPECT_TRUE(reenumerated.Succeeded);
+	EXPECT_TRUE(tree_.locate(L"HID\\VID_1234&PID_0002&MI_00\\1"));
+	EXPECT_EQ(ListDeviceInstancesByService(tree_, L"KBDHID")->size(), 1u);
+}
+
+TEST_F(SimulatedKeyboard, FindByHwId)
+{
+	const auto found = FindByHwId(tree_, L"PID_0002");
+
+	ASSERT_TRUE(found);
+	ASSERT_EQ(found->size(), 1u);
+	EXPECT_EQ((*found)[0].Name, L"USB Composite Device");
+	EXPECT_EQ((*found)[0].HardwareIds.size(), 2u);
+	EXPECT_EQ((*found)[0].Version.Major, 1u);
+	EXPECT_EQ((*found)[0].Version.Private, 4u);
+}
+
+TEST_F(SimulatedKeyboard, PortCycleNeedsAHub)
+{
+	SimulatedDevice pci;
+	pci.InstanceId = L"PCI\\VEN_8086&DEV_0001\\0";
+	ASSERT_TRUE(tree_.add(pci));
+
+	const auto cycled = CycleUsbPortOfDevice(tree_, pci.InstanceId);
+
+	ASSERT_FALSE(cycled);
+	EXPECT_EQ(static_cast<uint32_t>(cycled.error().value()), ErrorNotSupported);
+}
+
+//
+// 10 hubs x 100 composite devices x 9 interfaces (10011 devnodes with the root), one hub failing
+// port cycles, a mix of transient and sticky problem codes, vetoes, failing restarts and start
+// latency; every interface is restarted from 64 threads at once
+//
+TEST(DeviceTreeSimulator, RestartTenThousandDevices)
+{
+	constexpr int hubs = 10, ports = 100, interfaces = 9, failingHub = 7;
+
+	DeviceTreeSimulator tree;
+	std::vector<std::wstring> targets;
+	std::vector<bool> sticky;
+	std::vector<int> hubOf;
+	uint32_t seed = 1;
+
+	const auto random = [&]
+	{
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 16) & 0x7FFF;
+	};
+
+	for (int h = 0; h < hubs; h++)
+	{
+		SimulatedDevice hub;
+		hub.InstanceId = L"USB\\ROOT_HUB30\\" + std::to_wstring(h);
+		hub.Service = L"USBHUB3";
+		hub.CyclePortError = h == failingHub ? 31 : 0; // ERROR_GEN_FAILURE
+		ASSERT_TRUE(tree.add(hub));
+
+		for (int p = 1; p <= ports; p++)
+		{
+			SimulatedDevice composite;
+			composite.InstanceId = L"USB\\VID_045E&PID_" + std::to_wstring(h * 1000 + p) + L"\\S";
+			composite.ParentInstanceId = hub.InstanceId;
+			composite.Address = p;
+			composite.Service = L"usbccgp";
+			composite.OperationLatency = std::chrono::milliseconds(random() % 2);
+			ASSERT_TRUE(tree.add(composite));
+
+			for (int i = 0; i < interfaces; i++)
+			{
+				SimulatedDevice device;
+				device.InstanceId = L"HID\\" + composite.InstanceId + L"&MI_0" + std::to_wstring(i);
+				device.ParentInstanceId = composite.InstanceId;
+				device.Service = i == 0 ? L"kbdhid" : L"HidUsb";
+				device.HardwareIds = {L"HID\\VID_045E&MI_0" + std::to_wstring(i)};
+				device.StartLatency = std::chrono::milliseconds(random() % 10);
+
+				const uint32_t roll = random() % 100;
+
+				if (roll < 3)
+				{
+					device.Started = false;
+					device.ProblemCode = 10;
+					device.ProblemSurvivesRestart = true;
+				}
+				else if (roll < 10)
+				{
+					device.Started = false;
+					device.ProblemCode = 28;
+				}
+
+				if (i == 0)
+				{
+					device.IgnoresPropertyChange = true;
+
+					if (roll % 2)
+					{
+						device.RemovalVeto = DeviceRemovalVeto{VetoDevice, L"csrss.exe"};
+					}
+				}
+
+				if (roll == 50)
+				{
+					device.RestartError = 5; // ERROR_ACCESS_DENIED
+				}
+
+				ASSERT_TRUE(tree.add(device));
+				targets.push_back(device.InstanceId);
+				sticky.push_back(device.ProblemSurvivesRestart);
+				hubOf.push_back(h);
+			}
+		}
+	}
+
+	ASSERT_EQ(tree.size(), 10011u);
+	EXPECT_EQ(ListDeviceInstancesByService(tree, L"hidusb")->size(), 8000u);
+	EXPECT_EQ(FindByHwId(tree, L"MI_03")->size(), 1000u);
+
+	DeviceRestartOptions options;
+	options.PerDeviceTimeout = 5s;
+	options.PostRestartVerifyTimeout = 200ms;
+
+	std::vector<DeviceRestartResult> results(targets.size());
+	std::atomic<size_t> next{0};
+	std::vector<std::thread> workers;
+
+	for (int w = 0; w < 64; w++)
+	{
+		workers.emplace_back([&]
+		{
+			for (size_t i; (i = next++) < targets.size();)
+			{
+				results[i] = RestartDeviceInstance(tree, targets[i], options);
+			}
+		});
+	}
+
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const auto& result = results[i];
+		SCOPED_TRACE(testing::Message() << std::string(targets[i].begin(), targets[i].end()));
+
+		EXPECT_TRUE(result.DevicePresent);
+		EXPECT_TRUE(result.FinalStatusValid);
+		EXPECT_EQ(result.FinalStatusWin32Error, 0u);
+		EXPECT_FALSE(result.TimedOut);
+
+		if (sticky[i])
+		{
+			EXPECT_FALSE(result.Succeeded);
+			EXPECT_TRUE(result.FinalHasProblem);
+			EXPECT_EQ(result.FinalProblemCode, 10u);
+		}
+		else if (hubOf[i] != failingHub)
+		{
+			// siblings cycling the same port may delay the start past the verify window, in
+			// which case a later strategy wins
+			EXPECT_TRUE(result.Succeeded);
+		}
+		else if (result.Succeeded)
+		{
+			EXPECT_NE(result.Strategy, RestartStrategy::UsbPortCycle);
+		}
+		else
+		{
+			// only a vetoed keyboard that ignores DIF_PROPERTYCHANGE is left without a strategy
+			EXPECT_EQ(result.VetoType, VetoDevice);
+			EXPECT_EQ(result.VetoName, L"csrss.exe");
+		}
+
+		if (result.Succeeded)
+		{
+			EXPECT_TRUE(result.FinalStarted);
+			EXPECT_FALSE(result.FinalHasProblem);
+		}
+	}
+
+	const auto stats = tree.stats();
+
+	EXPECT_GT(stats.PortCycles, 0u);
+	EXPECT_GT(stats.Vetoes, 0u);
+}
@@ -0,0 +1,118 @@
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DriverMatchIndex.hpp>
+
+
+using namespace nefarius::devcon::inf;
+namespace fs = std::filesystem;
+
+namespace
+{
+	using RankedModel = std::pair<std::u16string, uint32_t>;
+
+	//
+	// The INFs of data/match: models of ranks.inf and compatible.inf matching a Contoso pad by
+	// each kind of ID, four Litware widget drivers with the same hardware ID and a Litware gadget
+	// listing its hardware ID more than once
+	//
+	class MatchCorpus : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			auto index = DriverMatchIndex::BuildFromDirectory(fs::path(NEFLIB_TEST_DATA_DIR) / "match");
+			ASSERT_TRUE(index);
+			index_ = std::move(index.value());
+		}
+
+		//
+		// Install section and rank of every match, best first
+		//
+		std::vector<RankedModel> Match(std::vector<std::u16string_view> hardwareIds,
+		                               std::vector<std::u16string_view> compatibleIds = {}) const
+		{
+			std::vector<RankedModel> ranked;
+
+			for (const auto& match : index_.match(hardwareIds, compatibleIds))
+			{
+				ranked.emplace_back(match.Model->InstallSection, match.Rank);
+			}
+
+			return ranked;
+		}
+
+		DriverMatchIndex index_;
+	};
+}
+
+TEST_F(MatchCorpus, EveryInfIsIndexed)
+{
+	EXPECT_EQ(index_.size(), 7u);
+	EXPECT_TRUE(Match({u"ACME\\UNKNOWN"}, {u"ACME\\UNKNOWN_COMPAT"}).empty());
+	EXPECT_FALSE(index_.best({}));
+}
+
+TEST_F(MatchCorpus, RankOrdersByKindOfIdThenPosition)
+{
+	// compatible.inf is newer, but rank goes first
+	EXPECT_EQ(Match({u"USB\\VID_1234&PID_5678&REV_0100", u"USB\\VID_1234&PID_5678"},
+	                {u"USB\\Class_03&SubClass_01", u"USB\\Class_03"}),
+	          (std::vector<RankedModel>{
+		          {u"Revision_Install", 0x0000}, // device hardware ID 0 = model hardware ID
+		          {u"Exact_Install", 0x0100}, // device hardware ID 1 = model hardware ID
+		          {u"ModelCompatible_Install", 0x1101}, // device hardware ID 1 = model compatible ID 1
+		          {u"Class_Install", 0x2100}, // device compatible ID 1 = model hardware ID
+		          {u"Generic_Install", 0x3101}, // device compatible ID 1 = model compatible ID 1
+		          }));
+}
+
+TEST_F(MatchCorpus, IdsMatchIgnoringCase)
+{
+	const auto best = index_.best(std::vector<std::u16string_view>{u"usb\\vid_1234&pid_5678"});
+
+	ASSERT_TRUE(best);
+	EXPECT_EQ(best->Model->InstallSection, u"Exact_Install");
+	EXPECT_EQ(best->Model->Description, u"Contoso Pad");
+	EXPECT_EQ(best->InfPath->filename(), "ranks.inf");
+	EXPECT_EQ(best->Inf->Provider, u"Contoso");
+}
+
+TEST_F(MatchCorpus, TiesGoToTheNewestDateThenTheHighestVersion)
+{
+	const auto matches = index_.match(std::vector<std::u16string_view>{u"ACME\\WIDGET"});
+
+	ASSERT_EQ(matches.size(), 4u);
+	EXPECT_EQ(matches[0].Model->InstallSection, u"Widget2025Update_Install");
+	EXPECT_EQ(matches[0].DriverDate, 20250301u);
+	EXPECT_EQ(matches[0].DriverVersion, 0x0001000200000000u);
+	EXPECT_EQ(matches[1].Model->InstallSection, u"Widget2025_Install");
+	EXPECT_EQ(matches[2].Model->InstallSection, u"Widget2024_Install");
+
+	// a malformed date counts as the oldest, whatever the version
+	EXPECT_EQ(matches[3].Model->InstallSection, u"WidgetUndated_Install");
+	EXPECT_EQ(matches[3].DriverDate, 0u);
+	EXPECT_EQ(matches[3].DriverVersion, 0x0007000000000000u);
+
+	for (const auto& match : matches)
+	{
+		EXPECT_EQ(match.Rank, 0u);
+	}
+}
+
+TEST_F(MatchCorpus, ModelsMatchingSeveralIdsAreListedOnceWithTheirBestRank)
+{
+	// Gadget_Install matches hardware to hardware, hardware to compatible and both ways from the
+	// device compatible ID; GadgetLegacy_Install only has the compatible ID
+	EXPECT_EQ(Match({u"ACME\\GADGET"}, {u"ACME\\GADGET_COMPAT", u"ACME\\GADGET"}),
+	          (std::vector<RankedModel>{{u"Gadget_Install", 0x0000}, {u"GadgetLegacy_Install", 0x3001}}));
+
+	// without the hardware ID the second entry of the model's list is the best it gets
+	EXPECT_EQ(Match({}, {u"ACME\\GADGET_COMPAT"}),
+	          (std::vector<RankedModel>{{u"GadgetLegacy_Install", 0x3001}, {u"Gadget_Install", 0x3001}}));
+}
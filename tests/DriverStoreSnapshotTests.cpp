@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DriverStoreSnapshot.hpp>
+
+
+using namespace nefarius::devcon;
+namespace fs = std::filesystem;
+
+namespace
+{
+	//
+	// Layout of the snapshot file, see DriverStoreSnapshot.cpp
+	//
+	constexpr size_t HeaderSize = 24;
+	constexpr size_t RecordSize = 28;
+
+	//
+	// An emulated store with three packages, oem0.inf to oem2.inf
+	//
+	class StoreSnapshot : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			scratch_ = fs::temp_directory_path() / ("neflib-" + std::string(
+				testing::UnitTest::GetInstance()->current_test_info()->name()));
+			fs::remove_all(scratch_);
+			fs::create_directories(scratch_ / "source");
+
+			auto store = DriverStoreEmulator::Open(scratch_ / "store");
+			ASSERT_TRUE(store);
+			store_.emplace(std::move(store.value()));
+
+			for (const char* name : {"a.inf", "b.inf", "c.inf"})
+			{
+				ASSERT_TRUE(store_->publish(Inf(name)));
+			}
+		}
+
+		void TearDown() override
+		{
+			std::error_code error;
+			fs::remove_all(scratch_, error);
+		}
+
+		fs::path Inf(const std::string& name, const std::string& version = "1.0.0.0") const
+		{
+			const fs::path path = scratch_ / "source" / name;
+			std::ofstream(path, std::ios::binary) << "[Version]\nClass=Net\nDriverVer=01/01/2026," << version << "\n";
+			return path;
+		}
+
+		DriverStoreSnapshot Capture()
+		{
+			auto snapshot = DriverStoreSnapshot::Capture(*store_);
+			EXPECT_TRUE(snapshot);
+			return std::move(snapshot.value());
+		}
+
+		std::vector<char> ReadFile(const fs::path& path) const
+		{
+			std::ifstream in(path, std::ios::binary);
+			return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+		}
+
+		void WriteFile(const fs::path& path, const std::vector<char>& bytes) const
+		{
+			std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(),
+				static_cast<std::streamsize>(bytes.size()));
+		}
+
+		static std::vector<std::wstring> Names(const std::vector<DriverStorePackage>& packages)
+		{
+			std::vector<std::wstring> names;
+
+			for (const auto& package : packages)
+			{
+				names.push_back(package.PublishedInfName);
+			}
+
+			return names;
+		}
+
+		fs::path scratch_;
+		std::optional<DriverStoreEmulator> store_;
+	};
+}
+
+TEST_F(StoreSnapshot, SavedSnapshotLoadsBack)
+{
+	const auto snapshot = Capture();
+
+	ASSERT_EQ(snapshot.size(), 3u);
+	EXPECT_EQ(snapshot[0].PublishedInfName, L"oem0.inf");
+	EXPECT_EQ(snapshot[2].PublishedInfName, L"oem2.inf");
+
+	const fs::path file = scratch_ / "store.snapshot";
+	ASSERT_TRUE(snapshot.save(file));
+	EXPECT_FALSE(fs::exists(scratch_ / "store.snapshot.tmp"));
+
+	const auto loaded = DriverStoreSnapshot::Load(file);
+
+	ASSERT_TRUE(loaded);
+	ASSERT_EQ(loaded->size(), snapshot.size());
+
+	for (size_t index = 0; index < snapshot.size(); index++)
+	{
+		EXPECT_EQ((*loaded)[index].DriverPackageInfPath, snapshot[index].DriverPackageInfPath);
+		EXPECT_EQ((*loaded)[index].PublishedInfName, snapshot[index].PublishedInfName);
+		EXPECT_EQ((*loaded)[index].ProcessorArchitecture, snapshot[index].ProcessorArchitecture);
+	}
+
+	EXPECT_TRUE(DiffDriverStore(snapshot, *loaded).empty());
+
+	// an empty snapshot round-trips as well
+	ASSERT_TRUE(DriverStoreSnapshot().save(file));
+	const auto empty = DriverStoreSnapshot::Load(file);
+	ASSERT_TRUE(empty);
+	EXPECT_TRUE(empty->empty());
+}
+
+TEST_F(StoreSnapshot, LoadRejectsDamagedFiles)
+{
+	const fs::path file = scratch_ / "store.snapshot";
+	ASSERT_TRUE(Capture().save(file));
+	const auto intact = ReadFile(file);
+	ASSERT_EQ(intact.size() % sizeof(wchar_t), 0u);
+
+	const auto expectCorrupt = [&](const std::vector<char>& bytes)
+	{
+		WriteFile(file, bytes);
+		const auto loaded = DriverStoreSnapshot::Load(file);
+
+		ASSERT_FALSE(loaded);
+		EXPECT_EQ(loaded.error(), std::make_error_code(std::errc::bad_message));
+	};
+
+	{
+		SCOPED_TRACE("bad magic");
+		auto bytes = intact;
+		bytes[7] = 'X';
+		expectCorrupt(bytes);
+	}
+
+	{
+		SCOPED_TRACE("truncated");
+		expectCorrupt(std::vector<char>(intact.begin(), intact.end() - sizeof(wchar_t)));
+		expectCorrupt(std::vector<char>(intact.begin(), intact.begin() + 10));
+	}
+
+	{
+		SCOPED_TRACE("trailing garbage");
+		auto bytes = intact;
+		bytes.insert(bytes.end(), sizeof(wchar_t), 'X');
+		expectCorrupt(bytes);
+	}
+
+	{
+		SCOPED_TRACE("unsorted records");
+		auto bytes = intact;
+		std::swap_ranges(bytes.begin() + HeaderSize, bytes.begin() + HeaderSize + RecordSize,
+		                 bytes.begin() + HeaderSize + RecordSize);
+		expectCorrupt(bytes);
+	}
+
+	EXPECT_EQ(DriverStoreSnapshot::Load(scratch_ / "missing.snapshot").error(),
+	          std::make_error_code(std::errc::no_such_file_or_directory));
+}
+
+TEST_F(StoreSnapshot, DiffReportsAddedRemovedAndChangedPackages)
+{
+	const auto before = Capture();
+
+	const auto b = before.find(L"oem1.inf");
+	ASSERT_TRUE(b);
+	const auto c = before.find(L"oem2.inf");
+	ASSERT_TRUE(c);
+
+	ASSERT_TRUE(store_->remove(b->materialize()));
+	ASSERT_TRUE(store_->remove(c->materialize()));
+
+	// reuses oem1.inf for a different package, then takes oem2.inf and oem3.inf
+	ASSERT_TRUE(store_->publish(Inf("d.inf")));
+	ASSERT_TRUE(store_->publish(Inf("e.inf")));
+	ASSERT_TRUE(store_->publish(Inf("f.inf")));
+	ASSERT_TRUE(store_->remove(Capture().find(L"oem2.inf")->materialize()));
+
+	const auto after = Capture();
+	const auto diff = DiffDriverStore(before, after);
+
+	EXPECT_EQ(Names(diff.Added), (std::vector<std::wstring>{L"oem3.inf"}));
+	EXPECT_EQ(Names(diff.Removed), (std::vector<std::wstring>{L"oem2.inf"}));
+	ASSERT_EQ(diff.Changed.size(), 1u);
+	EXPECT_EQ(diff.Changed[0].Old.PublishedInfName, L"oem1.inf");
+	EXPECT_EQ(fs::path(diff.Changed[0].Old.DriverPackageInfPath).filename(), "b.inf");
+	EXPECT_EQ(fs::path(diff.Changed[0].New.DriverPackageInfPath).filename(), "d.inf");
+
+	const auto reverse = DiffDriverStore(after, before);
+
+	EXPECT_EQ(Names(reverse.Added), (std::vector<std::wstring>{L"oem2.inf"}));
+	EXPECT_EQ(Names(reverse.Removed), (std::vector<std::wstring>{L"oem3.inf"}));
+	EXPECT_EQ(reverse.Changed.size(), 1u);
+
+	EXPECT_EQ(Names(DiffDriverStore(DriverStoreSnapshot(), after).Added),
+	          (std::vector<std::wstring>{L"oem0.inf", L"oem1.inf", L"oem3.inf"}));
+}
+
+TEST_F(StoreSnapshot, FindIgnoresCase)
+{
+	const auto snapshot = Capture();
+
+	const auto found = snapshot.find(L"OEM1.INF");
+
+	ASSERT_TRUE(found);
+	EXPECT_EQ(found->PublishedInfName, L"oem1.inf");
+	EXPECT_EQ(fs::path(found->DriverPackageInfPath).filename(), "b.inf");
+	EXPECT_FALSE(snapshot.find(L"oem3.inf"));
+	EXPECT_FALSE(snapshot.find(L"oem1"));
+	EXPECT_FALSE(DriverStoreSnapshot().find(L"oem0.inf"));
+
+	// spelled differently in the packages handed in, still one order
+	const auto mixed = DriverStoreSnapshot::FromPackages(std::vector<DriverStorePackage>{
+		{L"C:\\x\\b.inf", L"OEM10.inf"}, {L"C:\\x\\a.inf", L"oem1.INF"}, {L"C:\\x\\c.inf", L"Oem2.inf"}
+	});
+
+	ASSERT_EQ(mixed.size(), 3u);
+	EXPECT_EQ(mixed[0].PublishedInfName, L"oem1.INF");
+	EXPECT_EQ(mixed[1].PublishedInfName, L"OEM10.inf");
+	EXPECT_EQ(mixed.find(L"oem10.inf")->DriverPackageInfPath, L"C:\\x\\b.inf");
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/DriverStore.hpp>
+
+
+using namespace nefarius::devcon;
+namespace fs = std::filesystem;
+
+namespace
+{
+	class DriverStore : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			scratch_ = fs::temp_directory_path() / ("neflib-" + std::string(
+				testing::UnitTest::GetInstance()->current_test_info()->name()));
+			fs::remove_all(scratch_);
+			fs::create_directories(scratch_ / "source");
+		}
+
+		void TearDown() override
+		{
+			std::error_code error;
+			fs::remove_all(scratch_, error);
+		}
+
+		fs::path Inf(const std::string& name, const std::string& version = "1.0.0.0")
+		{
+			const fs::path path = scratch_ / "source" / name;
+			std::ofstream(path, std::ios::binary) << "[Version]\nClass=Net\nDriverVer=01/01/2026," << version << "\n";
+			return path;
+		}
+
+		std::vector<std::wstring> PublishedNames(DriverStoreEmulator& store)
+		{
+			std::vector<std::wstring> names;
+
+			EXPECT_TRUE(store.enumerate([&](const DriverStorePackageView& package)
+			{
+				names.emplace_back(package.PublishedInfName);
+				return true;
+			}));
+
+			std::ranges::sort(names);
+			return names;
+		}
+
+		fs::path scratch_;
+	};
+}
+
+TEST_F(DriverStore, PublishIsIdempotentAcrossSaveAndReopen)
+{
+	const fs::path inf = Inf("widget.inf");
+
+	{
+		// a root spelled with redundant components and a trailing separator
+		auto store = DriverStoreEmulator::Open(scratch_ / "other" / ".." / "store" / "");
+		ASSERT_TRUE(store);
+
+		const auto package = store->publish(inf);
+		ASSERT_TRUE(package);
+		EXPECT_EQ(package->PublishedInfName, L"oem0.inf");
+		EXPECT_EQ(package->DriverPackageInfPath, fs::path(package->DriverPackageInfPath).lexically_normal().wstring());
+		ASSERT_TRUE(store->save());
+	}
+
+	auto store = DriverStoreEmulator::Open(scratch_ / "store");
+	ASSERT_TRUE(store);
+	ASSERT_EQ(store->size(), 1u);
+
+	// read back from the index file with '/' separators, which mustn't hide the package on Windows
+	const auto again = store->publish(inf);
+	ASSERT_TRUE(again);
+	EXPECT_EQ(again->PublishedInfName, L"oem0.inf");
+	EXPECT_EQ(store->size(), 1u);
+	EXPECT_EQ(PublishedNames(*store), (std::vector<std::wstring>{L"oem0.inf"}));
+	EXPECT_FALSE(fs::exists(scratch_ / "store" / "INF" / "oem1.inf"));
+}
+
+TEST_F(DriverStore, RemoveAcceptsAnySpellingOfThePackagePath)
+{
+	auto store = DriverStoreEmulator::Open(scratch_ / "store");
+	ASSERT_TRUE(store);
+
+	auto package = store->publish(Inf("widget.inf"));
+	ASSERT_TRUE(package);
+
+	const fs::path path(package->DriverPackageInfPath);
+	package->DriverPackageInfPath = (path.parent_path() / ".." / path.parent_path().filename() / "." / path.filename()).
+		wstring();
+
+	EXPECT_TRUE(store->remove(*package));
+	EXPECT_EQ(store->size(), 0u);
+	EXPECT_FALSE(fs::exists(path));
+	EXPECT_FALSE(store->remove(*package));
+}
+
+TEST_F(DriverStore, FreedOemNumbersAreReused)
+{
+	auto store = DriverStoreEmulator::Open(scratch_ / "store");
+	ASSERT_TRUE(store);
+
+	const auto first = store->publish(Inf("a.inf"));
+	const auto second = store->publish(Inf("b.inf"));
+	const auto third = store->publish(Inf("c.inf"));
+	ASSERT_TRUE(first && second && third);
+
+	ASSERT_TRUE(store->remove(*second));
+	ASSERT_TRUE(store->save());
+
+	auto reopened = DriverStoreEmulator::Open(scratch_ / "store");
+	ASSERT_TRUE(reopened);
+
+	const auto fourth = reopened->publish(Inf("d.inf"));
+	ASSERT_TRUE(fourth);
+	EXPECT_EQ(fourth->PublishedInfName, L"oem1.inf");
+	EXPECT_EQ(PublishedNames(*reopened), (std::vector<std::wstring>{L"oem0.inf", L"oem1.inf", L"oem2.inf"}));
+}
+
+TEST_F(DriverStore, IndexMatchesPublishedPackages)
+{
+	auto store = DriverStoreEmulator::Open(scratch_ / "store");
+	ASSERT_TRUE(store);
+
+	const fs::path widget = Inf("widget.inf");
+	ASSERT_TRUE(store->publish(widget));
+	ASSERT_TRUE(store->publish(Inf("gadget.inf", "2.0.0.0")));
+
+	const auto index = DriverStoreIndex::Build(*store);
+	ASSERT_TRUE(index);
+
+	const auto matches = index->match(widget);
+	ASSERT_TRUE(matches);
+	ASSERT_EQ(matches->size(), 1u);
+	EXPECT_EQ(fs::path((*matches)[0]->DriverPackageInfPath).filename(), "widget.inf");
+}
@@ -0,0 +1,29 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/ErrorCatalog.hpp>
+
+
+using namespace nefarius::utilities::errors;
+
+TEST(ErrorCatalog, SetupApiCodes)
+{
+	EXPECT_EQ(FallbackSymbol(0xE000020B), "ERROR_NO_SUCH_DEVINST");
+	EXPECT_EQ(FallbackMessage(0xE000020B), "The device instance does not exist in the hardware tree.");
+
+	// the first and the last entry of the catalog
+	EXPECT_EQ(FallbackSymbol(0), "ERROR_SUCCESS");
+	EXPECT_EQ(FallbackMessage(0), "The operation completed successfully.");
+	EXPECT_EQ(FallbackSymbol(0xE000024C), "ERROR_DRIVER_STORE_DELETE_FAILED");
+	EXPECT_FALSE(FallbackMessage(0xE000024C).ends_with('\n'));
+}
+
+TEST(ErrorCatalog, UnknownCodesAreEmpty)
+{
+	for (const uint32_t code : {1u, 0xE000020Cu, 0xE00002FFu, 0xE000024Du, 0x8007000Eu, 0xFFFFFFFFu})
+	{
+		EXPECT_TRUE(FallbackMessage(code).empty()) << std::hex << code;
+		EXPECT_TRUE(FallbackSymbol(code).empty()) << std::hex << code;
+	}
+}
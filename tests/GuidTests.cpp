@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/Guid.hpp>
+
+
+using namespace nefarius::utilities;
+using namespace nefarius::utilities::literals;
+
+namespace
+{
+	constexpr Guid SystemClass{0x4d36e97d, 0xe325, 0x11ce, {0xbf, 0xc1, 0x08, 0x00, 0x2b, 0xe1, 0x03, 0x18}};
+
+	constexpr std::string_view SystemClassText = "4d36e97d-e325-11ce-bfc1-08002be10318";
+
+	//
+	// The scalar decoder alone; ParseGuid takes it in constant expressions and SSE2 at runtime
+	//
+	template <typename CharT>
+	std::optional<Guid> ParseScalar(std::basic_string_view<CharT> Text)
+	{
+		const auto core = detail::GuidCore(Text);
+		return core ? detail::ParseGuidScalar(*core) : std::nullopt;
+	}
+
+	template <typename CharT>
+	std::basic_string<CharT> Widen(std::string_view Text)
+	{
+		return std::basic_string<CharT>(Text.begin(), Text.end());
+	}
+
+	Guid RandomGuid(std::mt19937& random)
+	{
+		Guid guid{
+			static_cast<uint32_t>(random()), static_cast<uint16_t>(random()), static_cast<uint16_t>(random())
+		};
+
+		for (auto& byte : guid.Data4)
+		{
+			byte = static_cast<uint8_t>(random());
+		}
+
+		return guid;
+	}
+}
+
+static_assert(ParseGuid(SystemClassText) == SystemClass);
+static_assert(ParseGuid("{4D36E97D-E325-11CE-BFC1-08002BE10318}") == SystemClass);
+static_assert(!ParseGuid("{4d36e97d-e325-11ce-bfc1-08002be10318"));
+static_assert("{4d36e97d-e325-11ce-bfc1-08002be10318}"_guid == SystemClass);
+
+TEST(Guid, AcceptsBracedAndUnbracedFormsOfEitherCase)
+{
+	std::string upper(SystemClassText);
+	std::ranges::transform(upper, upper.begin(), [](char c)
+	{
+		return c >= 'a' && c <= 'f' ? static_cast<char>(c - 'a' + 'A') : c;
+	});
+
+	for (const std::string& text : {
+		     std::string(SystemClassText), upper, "{" + std::string(SystemClassText) + "}", "{" + upper + "}",
+		     std::string("4d36E97D-e325-11CE-bFc1-08002Be10318")
+	     })
+	{
+		SCOPED_TRACE(text);
+		EXPECT_EQ(ParseGuid(text), SystemClass);
+		EXPECT_EQ(ParseGuid(Widen<wchar_t>(text)), SystemClass);
+		EXPECT_EQ(ParseGuid<char8_t>(Widen<char8_t>(text)), SystemClass);
+		EXPECT_EQ(ParseGuid<char16_t>(Widen<char16_t>(text)), SystemClass);
+		EXPECT_EQ(ParseGuid<char32_t>(Widen<char32_t>(text)), SystemClass);
+	}
+}
+
+TEST(Guid, RejectsMalformedText)
+{
+	const std::string core(SystemClassText);
+
+	for (const std::string& text : {
+		     // wrong lengths
+		     std::string(), core.substr(1), core + "0", "{" + core, core + "}", "{" + core + "0}", "{{" + core + "}}",
+		     // hyphens moved or missing
+		     std::string("4d36e97de-325-11ce-bfc1-08002be10318"), std::string("4d36e97d-e32511ce-bfc1-08002be103180"),
+		     std::string("4d36e97d0e325011ce0bfc1008002be10318"),
+		     // mismatched or other braces
+		     "(" + core + ")", "{" + core + ")", "[" + core + "}", "}" + core + "{", "{" + core + "{",
+		     // not hex digits
+		     std::string("4d36e97g-e325-11ce-bfc1-08002be10318"), std::string("4d36e97d-e325-11ce-bfc1-08002be1031 "),
+		     std::string("+d36e97d-e325-11ce-bfc1-08002be10318"), std::string("4d36e97d-e325-11ce-bfc1-08002be1031:"),
+		     std::string("4d36e97d-e325-11ce-bfc1-08002be1031@"), std::string("4d36e97d-e325-11ce-bfc1-08002be1031`"),
+		     std::string("4d36e97d-e325-11ce-bfc1-08002be1031G"), std::string("4d36e97d-e325-11ce-bfc1-08002be10318\0", 37),
+		     std::string("4d36e97d-e325-11ce-bfc1-08002be1031\xC1", 36),
+	     })
+	{
+		SCOPED_TRACE(text);
+		EXPECT_FALSE(ParseGuid(text));
+		EXPECT_FALSE(ParseGuid(Widen<wchar_t>(text)));
+	}
+
+	// wide characters whose low byte is a hex digit, like U+0141 and U+FF21, aren't ASCII
+	for (const char32_t c : {U'Ł', U'١', U'Ａ', U'\U00010041'})
+	{
+		std::u32string wide = Widen<char32_t>(SystemClassText);
+		wide[35] = c;
+
+		EXPECT_FALSE(ParseGuid<char32_t>(wide)) << static_cast<uint32_t>(c);
+
+		if (c <= 0xFFFF)
+		{
+			std::u16string narrow = Widen<char16_t>(SystemClassText);
+			narrow[35] = static_cast<char16_t>(c);
+			EXPECT_FALSE(ParseGuid<char16_t>(narrow)) << static_cast<uint32_t>(c);
+		}
+	}
+}
+
+TEST(Guid, RuntimeParsingAgreesWithTheScalarDecoder)
+{
+	// every byte at every position, for the hex digits as well as the hyphens and braces
+	const std::string braced = "{" + std::string(SystemClassText) + "}";
+
+	for (size_t position = 0; position < braced.size(); ++position)
+	{
+		for (unsigned value = 0; value <= 0xFF; ++value)
+		{
+			std::string text = braced;
+			text[position] = static_cast<char>(value);
+
+			ASSERT_EQ(ParseGuid(text), ParseScalar<char>(text)) << position << " " << value;
+		}
+	}
+
+	// characters past the byte range
+	for (size_t position = 1; position + 1 < braced.size(); ++position)
+	{
+		for (const char32_t c : {U'0', U'İ', U'š', U'聁', U'\U00010066'})
+		{
+			std::u32string text = Widen<char32_t>(braced);
+			text[position] = c;
+
+			ASSERT_EQ(ParseGuid<char32_t>(text), ParseScalar<char32_t>(text)) << position;
+		}
+	}
+
+	// random GUIDs in random case
+	std::mt19937 random(42);
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		std::array<char, BracedGuidStringLength> text;
+		const Guid guid = RandomGuid(random);
+		FormatGuid(guid, text.data());
+
+		for (auto& c : text)
+		{
+			if (c >= 'a' && c <= 'f' && random() % 2)
+			{
+				c = static_cast<char>(c - 'a' + 'A');
+			}
+		}
+
+		const std::string_view view(text.data(), text.size());
+
+		ASSERT_EQ(ParseGuid(view), guid) << view;
+		ASSERT_EQ(ParseScalar(view), guid) << view;
+	}
+}
+
+TEST(Guid, Literals)
+{
+	constexpr auto narrow = "{745a17a0-74d3-11d0-b6fe-00a0c90f57da}"_guid;
+	constexpr auto wide = L"745A17A0-74D3-11D0-B6FE-00A0C90F57DA"_guid;
+
+	static_assert(narrow == wide);
+	static_assert(narrow.Data1 == 0x745a17a0 && narrow.Data2 == 0x74d3 && narrow.Data3 == 0x11d0);
+	static_assert(narrow.Data4 == std::array<uint8_t, 8>{0xb6, 0xfe, 0x00, 0xa0, 0xc9, 0x0f, 0x57, 0xda});
+
+	EXPECT_EQ(narrow, ParseGuid("745a17a0-74d3-11d0-b6fe-00a0c90f57da"));
+	EXPECT_EQ("4d36e97d-e325-11ce-bfc1-08002be10318"_guid, SystemClass);
+}
+
+TEST(Guid, FormattedGuidsParseBack)
+{
+	EXPECT_EQ(GuidToString(SystemClass), "{" + std::string(SystemClassText) + "}");
+	EXPECT_EQ(GuidToString(SystemClass, false), SystemClassText);
+	EXPECT_EQ(GuidToWString(SystemClass), L"{4d36e97d-e325-11ce-bfc1-08002be10318}");
+	EXPECT_EQ(GuidToString(Guid{}), "{00000000-0000-0000-0000-000000000000}");
+
+	std::mt19937 random(7);
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		const Guid guid = RandomGuid(random);
+
+		ASSERT_EQ(ParseGuid(GuidToString(guid)), guid);
+		ASSERT_EQ(ParseGuid(GuidToString(guid, false)), guid);
+		ASSERT_EQ(ParseGuid(GuidToWString(guid)), guid);
+
+		std::array<char16_t, BracedGuidStringLength> text;
+		const auto end = FormatGuid(guid, text.data(), false);
+
+		ASSERT_EQ(end - text.data(), static_cast<ptrdiff_t>(GuidStringLength));
+		ASSERT_EQ(ParseGuid(std::u16string_view(text.data(), GuidStringLength)), guid);
+	}
+
+	// formatting works in constant expressions too
+	constexpr auto formatted = []
+	{
+		std::array<char, BracedGuidStringLength> text{};
+		FormatGuid(SystemClass, text.data());
+		return text;
+	}();
+
+	static_assert(ParseGuid(std::string_view(formatted.data(), formatted.size())) == SystemClass);
+}
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/InfAnalysis.hpp>
+
+
+using namespace nefarius::devcon::inf;
+namespace fs = std::filesystem;
+
+namespace
+{
+	//
+	// A scratch directory tree, removed again when the test ends
+	//
+	class InfDirectory : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			root_ = fs::temp_directory_path() / ("neflib-" + std::string(
+				testing::UnitTest::GetInstance()->current_test_info()->name()));
+			fs::remove_all(root_);
+			fs::create_directories(root_);
+		}
+
+		void TearDown() override
+		{
+			std::error_code error;
+
+			for (const auto& entry : fs::recursive_directory_iterator(root_, error))
+			{
+				fs::permissions(entry.path(), fs::perms::owner_all, fs::perm_options::add, error);
+			}
+
+			fs::remove_all(root_, error);
+		}
+
+		void Write(const fs::path& relative, const std::string& content = "[Version]\nClass=Net\n")
+		{
+			fs::create_directories((root_ / relative).parent_path());
+			std::ofstream(root_ / relative, std::ios::binary) << content;
+		}
+
+		struct Delivered
+		{
+			std::vector<std::string> Analyzed;
+			std::vector<std::string> Errors;
+			InfBatchStats Stats;
+		};
+
+		Delivered Run(const InfBatchOptions& options = {})
+		{
+			Delivered delivered;
+
+			const auto stats = AnalyzeInfDirectory(root_, [&](const fs::path& path,
+			                                                  std::expected<InfAnalysis, std::error_code>&& result)
+			{
+				(result ? delivered.Analyzed : delivered.Errors).push_back(
+					path.lexically_relative(root_).generic_string());
+				return true;
+			}, options);
+
+			EXPECT_TRUE(stats);
+			delivered.Stats = stats.value_or(InfBatchStats{});
+			std::ranges::sort(delivered.Analyzed);
+			std::ranges::sort(delivered.Errors);
+			return delivered;
+		}
+
+		fs::path root_;
+	};
+}
+
+TEST_F(InfDirectory, Recursive)
+{
+	Write("a.inf");
+	Write("sub/b.inf");
+	Write("sub/deep/c.INF");
+	Write("sub/readme.txt");
+
+	const auto delivered = Run();
+
+	EXPECT_EQ(delivered.Analyzed, (std::vector<std::string>{"a.inf", "sub/b.inf", "sub/deep/c.INF"}));
+	EXPECT_EQ(delivered.Stats.Analyzed, 3u);
+	EXPECT_EQ(delivered.Stats.Failed, 0u);
+	EXPECT_EQ(delivered.Stats.Inaccessible, 0u);
+}
+
+TEST_F(InfDirectory, NonRecursiveDoesNotDescend)
+{
+	Write("a.inf");
+	Write("b.inf");
+	Write("sub/c.inf");
+
+	InfBatchOptions options;
+	options.Recursive = false;
+
+	EXPECT_EQ(Run(options).Analyzed, (std::vector<std::string>{"a.inf", "b.inf"}));
+}
+
+#if !defined(_WIN32)
+TEST_F(InfDirectory, InaccessibleSubdirectoryIsSkippedAndReported)
+{
+	Write("a.inf");
+	Write("locked/b.inf");
+	Write("z/c.inf");
+
+	fs::permissions(root_ / "locked", fs::perms::none);
+
+	if (std::error_code error; fs::directory_iterator(root_ / "locked", error), !error)
+	{
+		GTEST_SKIP() << "permissions aren't enforced for this user";
+	}
+
+	const auto delivered = Run();
+
+	EXPECT_EQ(delivered.Analyzed, (std::vector<std::string>{"a.inf", "z/c.inf"}));
+	EXPECT_EQ(delivered.Errors, (std::vector<std::string>{"locked"}));
+	EXPECT_EQ(delivered.Stats.Analyzed, 2u);
+	EXPECT_EQ(delivered.Stats.Inaccessible, 1u);
+}
+#endif
+
+TEST_F(InfDirectory, MissingDirectoryIsAnError)
+{
+	const auto stats = AnalyzeInfDirectory(root_ / "missing", [](const fs::path&, auto&&) { return true; });
+
+	ASSERT_FALSE(stats);
+	EXPECT_EQ(stats.error(), std::errc::no_such_file_or_directory);
+}
+
+TEST(InfAnalysis, Corpus)
+{
+	const auto stats = AnalyzeInfDirectory(fs::path(NEFLIB_TEST_DATA_DIR) / "inf",
+	                                       [&](const fs::path&, std::expected<InfAnalysis, std::error_code>&& result)
+	                                       {
+		                                       EXPECT_TRUE(result);
+		                                       return true;
+	                                       });
+
+	ASSERT_TRUE(stats);
+	EXPECT_EQ(stats->Analyzed, 5u);
+	EXPECT_EQ(stats->Failed, 0u);
+}
+
+namespace
+{
+	InfAnalysis AnalyzeText(std::string_view text, const std::optional<nefarius::utilities::Guid>& namedClassGuid = {})
+	{
+		const auto inf = InfFile::FromBuffer(std::as_bytes(std::span(text.data(), text.size())));
+		EXPECT_TRUE(inf);
+		return AnalyzeInf(*inf, InfPlatformTarget::Host(), namedClassGuid);
+	}
+
+	constexpr std::string_view UpperFilterInstall =
+		"[DefaultInstall]\nAddReg=Filter_AddReg\n\n"
+		"[Filter_AddReg]\nHKR,,UpperFilters,0x00010008,Widget\n";
+}
+
+TEST(InfAnalysis, HkrTargetsTheClassNamedWithoutClassGuid)
+{
+	const auto analysis = AnalyzeText(std::string("[Version]\nClass=hidclass\n\n").append(UpperFilterInstall));
+	const auto hidClass = nefarius::utilities::ParseGuid("{745a17a0-74d3-11d0-b6fe-00a0c90f57da}");
+
+	EXPECT_EQ(analysis.ClassGuid, hidClass);
+	ASSERT_EQ(analysis.FilterTargets.size(), 1u);
+	EXPECT_EQ(analysis.FilterTargets[0].ClassGuid, *hidClass);
+	EXPECT_EQ(analysis.FilterTargets[0].Position, InfFilterPosition::Upper);
+	EXPECT_EQ(analysis.FilterTargets[0].ServiceName, u"Widget");
+}
+
+TEST(InfAnalysis, ClassGuidTakesPrecedenceOverTheClassName)
+{
+	const auto analysis = AnalyzeText(
+		std::string("[Version]\nClass=HIDClass\nClassGuid={4d36e97d-e325-11ce-bfc1-08002be10318}\n\n").
+		append(UpperFilterInstall));
+
+	ASSERT_EQ(analysis.FilterTargets.size(), 1u);
+	EXPECT_EQ(analysis.FilterTargets[0].ClassGuid, *SystemSetupClassGuid(u"System"));
+}
+
+TEST(InfAnalysis, CustomClassNameNeedsItsRegisteredGuid)
+{
+	const std::string text = std::string("[Version]\nClass=ContosoWidgets\nClassGuid=malformed\n\n").
+		append(UpperFilterInstall);
+	const auto registered = nefarius::utilities::ParseGuid("{01234567-89ab-cdef-0123-456789abcdef}");
+
+	EXPECT_FALSE(SystemSetupClassGuid(u"ContosoWidgets"));
+	EXPECT_TRUE(AnalyzeText(text).FilterTargets.empty());
+
+	const auto analysis = AnalyzeText(text, registered);
+
+	EXPECT_EQ(analysis.ClassGuid, registered);
+	ASSERT_EQ(analysis.FilterTargets.size(), 1u);
+	EXPECT_EQ(analysis.FilterTargets[0].ClassGuid, *registered);
+}
@@ -0,0 +1,197 @@
+#include <cstdlib>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/InfFile.hpp>
+
+
+using namespace nefarius::devcon::inf;
+
+namespace
+{
+	InfFile Load(const char* name, const InfOpenOptions& options = {})
+	{
+		auto inf = InfFile::Open(std::filesystem::path(NEFLIB_TEST_DATA_DIR) / "inf" / name, options);
+
+		if (!inf)
+		{
+			ADD_FAILURE() << name << ": " << inf.error().message();
+			std::abort();
+		}
+
+		return std::move(*inf);
+	}
+
+	std::vector<std::u16string> Fields(const InfLine& line)
+	{
+		std::vector<std::u16string> fields;
+
+		for (size_t i = 1; i <= line.field_count(); i++)
+		{
+			fields.emplace_back(line.field(i));
+		}
+
+		return fields;
+	}
+
+	std::u16string Value(const InfFile& inf, std::u16string_view section, std::u16string_view key)
+	{
+		return std::u16string(inf.value(section, key).value_or(u"<missing>"));
+	}
+
+	InfFile FromText(std::string_view text)
+	{
+		return std::move(*InfFile::FromBuffer(std::as_bytes(std::span(text.data(), text.size()))));
+	}
+}
+
+TEST(InfFile, Utf16LeWithBom)
+{
+	const auto inf = Load("vigembus.inf");
+
+	EXPECT_EQ(inf.encoding(), InfEncoding::Utf16LE);
+	EXPECT_EQ(Value(inf, u"Version", u"ClassGuid"), u"{4D36E97D-E325-11CE-BFC1-08002BE10318}");
+	EXPECT_EQ(Value(inf, u"Version", u"Provider"), u"Nefarius Software Solutions e.U.");
+	EXPECT_EQ(Value(inf, u"ViGEmBus_Service_Inst", u"StartType"), u"3");
+	EXPECT_EQ(Value(inf, u"ViGEmBus_Service_Inst", u"ServiceBinary"), u"%12%\\ViGEmBus.sys");
+
+	const auto models = inf.section(u"standard.ntamd64");
+
+	ASSERT_TRUE(models);
+	ASSERT_EQ(models->size(), 1u);
+	EXPECT_EQ((*models->begin()).key(), u"Virtual Gamepad Emulation Bus");
+	EXPECT_EQ(Fields(*models->begin()), (std::vector<std::u16string>{u"ViGEmBus_Device", u"Nefarius\\ViGEmBus\\Gen1"}));
+}
+
+TEST(InfFile, Utf8WithoutBom)
+{
+	const auto inf = Load("hidhide.inf");
+
+	EXPECT_EQ(inf.encoding(), InfEncoding::Utf8);
+	EXPECT_EQ(inf.string(u"HidHide.DeviceDesc"), u"HidHide Device");
+
+	const auto filter = inf.section(u"HidHide_AddReg");
+
+	ASSERT_TRUE(filter);
+	EXPECT_EQ(Fields(*filter->begin()),
+	          (std::vector<std::u16string>{u"HKR", u"", u"UpperFilters", u"0x00010008", u"HidHide"}));
+}
+
+TEST(InfFile, LanguageSpecificStrings)
+{
+	const auto inf = Load("hidhide.inf", InfOpenOptions{0x0407});
+
+	EXPECT_EQ(inf.string(u"HidHide.DeviceDesc"), u"HidHide Gerätefilter für Eingabegeräte");
+	EXPECT_EQ(inf.string(u"ManufacturerName"), u"Nefarius Software Solutions e.U.");
+}
+
+TEST(InfFile, Utf8WithBom)
+{
+	const auto inf = Load("utf8-bom.inf");
+
+	EXPECT_EQ(inf.encoding(), InfEncoding::Utf8);
+	EXPECT_EQ(Value(inf, u"Version", u"Signature"), u"$Windows NT$");
+	EXPECT_EQ(Value(inf, u"Version", u"Provider"), u"Ünïcödé Drivers ™");
+	EXPECT_EQ(inf.string(u"DeviceDesc"), u"USB ☃ Controller");
+}
+
+TEST(InfFile, AnsiIsWindows1252)
+{
+	const auto inf = Load("legacy-ansi.inf");
+
+	EXPECT_EQ(inf.encoding(), InfEncoding::Ansi);
+	EXPECT_EQ(Value(inf, u"Version", u"Provider"), u"Gerätebau GmbH © 2005");
+	EXPECT_EQ(inf.string(u"Price"), u"€ 20");
+}
+
+TEST(InfFile, DetectsBomLessUtf16AndBigEndian)
+{
+	const std::u16string text = u"[Version]\r\nClass=Net\r\n";
+	std::string little, big;
+
+	for (const char16_t c : text)
+	{
+		little += {static_cast<char>(c & 0xFF), static_cast<char>(c >> 8)};
+		big += {static_cast<char>(c >> 8), static_cast<char>(c & 0xFF)};
+	}
+
+	const auto bomLess = FromText(little);
+	const auto bigEndian = FromText("\xFE\xFF" + big);
+
+	EXPECT_EQ(bomLess.encoding(), InfEncoding::Utf16LE);
+	EXPECT_EQ(Value(bomLess, u"Version", u"Class"), u"Net");
+	EXPECT_EQ(bigEndian.encoding(), InfEncoding::Utf16BE);
+	EXPECT_EQ(Value(bigEndian, u"Version", u"Class"), u"Net");
+}
+
+TEST(InfFile, PureAsciiIsAnsi)
+{
+	EXPECT_EQ(FromText("[Version]\nClass=Net\n").encoding(), InfEncoding::Ansi);
+}
+
+TEST(InfFile, LineContinuations)
+{
+	const auto inf = Load("continuations.inf");
+	const auto install = inf.section(u"Install");
+
+	ASSERT_TRUE(install);
+
+	const auto copyFiles = install->find(u"CopyFiles");
+
+	ASSERT_TRUE(copyFiles);
+	EXPECT_EQ(Fields(*copyFiles), (std::vector<std::u16string>{u"First_Files", u"Second_Files", u"Third_Files"}));
+	EXPECT_EQ(copyFiles->line_number(), 8u);
+
+	// a comment may follow the backslash
+	EXPECT_EQ(Fields(*install->find(u"AddReg")), (std::vector<std::u16string>{u"Reg1", u"Reg2"}));
+
+	// a continuation inside a field joins both halves
+	EXPECT_EQ(Value(inf, u"Install", u"Split"), u"abcdef");
+
+	// the line after the continued ones is numbered after them
+	EXPECT_EQ(install->find(u"Empty")->line_number(), 20u);
+}
+
+TEST(InfFile, StringKeyExpansion)
+{
+	const auto inf = Load("continuations.inf");
+
+	EXPECT_EQ(Value(inf, u"Version", u"Provider"), u"Contoso");
+	EXPECT_EQ(Value(inf, u"Install", u"Description"), u"Widget %Company% for Contoso");
+	EXPECT_EQ(Value(inf, u"Install", u"Percent"), u"100% done");
+	EXPECT_EQ(Value(inf, u"Install", u"Unknown"), u"%NoSuchKey%");
+	EXPECT_EQ(Value(inf, u"Install", u"Mixed"), u"Widget %Company% and more");
+
+	// [Strings] values themselves aren't expanded
+	EXPECT_EQ(inf.string(u"product"), u"Widget %Company%");
+
+	const auto description = inf.section(u"Install")->find(u"Description");
+
+	EXPECT_EQ(description->raw_field(1), u"%Product% for %Company%");
+}
+
+TEST(InfFile, Quoting)
+{
+	const auto inf = Load("continuations.inf");
+	const auto quoted = inf.section(u"Install")->find(u"Quoted");
+
+	ASSERT_TRUE(quoted);
+	EXPECT_EQ(Fields(*quoted), (std::vector<std::u16string>{u"a, b; c", u"say \"hi\""}));
+
+	const auto empty = inf.section(u"Install")->find(u"Empty");
+
+	EXPECT_EQ(Fields(*empty), (std::vector<std::u16string>{u"", u"", u"x"}));
+}
+
+TEST(InfFile, MissingFile)
+{
+	const auto inf = InfFile::Open(std::filesystem::path(NEFLIB_TEST_DATA_DIR) / "inf" / "does-not-exist.inf");
+
+	ASSERT_FALSE(inf);
+	EXPECT_EQ(inf.error(), std::errc::no_such_file_or_directory);
+}
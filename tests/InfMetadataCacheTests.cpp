@@ -0,0 +1,301 @@
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/InfMetadataCache.hpp>
+
+
+using namespace nefarius::devcon::inf;
+using namespace std::chrono_literals;
+namespace fs = std::filesystem;
+
+namespace
+{
+	//
+	// A scratch directory with a copy of hidhide.inf and a cache file next to it
+	//
+	class CachedInf : public testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			root_ = fs::temp_directory_path() / ("neflib-" + std::string(
+				testing::UnitTest::GetInstance()->current_test_info()->name()));
+			fs::remove_all(root_);
+			fs::create_directories(root_);
+
+			inf_ = root_ / "hidhide.inf";
+			cacheFile_ = root_ / "inf.cache";
+			fs::copy_file(fs::path(NEFLIB_TEST_DATA_DIR) / "inf" / "hidhide.inf", inf_);
+		}
+
+		void TearDown() override
+		{
+			std::error_code error;
+			fs::remove_all(root_, error);
+		}
+
+		InfMetadataCache Open(const InfMetadataCacheOptions& options = {}) const
+		{
+			auto cache = InfMetadataCache::Open(cacheFile_, options);
+			EXPECT_TRUE(cache);
+			return std::move(cache.value());
+		}
+
+		//
+		// Fills the cache file with the analysis of the INF
+		//
+		InfAnalysis Populate(const InfMetadataCacheOptions& options = {}) const
+		{
+			auto cache = Open(options);
+			auto analysis = cache.lookup(inf_);
+
+			EXPECT_TRUE(analysis);
+			EXPECT_TRUE(cache.save());
+			EXPECT_TRUE(fs::exists(cacheFile_));
+			return std::move(analysis.value());
+		}
+
+		std::vector<char> ReadCacheFile() const
+		{
+			std::ifstream in(cacheFile_, std::ios::binary);
+			return {std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+		}
+
+		void WriteCacheFile(const std::vector<char>& bytes) const
+		{
+			std::ofstream(cacheFile_, std::ios::binary | std::ios::trunc).write(bytes.data(),
+				static_cast<std::streamsize>(bytes.size()));
+		}
+
+		void Touch() const
+		{
+			fs::last_write_time(inf_, fs::last_write_time(inf_) + 1h);
+		}
+
+		fs::path root_;
+		fs::path inf_;
+		fs::path cacheFile_;
+	};
+
+	void ExpectSameAnalysis(const InfAnalysis& actual, const InfAnalysis& expected)
+	{
+		EXPECT_EQ(actual.ClassGuid, expected.ClassGuid);
+		EXPECT_EQ(actual.ClassName, expected.ClassName);
+		EXPECT_EQ(actual.Provider, expected.Provider);
+		EXPECT_EQ(actual.DriverDate, expected.DriverDate);
+		EXPECT_EQ(actual.DriverVersion, expected.DriverVersion);
+		ASSERT_EQ(actual.FilterTargets.size(), expected.FilterTargets.size());
+
+		for (size_t index = 0; index < actual.FilterTargets.size(); index++)
+		{
+			EXPECT_EQ(actual.FilterTargets[index].ClassGuid, expected.FilterTargets[index].ClassGuid);
+			EXPECT_EQ(actual.FilterTargets[index].Position, expected.FilterTargets[index].Position);
+			EXPECT_EQ(actual.FilterTargets[index].ServiceName, expected.FilterTargets[index].ServiceName);
+		}
+
+		ASSERT_EQ(actual.Models.size(), expected.Models.size());
+
+		for (size_t index = 0; index < actual.Models.size(); index++)
+		{
+			EXPECT_EQ(actual.Models[index].Description, expected.Models[index].Description);
+			EXPECT_EQ(actual.Models[index].InstallSection, expected.Models[index].InstallSection);
+			EXPECT_EQ(actual.Models[index].HardwareIds, expected.Models[index].HardwareIds);
+		}
+	}
+}
+
+TEST_F(CachedInf, UnchangedFileIsAHit)
+{
+	auto cache = Open();
+
+	const auto first = cache.lookup(inf_);
+	const auto second = cache.lookup(inf_);
+
+	ASSERT_TRUE(first);
+	ASSERT_TRUE(second);
+	EXPECT_EQ(first->Provider, u"Nefarius Software Solutions e.U.");
+	EXPECT_FALSE(first->Models.empty());
+	ExpectSameAnalysis(*second, *first);
+	EXPECT_EQ(cache.stats().Misses, 1u);
+	EXPECT_EQ(cache.stats().Hits, 1u);
+}
+
+TEST_F(CachedInf, SavedEntriesSurviveReopening)
+{
+	const auto expected = Populate();
+	auto cache = Open();
+	const auto analysis = cache.lookup(inf_);
+
+	ASSERT_TRUE(analysis);
+	ExpectSameAnalysis(*analysis, expected);
+	EXPECT_EQ(cache.stats().Hits, 1u);
+	EXPECT_EQ(cache.stats().Misses, 0u);
+
+	// nothing changed, so nothing is written
+	const auto written = fs::last_write_time(cacheFile_);
+	EXPECT_TRUE(cache.save());
+	EXPECT_EQ(fs::last_write_time(cacheFile_), written);
+}
+
+TEST_F(CachedInf, SizeOrTimeChangeReparses)
+{
+	Populate();
+
+	Touch();
+	auto touched = Open();
+	ASSERT_TRUE(touched.lookup(inf_));
+	EXPECT_EQ(touched.stats().Misses, 1u);
+
+	std::ofstream(inf_, std::ios::binary | std::ios::app) << "\r\n; appended\r\n";
+	auto grown = Open();
+	ASSERT_TRUE(grown.lookup(inf_));
+	EXPECT_EQ(grown.stats().Misses, 1u);
+
+	// the reparsed entry is a hit from then on
+	ASSERT_TRUE(grown.lookup(inf_));
+	EXPECT_EQ(grown.stats().Hits, 1u);
+}
+
+TEST_F(CachedInf, ContentHashKeepsTouchedEntries)
+{
+	InfMetadataCacheOptions options;
+	options.Validation = InfCacheValidation::ContentHash;
+
+	Populate(options);
+	Touch();
+
+	{
+		auto cache = Open(options);
+		ASSERT_TRUE(cache.lookup(inf_));
+		EXPECT_EQ(cache.stats().Hits, 1u);
+		EXPECT_EQ(cache.stats().Misses, 0u);
+		EXPECT_TRUE(cache.save());
+	}
+
+	// the new write time was recorded, so this is a plain hit
+	auto cache = Open(options);
+	ASSERT_TRUE(cache.lookup(inf_));
+	EXPECT_EQ(cache.stats().Hits, 1u);
+
+	// same size, different content
+	std::ifstream in(inf_, std::ios::binary);
+	std::string text{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+	in.close();
+	text[text.find("HidHide")] = 'X';
+	const auto time = fs::last_write_time(inf_);
+	std::ofstream(inf_, std::ios::binary | std::ios::trunc) << text;
+	fs::last_write_time(inf_, time + 1h);
+
+	ASSERT_TRUE(cache.lookup(inf_));
+	EXPECT_EQ(cache.stats().Misses, 1u);
+}
+
+TEST_F(CachedInf, InvalidatedEntriesAreReparsedAndDropped)
+{
+	Populate();
+
+	{
+		auto cache = Open();
+		cache.invalidate(inf_);
+		ASSERT_TRUE(cache.lookup(inf_));
+		EXPECT_EQ(cache.stats().Misses, 1u);
+
+		cache.invalidate(inf_);
+		EXPECT_TRUE(cache.save());
+	}
+
+	auto cache = Open();
+	ASSERT_TRUE(cache.lookup(inf_));
+	EXPECT_EQ(cache.stats().Misses, 1u);
+}
+
+TEST_F(CachedInf, DeletedInfsAreDroppedOnSave)
+{
+	Populate();
+	const auto populated = fs::file_size(cacheFile_);
+
+	fs::remove(inf_);
+
+	auto cache = Open();
+	EXPECT_FALSE(cache.lookup(inf_));
+
+	// saving is only triggered by a change
+	cache.invalidate(root_ / "other.inf");
+	EXPECT_TRUE(cache.save());
+	EXPECT_LT(fs::file_size(cacheFile_), populated);
+}
+
+TEST_F(CachedInf, DamagedCacheFilesAreDiscarded)
+{
+	Populate();
+	const auto intact = ReadCacheFile();
+
+	const auto expectMiss = [this](const InfMetadataCacheOptions& options = {})
+	{
+		auto cache = Open(options);
+		const auto analysis = cache.lookup(inf_);
+
+		ASSERT_TRUE(analysis);
+		EXPECT_EQ(analysis->Provider, u"Nefarius Software Solutions e.U.");
+		EXPECT_EQ(cache.stats().Hits, 0u);
+		EXPECT_EQ(cache.stats().Misses, 1u);
+	};
+
+	{
+		SCOPED_TRACE("truncated");
+		WriteCacheFile(std::vector<char>(intact.begin(), intact.end() - 2));
+		expectMiss();
+	}
+
+	{
+		SCOPED_TRACE("shorter than the header");
+		WriteCacheFile(std::vector<char>(intact.begin(), intact.begin() + 20));
+		expectMiss();
+	}
+
+	{
+		SCOPED_TRACE("bad magic");
+		auto bytes = intact;
+		bytes[0] = 'X';
+		WriteCacheFile(bytes);
+		expectMiss();
+	}
+
+	{
+		SCOPED_TRACE("string out of range");
+		auto bytes = intact;
+		// offset of the path of the first entry: header (52 bytes), KeyHash and Flags
+		constexpr uint32_t offset = 0xFFFFFFF0;
+		std::memcpy(bytes.data() + 52 + 8, &offset, sizeof(offset));
+		WriteCacheFile(bytes);
+		expectMiss();
+	}
+
+	{
+		SCOPED_TRACE("other target");
+		WriteCacheFile(intact);
+
+		InfMetadataCacheOptions options;
+		options.Target.Architecture = InfPlatformTarget::Host().Architecture == InfArchitecture::X86
+			                              ? InfArchitecture::Amd64
+			                              : InfArchitecture::X86;
+		expectMiss(options);
+
+		InfMetadataCacheOptions language;
+		language.Open.LanguageId = 0x0407;
+		expectMiss(language);
+	}
+
+	// the intact file is still good
+	WriteCacheFile(intact);
+	auto cache = Open();
+	ASSERT_TRUE(cache.lookup(inf_));
+	EXPECT_EQ(cache.stats().Hits, 1u);
+}
@@ -0,0 +1,460 @@
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/MultiStringArray.hpp>
+#include <nefarius/neflib/MultiStringSet.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
+
+
+using namespace nefarius::utilities;
+using namespace std::string_view_literals;
+
+namespace
+{
+	//
+	// Copies the buffer to a heap block of exactly its size, so AddressSanitizer catches any read
+	// past the end
+	//
+	template <typename CharT>
+	std::unique_ptr<CharT[]> ExactCopy(std::basic_string_view<CharT> buffer)
+	{
+		auto copy = std::make_unique<CharT[]>(buffer.size());
+		std::copy(buffer.begin(), buffer.end(), copy.get());
+		return copy;
+	}
+
+	template <typename CharT>
+	std::vector<std::basic_string<CharT>> Entries(MultiStringView<CharT> view)
+	{
+		return std::vector<std::basic_string<CharT>>(view.begin(), view.end());
+	}
+
+	//
+	// The straightforward reading of a REG_MULTI_SZ buffer: entries up to the first empty one or
+	// the end of the buffer; well-formed if that end is marked by a NUL inside the buffer
+	//
+	struct ReferenceParse
+	{
+		std::vector<std::string> Entries;
+		bool WellFormed = false;
+	};
+
+	ReferenceParse Parse(std::string_view buffer)
+	{
+		ReferenceParse result;
+		size_t pos = 0;
+
+		while (pos < buffer.size())
+		{
+			const size_t terminator = buffer.find('\0', pos);
+
+			if (terminator == pos)
+			{
+				result.WellFormed = true;
+				return result;
+			}
+
+			if (terminator == std::string_view::npos)
+			{
+				result.Entries.emplace_back(buffer.substr(pos));
+				return result;
+			}
+
+			result.Entries.emplace_back(buffer.substr(pos, terminator - pos));
+			pos = terminator + 1;
+		}
+
+		return result;
+	}
+
+	//
+	// Buffers over a tiny alphabet, so NULs, empty entries and case variants are frequent
+	//
+	std::string RandomBuffer(std::mt19937& rng, size_t maxLength)
+	{
+		static constexpr char alphabet[] = {'\0', '\0', 'a', 'A', 'b', 'B', 'c'};
+
+		std::string buffer(std::uniform_int_distribution<size_t>(0, maxLength)(rng), '\0');
+
+		for (auto& c : buffer)
+		{
+			c = alphabet[std::uniform_int_distribution<size_t>(0, std::size(alphabet) - 1)(rng)];
+		}
+
+		return buffer;
+	}
+
+	std::string RandomEntry(std::mt19937& rng)
+	{
+		// may contain NULs or be empty on purpose
+		return RandomBuffer(rng, 4);
+	}
+
+	std::string EntryOf(const std::string& value)
+	{
+		return value.substr(0, value.find('\0'));
+	}
+}
+
+TEST(MultiStringView, EmptyAndNullBuffers)
+{
+	EXPECT_TRUE(NarrowMultiStringView().empty());
+	EXPECT_TRUE(NarrowMultiStringView(nullptr, 0).empty());
+	EXPECT_TRUE(NarrowMultiStringView("\0\0", 2).empty());
+	EXPECT_TRUE(NarrowMultiStringView("\0\0", 2).is_well_formed());
+	EXPECT_FALSE(NarrowMultiStringView(nullptr, 0).is_well_formed());
+}
+
+TEST(MultiStringView, WellFormedList)
+{
+	constexpr auto buffer = "USB\\VID_1234\0USB\\VID_1234&PID_5678\0\0"sv;
+	const NarrowMultiStringView view(buffer.data(), buffer.size());
+
+	EXPECT_EQ(Entries(view), (std::vector<std::string>{"USB\\VID_1234", "USB\\VID_1234&PID_5678"}));
+	EXPECT_TRUE(view.is_well_formed());
+	EXPECT_TRUE(view.contains("USB\\VID_1234"));
+	EXPECT_FALSE(view.contains("USB"));
+}
+
+TEST(MultiStringView, UnterminatedLastEntry)
+{
+	const auto buffer = ExactCopy("first\0second"sv);
+	const NarrowMultiStringView view(buffer.get(), 12);
+
+	EXPECT_EQ(Entries(view), (std::vector<std::string>{"first", "second"}));
+	EXPECT_FALSE(view.is_well_formed());
+}
+
+TEST(MultiStringView, MissingListTerminator)
+{
+	const auto buffer = ExactCopy("first\0"sv);
+	const NarrowMultiStringView view(buffer.get(), 6);
+
+	EXPECT_EQ(Entries(view), (std::vector<std::string>{"first"}));
+	EXPECT_FALSE(view.is_well_formed());
+}
+
+TEST(MultiStringView, EmptyEntryEndsTheList)
+{
+	constexpr auto buffer = "a\0\0b\0\0"sv;
+	const NarrowMultiStringView view(buffer.data(), buffer.size());
+
+	EXPECT_EQ(Entries(view), (std::vector<std::string>{"a"}));
+	EXPECT_TRUE(view.is_well_formed());
+}
+
+TEST(MultiStringView, FromBytesDropsPartialCharacters)
+{
+	constexpr char16_t buffer[] = u"ab\0c\0";
+
+	// one byte short of the list terminator, the odd byte is dropped
+	const auto view = MultiStringView<char16_t>::from_bytes(buffer, sizeof(buffer) - 1);
+
+	EXPECT_EQ(view.chars(), 5u);
+	EXPECT_EQ(Entries(view), (std::vector<std::u16string>{u"ab", u"c"}));
+	EXPECT_FALSE(view.is_well_formed());
+}
+
+TEST(MultiStringArray, RawBufferIsNeverReadPastItsLength)
+{
+	const auto buffer = ExactCopy("one\0two"sv);
+	NarrowMultiStringArray array(buffer.get(), 7);
+
+	EXPECT_FALSE(array.is_well_formed());
+	EXPECT_EQ(array.count(), 2u);
+	EXPECT_EQ(array.to_vector(), (std::vector<std::string>{"one", "two"}));
+
+	// editing repairs the termination
+	array.push_back("three");
+
+	EXPECT_TRUE(array.is_well_formed());
+	EXPECT_EQ(array.to_vector(), (std::vector<std::string>{"one", "two", "three"}));
+}
+
+TEST(MultiStringArray, EmbeddedNulsAndEmptyStrings)
+{
+	const std::vector<std::string> strings{"a", std::string("b\0hidden", 8), "", "c"};
+	const NarrowMultiStringArray array(strings);
+
+	EXPECT_TRUE(array.is_well_formed());
+	EXPECT_EQ(array.to_vector(), (std::vector<std::string>{"a", "b", "c"}));
+	EXPECT_EQ(std::string_view(array.c_str(), array.chars()), "a\0b\0c\0\0"sv);
+
+	const NarrowMultiStringArray single(std::string("x\0y", 3));
+
+	EXPECT_EQ(std::string_view(single.c_str(), single.chars()), "x\0\0"sv);
+}
+
+TEST(MultiStringArray, EmptyListIsTwoNuls)
+{
+	const NarrowMultiStringArray fromVector(std::vector<std::string>{});
+
+	EXPECT_EQ(std::string_view(fromVector.c_str(), fromVector.chars()), "\0\0"sv);
+
+	NarrowMultiStringArray edited(std::vector<std::string>{"only"});
+	edited.erase("only");
+
+	EXPECT_EQ(std::string_view(edited.c_str(), edited.chars()), "\0\0"sv);
+	EXPECT_TRUE(edited.is_well_formed());
+}
+
+TEST(MultiStringArray, Editing)
+{
+	NarrowMultiStringArray array(std::vector<std::string>{"b", "d"});
+
+	array.insert_at(0, "a");
+	array.insert_at(2, "c");
+	array.insert_at(100, "e");
+
+	EXPECT_EQ(array.to_vector(), (std::vector<std::string>{"a", "b", "c", "d", "e"}));
+	EXPECT_TRUE(array.replace("c", "see"));
+	EXPECT_FALSE(array.replace("x", "y"));
+	EXPECT_EQ(array.erase_if([](std::string_view entry) { return entry.size() == 1 && entry < "c"; }), 2u);
+	EXPECT_EQ(array.to_vector(), (std::vector<std::string>{"see", "d", "e"}));
+	EXPECT_TRUE(array.is_well_formed());
+}
+
+TEST(MultiStringArray, DedupeCaseInsensitiveKeepsFirstSpelling)
+{
+	MultiStringArray<char16_t> array(std::vector<std::u16string>{
+		u"ROOT\\HidGuardian", u"upperfilter", u"root\\hidguardian", u"UpperFilter", u"Straße",
+		u"STRAßE", u"İ"
+	});
+
+	EXPECT_EQ(array.dedupe_case_insensitive(), 3u);
+	EXPECT_EQ(array.to_vector(), (std::vector<std::u16string>{
+		          u"ROOT\\HidGuardian", u"upperfilter", u"Straße", u"İ"}));
+	EXPECT_TRUE(array.is_well_formed());
+}
+
+TEST(MultiStringArray, DedupeLargeListMatchesSet)
+{
+	std::vector<std::string> ids;
+
+	// colliding spellings of 2500 IDs spread over 10000 entries
+	for (int i = 0; i < 10000; i++)
+	{
+		std::string id = "USB\\VID_045E&PID_" + std::to_string(i % 2500);
+
+		if (i % 3 == 1)
+		{
+			std::ranges::transform(id, id.begin(), [](char c) { return c >= 'A' && c <= 'Z' ? c + 32 : c; });
+		}
+
+		ids.push_back(std::move(id));
+	}
+
+	NarrowMultiStringArray array(ids);
+	const MultiStringSet<char> set(NarrowMultiStringView(array.c_str(), array.chars()));
+
+	EXPECT_EQ(array.dedupe_case_insensitive(), 7500u);
+	EXPECT_EQ(array.to_vector(), NarrowMultiStringArray(set.view()).to_vector());
+	EXPECT_EQ(array.to_vector(), std::vector<std::string>(ids.begin(), ids.begin() + 2500));
+	EXPECT_TRUE(array.is_well_formed());
+}
+
+TEST(MultiStringArray, InlineAndPmrStorage)
+{
+	MultiStringArray<char, 16> small(std::vector<std::string>{"abc"});
+
+	for (int i = 0; i < 20; i++)
+	{
+		small.push_back("entry" + std::to_string(i));
+	}
+
+	EXPECT_EQ(small.count(), 21u);
+	EXPECT_TRUE(small.is_well_formed());
+
+	auto moved = std::move(small);
+	EXPECT_EQ(moved.count(), 21u);
+
+	std::pmr::monotonic_buffer_resource arena;
+	pmr::NarrowMultiStringArray pooled(std::vector<std::string>{"x", "y"}, &arena);
+	pooled.push_back("z");
+
+	EXPECT_EQ(pooled.to_vector(), (std::vector<std::string>{"x", "y", "z"}));
+	EXPECT_EQ(pooled.get_allocator().resource(), &arena);
+}
+
+TEST(MultiStringSet, CaseInsensitiveMembership)
+{
+	MultiStringSet<char16_t> set;
+
+	EXPECT_TRUE(set.insert(u"UpperFilter"));
+	EXPECT_FALSE(set.insert(u"UPPERFILTER"));
+	EXPECT_FALSE(set.insert(u""));
+	EXPECT_TRUE(set.insert(u"Other"));
+	EXPECT_EQ(set.find(u"upperfilter"), std::u16string_view(u"UpperFilter"));
+	EXPECT_TRUE(set.erase(u"upperFILTER"));
+	EXPECT_FALSE(set.contains(u"UpperFilter"));
+	EXPECT_EQ(Entries(set.view()), (std::vector<std::u16string>{u"Other"}));
+	EXPECT_TRUE(set.view().is_well_formed());
+}
+
+TEST(MultiStringSet, WideStringsFoldPerCodePoint)
+{
+	// U+10400 DESERET CAPITAL LONG I folds to U+10428, one unit of a UTF-32 wchar_t or a
+	// surrogate pair of a UTF-16 one
+	WideMultiStringSet set;
+
+	EXPECT_TRUE(set.insert(L"ROOT\\\U00010400"));
+	EXPECT_FALSE(set.insert(L"root\\\U00010428"));
+	EXPECT_TRUE(set.insert(L"Stra\u00DFe"));
+	EXPECT_FALSE(set.insert(L"STRA\u1E9EE"));
+	EXPECT_EQ(set.find(L"Root\\\U00010428"), std::wstring_view(L"ROOT\\\U00010400"));
+	EXPECT_EQ(casefold::HashIgnoreCase(std::wstring_view(L"\U00010400x")),
+	          casefold::HashIgnoreCase(std::u16string_view(u"\U00010428X")));
+	EXPECT_EQ(casefold::FindIgnoreCase(std::wstring_view(L"ab\U00010428C"), std::wstring_view(L"\U00010400c")), 2u);
+
+	WideMultiStringArray array(std::vector<std::wstring>{L"UpperFilter", L"\U00010400", L"upperfilter", L"\U00010428"});
+
+	EXPECT_EQ(array.dedupe_case_insensitive(), 2u);
+	EXPECT_EQ(array.to_vector(), (std::vector<std::wstring>{L"UpperFilter", L"\U00010400"}));
+	EXPECT_TRUE(array.is_well_formed());
+}
+
+TEST(CaseFolding, FoldCaseFoldsSurrogatePairsAsOneCodePoint)
+{
+	EXPECT_EQ(casefold::FoldCase(std::u16string_view(u"USB\\\U00010400\u00C4")), u"usb\\\U00010428\u00E4");
+	EXPECT_EQ(casefold::FoldCase(std::wstring_view(L"USB\\\U00010400\u00C4")), L"usb\\\U00010428\u00E4");
+	EXPECT_EQ(casefold::CompareIgnoreCase(std::u16string_view(u"\U00010400B"), std::u16string_view(u"\U00010428a")),
+	          std::strong_ordering::greater);
+	EXPECT_EQ(casefold::CompareIgnoreCase(std::wstring_view(L"\U00010400B"), std::wstring_view(L"\U00010428b")),
+	          std::strong_ordering::equal);
+
+	// by code point, so U+10428 orders after U+FF41 like it does in UTF-32
+	EXPECT_EQ(casefold::CompareIgnoreCase(std::u16string_view(u"\U00010428"), std::u16string_view(u"\uFF41")),
+	          std::strong_ordering::greater);
+}
+
+//
+// Properties checked against ReferenceParse and a std::vector model over many random buffers
+// and edit sequences; seeds are fixed so failures reproduce
+//
+
+TEST(MultiStringProperties, ViewMatchesReference)
+{
+	std::mt19937 rng(0x4E45464C);
+
+	for (int iteration = 0; iteration < 20000; iteration++)
+	{
+		const std::string buffer = RandomBuffer(rng, 24);
+		const auto copy = ExactCopy<char>(buffer);
+		const NarrowMultiStringView view(copy.get(), buffer.size());
+		const auto expected = Parse(buffer);
+
+		ASSERT_EQ(Entries(view), expected.Entries) << "buffer size " << buffer.size();
+		ASSERT_EQ(view.is_well_formed(), expected.WellFormed);
+		ASSERT_EQ(view.empty(), expected.Entries.empty());
+
+		const NarrowMultiStringArray array(view);
+
+		ASSERT_TRUE(array.is_well_formed());
+		ASSERT_EQ(array.to_vector(), expected.Entries);
+	}
+}
+
+TEST(MultiStringProperties, EditsKeepTheInvariant)
+{
+	std::mt19937 rng(0x4D535A);
+
+	for (int iteration = 0; iteration < 2000; iteration++)
+	{
+		const std::string buffer = RandomBuffer(rng, 16);
+		const auto copy = ExactCopy<char>(buffer);
+		MultiStringArray<char, 8> array(copy.get(), buffer.size());
+		std::vector<std::string> model = Parse(buffer).Entries;
+
+		for (int step = 0; step < 16; step++)
+		{
+			const std::string value = RandomEntry(rng);
+			const std::string entry = EntryOf(value);
+
+			switch (std::uniform_int_distribution<int>(0, 6)(rng))
+			{
+			case 0:
+				array.push_back(value);
+				if (!entry.empty())
+				{
+					model.push_back(entry);
+				}
+				break;
+			case 1:
+			{
+				const size_t index = std::uniform_int_distribution<size_t>(0, model.size() + 1)(rng);
+				array.insert_at(index, value);
+				if (!entry.empty())
+				{
+					model.insert(model.begin() + static_cast<std::ptrdiff_t>(std::min(index, model.size())), entry);
+				}
+				break;
+			}
+			case 2:
+				ASSERT_EQ(array.erase(value), static_cast<size_t>(std::erase(model, value)));
+				break;
+			case 3:
+			{
+				const std::string match = RandomEntry(rng);
+				const auto found = std::ranges::find(model, match);
+				ASSERT_EQ(array.replace(match, value), found != model.end());
+				if (found != model.end())
+				{
+					if (entry.empty())
+					{
+						model.erase(found);
+					}
+					else
+					{
+						*found = entry;
+					}
+				}
+				break;
+			}
+			case 4:
+			{
+				const auto predicate = [](std::string_view candidate) { return candidate.size() == 2; };
+				ASSERT_EQ(array.erase_if(predicate), static_cast<size_t>(std::erase_if(model, predicate)));
+				break;
+			}
+			case 5:
+				// a write through data() the array doesn't see, so the edit after it has to rescan
+				if (!model.empty())
+				{
+					array.data()[0] = 0;
+					model.clear();
+				}
+				array.push_back(value);
+				if (!entry.empty())
+				{
+					model.push_back(entry);
+				}
+				break;
+			default:
+			{
+				std::vector<std::string> unique;
+				for (const auto& candidate : model)
+				{
+					if (std::ranges::none_of(unique, [&](const std::string& kept)
+					{
+						return casefold::EqualsIgnoreCase(kept, candidate);
+					}))
+					{
+						unique.push_back(candidate);
+					}
+				}
+				ASSERT_EQ(array.dedupe_case_insensitive(), model.size() - unique.size());
+				model = std::move(unique);
+				break;
+			}
+			}
+
+			ASSERT_TRUE(array.is_well_formed());
+			ASSERT_EQ(array.to_vector(), model);
+		}
+	}
+}
@@ -0,0 +1,122 @@
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/StringPool.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	constexpr uint32_t ShardMask = 0xF; // see StringPool.cpp
+}
+
+TEST(StringPool, SameContentSameHandle)
+{
+	const auto before = InternedString::PoolSize();
+
+	const InternedString first(L"USB\\VID_045E&PID_028E");
+	const InternedString second(std::wstring(L"USB\\VID_045E&PID_028E"));
+	const InternedString other(L"usb\\vid_045e&pid_028e");
+	const InternedString copy = first;
+
+	EXPECT_NE(first.handle(), InternedString::NullHandle);
+	EXPECT_EQ(first.handle(), second.handle());
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(copy, first);
+	EXPECT_NE(first, other);
+	EXPECT_EQ(first.view(), L"USB\\VID_045E&PID_028E");
+	EXPECT_EQ(first.c_str()[first.view().size()], L'\0');
+	EXPECT_EQ(std::hash<InternedString>{}(first), std::hash<InternedString>{}(second));
+	EXPECT_EQ(InternedString::PoolSize(), before + 2);
+
+	// usable as a key of either kind of container
+	EXPECT_EQ((std::set<InternedString>{first, second, other}.size()), 2u);
+	EXPECT_EQ((std::unordered_set<InternedString>{first, second, other}.size()), 2u);
+}
+
+TEST(StringPool, EmptyStringsTakeNoEntry)
+{
+	const auto before = InternedString::PoolSize();
+	const InternedString empty(L"");
+
+	EXPECT_TRUE(empty.empty());
+	EXPECT_EQ(empty, InternedString());
+	EXPECT_EQ(empty.handle(), InternedString::NullHandle);
+	EXPECT_STREQ(empty.c_str(), L"");
+	EXPECT_TRUE(empty.view().empty());
+	EXPECT_EQ(InternedString::PoolSize(), before);
+}
+
+TEST(StringPool, ReleasedSlotsAreReused)
+{
+	const auto before = InternedString::PoolSize();
+	uint32_t released;
+
+	{
+		const InternedString value(L"StringPool.ReleasedSlotsAreReused");
+		InternedString moved = value;
+		const InternedString target(std::move(moved));
+
+		released = value.handle();
+		EXPECT_TRUE(moved.empty());
+		EXPECT_EQ(InternedString::PoolSize(), before + 1);
+	}
+
+	EXPECT_EQ(InternedString::PoolSize(), before);
+
+	// another string of the same shard takes the freed slot
+	for (int candidate = 0;; ++candidate)
+	{
+		const InternedString value(L"candidate " + std::to_wstring(candidate));
+
+		if ((value.handle() & ShardMask) == (released & ShardMask))
+		{
+			EXPECT_EQ(value.handle(), released);
+			EXPECT_EQ(value.view(), L"candidate " + std::to_wstring(candidate));
+			break;
+		}
+	}
+
+	EXPECT_EQ(InternedString::PoolSize(), before);
+}
+
+TEST(StringPool, ConcurrentInternAndReleaseOfTheSameString)
+{
+	const auto before = InternedString::PoolSize();
+	const std::wstring content = L"HID\\VID_045E&PID_028E&IG_00\\7&1A2B3C4D&0&0000";
+
+	{
+		std::vector<std::jthread> threads;
+
+		for (int thread = 0; thread < 8; ++thread)
+		{
+			threads.emplace_back([&content]
+			{
+				for (int round = 0; round < 20000; ++round)
+				{
+					InternedString value(content);
+					const InternedString copy = value;
+
+					ASSERT_EQ(copy.view(), content);
+
+					// drops to zero and revives the entry across threads
+					value = InternedString();
+					ASSERT_EQ(InternedString(content), copy);
+				}
+			});
+		}
+	}
+
+	EXPECT_EQ(InternedString::PoolSize(), before);
+
+	const InternedString again(content);
+
+	EXPECT_EQ(again.view(), content);
+	EXPECT_EQ(InternedString::PoolSize(), before + 1);
+}
@@ -0,0 +1,491 @@
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/Transcode.hpp>
+
+#if __has_include(<iconv.h>)
+#include <iconv.h>
+#define NEFLIB_TEST_ICONV
+#endif
+
+
+using namespace nefarius::utilities;
+using transcode::Kernel;
+
+namespace
+{
+	constexpr char32_t Replacement = 0xFFFD;
+
+	//
+	// Reference converters, written straight from the Unicode Standard (Table 3-7 and the
+	// "maximal subpart" substitution practice of section 3.9) and sharing no code with the library
+	//
+
+	std::u32string DecodeUtf8(std::string_view input)
+	{
+		std::u32string output;
+		size_t i = 0;
+
+		while (i < input.size())
+		{
+			const auto lead = static_cast<uint8_t>(input[i]);
+
+			if (lead < 0x80)
+			{
+				output.push_back(lead);
+				i++;
+				continue;
+			}
+
+			size_t trailing;
+			uint8_t low = 0x80, high = 0xBF;
+			char32_t value;
+
+			if (lead >= 0xC2 && lead <= 0xDF)
+			{
+				trailing = 1;
+				value = lead & 0x1F;
+			}
+			else if (lead >= 0xE0 && lead <= 0xEF)
+			{
+				trailing = 2;
+				value = lead & 0x0F;
+				low = lead == 0xE0 ? 0xA0 : 0x80;
+				high = lead == 0xED ? 0x9F : 0xBF;
+			}
+			else if (lead >= 0xF0 && lead <= 0xF4)
+			{
+				trailing = 3;
+				value = lead & 0x07;
+				low = lead == 0xF0 ? 0x90 : 0x80;
+				high = lead == 0xF4 ? 0x8F : 0xBF;
+			}
+			else
+			{
+				output.push_back(Replacement);
+				i++;
+				continue;
+			}
+
+			size_t next = i + 1;
+			bool valid = true;
+
+			for (size_t k = 0; k < trailing; k++, next++)
+			{
+				const auto byte = next < input.size() ? static_cast<uint8_t>(input[next]) : 0;
+
+				if (next >= input.size() || byte < (k == 0 ? low : 0x80) || byte > (k == 0 ? high : 0xBF))
+				{
+					valid = false;
+					break;
+				}
+
+				value = value << 6 | (byte & 0x3F);
+			}
+
+			output.push_back(valid ? value : Replacement);
+			i = next;
+		}
+
+		return output;
+	}
+
+	std::u32string DecodeUtf16(std::u16string_view input)
+	{
+		std::u32string output;
+
+		for (size_t i = 0; i < input.size(); i++)
+		{
+			const char16_t unit = input[i];
+
+			if (unit >= 0xD800 && unit <= 0xDBFF && i + 1 < input.size() && input[i + 1] >= 0xDC00 && input[i + 1]
+				<= 0xDFFF)
+			{
+				output.push_back(0x10000 + ((unit - 0xD800) << 10) + (input[i + 1] - 0xDC00));
+				i++;
+			}
+			else
+			{
+				output.push_back(unit >= 0xD800 && unit <= 0xDFFF ? Replacement : unit);
+			}
+		}
+
+		return output;
+	}
+
+	std::u32string DecodeUtf32(std::u32string_view input)
+	{
+		std::u32string output;
+
+		for (const char32_t value : input)
+		{
+			output.push_back(value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF) ? Replacement : value);
+		}
+
+		return output;
+	}
+
+	std::string EncodeUtf8(std::u32string_view input)
+	{
+		std::string output;
+
+		for (const char32_t value : input)
+		{
+			if (value < 0x80)
+			{
+				output.push_back(static_cast<char>(value));
+			}
+			else if (value < 0x800)
+			{
+				output.push_back(static_cast<char>(0xC0 | value >> 6));
+				output.push_back(static_cast<char>(0x80 | (value & 0x3F)));
+			}
+			else if (value < 0x10000)
+			{
+				output.push_back(static_cast<char>(0xE0 | value >> 12));
+				output.push_back(static_cast<char>(0x80 | (value >> 6 & 0x3F)));
+				output.push_back(static_cast<char>(0x80 | (value & 0x3F)));
+			}
+			else
+			{
+				output.push_back(static_cast<char>(0xF0 | value >> 18));
+				output.push_back(static_cast<char>(0x80 | (value >> 12 & 0x3F)));
+				output.push_back(static_cast<char>(0x80 | (value >> 6 & 0x3F)));
+				output.push_back(static_cast<char>(0x80 | (value & 0x3F)));
+			}
+		}
+
+		return output;
+	}
+
+	std::u16string EncodeUtf16(std::u32string_view input)
+	{
+		std::u16string output;
+
+		for (const char32_t value : input)
+		{
+			if (value < 0x10000)
+			{
+				output.push_back(static_cast<char16_t>(value));
+			}
+			else
+			{
+				output.push_back(static_cast<char16_t>(0xD800 + ((value - 0x10000) >> 10)));
+				output.push_back(static_cast<char16_t>(0xDC00 + ((value - 0x10000) & 0x3FF)));
+			}
+		}
+
+		return output;
+	}
+
+	//
+	// The library under test, through the currently selected kernel
+	//
+
+	std::string Utf16ToUtf8(std::u16string_view input)
+	{
+		std::string output(transcode::Utf8LengthFromUtf16(input.data(), input.size()), '\0');
+		output.resize(transcode::Utf16ToUtf8(input.data(), input.size(), output.data()));
+		return output;
+	}
+
+	std::u16string Utf8ToUtf16(std::string_view input)
+	{
+		std::u16string output(transcode::Utf16LengthFromUtf8(input.data(), input.size()), u'\0');
+		output.resize(transcode::Utf8ToUtf16(input.data(), input.size(), output.data()));
+		return output;
+	}
+
+	std::string Utf32ToUtf8(std::u32string_view input)
+	{
+		std::string output(transcode::Utf8LengthFromUtf32(input.data(), input.size()), '\0');
+		output.resize(transcode::Utf32ToUtf8(input.data(), input.size(), output.data()));
+		return output;
+	}
+
+	std::u32string Utf8ToUtf32(std::string_view input)
+	{
+		std::u32string output(transcode::Utf32LengthFromUtf8(input.data(), input.size()), U'\0');
+		output.resize(transcode::Utf8ToUtf32(input.data(), input.size(), output.data()));
+		return output;
+	}
+
+	//
+	// Inputs built from runs, so the vector loops see long ASCII stretches interrupted at every
+	// possible offset by multi-byte characters, truncated sequences and stray bytes
+	//
+
+	std::string RandomUtf8(std::mt19937& rng, bool wellFormed)
+	{
+		static constexpr std::string_view pieces[] = {
+			"\xC3\xA4", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xEF\xBF\xBD", "\xED\x9F\xBF", "\xEE\x80\x80",
+			"\xF4\x8F\xBF\xBF"
+		};
+		static constexpr std::string_view broken[] = {
+			"\x80", "\xBF", "\xC0\xAF", "\xC1\xBF", "\xC2", "\xE0\x80\xAF", "\xE0\xA0", "\xED\xA0\x80",
+			"\xED\xBF\xBF", "\xF0\x80\x80\xAF", "\xF0\x9F\x98", "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFE",
+			"\xFF", "\xE1\x80\xC2"
+		};
+
+		std::string input;
+		const auto runs = std::uniform_int_distribution<int>(0, 12)(rng);
+
+		for (int run = 0; run < runs; run++)
+		{
+			switch (std::uniform_int_distribution<int>(0, wellFormed ? 1 : 2)(rng))
+			{
+			case 0:
+				input.append(std::uniform_int_distribution<size_t>(0, 70)(rng),
+				             static_cast<char>(std::uniform_int_distribution<int>(0, 0x7F)(rng)));
+				break;
+			case 1:
+				input.append(pieces[std::uniform_int_distribution<size_t>(0, std::size(pieces) - 1)(rng)]);
+				break;
+			default:
+				input.append(broken[std::uniform_int_distribution<size_t>(0, std::size(broken) - 1)(rng)]);
+				break;
+			}
+		}
+
+		return input;
+	}
+
+	std::u16string RandomUtf16(std::mt19937& rng, bool wellFormed)
+	{
+		std::u16string input;
+		const auto runs = std::uniform_int_distribution<int>(0, 12)(rng);
+
+		for (int run = 0; run < runs; run++)
+		{
+			switch (std::uniform_int_distribution<int>(0, wellFormed ? 2 : 3)(rng))
+			{
+			case 0:
+				input.append(std::uniform_int_distribution<size_t>(0, 70)(rng),
+				             static_cast<char16_t>(std::uniform_int_distribution<int>(0, 0x7F)(rng)));
+				break;
+			case 1:
+				input.push_back(static_cast<char16_t>(std::uniform_int_distribution<int>(0x80, 0xD7FF)(rng)));
+				break;
+			case 2:
+				input.append(u"\U0001F600");
+				break;
+			default:
+				// lone high or low surrogate
+				input.push_back(static_cast<char16_t>(std::uniform_int_distribution<int>(0xD800, 0xDFFF)(rng)));
+				break;
+			}
+		}
+
+		return input;
+	}
+
+#if defined(NEFLIB_TEST_ICONV)
+	template <typename Output>
+	Output Iconv(const char* to, const char* from, const void* data, size_t bytes)
+	{
+		const iconv_t cd = iconv_open(to, from);
+		Output output((bytes + 1) * 4, typename Output::value_type());
+		char* in = static_cast<char*>(const_cast<void*>(data));
+		char* out = reinterpret_cast<char*>(output.data());
+		size_t outLeft = output.size() * sizeof(typename Output::value_type);
+
+		EXPECT_NE(iconv(cd, &in, &bytes, &out, &outLeft), static_cast<size_t>(-1));
+		iconv_close(cd);
+
+		output.resize(output.size() - outLeft / sizeof(typename Output::value_type));
+		return output;
+	}
+#endif
+
+	std::string KernelName(const testing::TestParamInfo<Kernel>& info)
+	{
+		static constexpr const char* names[] = {"Auto", "Scalar", "SSE2", "AVX2", "NEON"};
+		return names[static_cast<int>(info.param)];
+	}
+
+	class TranscodeKernel : public testing::TestWithParam<Kernel>
+	{
+	protected:
+		void SetUp() override
+		{
+			if (!transcode::SelectKernel(GetParam()))
+			{
+				GTEST_SKIP() << "kernel not supported on this CPU";
+			}
+		}
+
+		void TearDown() override
+		{
+			transcode::SelectKernel(Kernel::Auto);
+		}
+
+		//
+		// Runs a conversion with the scalar kernel, then switches back to the one under test
+		//
+		template <typename Function>
+		auto Scalar(Function function)
+		{
+			transcode::SelectKernel(Kernel::Scalar);
+			auto result = function();
+			transcode::SelectKernel(GetParam());
+			return result;
+		}
+	};
+}
+
+TEST(TranscodeReference, UnicodeStandardExamples)
+{
+	// Unicode Standard, section 3.9, table 3-8 (U+FFFD for maximal subparts)
+	EXPECT_EQ(DecodeUtf8("\x61\xF1\x80\x80\xE1\x80\xC2\x62\x80\x63\x80\xBF\x64"),
+	          U"\x61\xFFFD\xFFFD\xFFFD\x62\xFFFD\x63\xFFFD\xFFFD\x64");
+	EXPECT_EQ(DecodeUtf8("\xC0\xAF\xE0\x80\xBF\xF0\x81\x82\x41"),
+	          U"\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\x41");
+	EXPECT_EQ(DecodeUtf8("\xED\xA0\x80\xED\xBF\xBF\xED\xAF\x41"),
+	          U"\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\x41");
+	EXPECT_EQ(DecodeUtf16(u"a\xD800" u"b\xDC00\xD83D\xDE00"), U"a\xFFFD" U"b\xFFFD\U0001F600");
+}
+
+TEST_P(TranscodeKernel, UnicodeStandardExamples)
+{
+	EXPECT_EQ(Utf8ToUtf16("\x61\xF1\x80\x80\xE1\x80\xC2\x62\x80\x63\x80\xBF\x64"),
+	          u"\x61\xFFFD\xFFFD\xFFFD\x62\xFFFD\x63\xFFFD\xFFFD\x64");
+	EXPECT_EQ(Utf8ToUtf16("\xC0\xAF\xE0\x80\xBF\xF0\x81\x82\x41"),
+	          u"\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\x41");
+	EXPECT_EQ(Utf8ToUtf16("\xED\xA0\x80\xED\xBF\xBF\xED\xAF\x41"),
+	          u"\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\xFFFD\x41");
+}
+
+TEST_P(TranscodeKernel, UnpairedSurrogates)
+{
+	const std::u16string input = u"abc\xD800xyz\xDC00\xDBFF\xD83D\xDE00\xD800";
+
+	EXPECT_EQ(Utf16ToUtf8(input), "abc\xEF\xBF\xBDxyz\xEF\xBF\xBD\xEF\xBF\xBD\xF0\x9F\x98\x80\xEF\xBF\xBD");
+
+	// the same, but with a long ASCII run so the vector path hands over right before the surrogate
+	const std::u16string padded = std::u16string(67, u'p') + input;
+
+	EXPECT_EQ(Utf16ToUtf8(padded), EncodeUtf8(DecodeUtf16(padded)));
+}
+
+TEST_P(TranscodeKernel, AsciiAtEveryLengthAndOffset)
+{
+	std::string narrow;
+	std::u16string wide;
+
+	for (size_t i = 0; i < 200; i++)
+	{
+		narrow.push_back(static_cast<char>('!' + i % 90));
+		wide.push_back(static_cast<char16_t>('!' + i % 90));
+	}
+
+	for (size_t offset = 0; offset < 33; offset++)
+	{
+		for (size_t length = 0; offset + length <= narrow.size(); length++)
+		{
+			const std::string_view source(narrow.data() + offset, length);
+			const std::u16string_view wideSource(wide.data() + offset, length);
+
+			ASSERT_EQ(transcode::CountAsciiPrefix(source.data(), length), length);
+			ASSERT_EQ(transcode::CountAsciiPrefix(wideSource.data(), length), length);
+			ASSERT_EQ(Utf8ToUtf16(source), wideSource);
+			ASSERT_EQ(Utf16ToUtf8(wideSource), source);
+		}
+	}
+}
+
+TEST_P(TranscodeKernel, AsciiPrefixStopsAtTheFirstNonAsciiUnit)
+{
+	for (size_t position = 0; position < 100; position++)
+	{
+		std::string narrow(100, 'a');
+		std::u16string wide(100, u'a');
+		narrow[position] = '\x80';
+		wide[position] = u'\x80';
+
+		ASSERT_EQ(transcode::CountAsciiPrefix(narrow.data(), narrow.size()), position);
+		ASSERT_EQ(transcode::CountAsciiPrefix(wide.data(), wide.size()), position);
+
+		std::string narrowed(100, '\0');
+		std::u16string widened(100, u'\0');
+
+		ASSERT_EQ(transcode::NarrowAsciiPrefix(wide.data(), wide.size(), narrowed.data()), position);
+		ASSERT_EQ(transcode::WidenAsciiPrefix(narrow.data(), narrow.size(), widened.data()), position);
+		ASSERT_EQ(narrowed.substr(0, position), std::string(position, 'a'));
+		ASSERT_EQ(widened.substr(0, position), std::u16string(position, u'a'));
+	}
+}
+
+TEST_P(TranscodeKernel, MatchesReferenceAndScalar)
+{
+	std::mt19937 rng(1234);
+
+	for (int i = 0; i < 5000; i++)
+	{
+		const bool wellFormed = i % 2 == 0;
+		const auto narrow = RandomUtf8(rng, wellFormed);
+		const auto wide = RandomUtf16(rng, wellFormed);
+
+		const auto expectedWide = EncodeUtf16(DecodeUtf8(narrow));
+		const auto expectedNarrow = EncodeUtf8(DecodeUtf16(wide));
+
+		ASSERT_EQ(Utf8ToUtf16(narrow), expectedWide);
+		ASSERT_EQ(Utf16ToUtf8(wide), expectedNarrow);
+		ASSERT_EQ(Utf8ToUtf16(narrow), Scalar([&] { return Utf8ToUtf16(narrow); }));
+		ASSERT_EQ(Utf16ToUtf8(wide), Scalar([&] { return Utf16ToUtf8(wide); }));
+
+		ASSERT_EQ(transcode::Utf16LengthFromUtf8(narrow.data(), narrow.size()), expectedWide.size());
+		ASSERT_EQ(transcode::Utf8LengthFromUtf16(wide.data(), wide.size()), expectedNarrow.size());
+
+		if (wellFormed)
+		{
+			ASSERT_EQ(Utf16ToUtf8(Utf8ToUtf16(narrow)), narrow);
+			ASSERT_EQ(Utf8ToUtf16(Utf16ToUtf8(wide)), wide);
+		}
+	}
+}
+
+TEST_P(TranscodeKernel, Utf32MatchesReference)
+{
+	std::mt19937 rng(5678);
+
+	for (int i = 0; i < 2000; i++)
+	{
+		const auto narrow = RandomUtf8(rng, i % 2 == 0);
+		std::u32string wide = DecodeUtf16(RandomUtf16(rng, true));
+
+		// values no UTF-32 string may hold
+		if (i % 3 == 0)
+		{
+			wide.push_back(0xD800);
+			wide.push_back(0x110000);
+			wide.push_back(0xFFFFFFFF);
+		}
+
+		ASSERT_EQ(Utf8ToUtf32(narrow), DecodeUtf8(narrow));
+		ASSERT_EQ(Utf32ToUtf8(wide), EncodeUtf8(DecodeUtf32(wide)));
+	}
+}
+
+#if defined(NEFLIB_TEST_ICONV)
+TEST_P(TranscodeKernel, WellFormedInputMatchesIconv)
+{
+	std::mt19937 rng(91011);
+
+	for (int i = 0; i < 1000; i++)
+	{
+		const auto narrow = RandomUtf8(rng, true);
+		const auto wide = RandomUtf16(rng, true);
+
+		ASSERT_EQ(Utf8ToUtf16(narrow), Iconv<std::u16string>("UTF-16LE", "UTF-8", narrow.data(), narrow.size()));
+		ASSERT_EQ(Utf16ToUtf8(wide),
+		          Iconv<std::string>("UTF-8", "UTF-16LE", wide.data(), wide.size() * sizeof(char16_t)));
+	}
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P(AllKernels, TranscodeKernel,
+                         testing::Values(Kernel::Scalar, Kernel::SSE2, Kernel::AVX2, Kernel::NEON), KernelName);
@@ -0,0 +1,168 @@
+#include <cwchar>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <nefarius/neflib/UniUtil.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	std::wstring RandomWide(std::mt19937& rng, size_t length)
+	{
+		std::uniform_int_distribution<int> kind(0, 3);
+		std::wstring value;
+
+		while (value.size() < length)
+		{
+			char32_t codePoint;
+
+			switch (kind(rng))
+			{
+			case 0:
+				codePoint = std::uniform_int_distribution<char32_t>(0x20, 0x7E)(rng);
+				break;
+			case 1:
+				codePoint = std::uniform_int_distribution<char32_t>(0x80, 0xD7FF)(rng);
+				break;
+			case 2:
+				codePoint = std::uniform_int_distribution<char32_t>(0xE000, 0xFFFD)(rng);
+				break;
+			default:
+				codePoint = std::uniform_int_distribution<char32_t>(0x10000, 0x10FFFF)(rng);
+				break;
+			}
+
+#if WCHAR_MAX <= 0xFFFF
+			if (codePoint >= 0x10000)
+			{
+				codePoint -= 0x10000;
+				value.push_back(static_cast<wchar_t>(0xD800 + (codePoint >> 10)));
+				value.push_back(static_cast<wchar_t>(0xDC00 + (codePoint & 0x3FF)));
+				continue;
+			}
+#endif
+
+			value.push_back(static_cast<wchar_t>(codePoint));
+		}
+
+		return value;
+	}
+}
+
+TEST(UniUtil, AsciiRoundTrip)
+{
+	const std::wstring wide = L"USB\\VID_045E&PID_028E&REV_0114";
+	const std::string narrow = "USB\\VID_045E&PID_028E&REV_0114";
+
+	EXPECT_EQ(ConvertWideToANSI(wide), narrow);
+	EXPECT_EQ(ConvertAnsiToWide(narrow), wide);
+	EXPECT_EQ(ConvertToNarrow(wide), narrow);
+	EXPECT_EQ(ConvertToWide(narrow), wide);
+	EXPECT_EQ(ConvertToNarrow(std::wstring()), "");
+}
+
+TEST(UniUtil, SpanConversionReportsRequiredSize)
+{
+	const std::wstring_view wide = L"ROOT\\SYSTEM\\0001";
+	char buffer[8];
+
+	EXPECT_EQ(ConvertToNarrow(wide, std::span<char>()), wide.size());
+	EXPECT_EQ(ConvertToNarrow(wide, std::span(buffer)), wide.size());
+
+	std::string output(wide.size(), '\0');
+
+	EXPECT_EQ(ConvertToNarrow(wide, std::span(output)), wide.size());
+	EXPECT_EQ(output, "ROOT\\SYSTEM\\0001");
+
+	std::wstring widened(output.size(), L'\0');
+
+	EXPECT_EQ(ConvertToWide(output, std::span(widened)), output.size());
+	EXPECT_EQ(widened, wide);
+}
+
+TEST(UniUtil, AppendReusesTheString)
+{
+	std::string output = "prefix:";
+
+	AppendNarrow(output, L"abc");
+	AppendNarrow(output, L"def");
+
+	EXPECT_EQ(output, "prefix:abcdef");
+
+	std::wstring wide = L">";
+
+	AppendWide(wide, "xyz");
+
+	EXPECT_EQ(wide, L">xyz");
+}
+
+TEST(UniUtil, OutputIterators)
+{
+	std::string narrow;
+	ConvertToNarrow(std::wstring_view(L"hello"), std::back_inserter(narrow));
+
+	std::vector<wchar_t> wide;
+	ConvertToWide(std::string_view("world"), std::back_inserter(wide));
+
+	EXPECT_EQ(narrow, "hello");
+	EXPECT_EQ(std::wstring(wide.begin(), wide.end()), L"world");
+}
+
+TEST(UniUtil, EmbeddedNulsAreConverted)
+{
+	const std::wstring wide(L"a\0b", 3);
+
+	EXPECT_EQ(ConvertToNarrow(wide), std::string("a\0b", 3));
+	EXPECT_EQ(ConvertToWide(std::string("a\0b", 3)), wide);
+}
+
+//
+// The narrow encoding is the ANSI code page on Windows, so the non-ASCII expectations below only
+// hold everywhere else, where it's UTF-8
+//
+#if !defined(_WIN32)
+
+TEST(UniUtil, NonAsciiIsUtf8)
+{
+	const std::wstring wide = L"Gerät € \U0001F3AE";
+	const std::string narrow = "Ger\xC3\xA4t \xE2\x82\xAC \xF0\x9F\x8E\xAE";
+
+	EXPECT_EQ(ConvertToNarrow(wide), narrow);
+	EXPECT_EQ(ConvertToWide(narrow), wide);
+}
+
+TEST(UniUtil, IllFormedInputIsReplaced)
+{
+	// truncated sequence, stray continuation byte, overlong encoding, encoded surrogate
+	EXPECT_EQ(ConvertToWide(std::string("a\xE2\x82")), L"a�");
+	EXPECT_EQ(ConvertToWide(std::string("\x80x")), L"�x");
+	EXPECT_EQ(ConvertToWide(std::string("\xC0\xAF")), L"��");
+	EXPECT_EQ(ConvertToWide(std::string("\xED\xA0\x80")), L"���");
+
+	std::wstring surrogate = L"x";
+	surrogate.push_back(static_cast<wchar_t>(0xD800));
+
+	EXPECT_EQ(ConvertToNarrow(surrogate), "x\xEF\xBF\xBD");
+}
+
+TEST(UniUtil, RandomRoundTrips)
+{
+	std::mt19937 rng(0x554E49);
+
+	for (int iteration = 0; iteration < 2000; iteration++)
+	{
+		const std::wstring wide = RandomWide(rng, std::uniform_int_distribution<size_t>(0, 80)(rng));
+		const std::string narrow = ConvertToNarrow(wide);
+
+		ASSERT_EQ(ConvertToNarrow(wide, std::span<char>()), narrow.size());
+		ASSERT_EQ(ConvertToWide(narrow), wide);
+	}
+}
+
+#endif
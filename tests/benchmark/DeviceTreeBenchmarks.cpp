@@ -0,0 +1,131 @@
+//
+// Restarting, searching and listing devices on a DeviceTreeSimulator of 10000+ devnodes: hubs
+// with 100 composite devices each, 9 interfaces per composite device. The trees have no latency
+// so the numbers measure the engine and the simulator's bookkeeping, not sleeps.
+//
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <nefarius/neflib/DeviceTree.hpp>
+
+
+using namespace nefarius::devcon;
+
+namespace
+{
+	struct PopulatedTree
+	{
+		DeviceTreeSimulator Tree;
+		std::vector<std::wstring> Interfaces;
+
+		explicit PopulatedTree(int hubs)
+		{
+			for (int h = 0; h < hubs; h++)
+			{
+				SimulatedDevice hub;
+				hub.InstanceId = L"USB\\ROOT_HUB30\\" + std::to_wstring(h);
+				hub.Service = L"USBHUB3";
+				Tree.add(hub);
+
+				for (int p = 1; p <= 100; p++)
+				{
+					SimulatedDevice composite;
+					composite.InstanceId = L"USB\\VID_045E&PID_" + std::to_wstring(h * 1000 + p) + L"\\S";
+					composite.ParentInstanceId = hub.InstanceId;
+					composite.Address = p;
+					composite.Service = L"usbccgp";
+					Tree.add(composite);
+
+					for (int i = 0; i < 9; i++)
+					{
+						SimulatedDevice device;
+						device.InstanceId = L"HID\\" + composite.InstanceId + L"&MI_0" + std::to_wstring(i);
+						device.ParentInstanceId = composite.InstanceId;
+						device.Service = i == 0 ? L"kbdhid" : L"HidUsb";
+						device.HardwareIds = {L"HID\\VID_045E&MI_0" + std::to_wstring(i)};
+						Tree.add(device);
+						Interfaces.push_back(device.InstanceId);
+					}
+				}
+			}
+		}
+	};
+
+	PopulatedTree& Populated(int hubs)
+	{
+		static std::map<int, std::unique_ptr<PopulatedTree>> trees;
+		auto& tree = trees[hubs];
+
+		if (!tree)
+		{
+			tree = std::make_unique<PopulatedTree>(hubs);
+		}
+
+		return *tree;
+	}
+
+	void BM_Restart(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<int>(state.range(0)));
+		const auto strategy = static_cast<RestartStrategy>(state.range(1));
+		size_t next = 0;
+
+		DeviceRestartOptions options;
+		options.AllowUsbPortCycle = strategy == RestartStrategy::UsbPortCycle;
+		options.AllowPropertyChange = strategy == RestartStrategy::PropertyChange;
+		options.AllowRemoveAndReenumerate = strategy == RestartStrategy::RemoveAndReenumerate;
+
+		for (auto _ : state)
+		{
+			const auto& id = populated.Interfaces[next++ * 7919 % populated.Interfaces.size()];
+
+			if (!RestartDeviceInstance(populated.Tree, id, options).Succeeded)
+			{
+				state.SkipWithError("restart failed");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+		state.counters["devnodes"] = static_cast<double>(populated.Tree.size());
+	}
+
+	void BM_FindByHwId(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<int>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(FindByHwId(populated.Tree, L"MI_03"));
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * populated.Tree.size()));
+	}
+
+	void BM_ListByService(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<int>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(ListDeviceInstancesByService(populated.Tree, L"kbdhid"));
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * populated.Tree.size()));
+	}
+}
+
+BENCHMARK(BM_Restart)->ArgNames({"hubs", "strategy"})->ArgsProduct({
+	{10, 20},
+	{
+		static_cast<int64_t>(RestartStrategy::UsbPortCycle),
+		static_cast<int64_t>(RestartStrategy::PropertyChange),
+		static_cast<int64_t>(RestartStrategy::RemoveAndReenumerate)
+	}
+})->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_FindByHwId)->ArgName("hubs")->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ListByService)->ArgName("hubs")->Arg(10)->Arg(20)->Unit(benchmark::kMillisecond);
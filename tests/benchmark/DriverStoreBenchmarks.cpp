@@ -0,0 +1,204 @@
+//
+// Enumerating, matching against and deleting from a driver store of 10000+ packages, run
+// against DriverStoreEmulator so the numbers don't depend on the machine's real store. The
+// store is built once per size in the temporary directory and removed at exit.
+//
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <nefarius/neflib/DriverStore.hpp>
+
+
+using namespace nefarius::devcon;
+namespace fs = std::filesystem;
+
+namespace
+{
+	struct PopulatedStore
+	{
+		fs::path Scratch;
+		std::vector<fs::path> Originals;
+		std::unique_ptr<DriverStoreEmulator> Store;
+		std::unique_ptr<DriverStoreIndex> Index;
+		size_t Created = 0;
+
+		PopulatedStore(const PopulatedStore&) = delete;
+		PopulatedStore& operator=(const PopulatedStore&) = delete;
+
+		explicit PopulatedStore(size_t count)
+			: Scratch(fs::temp_directory_path() / ("neflib-bench-driverstore-" + std::to_string(count)))
+		{
+			fs::remove_all(Scratch);
+			fs::create_directories(Scratch / "source");
+
+			Store = std::make_unique<DriverStoreEmulator>(std::move(*DriverStoreEmulator::Open(Scratch / "store")));
+
+			for (size_t i = 0; i < count; i++)
+			{
+				Originals.push_back(Write(i));
+				Store->publish(Originals.back());
+			}
+
+			Index = std::make_unique<DriverStoreIndex>(std::move(*DriverStoreIndex::Build(*Store)));
+		}
+
+		~PopulatedStore()
+		{
+			Store.reset();
+			std::error_code error;
+			fs::remove_all(Scratch, error);
+		}
+
+		//
+		// A typical function driver INF with a unique hardware ID and version
+		//
+		fs::path Write(size_t number)
+		{
+			const std::string id = std::to_string(number);
+			const fs::path path = Scratch / "source" / ("pkg" + id + ".inf");
+
+			std::ofstream(path, std::ios::binary)
+				<< "[Version]\r\nSignature=\"$WINDOWS NT$\"\r\nClass=HIDClass\r\n"
+				<< "ClassGuid={745a17a0-74d3-11d0-b6fe-00a0c90f57da}\r\nProvider=%Mfg%\r\n"
+				<< "DriverVer=10/17/2026,1.0." << number << ".0\r\n\r\n"
+				<< "[Manufacturer]\r\n%Mfg%=Models,NTamd64\r\n\r\n"
+				<< "[Models.NTamd64]\r\n%Desc%=Install,USB\\VID_1234&PID_" << id << "\r\n\r\n"
+				<< "[Install.NT]\r\nCopyFiles=Files\r\n\r\n"
+				<< "[Strings]\r\nMfg=\"Contoso\"\r\nDesc=\"Device " << id << "\"\r\n";
+
+			return path;
+		}
+	};
+
+	PopulatedStore& Populated(size_t count)
+	{
+		static std::map<size_t, std::unique_ptr<PopulatedStore>> stores;
+		auto& store = stores[count];
+
+		if (!store)
+		{
+			store = std::make_unique<PopulatedStore>(count);
+		}
+
+		return *store;
+	}
+
+	void BM_Enumerate(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			size_t packages = 0;
+
+			populated.Store->enumerate([&](const DriverStorePackageView&)
+			{
+				packages++;
+				return true;
+			});
+
+			benchmark::DoNotOptimize(packages);
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * populated.Store->size()));
+	}
+
+	void BM_EnumerateFiltered(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<size_t>(state.range(0)));
+
+		// the last package published, so the whole store is scanned; spelled in another case
+		const std::wstring name = L"OEM" + std::to_wstring(populated.Store->size() - 1) + L".INF";
+		DriverStorePackageFilter filter;
+		filter.PublishedInfName = name;
+
+		for (auto _ : state)
+		{
+			const DriverStorePackageView* found = nullptr;
+
+			populated.Store->enumerate([&](const DriverStorePackageView& package)
+			{
+				found = &package;
+				return false;
+			}, filter);
+
+			if (found == nullptr)
+			{
+				state.SkipWithError("package not found");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * populated.Store->size()));
+	}
+
+	//
+	// Parsing every package INF once; what a match is paid for up front
+	//
+	void BM_IndexBuild(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(DriverStoreIndex::Build(*populated.Store));
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * populated.Store->size()));
+	}
+
+	void BM_Match(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<size_t>(state.range(0)));
+		size_t next = 0;
+
+		for (auto _ : state)
+		{
+			const auto& original = populated.Originals[next++ * 7919 % populated.Originals.size()];
+			const auto matches = populated.Index->match(original);
+
+			if (!matches || matches->size() != 1)
+			{
+				state.SkipWithError("package not found");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	}
+
+	//
+	// Publishing isn't timed, only removing the package again
+	//
+	void BM_Delete(benchmark::State& state)
+	{
+		auto& populated = Populated(static_cast<size_t>(state.range(0)));
+
+		for (auto _ : state)
+		{
+			state.PauseTiming();
+			const auto package = populated.Store->publish(populated.Write(state.range(0) + populated.Created++));
+			state.ResumeTiming();
+
+			if (!package || !populated.Store->remove(*package))
+			{
+				state.SkipWithError("publishing or removing failed");
+				break;
+			}
+		}
+
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+	}
+}
+
+BENCHMARK(BM_Enumerate)->ArgName("packages")->Arg(10000)->Arg(20000);
+BENCHMARK(BM_EnumerateFiltered)->ArgName("packages")->Arg(10000)->Arg(20000);
+BENCHMARK(BM_IndexBuild)->ArgName("packages")->Arg(10000)->Arg(20000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Match)->ArgName("packages")->Arg(10000)->Arg(20000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Delete)->ArgName("packages")->Arg(10000)->Arg(20000)->Unit(benchmark::kMicrosecond);
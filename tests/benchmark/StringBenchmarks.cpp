@@ -0,0 +1,298 @@
+//
+// Conversions (items) and input bytes per second of the string layer: the UniUtil conversions,
+// the transcoding kernels behind them and the multi-string containers. Inputs mimic what an
+// inventory sweep converts: hardware/instance IDs, mostly ASCII, some with non-ASCII names.
+//
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <nefarius/neflib/MultiStringArray.hpp>
+#include <nefarius/neflib/MultiStringSet.hpp>
+#include <nefarius/neflib/Transcode.hpp>
+#include <nefarius/neflib/UniUtil.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	std::vector<std::wstring> HardwareIds(bool nonAscii)
+	{
+		std::vector<std::wstring> ids;
+
+		for (int i = 0; i < 256; i++)
+		{
+			std::wstring id = L"USB\\VID_045E&PID_" + std::to_wstring(1000 + i) + L"&REV_0114&MI_00\\7&2a5f1b3c&0&000" +
+				std::to_wstring(i % 10);
+
+			if (nonAscii && i % 4 == 0)
+			{
+				id += L"\\Gerät für Eingabe €";
+			}
+
+			ids.push_back(std::move(id));
+		}
+
+		return ids;
+	}
+
+	std::vector<std::string> Narrow(const std::vector<std::wstring>& ids)
+	{
+		std::vector<std::string> narrow;
+
+		for (const auto& id : ids)
+		{
+			narrow.push_back(ConvertToNarrow(id));
+		}
+
+		return narrow;
+	}
+
+	template <typename Strings>
+	size_t TotalBytes(const Strings& strings)
+	{
+		size_t bytes = 0;
+
+		for (const auto& value : strings)
+		{
+			bytes += value.size() * sizeof(value[0]);
+		}
+
+		return bytes;
+	}
+
+	void Report(benchmark::State& state, size_t itemsPerIteration, size_t bytesPerIteration)
+	{
+		state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * itemsPerIteration));
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytesPerIteration));
+	}
+
+	void BM_ConvertWideToANSI(benchmark::State& state)
+	{
+		const auto ids = HardwareIds(state.range(0) != 0);
+
+		for (auto _ : state)
+		{
+			for (const auto& id : ids)
+			{
+				benchmark::DoNotOptimize(ConvertWideToANSI(id));
+			}
+		}
+
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	void BM_ConvertAnsiToWide(benchmark::State& state)
+	{
+		const auto ids = Narrow(HardwareIds(state.range(0) != 0));
+
+		for (auto _ : state)
+		{
+			for (const auto& id : ids)
+			{
+				benchmark::DoNotOptimize(ConvertAnsiToWide(id));
+			}
+		}
+
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	//
+	// Clearing and re-appending to one string; no allocation once it has grown
+	//
+	void BM_AppendNarrow(benchmark::State& state)
+	{
+		const auto ids = HardwareIds(state.range(0) != 0);
+		std::string output;
+
+		for (auto _ : state)
+		{
+			for (const auto& id : ids)
+			{
+				output.clear();
+				benchmark::DoNotOptimize(AppendNarrow(output, id).data());
+			}
+		}
+
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	void BM_Utf16ToUtf8(benchmark::State& state)
+	{
+		const auto kernel = static_cast<transcode::Kernel>(state.range(0));
+
+		if (!transcode::SelectKernel(kernel))
+		{
+			state.SkipWithError("kernel not supported on this CPU");
+			return;
+		}
+
+		std::vector<std::u16string> ids;
+
+		for (const auto& id : HardwareIds(false))
+		{
+			ids.emplace_back(id.begin(), id.end());
+		}
+
+		std::string output(4096, '\0');
+
+		for (auto _ : state)
+		{
+			for (const auto& id : ids)
+			{
+				benchmark::DoNotOptimize(transcode::Utf16ToUtf8(id.data(), id.size(), output.data()));
+			}
+		}
+
+		transcode::SelectKernel(transcode::Kernel::Auto);
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	void BM_Utf8ToUtf16(benchmark::State& state)
+	{
+		const auto kernel = static_cast<transcode::Kernel>(state.range(0));
+
+		if (!transcode::SelectKernel(kernel))
+		{
+			state.SkipWithError("kernel not supported on this CPU");
+			return;
+		}
+
+		const auto ids = Narrow(HardwareIds(false));
+		std::u16string output(4096, u'\0');
+
+		for (auto _ : state)
+		{
+			for (const auto& id : ids)
+			{
+				benchmark::DoNotOptimize(transcode::Utf8ToUtf16(id.data(), id.size(), output.data()));
+			}
+		}
+
+		transcode::SelectKernel(transcode::Kernel::Auto);
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	void BM_MultiStringArrayFromVector(benchmark::State& state)
+	{
+		const auto ids = Narrow(HardwareIds(false));
+		const std::vector<std::string> lists[] = {
+			{ids.begin(), ids.begin() + 2}, {ids.begin(), ids.begin() + 8}, {ids.begin(), ids.end()}
+		};
+		const auto& list = lists[state.range(0)];
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(NarrowMultiStringArray(list).c_str());
+		}
+
+		Report(state, 1, TotalBytes(list));
+	}
+
+	void BM_MultiStringArrayToVector(benchmark::State& state)
+	{
+		const auto ids = Narrow(HardwareIds(false));
+		const NarrowMultiStringArray array(ids);
+
+		for (auto _ : state)
+		{
+			benchmark::DoNotOptimize(array.to_vector());
+		}
+
+		Report(state, 1, array.size());
+	}
+
+	void BM_MultiStringViewIterate(benchmark::State& state)
+	{
+		const auto ids = Narrow(HardwareIds(false));
+		const NarrowMultiStringArray array(ids);
+
+		for (auto _ : state)
+		{
+			size_t total = 0;
+
+			for (const auto entry : array.view())
+			{
+				total += entry.size();
+			}
+
+			benchmark::DoNotOptimize(total);
+		}
+
+		Report(state, 1, array.size());
+	}
+
+	void BM_MultiStringArrayPushBack(benchmark::State& state)
+	{
+		const auto ids = Narrow(HardwareIds(false));
+
+		for (auto _ : state)
+		{
+			SmallNarrowMultiStringArray array;
+
+			for (const auto& id : ids)
+			{
+				array.push_back(id);
+			}
+
+			benchmark::DoNotOptimize(array.c_str());
+		}
+
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+
+	void BM_MultiStringArrayDedupe(benchmark::State& state)
+	{
+		auto ids = Narrow(HardwareIds(false));
+		ids.insert(ids.end(), ids.begin(), ids.end());
+		const NarrowMultiStringArray source(ids);
+
+		for (auto _ : state)
+		{
+			auto array = source;
+			benchmark::DoNotOptimize(array.dedupe_case_insensitive());
+		}
+
+		Report(state, ids.size(), source.size());
+	}
+
+	void BM_MultiStringSetInsert(benchmark::State& state)
+	{
+		std::vector<std::u16string> ids;
+
+		for (const auto& id : HardwareIds(false))
+		{
+			ids.emplace_back(id.begin(), id.end());
+		}
+
+		for (auto _ : state)
+		{
+			MultiStringSet<char16_t> set;
+
+			for (const auto& id : ids)
+			{
+				set.insert(id);
+			}
+
+			benchmark::DoNotOptimize(set.c_str());
+		}
+
+		Report(state, ids.size(), TotalBytes(ids));
+	}
+}
+
+BENCHMARK(BM_ConvertWideToANSI)->ArgName("non_ascii")->Arg(0)->Arg(1);
+BENCHMARK(BM_ConvertAnsiToWide)->ArgName("non_ascii")->Arg(0)->Arg(1);
+BENCHMARK(BM_AppendNarrow)->ArgName("non_ascii")->Arg(0)->Arg(1);
+BENCHMARK(BM_Utf16ToUtf8)->ArgName("kernel")->DenseRange(static_cast<int>(transcode::Kernel::Scalar),
+                                                          static_cast<int>(transcode::Kernel::NEON));
+BENCHMARK(BM_Utf8ToUtf16)->ArgName("kernel")->DenseRange(static_cast<int>(transcode::Kernel::Scalar),
+                                                          static_cast<int>(transcode::Kernel::NEON));
+BENCHMARK(BM_MultiStringArrayFromVector)->ArgName("list")->DenseRange(0, 2);
+BENCHMARK(BM_MultiStringArrayToVector);
+BENCHMARK(BM_MultiStringViewIterate);
+BENCHMARK(BM_MultiStringArrayPushBack);
+BENCHMARK(BM_MultiStringArrayDedupe);
+BENCHMARK(BM_MultiStringSetInsert);
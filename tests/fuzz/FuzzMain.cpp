@@ -0,0 +1,104 @@
+//
+// Stands in for libFuzzer where it isn't available (GCC, MSVC): runs the target on every file
+// (or every file in every directory) given on the command line, then on -runs=N pseudo-random
+// inputs. The generator is seeded with -seed=N (default 1), so a failing run reproduces.
+//
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size);
+
+namespace
+{
+	void RunFile(const std::filesystem::path& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+		LLVMFuzzerTestOneInput(data.data(), data.size());
+	}
+
+	//
+	// Half the inputs are drawn from a handful of byte values (NULs, ASCII, UTF-8 lead and
+	// continuation bytes, surrogate halves), which hits the interesting cases far more often
+	// than uniform bytes do
+	//
+	std::vector<uint8_t> RandomInput(std::mt19937_64& rng)
+	{
+		static constexpr uint8_t interesting[] = {
+			0x00, 0x00, 0x00, 'a', 'A', '\\', '%', ';', '\n', 0x7F, 0x80, 0xBF, 0xC2, 0xDF, 0xE0, 0xED, 0xEF,
+			0xF0, 0xF4, 0xFF, 0xD8, 0xDC
+		};
+
+		const size_t length = std::uniform_int_distribution<size_t>(0, 1)(rng)
+			                      ? std::uniform_int_distribution<size_t>(0, 64)(rng)
+			                      : std::uniform_int_distribution<size_t>(0, 4096)(rng);
+		const bool skewed = std::uniform_int_distribution<int>(0, 1)(rng) != 0;
+
+		std::vector<uint8_t> data(length);
+
+		for (auto& byte : data)
+		{
+			byte = skewed
+				       ? interesting[std::uniform_int_distribution<size_t>(0, std::size(interesting) - 1)(rng)]
+				       : static_cast<uint8_t>(std::uniform_int_distribution<int>(0, 255)(rng));
+		}
+
+		return data;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t runs = 0;
+	uint64_t seed = 1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view argument = argv[i];
+
+		if (argument.starts_with("-runs="))
+		{
+			runs = std::strtoull(argv[i] + 6, nullptr, 10);
+		}
+		else if (argument.starts_with("-seed="))
+		{
+			seed = std::strtoull(argv[i] + 6, nullptr, 10);
+		}
+		else if (std::filesystem::is_directory(argument))
+		{
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(argument))
+			{
+				if (entry.is_regular_file())
+				{
+					RunFile(entry.path());
+				}
+			}
+		}
+		else
+		{
+			RunFile(argument);
+		}
+	}
+
+	std::mt19937_64 rng(seed);
+
+	for (uint64_t run = 0; run < runs; run++)
+	{
+		const auto data = RandomInput(rng);
+		LLVMFuzzerTestOneInput(data.data(), data.size());
+	}
+
+	std::printf("Done %llu runs (seed %llu)\n", static_cast<unsigned long long>(runs),
+	            static_cast<unsigned long long>(seed));
+
+	return 0;
+}
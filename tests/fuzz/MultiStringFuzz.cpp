@@ -0,0 +1,174 @@
+//
+// Feeds arbitrary bytes as narrow and UTF-16 multi-string buffers to MultiStringView,
+// MultiStringArray and MultiStringSet, then drives the editing operations with the same bytes.
+// Traps if the double-NUL invariant or the entries ever disagree with a plain re-parse; reads
+// out of bounds are left to the sanitizers.
+//
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nefarius/neflib/MultiStringArray.hpp>
+#include <nefarius/neflib/MultiStringSet.hpp>
+#include <nefarius/neflib/MultiStringView.hpp>
+
+
+using namespace nefarius::utilities;
+
+namespace
+{
+	void Check(bool condition)
+	{
+		if (!condition)
+		{
+			std::abort();
+		}
+	}
+
+	template <typename CharT>
+	std::vector<std::basic_string_view<CharT>> Reparse(const CharT* buffer, size_t length)
+	{
+		std::vector<std::basic_string_view<CharT>> entries;
+		size_t pos = 0;
+
+		while (pos < length && buffer[pos] != CharT('\0'))
+		{
+			size_t end = pos;
+
+			while (end < length && buffer[end] != CharT('\0'))
+			{
+				end++;
+			}
+
+			entries.emplace_back(buffer + pos, end - pos);
+			pos = end + 1;
+		}
+
+		return entries;
+	}
+
+	template <typename CharT>
+	void CheckWellFormed(const MultiStringView<CharT> view)
+	{
+		Check(view.is_well_formed());
+
+		const auto entries = Reparse(view.data(), view.chars());
+
+		Check(std::ranges::equal(view, entries));
+	}
+
+	template <typename CharT>
+	void FuzzBuffer(const CharT* buffer, size_t length, const uint8_t* ops, size_t opCount)
+	{
+		const MultiStringView<CharT> view(buffer, length);
+		const auto entries = Reparse(buffer, length);
+
+		Check(std::ranges::equal(view, entries));
+		Check(view.empty() == entries.empty());
+
+		MultiStringArray<CharT, 32> array(buffer, length);
+
+		Check(array.count() == entries.size());
+		Check(array.is_well_formed() == view.is_well_formed());
+
+		CheckWellFormed(MultiStringArray<CharT>(view).view());
+
+		MultiStringSet<CharT> set(view);
+		CheckWellFormed(set.view());
+		Check(set.count() <= entries.size());
+
+		for (const auto entry : entries)
+		{
+			Check(set.contains(entry));
+		}
+
+		//
+		// Two bytes per edit: the operation and an entry index or a string length. A raw buffer is
+		// only repaired by an edit that changes the array, so until then it may stay unterminated.
+		//
+		bool edited = false;
+
+		for (size_t i = 0; i + 1 < opCount; i += 2)
+		{
+			const size_t argument = ops[i + 1];
+			const auto values = array.to_vector();
+			const std::basic_string_view<CharT> some = values.empty()
+				                                           ? std::basic_string_view<CharT>()
+				                                           : std::basic_string_view<CharT>(
+					                                           values[argument % values.size()]);
+			const std::basic_string<CharT> fresh(argument % 5, static_cast<CharT>('a' + argument % 3));
+
+			switch (ops[i] % 7)
+			{
+			case 0:
+				array.push_back(fresh);
+				edited = true;
+				break;
+			case 1:
+				array.insert_at(argument, fresh);
+				edited = true;
+				break;
+			case 2:
+				array.erase(some);
+				edited = true;
+				break;
+			case 3:
+				edited |= array.replace(some, fresh);
+				break;
+			case 4:
+				array.erase_if([argument](std::basic_string_view<CharT> entry) { return entry.size() == argument % 4; });
+				edited = true;
+				break;
+			case 5:
+				array.dedupe_case_insensitive();
+				edited = true;
+				break;
+			default:
+				set.erase(some);
+				CheckWellFormed(set.view());
+				break;
+			}
+
+			if (edited)
+			{
+				CheckWellFormed(array.view());
+			}
+
+			Check(array.count() == Reparse(array.c_str(), array.chars()).size());
+		}
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	if (Size == 0)
+	{
+		return 0;
+	}
+
+	//
+	// The first byte splits the input into the buffer and the edit script
+	//
+	const size_t split = std::min<size_t>(Data[0], Size - 1);
+	const uint8_t* payload = Data + 1;
+	const uint8_t* ops = payload + split;
+	const size_t opCount = Size - 1 - split;
+
+	//
+	// Exactly sized heap copies, so any read past the end is caught
+	//
+	const auto narrow = std::make_unique<char[]>(split);
+	std::memcpy(narrow.get(), payload, split);
+	FuzzBuffer(narrow.get(), split, ops, opCount);
+
+	const size_t units = split / sizeof(char16_t);
+	const auto wide = std::make_unique<char16_t[]>(units);
+	std::memcpy(wide.get(), payload, units * sizeof(char16_t));
+	FuzzBuffer(wide.get(), units, ops, opCount);
+
+	return 0;
+}
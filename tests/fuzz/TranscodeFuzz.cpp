@@ -0,0 +1,99 @@
+//
+// Converts arbitrary bytes as UTF-8, UTF-16 and UTF-32 with every kernel this CPU supports and
+// traps if any of them disagrees with the scalar kernel, writes past the length it reported or
+// fails to round-trip its own output.
+//
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <nefarius/neflib/Transcode.hpp>
+
+
+using namespace nefarius::utilities;
+using transcode::Kernel;
+
+namespace
+{
+	void Check(bool condition)
+	{
+		if (!condition)
+		{
+			std::abort();
+		}
+	}
+
+	struct Results
+	{
+		std::u16string Utf16;
+		std::u32string Utf32;
+		std::string FromUtf16;
+		std::string FromUtf32;
+	};
+
+	Results Convert(const std::string& narrow, const std::u16string& wide, const std::u32string& wide32)
+	{
+		Results results;
+
+		results.Utf16.resize(transcode::Utf16LengthFromUtf8(narrow.data(), narrow.size()));
+		Check(transcode::Utf8ToUtf16(narrow.data(), narrow.size(), results.Utf16.data()) == results.Utf16.size());
+
+		results.Utf32.resize(transcode::Utf32LengthFromUtf8(narrow.data(), narrow.size()));
+		Check(transcode::Utf8ToUtf32(narrow.data(), narrow.size(), results.Utf32.data()) == results.Utf32.size());
+
+		results.FromUtf16.resize(transcode::Utf8LengthFromUtf16(wide.data(), wide.size()));
+		Check(transcode::Utf16ToUtf8(wide.data(), wide.size(), results.FromUtf16.data()) == results.FromUtf16.size());
+
+		results.FromUtf32.resize(transcode::Utf8LengthFromUtf32(wide32.data(), wide32.size()));
+		Check(transcode::Utf32ToUtf8(wide32.data(), wide32.size(), results.FromUtf32.data()) ==
+			results.FromUtf32.size());
+
+		return results;
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size)
+{
+	const std::string narrow(reinterpret_cast<const char*>(Data), Size);
+	std::u16string wide(Size / sizeof(char16_t), u'\0');
+	std::u32string wide32(Size / sizeof(char32_t), U'\0');
+	std::memcpy(wide.data(), Data, wide.size() * sizeof(char16_t));
+	std::memcpy(wide32.data(), Data, wide32.size() * sizeof(char32_t));
+
+	transcode::SelectKernel(Kernel::Scalar);
+	const auto expected = Convert(narrow, wide, wide32);
+
+	//
+	// Whatever came out is well-formed, so converting it back and forth must be lossless
+	//
+	{
+		std::string back(transcode::Utf8LengthFromUtf16(expected.Utf16.data(), expected.Utf16.size()), '\0');
+		back.resize(transcode::Utf16ToUtf8(expected.Utf16.data(), expected.Utf16.size(), back.data()));
+
+		std::u16string again(transcode::Utf16LengthFromUtf8(back.data(), back.size()), u'\0');
+		again.resize(transcode::Utf8ToUtf16(back.data(), back.size(), again.data()));
+
+		Check(again == expected.Utf16);
+	}
+
+	for (const auto kernel : {Kernel::SSE2, Kernel::AVX2, Kernel::NEON})
+	{
+		if (!transcode::SelectKernel(kernel))
+		{
+			continue;
+		}
+
+		const auto actual = Convert(narrow, wide, wide32);
+
+		Check(actual.Utf16 == expected.Utf16);
+		Check(actual.Utf32 == expected.Utf32);
+		Check(actual.FromUtf16 == expected.FromUtf16);
+		Check(actual.FromUtf32 == expected.FromUtf32);
+	}
+
+	transcode::SelectKernel(Kernel::Auto);
+
+	return 0;
+}